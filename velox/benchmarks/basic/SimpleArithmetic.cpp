@@ -17,6 +17,7 @@
 #include <folly/Benchmark.h>
 #include <gflags/gflags.h>
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/functions/Registerer.h"
 #include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
 #include "velox/functions/prestosql/ArithmeticImpl.h"
@@ -80,6 +81,41 @@ struct CheckedPlusFunction {
   }
 };
 
+// Multiply with a hand-written SIMD kernel for flat inputs without nulls.
+template <typename T>
+struct MultiplyBatchFunction {
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  call(TInput& result, const TInput& a, const TInput& b) {
+    result = functions::multiply(a, b);
+  }
+
+  void callBatch(
+      double* result,
+      const double* a,
+      const double* b,
+      int32_t size) {
+    using Batch = xsimd::batch<double>;
+    int32_t i = 0;
+    for (; i + Batch::size <= size; i += Batch::size) {
+      (Batch::load_unaligned(a + i) * Batch::load_unaligned(b + i))
+          .store_unaligned(result + i);
+    }
+    for (; i < size; ++i) {
+      result[i] = functions::multiply(a[i], b[i]);
+    }
+  }
+};
+
+template <typename T>
+struct LessThanFunction {
+  template <typename TInput>
+  FOLLY_ALWAYS_INLINE void
+  call(bool& result, const TInput& a, const TInput& b) {
+    result = a < b;
+  }
+};
+
 class SimpleArithmeticBenchmark
     : public functions::test::FunctionBenchmarkBase {
  public:
@@ -90,6 +126,9 @@ class SimpleArithmeticBenchmark
         {"multiply_nullable_output"});
     registerFunction<MultiplyNullOutputFunction, double, double, double>(
         {"multiply_null_output"});
+    registerFunction<MultiplyBatchFunction, double, double, double>(
+        {"multiply_batch"});
+    registerFunction<LessThanFunction, bool, double, double>({"less_than"});
 
     registerFunction<PlusFunction, int64_t, int64_t, int64_t>({"plus"});
     registerFunction<CheckedPlusFunction, int64_t, int64_t, int64_t>(
@@ -132,28 +171,50 @@ class SimpleArithmeticBenchmark
         pool(), inputType_, nullptr, size, std::move(children));
   }
 
-  size_t runSmall(const std::string& expression, size_t times) {
-    return run(expression, times, smallRowVector_);
+  size_t runSmall(
+      const std::string& expression,
+      size_t times,
+      bool allRows = true) {
+    return run(expression, times, smallRowVector_, allRows);
   }
 
-  size_t runMedium(const std::string& expression, size_t times) {
-    return run(expression, times, mediumRowVector_);
+  size_t runMedium(
+      const std::string& expression,
+      size_t times,
+      bool allRows = true) {
+    return run(expression, times, mediumRowVector_, allRows);
   }
 
-  size_t runLarge(const std::string& expression, size_t times) {
-    return run(expression, times, largeRowVector_);
+  size_t runLarge(
+      const std::string& expression,
+      size_t times,
+      bool allRows = true) {
+    return run(expression, times, largeRowVector_, allRows);
   }
 
-  // Runs `expression` `times` thousand times.
-  size_t
-  run(const std::string& expression, size_t times, const RowVectorPtr& input) {
+  // Runs `expression` `times` thousand times. If `allRows` is false, the
+  // first row is left out, so that functions iterate over the selected rows
+  // instead of running their dense loop over all rows.
+  size_t run(
+      const std::string& expression,
+      size_t times,
+      const RowVectorPtr& input,
+      bool allRows = true) {
     folly::BenchmarkSuspender suspender;
     auto exprSet = compileExpression(expression, inputType_);
+    SelectivityVector rows(input->size());
+    if (!allRows) {
+      rows.setValid(0, false);
+      rows.updateBounds();
+    }
     suspender.dismiss();
 
     size_t count = 0;
     for (auto i = 0; i < times * 1'000; i++) {
-      count += evaluate(exprSet, input)->size();
+      exec::EvalCtx evalCtx(&execCtx_, &exprSet, input.get());
+      std::vector<VectorPtr> results(1);
+      exprSet.eval(rows, &evalCtx, &results);
+      count += results[0]->size();
     }
     return count;
   }
@@ -218,6 +279,36 @@ BENCHMARK_MULTI(plusCheckedSmall, n) {
   return benchmark->runSmall("checked_plus(c, d)", n);
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_MULTI(multiplyPerRowSmall, n) {
+  return benchmark->runSmall("multiply(a, b)", n, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(multiplyDenseSmall, n) {
+  return benchmark->runSmall("multiply(a, b)", n);
+}
+
+BENCHMARK_RELATIVE_MULTI(multiplyBatchSmall, n) {
+  return benchmark->runSmall("multiply_batch(a, b)", n);
+}
+
+BENCHMARK_MULTI(multiplyConstantPerRowSmall, n) {
+  return benchmark->runSmall("multiply(a, constant)", n, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(multiplyConstantDenseSmall, n) {
+  return benchmark->runSmall("multiply(a, constant)", n);
+}
+
+BENCHMARK_MULTI(lessThanPerRowSmall, n) {
+  return benchmark->runSmall("less_than(a, b)", n, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(lessThanDenseSmall, n) {
+  return benchmark->runSmall("less_than(a, b)", n);
+}
+
 BENCHMARK_DRAW_LINE();
 BENCHMARK_DRAW_LINE();
 
@@ -272,6 +363,36 @@ BENCHMARK_MULTI(plusCheckedMedium, n) {
   return benchmark->runMedium("checked_plus(c, d)", n);
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_MULTI(multiplyPerRowMedium, n) {
+  return benchmark->runMedium("multiply(a, b)", n, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(multiplyDenseMedium, n) {
+  return benchmark->runMedium("multiply(a, b)", n);
+}
+
+BENCHMARK_RELATIVE_MULTI(multiplyBatchMedium, n) {
+  return benchmark->runMedium("multiply_batch(a, b)", n);
+}
+
+BENCHMARK_MULTI(multiplyConstantPerRowMedium, n) {
+  return benchmark->runMedium("multiply(a, constant)", n, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(multiplyConstantDenseMedium, n) {
+  return benchmark->runMedium("multiply(a, constant)", n);
+}
+
+BENCHMARK_MULTI(lessThanPerRowMedium, n) {
+  return benchmark->runMedium("less_than(a, b)", n, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(lessThanDenseMedium, n) {
+  return benchmark->runMedium("less_than(a, b)", n);
+}
+
 BENCHMARK_DRAW_LINE();
 BENCHMARK_DRAW_LINE();
 
@@ -326,6 +447,36 @@ BENCHMARK_MULTI(plusCheckedLarge, n) {
   return benchmark->runLarge("checked_plus(c, d)", n);
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_MULTI(multiplyPerRowLarge, n) {
+  return benchmark->runLarge("multiply(a, b)", n, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(multiplyDenseLarge, n) {
+  return benchmark->runLarge("multiply(a, b)", n);
+}
+
+BENCHMARK_RELATIVE_MULTI(multiplyBatchLarge, n) {
+  return benchmark->runLarge("multiply_batch(a, b)", n);
+}
+
+BENCHMARK_MULTI(multiplyConstantPerRowLarge, n) {
+  return benchmark->runLarge("multiply(a, constant)", n, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(multiplyConstantDenseLarge, n) {
+  return benchmark->runLarge("multiply(a, constant)", n);
+}
+
+BENCHMARK_MULTI(lessThanPerRowLarge, n) {
+  return benchmark->runLarge("less_than(a, b)", n, false);
+}
+
+BENCHMARK_RELATIVE_MULTI(lessThanDenseLarge, n) {
+  return benchmark->runLarge("less_than(a, b)", n);
+}
+
 } // namespace
 
 int main(int argc, char* argv[]) {
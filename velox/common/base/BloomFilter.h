@@ -49,6 +49,11 @@ class BloomFilter {
         hashInput ? folly::hasher<uint64_t>()(value) : value);
   }
 
+  // Returns the size of the bits in bytes.
+  uint64_t sizeInBytes() const {
+    return bits_.size() * sizeof(uint64_t);
+  }
+
   bool mayContain(uint64_t value) const {
     return test(
         bits_.data(),
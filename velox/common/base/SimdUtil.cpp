@@ -16,6 +16,8 @@
 
 #include "velox/common/base/SimdUtil.h"
 #include <folly/Preprocessor.h>
+#include <cstring>
+#include <string>
 
 namespace facebook::velox::simd {
 
@@ -74,4 +76,49 @@ bool initializeSimdUtil() {
 
 static bool FB_ANONYMOUS_VARIABLE(g_simdConstants) = initializeSimdUtil();
 
+size_t simdStrstr(
+    const char* s,
+    size_t size,
+    const char* needle,
+    size_t needleSize) {
+  if (needleSize == 0) {
+    return 0;
+  }
+  if (needleSize > size) {
+    return std::string::npos;
+  }
+  using Batch = xsimd::batch<int8_t>;
+  // One bit per byte of a batch, e.g. 64 bits for AVX-512.
+  using CandidateMask =
+      std::conditional_t<(Batch::size > 32), uint64_t, uint32_t>;
+  static_assert(Batch::size <= 64);
+  const auto first = xsimd::broadcast<int8_t>(needle[0]);
+  const auto last = xsimd::broadcast<int8_t>(needle[needleSize - 1]);
+  size_t offset = 0;
+  for (; offset + needleSize - 1 + Batch::size <= size;
+       offset += Batch::size) {
+    auto firstBlock =
+        xsimd::load_unaligned(reinterpret_cast<const int8_t*>(s + offset));
+    auto lastBlock = xsimd::load_unaligned(
+        reinterpret_cast<const int8_t*>(s + offset + needleSize - 1));
+    auto candidates = static_cast<CandidateMask>(
+        toBitMask((firstBlock == first) & (lastBlock == last)));
+    while (candidates) {
+      auto position = offset + __builtin_ctzll(candidates);
+      if (needleSize <= 2 ||
+          memcmp(s + position + 1, needle + 1, needleSize - 2) == 0) {
+        return position;
+      }
+      candidates &= candidates - 1;
+    }
+  }
+  for (; offset + needleSize <= size; ++offset) {
+    if (s[offset] == needle[0] &&
+        memcmp(s + offset, needle, needleSize) == 0) {
+      return offset;
+    }
+  }
+  return std::string::npos;
+}
+
 } // namespace facebook::velox::simd
@@ -395,6 +395,16 @@ void memset(void* to, char data, int32_t bytes, const A& = {});
     }                                                      \
   }()
 
+// Returns the offset of the first occurrence of 'needle' of 'needleSize'
+// bytes in 's' of 'size' bytes or std::string::npos if there is none.
+// Compares the first and last byte of 'needle' with a batch of positions
+// at a time and only memcmp's the candidates where both match.
+size_t simdStrstr(
+    const char* FOLLY_NONNULL s,
+    size_t size,
+    const char* FOLLY_NONNULL needle,
+    size_t needleSize);
+
 // Returns true if 'values[0]' to 'values[size - 1]' are consecutive
 // values of T. The values are expected to be sorted.
 template <typename T>
@@ -295,6 +295,36 @@ TEST_F(SimdUtilTest, memory) {
   }
 }
 
+TEST_F(SimdUtilTest, strstr) {
+  auto find = [](const std::string& s, const std::string& needle) {
+    return simd::simdStrstr(s.data(), s.size(), needle.data(), needle.size());
+  };
+  EXPECT_EQ(0, find("abc", ""));
+  EXPECT_EQ(std::string::npos, find("ab", "abc"));
+  EXPECT_EQ(0, find("abc", "abc"));
+  EXPECT_EQ(std::string::npos, find("abd", "abc"));
+
+  // Needles of 1 to 10 bytes at every position of a haystack longer than a
+  // few batches, preceded by near misses.
+  for (auto needleSize = 1; needleSize <= 10; ++needleSize) {
+    std::string needle;
+    for (auto i = 0; i < needleSize; ++i) {
+      needle.push_back('a' + i);
+    }
+    std::string nearMiss = needle;
+    nearMiss.back() = 'z';
+    for (auto position = 0; position < 100; ++position) {
+      std::string s(position, 'x');
+      if (position >= needleSize && needleSize > 1) {
+        s.replace(0, needleSize, nearMiss);
+      }
+      s += needle + std::string(position % 7, 'y');
+      EXPECT_EQ(s.find(needle), find(s, needle)) << s << " " << needle;
+      EXPECT_EQ(std::string::npos, find(s, needle + "!"));
+    }
+  }
+}
+
 TEST_F(SimdUtilTest, crc32) {
   uint32_t checksum = 0;
   checksum = simd::crc32U64(0, 123456789);
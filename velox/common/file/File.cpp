@@ -22,6 +22,8 @@
 #include <stdexcept>
 
 #include <fcntl.h>
+#include <folly/String.h>
+#include <folly/portability/SysMman.h>
 #include <folly/portability/SysUio.h>
 
 namespace facebook::velox {
@@ -56,6 +58,17 @@ uint64_t InMemoryReadFile::preadv(
   return numRead;
 }
 
+std::string_view InMemoryReadFile::preadView(uint64_t offset, uint64_t length)
+    const {
+  VELOX_CHECK(
+      offset <= file_.size() && length <= file_.size() - offset,
+      "Read past end of InMemoryReadFile, offset {} length {}",
+      offset,
+      length);
+  bytesRead_ += length;
+  return file_.substr(offset, length);
+}
+
 void InMemoryWriteFile::append(std::string_view data) {
   file_->append(data);
 }
@@ -140,6 +153,120 @@ uint64_t LocalReadFile::memoryUsage() const {
   return sizeof(FILE);
 }
 
+namespace {
+int toMadvise(MmapOptions::Advice advice) {
+  switch (advice) {
+    case MmapOptions::Advice::kNormal:
+      return MADV_NORMAL;
+    case MmapOptions::Advice::kSequential:
+      return MADV_SEQUENTIAL;
+    case MmapOptions::Advice::kRandom:
+      return MADV_RANDOM;
+    case MmapOptions::Advice::kWillNeed:
+      return MADV_WILLNEED;
+    case MmapOptions::Advice::kDontNeed:
+      return MADV_DONTNEED;
+  }
+  VELOX_UNREACHABLE();
+}
+} // namespace
+
+MmapReadFile::MmapReadFile(std::string_view path, MmapOptions options) {
+  const std::string name(path);
+  fd_ = open(name.c_str(), O_RDONLY);
+  VELOX_CHECK_GE(
+      fd_,
+      0,
+      "open failure in MmapReadFile constructor, {}: {}",
+      path,
+      folly::errnoStr(errno));
+  const off_t size = lseek(fd_, 0, SEEK_END);
+  VELOX_CHECK_GE(size, 0, "lseek failure in MmapReadFile, {}.", path);
+  size_ = size;
+  if (size_ == 0) {
+    return;
+  }
+  int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+  if (options.populate) {
+    flags |= MAP_POPULATE;
+  }
+#endif
+  auto data = mmap(nullptr, size_, PROT_READ, flags, fd_, 0);
+  VELOX_CHECK(
+      data != MAP_FAILED,
+      "mmap failure in MmapReadFile, {}: {}",
+      path,
+      folly::errnoStr(errno));
+  data_ = static_cast<char*>(data);
+  if (options.advice != MmapOptions::Advice::kNormal) {
+    advise(0, size_, options.advice);
+  }
+}
+
+MmapReadFile::~MmapReadFile() {
+  if (data_) {
+    munmap(data_, size_);
+  }
+  ::close(fd_);
+}
+
+void MmapReadFile::checkRange(uint64_t offset, uint64_t length) const {
+  VELOX_CHECK(
+      offset <= size_ && length <= size_ - offset,
+      "Read past end of MmapReadFile, offset {} length {}",
+      offset,
+      length);
+}
+
+std::string_view
+MmapReadFile::pread(uint64_t offset, uint64_t length, void* buf) const {
+  auto view = preadView(offset, length);
+  memcpy(buf, view.data(), length);
+  return {static_cast<char*>(buf), length};
+}
+
+std::string MmapReadFile::pread(uint64_t offset, uint64_t length) const {
+  return std::string(preadView(offset, length));
+}
+
+uint64_t MmapReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  uint64_t numRead = 0;
+  for (auto& range : buffers) {
+    if (range.data()) {
+      auto view = preadView(offset + numRead, range.size());
+      memcpy(range.data(), view.data(), range.size());
+    }
+    numRead += range.size();
+  }
+  return numRead;
+}
+
+std::string_view MmapReadFile::preadView(uint64_t offset, uint64_t length)
+    const {
+  checkRange(offset, length);
+  bytesRead_ += length;
+  return {data_ + offset, length};
+}
+
+void MmapReadFile::advise(
+    uint64_t offset,
+    uint64_t length,
+    MmapOptions::Advice advice) const {
+  checkRange(offset, length);
+  if (length == 0) {
+    return;
+  }
+  // madvise() takes page aligned addresses.
+  static const uint64_t kPageSize = sysconf(_SC_PAGESIZE);
+  const uint64_t begin = offset / kPageSize * kPageSize;
+  auto rc = madvise(data_ + begin, offset + length - begin, toMadvise(advice));
+  VELOX_CHECK_EQ(
+      rc, 0, "madvise failure in MmapReadFile: {}", folly::errnoStr(errno));
+}
+
 LocalWriteFile::LocalWriteFile(std::string_view path) {
   std::unique_ptr<char[]> buf(new char[path.size() + 1]);
   buf[path.size()] = 0;
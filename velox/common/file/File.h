@@ -81,6 +81,19 @@ class ReadFile {
     return false;
   }
 
+  // Returns the bytes at [offset, offset + length) as a view of memory
+  // owned by the file, e.g. a memory mapping, without copying. The view
+  // stays valid for the lifetime of the file. Use only if hasPreadView()
+  // is true.
+  virtual std::string_view preadView(uint64_t /*offset*/, uint64_t /*length*/)
+      const {
+    VELOX_NYI("preadView not supported");
+  }
+
+  virtual bool hasPreadView() const {
+    return false;
+  }
+
   // Whether preads should be coalesced where possible. E.g. remote disk would
   // set to true, in-memory to false.
   virtual bool shouldCoalesce() const = 0;
@@ -150,6 +163,18 @@ class InMemoryReadFile final : public ReadFile {
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const final;
 
+  std::string_view preadView(uint64_t offset, uint64_t length) const final;
+
+  // Mainly for testing. Off by default, so that readers of in-memory files
+  // go through the same copying paths as for other files.
+  void setHasPreadView(bool hasPreadView) {
+    hasPreadView_ = hasPreadView;
+  }
+
+  bool hasPreadView() const final {
+    return hasPreadView_;
+  }
+
   uint64_t size() const final {
     return file_.size();
   }
@@ -170,6 +195,7 @@ class InMemoryReadFile final : public ReadFile {
   const std::string ownedFile_;
   const std::string_view file_;
   bool shouldCoalesce_ = false;
+  bool hasPreadView_ = false;
 };
 
 class InMemoryWriteFile final : public WriteFile {
@@ -212,6 +238,10 @@ class LocalReadFile final : public ReadFile {
     return false;
   }
 
+  int32_t fd() const {
+    return fd_;
+  }
+
  private:
   void preadInternal(uint64_t offset, uint64_t length, char* FOLLY_NONNULL pos)
       const;
@@ -220,6 +250,72 @@ class LocalReadFile final : public ReadFile {
   mutable long size_ = -1;
 };
 
+struct MmapOptions {
+  // madvise() advice for the pages of a mapping.
+  enum class Advice { kNormal, kSequential, kRandom, kWillNeed, kDontNeed };
+
+  // Faults in the whole file when it is opened (MAP_POPULATE) instead of
+  // on first access of each page.
+  bool populate{false};
+
+  // Advice for the whole mapping, applied when the file is opened.
+  Advice advice{Advice::kNormal};
+};
+
+// Reads a local file through a read-only shared memory mapping. The pread
+// variants copy out of the mapping like LocalReadFile. preadView() returns
+// the mapped bytes without a copy. An access to a page of a file truncated
+// after opening raises SIGBUS, so use only for files that are not modified
+// while read.
+class MmapReadFile final : public ReadFile {
+ public:
+  explicit MmapReadFile(std::string_view path, MmapOptions options = {});
+
+  ~MmapReadFile();
+
+  std::string_view
+  pread(uint64_t offset, uint64_t length, void* FOLLY_NONNULL buf) const final;
+
+  std::string pread(uint64_t offset, uint64_t length) const final;
+
+  uint64_t preadv(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  std::string_view preadView(uint64_t offset, uint64_t length) const final;
+
+  bool hasPreadView() const final {
+    return true;
+  }
+
+  uint64_t size() const final {
+    return size_;
+  }
+
+  // The mapped pages belong to the page cache and are not counted.
+  uint64_t memoryUsage() const final {
+    return sizeof(*this);
+  }
+
+  bool shouldCoalesce() const final {
+    return false;
+  }
+
+  // Applies 'advice' to the pages of [offset, offset + length), e.g.
+  // kWillNeed to read ahead a range that is about to be decoded or
+  // kDontNeed to drop a range that has been consumed.
+  void advise(uint64_t offset, uint64_t length, MmapOptions::Advice advice)
+      const;
+
+ private:
+  void checkRange(uint64_t offset, uint64_t length) const;
+
+  int32_t fd_;
+  uint64_t size_{0};
+  // nullptr for an empty file, which cannot be mapped.
+  char* FOLLY_NULLABLE data_{nullptr};
+};
+
 class LocalWriteFile final : public WriteFile {
  public:
   // An error is thrown is a file already exists at |path|.
@@ -18,6 +18,7 @@
 #include <folly/synchronization/CallOnce.h>
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/file/File.h"
+#include "velox/common/file/IoUringFile.h"
 #include "velox/core/Context.h"
 
 #include <cstdio>
@@ -28,6 +29,33 @@ namespace {
 
 constexpr std::string_view kFileScheme("file:");
 
+// Configs of the local file system. If 'local.mmap-enabled' is true, files
+// are read through a memory mapping. 'local.mmap-populate' faults in the
+// whole file on open and 'local.mmap-advice' is one of 'normal',
+// 'sequential', 'random' or 'willneed' and is applied to the whole file.
+// These are process-wide: the local file system is a singleton that keeps
+// the config it is first created with, so they apply to every local file
+// opened afterwards, whatever config is passed to getFileSystem() later.
+constexpr const char* kMmapEnabled = "local.mmap-enabled";
+constexpr const char* kMmapPopulate = "local.mmap-populate";
+constexpr const char* kMmapAdvice = "local.mmap-advice";
+
+MmapOptions::Advice toMmapAdvice(const std::string& name) {
+  if (name == "normal") {
+    return MmapOptions::Advice::kNormal;
+  }
+  if (name == "sequential") {
+    return MmapOptions::Advice::kSequential;
+  }
+  if (name == "random") {
+    return MmapOptions::Advice::kRandom;
+  }
+  if (name == "willneed") {
+    return MmapOptions::Advice::kWillNeed;
+  }
+  VELOX_USER_FAIL("Unknown {}: {}", kMmapAdvice, name);
+}
+
 using RegisteredFileSystems = std::vector<std::pair<
     std::function<bool(std::string_view)>,
     std::function<std::shared_ptr<FileSystem>(std::shared_ptr<const Config>)>>>;
@@ -77,17 +105,31 @@ class LocalFileSystem : public FileSystem {
 
   std::unique_ptr<ReadFile> openFileForRead(std::string_view path) override {
     if (path.find(kFileScheme) == 0) {
-      return std::make_unique<LocalReadFile>(path.substr(kFileScheme.length()));
+      path = path.substr(kFileScheme.length());
+    }
+    if (config_ && config_->get<bool>(kMmapEnabled, false)) {
+      MmapOptions options;
+      options.populate = config_->get<bool>(kMmapPopulate, false);
+      options.advice = toMmapAdvice(
+          config_->get<std::string>(kMmapAdvice, std::string("normal")));
+      return std::make_unique<MmapReadFile>(path, options);
     }
+#ifdef VELOX_ENABLE_IO_URING
+    return std::make_unique<IoUringReadFile>(path);
+#else
     return std::make_unique<LocalReadFile>(path);
+#endif
   }
 
   std::unique_ptr<WriteFile> openFileForWrite(std::string_view path) override {
     if (path.find(kFileScheme) == 0) {
-      return std::make_unique<LocalWriteFile>(
-          path.substr(kFileScheme.length()));
+      path = path.substr(kFileScheme.length());
     }
+#ifdef VELOX_ENABLE_IO_URING
+    return std::make_unique<IoUringWriteFile>(path);
+#else
     return std::make_unique<LocalWriteFile>(path);
+#endif
   }
 
   void remove(std::string_view path) override {
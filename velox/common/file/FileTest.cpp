@@ -16,6 +16,7 @@
 
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/file/IoUringFile.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
 
 #include "gtest/gtest.h"
@@ -80,6 +81,24 @@ TEST(InMemoryFile, writeAndRead) {
   readData(&readFile);
 }
 
+TEST(InMemoryFile, preadView) {
+  std::string data = "aaaaabbbbbccccc";
+  InMemoryReadFile readFile(data);
+  ASSERT_FALSE(readFile.hasPreadView());
+  readFile.setHasPreadView(true);
+  ASSERT_TRUE(readFile.hasPreadView());
+  auto view = readFile.preadView(5, 5);
+  ASSERT_EQ(view, "bbbbb");
+  ASSERT_EQ(view.data(), data.data() + 5);
+  ASSERT_EQ(readFile.preadView(15, 0).size(), 0);
+  EXPECT_THROW(readFile.preadView(10, 6), VeloxRuntimeError);
+  EXPECT_THROW(readFile.preadView(16, 0), VeloxRuntimeError);
+  // 'offset + length' wraps around.
+  EXPECT_THROW(
+      readFile.preadView(5, std::numeric_limits<uint64_t>::max()),
+      VeloxRuntimeError);
+}
+
 TEST(LocalFile, writeAndRead) {
   auto tempFile = ::exec::test::TempFilePath::create();
   const auto& filename = tempFile->path.c_str();
@@ -92,6 +111,40 @@ TEST(LocalFile, writeAndRead) {
   readData(&readFile);
 }
 
+TEST(MmapFile, writeAndRead) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  MmapOptions options;
+  options.advice = MmapOptions::Advice::kSequential;
+  MmapReadFile readFile(filename, options);
+  readData(&readFile);
+
+  ASSERT_TRUE(readFile.hasPreadView());
+  auto view = readFile.preadView(10 + kOneMB, 5);
+  ASSERT_EQ(view, "ddddd");
+  // The view points into the mapping.
+  ASSERT_EQ(readFile.preadView(0, 5).data() + 10 + kOneMB, view.data());
+  readFile.advise(kOneMB, 15, MmapOptions::Advice::kWillNeed);
+  EXPECT_THROW(readFile.preadView(kOneMB, 16), VeloxRuntimeError);
+  EXPECT_THROW(
+      readFile.preadView(kOneMB, std::numeric_limits<uint64_t>::max()),
+      VeloxRuntimeError);
+}
+
+TEST(MmapFile, emptyFile) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  MmapOptions options;
+  options.populate = true;
+  MmapReadFile readFile(tempFile->path, options);
+  ASSERT_EQ(readFile.size(), 0);
+  ASSERT_EQ(readFile.preadView(0, 0).size(), 0);
+}
+
 TEST(LocalFile, viaRegistry) {
   filesystems::registerLocalFileSystem();
   auto tempFile = ::exec::test::TempFilePath::create();
@@ -108,3 +161,56 @@ TEST(LocalFile, viaRegistry) {
   ASSERT_EQ(readFile->pread(0, 5, &buffer1), "snarf");
   lfs->remove(filename);
 }
+
+#ifdef VELOX_ENABLE_IO_URING
+TEST(IoUringFile, writeAndRead) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    IoUringWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  IoUringReadFile readFile(filename);
+  readData(&readFile);
+}
+
+TEST(IoUringFile, preadvAsync) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    IoUringWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  IoUringReadFile readFile(filename);
+  if (!readFile.hasPreadvAsync()) {
+    // The kernel does not support io_uring.
+    return;
+  }
+  // Many outstanding reads, more than the queue depth, each with skips.
+  constexpr int32_t kNumReads = 1000;
+  std::vector<std::array<char, 10>> heads(kNumReads);
+  std::vector<std::array<char, 5>> tails(kNumReads);
+  std::vector<folly::SemiFuture<uint64_t>> futures;
+  for (auto i = 0; i < kNumReads; ++i) {
+    std::vector<folly::Range<char*>> buffers = {
+        folly::Range<char*>(heads[i].data(), heads[i].size()),
+        folly::Range<char*>(nullptr, (char*)(uint64_t)kOneMB),
+        folly::Range<char*>(tails[i].data(), tails[i].size())};
+    futures.push_back(readFile.preadvAsync(0, buffers));
+  }
+  for (auto i = 0; i < kNumReads; ++i) {
+    ASSERT_EQ(std::move(futures[i]).get(), 15 + kOneMB);
+    ASSERT_EQ(std::string_view(heads[i].data(), 10), "aaaaabbbbb");
+    ASSERT_EQ(std::string_view(tails[i].data(), 5), "ddddd");
+  }
+  EXPECT_EQ(IoUringContext::instance().numInFlight(), 0);
+
+  // A read past the end returns the bytes up to the end.
+  char buffer[20];
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(buffer, sizeof(buffer))};
+  EXPECT_EQ(readFile.preadvAsync(10 + kOneMB, buffers).get(), 5);
+}
+#endif
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef VELOX_ENABLE_IO_URING
+
+#include "velox/common/file/IoUringFile.h"
+
+#include <fcntl.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+
+namespace facebook::velox {
+
+namespace {
+// Bound on appended and not yet completed writes of an IoUringWriteFile.
+// Each holds a copy of its data.
+constexpr int32_t kMaxPendingWrites = 64;
+
+void setError(folly::Promise<uint64_t>& promise, const std::string& message) {
+  try {
+    VELOX_FAIL("{}", message);
+  } catch (const std::exception&) {
+    promise.setException(folly::exception_wrapper(std::current_exception()));
+  }
+}
+} // namespace
+
+IoUringContext::IoUringContext() {
+  auto rc = io_uring_queue_init(kQueueDepth, &ring_, 0);
+  if (rc < 0) {
+    LOG(WARNING) << "io_uring is not available, local file IO is synchronous: "
+                 << folly::errnoStr(-rc);
+    return;
+  }
+  valid_ = true;
+  reaper_ = std::thread([this]() { reap(); });
+}
+
+IoUringContext::~IoUringContext() {
+  if (!valid_) {
+    return;
+  }
+  {
+    // A NOP without a request wakes up the reaper to exit.
+    std::unique_lock<std::mutex> l(mutex_);
+    shutdown_ = true;
+    auto sqe = io_uring_get_sqe(&ring_);
+    while (!sqe) {
+      io_uring_submit(&ring_);
+      sqe = io_uring_get_sqe(&ring_);
+    }
+    io_uring_prep_nop(sqe);
+    io_uring_sqe_set_data(sqe, nullptr);
+    io_uring_submit(&ring_);
+  }
+  reaper_.join();
+  io_uring_queue_exit(&ring_);
+}
+
+// static
+IoUringContext& IoUringContext::instance() {
+  static IoUringContext context;
+  return context;
+}
+
+std::vector<folly::SemiFuture<uint64_t>> IoUringContext::submit(
+    std::vector<std::unique_ptr<Request>> requests) {
+  VELOX_CHECK(valid_, "io_uring is not available");
+  std::vector<folly::SemiFuture<uint64_t>> futures;
+  futures.reserve(requests.size());
+  std::unique_lock<std::mutex> l(mutex_);
+  VELOX_CHECK(!shutdown_);
+  for (auto& request : requests) {
+    futures.push_back(request->promise.getSemiFuture());
+    enqueueLocked(request.release(), l);
+  }
+  auto rc = io_uring_submit(&ring_);
+  VELOX_CHECK_GE(rc, 0, "io_uring_submit failed: {}", folly::errnoStr(-rc));
+  return futures;
+}
+
+void IoUringContext::enqueueLocked(
+    Request* request,
+    std::unique_lock<std::mutex>& lock) {
+  // Requests in flight include the queued ones, so there is always a free
+  // SQE below the limit and the completion queue, which is twice the
+  // submission queue, cannot overflow.
+  while (numInFlight_ >= kQueueDepth) {
+    // The queued SQEs must be submitted before waiting for completions.
+    io_uring_submit(&ring_);
+    hasSpace_.wait(lock);
+  }
+  auto sqe = io_uring_get_sqe(&ring_);
+  VELOX_CHECK_NOT_NULL(sqe);
+  if (request->isWrite) {
+    io_uring_prep_writev(
+        sqe,
+        request->fd,
+        request->iovecs.data(),
+        request->iovecs.size(),
+        request->offset);
+  } else {
+    io_uring_prep_readv(
+        sqe,
+        request->fd,
+        request->iovecs.data(),
+        request->iovecs.size(),
+        request->offset);
+  }
+  io_uring_sqe_set_data(sqe, request);
+  ++numInFlight_;
+}
+
+void IoUringContext::reap() {
+  for (;;) {
+    io_uring_cqe* cqe;
+    auto rc = io_uring_wait_cqe(&ring_, &cqe);
+    if (rc == -EINTR) {
+      continue;
+    }
+    VELOX_CHECK_EQ(
+        rc, 0, "io_uring_wait_cqe failed: {}", folly::errnoStr(-rc));
+    auto request = static_cast<Request*>(io_uring_cqe_get_data(cqe));
+    auto res = cqe->res;
+    io_uring_cqe_seen(&ring_, cqe);
+    if (!request) {
+      return;
+    }
+    complete(request, res);
+  }
+}
+
+void IoUringContext::complete(Request* request, int32_t res) {
+  std::unique_ptr<Request> owned(request);
+  if (res > 0 && res < request->remaining) {
+    // Short transfer. Drops the transferred prefix of the iovecs and
+    // resubmits for the rest.
+    request->done += res;
+    request->remaining -= res;
+    request->offset += res;
+    uint64_t bytes = res;
+    auto it = request->iovecs.begin();
+    while (bytes >= it->iov_len) {
+      bytes -= it->iov_len;
+      ++it;
+    }
+    request->iovecs.erase(request->iovecs.begin(), it);
+    auto& first = request->iovecs.front();
+    first.iov_base = static_cast<char*>(first.iov_base) + bytes;
+    first.iov_len -= bytes;
+    std::unique_lock<std::mutex> l(mutex_);
+    --numInFlight_;
+    enqueueLocked(owned.release(), l);
+    io_uring_submit(&ring_);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    --numInFlight_;
+  }
+  hasSpace_.notify_one();
+  if (res < 0) {
+    setError(
+        request->promise,
+        fmt::format(
+            "io_uring {} failure at offset {} of fd {}: {}",
+            request->isWrite ? "write" : "read",
+            request->offset,
+            request->fd,
+            folly::errnoStr(-res)));
+    return;
+  }
+  // A read of 0 bytes is at end of file and returns the short count like
+  // preadv.
+  request->promise.setValue(request->done + res);
+}
+
+folly::SemiFuture<uint64_t> IoUringReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  auto& context = IoUringContext::instance();
+  if (!context.valid()) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  // One readv per run of buffers between skips. The skipped bytes count
+  // as read, like in preadv.
+  std::vector<std::unique_ptr<IoUringContext::Request>> requests;
+  uint64_t skipped = 0;
+  uint64_t position = offset;
+  for (auto& range : buffers) {
+    if (!range.data()) {
+      skipped += range.size();
+      position += range.size();
+      continue;
+    }
+    if (requests.empty() ||
+        requests.back()->offset + requests.back()->remaining != position) {
+      auto request = std::make_unique<IoUringContext::Request>();
+      request->fd = file_.fd();
+      request->isWrite = false;
+      request->offset = position;
+      request->remaining = 0;
+      requests.push_back(std::move(request));
+    }
+    requests.back()->iovecs.push_back({range.data(), range.size()});
+    requests.back()->remaining += range.size();
+    position += range.size();
+  }
+  if (requests.empty()) {
+    return folly::SemiFuture<uint64_t>(skipped);
+  }
+  return folly::collectAll(context.submit(std::move(requests)))
+      .deferValue([skipped](std::vector<folly::Try<uint64_t>>&& results) {
+        uint64_t total = skipped;
+        for (auto& result : results) {
+          // Rethrows the error of a failed read.
+          total += result.value();
+        }
+        return total;
+      });
+}
+
+IoUringWriteFile::IoUringWriteFile(std::string_view path) {
+  const std::string name(path);
+  fd_ = open(name.c_str(), O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  VELOX_CHECK_GE(
+      fd_,
+      0,
+      "Failure in IoUringWriteFile: cannot create '{}': {}",
+      path,
+      folly::errnoStr(errno));
+}
+
+IoUringWriteFile::~IoUringWriteFile() {
+  try {
+    close();
+  } catch (const std::exception& ex) {
+    // We cannot throw an exception from the destructor. Warn instead.
+    LOG(WARNING) << "close failure in IoUringWriteFile destructor: "
+                 << ex.what();
+  }
+}
+
+void IoUringWriteFile::append(std::string_view data) {
+  VELOX_CHECK(!closed_, "file is closed");
+  if (data.empty()) {
+    return;
+  }
+  auto& context = IoUringContext::instance();
+  if (!context.valid()) {
+    auto bytes = folly::pwriteFull(fd_, data.data(), data.size(), size_);
+    VELOX_CHECK_EQ(
+        bytes,
+        data.size(),
+        "pwrite failure in IoUringWriteFile::append: {}",
+        folly::errnoStr(errno));
+    size_ += data.size();
+    return;
+  }
+  if (pending_.size() >= kMaxPendingWrites) {
+    waitForWrites();
+  }
+  auto request = std::make_unique<IoUringContext::Request>();
+  request->fd = fd_;
+  request->isWrite = true;
+  request->offset = size_;
+  request->remaining = data.size();
+  request->data = std::string(data);
+  request->iovecs.push_back({request->data.data(), request->data.size()});
+  std::vector<std::unique_ptr<IoUringContext::Request>> requests;
+  requests.push_back(std::move(request));
+  pending_.push_back(std::move(context.submit(std::move(requests))[0]));
+  pendingSizes_.push_back(data.size());
+  size_ += data.size();
+}
+
+void IoUringWriteFile::waitForWrites() {
+  auto futures = std::move(pending_);
+  auto sizes = std::move(pendingSizes_);
+  pending_.clear();
+  pendingSizes_.clear();
+  auto results = folly::collectAll(std::move(futures)).get();
+  for (auto i = 0; i < results.size(); ++i) {
+    VELOX_CHECK_EQ(
+        results[i].value(), sizes[i], "Short write in IoUringWriteFile");
+  }
+}
+
+void IoUringWriteFile::flush() {
+  VELOX_CHECK(!closed_, "file is closed");
+  waitForWrites();
+}
+
+void IoUringWriteFile::close() {
+  if (!closed_) {
+    closed_ = true;
+    waitForWrites();
+    auto ret = ::close(fd_);
+    VELOX_CHECK_EQ(ret, 0, "close failure in IoUringWriteFile::close.");
+  }
+}
+
+} // namespace facebook::velox
+
+#endif
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Local files whose asynchronous reads and writes are submitted to a
+// process-wide io_uring. Only built with -DVELOX_ENABLE_IO_URING.
+
+#pragma once
+
+#ifdef VELOX_ENABLE_IO_URING
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <liburing.h>
+#include <sys/uio.h>
+
+#include "velox/common/file/File.h"
+
+namespace facebook::velox {
+
+// A process-wide io_uring. Any thread may submit. A dedicated thread
+// reaps completions and fulfills the promise of each request, so that a
+// caller waiting for many reads blocks on one future instead of
+// occupying one thread per read.
+class IoUringContext {
+ public:
+  // A positioned readv or writev of 'iovecs' at 'offset' of 'fd'.
+  struct Request {
+    int32_t fd;
+    bool isWrite;
+    uint64_t offset;
+    std::vector<iovec> iovecs;
+    // Bytes still to transfer. A short transfer is resubmitted for the
+    // rest.
+    uint64_t remaining;
+    // Bytes transferred so far.
+    uint64_t done{0};
+    // Owns the bytes of a write for the case the caller's data does not
+    // outlive the request.
+    std::string data;
+    folly::Promise<uint64_t> promise;
+  };
+
+  static constexpr int32_t kQueueDepth = 256;
+
+  ~IoUringContext();
+
+  // Returns the process-wide ring, created on first use.
+  static IoUringContext& instance();
+
+  // False if the kernel does not support io_uring. The files then do their
+  // IO synchronously.
+  bool valid() const {
+    return valid_;
+  }
+
+  // Submits 'requests' with a single io_uring_submit() where the queue
+  // depth permits and returns the byte counts in the same order.
+  std::vector<folly::SemiFuture<uint64_t>> submit(
+      std::vector<std::unique_ptr<Request>> requests);
+
+  // Number of requests submitted and not completed. For testing.
+  int32_t numInFlight() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return numInFlight_;
+  }
+
+ private:
+  IoUringContext();
+
+  // Adds an SQE for 'request' to the submission queue. The caller holds
+  // 'mutex_' in 'lock'. Submits the queued SQEs and waits if the number
+  // of requests in flight is at the limit.
+  void enqueueLocked(
+      Request* FOLLY_NONNULL request,
+      std::unique_lock<std::mutex>& lock);
+
+  // Waits for completions until shutdown.
+  void reap();
+
+  // Fulfills or resubmits the request of a completion with result 'res'.
+  void complete(Request* FOLLY_NONNULL request, int32_t res);
+
+  io_uring ring_;
+  bool valid_{false};
+  mutable std::mutex mutex_;
+  std::condition_variable hasSpace_;
+  int32_t numInFlight_{0};
+  bool shutdown_{false};
+  std::thread reaper_;
+};
+
+// Reads a local file. pread() and preadv() are synchronous and the same as
+// LocalReadFile. preadvAsync() submits one readv per run of non-skipped
+// buffers to the IoUringContext.
+class IoUringReadFile final : public ReadFile {
+ public:
+  explicit IoUringReadFile(std::string_view path) : file_(path) {}
+
+  // Does not take ownership of 'fd'.
+  explicit IoUringReadFile(int32_t fd) : file_(fd) {}
+
+  std::string_view
+  pread(uint64_t offset, uint64_t length, void* FOLLY_NONNULL buf)
+      const final {
+    bytesRead_ += length;
+    return file_.pread(offset, length, buf);
+  }
+
+  std::string pread(uint64_t offset, uint64_t length) const final {
+    bytesRead_ += length;
+    return file_.pread(offset, length);
+  }
+
+  uint64_t preadv(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final {
+    return file_.preadv(offset, buffers);
+  }
+
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const final;
+
+  bool hasPreadvAsync() const final {
+    return IoUringContext::instance().valid();
+  }
+
+  uint64_t size() const final {
+    return file_.size();
+  }
+
+  uint64_t memoryUsage() const final {
+    return file_.memoryUsage();
+  }
+
+  bool shouldCoalesce() const final {
+    return false;
+  }
+
+ private:
+  const LocalReadFile file_;
+};
+
+// Writes a local file. Appends are copied and submitted to the
+// IoUringContext without waiting. flush() waits for the outstanding
+// writes.
+class IoUringWriteFile final : public WriteFile {
+ public:
+  // An error is thrown is a file already exists at 'path'.
+  explicit IoUringWriteFile(std::string_view path);
+  ~IoUringWriteFile();
+
+  void append(std::string_view data) final;
+  void flush() final;
+  void close() final;
+
+  uint64_t size() const final {
+    return size_;
+  }
+
+ private:
+  // Waits for the outstanding writes and throws on the first error.
+  void waitForWrites();
+
+  int32_t fd_;
+  uint64_t size_{0};
+  std::vector<folly::SemiFuture<uint64_t>> pending_;
+  // Byte counts of the writes in 'pending_'.
+  std::vector<uint64_t> pendingSizes_;
+  bool closed_{false};
+};
+
+} // namespace facebook::velox
+
+#endif
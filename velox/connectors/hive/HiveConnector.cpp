@@ -81,8 +81,25 @@ std::string HiveTableHandle::toString() const {
 HiveDataSink::HiveDataSink(
     std::shared_ptr<const RowType> inputType,
     const std::string& filePath,
-    velox::memory::MemoryPool* memoryPool)
+    velox::memory::MemoryPool* memoryPool,
+    dwio::common::FileFormat storageFormat)
     : inputType_(inputType) {
+  auto sink = facebook::velox::dwio::common::DataSink::create(filePath);
+#ifdef VELOX_ENABLE_PARQUET
+  if (storageFormat == dwio::common::FileFormat::PARQUET) {
+    parquetWriter_ = std::make_unique<facebook::velox::parquet::Writer>(
+        std::move(sink),
+        facebook::velox::parquet::WriterOptions{},
+        *memoryPool,
+        inputType);
+    return;
+  }
+#endif
+  VELOX_CHECK(
+      storageFormat == dwio::common::FileFormat::DWRF,
+      "Hive connector cannot write file format {}",
+      static_cast<int>(storageFormat));
+
   auto config = std::make_shared<WriterConfig>();
   // TODO: Wire up serde properties to writer configs.
 
@@ -92,15 +109,26 @@ HiveDataSink::HiveDataSink(
   // Without explicitly setting flush policy, the default memory based flush
   // policy is used.
 
-  auto sink = facebook::velox::dwio::common::DataSink::create(filePath);
   writer_ = std::make_unique<Writer>(options, std::move(sink), *memoryPool);
 }
 
 void HiveDataSink::appendData(VectorPtr input) {
+#ifdef VELOX_ENABLE_PARQUET
+  if (parquetWriter_) {
+    parquetWriter_->write(input);
+    return;
+  }
+#endif
   writer_->write(input);
 }
 
 void HiveDataSink::close() {
+#ifdef VELOX_ENABLE_PARQUET
+  if (parquetWriter_) {
+    parquetWriter_->close();
+    return;
+  }
+#endif
   writer_->close();
 }
 
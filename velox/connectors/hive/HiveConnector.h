@@ -26,6 +26,9 @@
 #include "velox/expression/Expr.h"
 #include "velox/type/Filter.h"
 #include "velox/type/Subfield.h"
+#ifdef VELOX_ENABLE_PARQUET
+#include "velox/dwio/parquet/writer/Writer.h"
+#endif
 
 namespace facebook::velox::connector::hive {
 
@@ -97,17 +100,25 @@ class HiveTableHandle : public ConnectorTableHandle {
  */
 class HiveInsertTableHandle : public ConnectorInsertTableHandle {
  public:
-  explicit HiveInsertTableHandle(const std::string& filePath)
-      : filePath_(filePath) {}
+  explicit HiveInsertTableHandle(
+      const std::string& filePath,
+      dwio::common::FileFormat storageFormat = dwio::common::FileFormat::DWRF)
+      : filePath_(filePath), storageFormat_(storageFormat) {}
 
   const std::string& filePath() const {
     return filePath_;
   }
 
+  // DWRF or, if built with Parquet support, PARQUET.
+  dwio::common::FileFormat storageFormat() const {
+    return storageFormat_;
+  }
+
   virtual ~HiveInsertTableHandle() {}
 
  private:
   const std::string filePath_;
+  const dwio::common::FileFormat storageFormat_;
 };
 
 class HiveDataSink : public DataSink {
@@ -115,7 +126,8 @@ class HiveDataSink : public DataSink {
   explicit HiveDataSink(
       std::shared_ptr<const RowType> inputType,
       const std::string& filePath,
-      velox::memory::MemoryPool* FOLLY_NONNULL memoryPool);
+      velox::memory::MemoryPool* FOLLY_NONNULL memoryPool,
+      dwio::common::FileFormat storageFormat = dwio::common::FileFormat::DWRF);
 
   void appendData(VectorPtr input) override;
 
@@ -123,7 +135,11 @@ class HiveDataSink : public DataSink {
 
  private:
   const std::shared_ptr<const RowType> inputType_;
+  // Exactly one of the writers is set, depending on the storage format.
   std::unique_ptr<facebook::velox::dwrf::Writer> writer_;
+#ifdef VELOX_ENABLE_PARQUET
+  std::unique_ptr<facebook::velox::parquet::Writer> parquetWriter_;
+#endif
 };
 
 class HiveConnector;
@@ -265,7 +281,8 @@ class HiveConnector final : public Connector {
     return std::make_shared<HiveDataSink>(
         inputType,
         hiveInsertHandle->filePath(),
-        connectorQueryCtx->memoryPool());
+        connectorQueryCtx->memoryPool(),
+        hiveInsertHandle->storageFormat());
   }
 
   folly::Executor* FOLLY_NULLABLE executor() {
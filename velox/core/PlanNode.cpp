@@ -456,12 +456,14 @@ WindowNode::WindowNode(
     std::vector<SortOrder> sortingOrders,
     std::vector<std::string> windowColumnNames,
     std::vector<Function> windowFunctions,
-    PlanNodePtr source)
+    PlanNodePtr source,
+    bool inputsSorted)
     : PlanNode(std::move(id)),
       partitionKeys_(std::move(partitionKeys)),
       sortingKeys_(std::move(sortingKeys)),
       sortingOrders_(std::move(sortingOrders)),
       windowFunctions_(std::move(windowFunctions)),
+      inputsSorted_(inputsSorted),
       sources_{std::move(source)},
       outputType_(getWindowOutputType(
           sources_[0]->outputType(),
@@ -477,10 +479,6 @@ WindowNode::WindowNode(
       "Number of sorting keys must be equal to the number of sorting orders");
 }
 
-void WindowNode::addDetails(std::stringstream& stream) const {
-  VELOX_NYI();
-}
-
 namespace {
 void addSortingKeys(
     std::stringstream& stream,
@@ -495,6 +493,78 @@ void addSortingKeys(
 }
 } // namespace
 
+// static
+const char* WindowNode::windowTypeName(WindowType type) {
+  switch (type) {
+    case WindowType::kRange:
+      return "RANGE";
+    case WindowType::kRows:
+      return "ROWS";
+  }
+  VELOX_UNREACHABLE();
+}
+
+// static
+const char* WindowNode::boundTypeName(BoundType type) {
+  switch (type) {
+    case BoundType::kUnboundedPreceding:
+      return "UNBOUNDED PRECEDING";
+    case BoundType::kPreceding:
+      return "PRECEDING";
+    case BoundType::kCurrentRow:
+      return "CURRENT ROW";
+    case BoundType::kFollowing:
+      return "FOLLOWING";
+    case BoundType::kUnboundedFollowing:
+      return "UNBOUNDED FOLLOWING";
+  }
+  VELOX_UNREACHABLE();
+}
+
+namespace {
+void addWindowBound(
+    std::stringstream& stream,
+    WindowNode::BoundType type,
+    const TypedExprPtr& value) {
+  if (value) {
+    stream << value->toString() << " ";
+  }
+  stream << WindowNode::boundTypeName(type);
+}
+} // namespace
+
+void WindowNode::addDetails(std::stringstream& stream) const {
+  if (!partitionKeys_.empty()) {
+    stream << "partition by [";
+    for (auto i = 0; i < partitionKeys_.size(); ++i) {
+      if (i > 0) {
+        stream << ", ";
+      }
+      stream << partitionKeys_[i]->name();
+    }
+    stream << "] ";
+  }
+  if (!sortingKeys_.empty()) {
+    stream << "order by [";
+    addSortingKeys(stream, sortingKeys_, sortingOrders_);
+    stream << "] ";
+  }
+  auto numInputs = sources_[0]->outputType()->size();
+  for (auto i = 0; i < windowFunctions_.size(); ++i) {
+    const auto& function = windowFunctions_[i];
+    const auto& frame = function.frame;
+    if (i > 0) {
+      stream << ", ";
+    }
+    stream << outputType_->nameOf(numInputs + i) << " := "
+           << function.functionCall->toString() << " "
+           << windowTypeName(frame.type) << " between ";
+    addWindowBound(stream, frame.startType, frame.startValue);
+    stream << " and ";
+    addWindowBound(stream, frame.endType, frame.endValue);
+  }
+}
+
 void LocalMergeNode::addDetails(std::stringstream& stream) const {
   addSortingKeys(stream, sortingKeys_, sortingOrders_);
 }
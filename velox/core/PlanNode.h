@@ -1545,6 +1545,10 @@ class WindowNode : public PlanNode {
   /// @windowColumnNames parameter specifies the output column
   /// names for each window function column. So
   /// windowColumnNames.length() = windowFunctions.length().
+  /// @inputsSorted is true if the input arrives clustered on the
+  /// partition keys and sorted on the sorting keys within each
+  /// partition. The operator then processes each partition as soon as
+  /// it is complete instead of accumulating and sorting all input.
   WindowNode(
       PlanNodeId id,
       std::vector<FieldAccessTypedExprPtr> partitionKeys,
@@ -1552,7 +1556,8 @@ class WindowNode : public PlanNode {
       std::vector<SortOrder> sortingOrders,
       std::vector<std::string> windowColumnNames,
       std::vector<Function> windowFunctions,
-      PlanNodePtr source);
+      PlanNodePtr source,
+      bool inputsSorted = false);
 
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
@@ -1580,10 +1585,18 @@ class WindowNode : public PlanNode {
     return windowFunctions_;
   }
 
+  bool inputsSorted() const {
+    return inputsSorted_;
+  }
+
   std::string_view name() const override {
     return "Window";
   }
 
+  static const char* windowTypeName(WindowType type);
+
+  static const char* boundTypeName(BoundType type);
+
  private:
   void addDetails(std::stringstream& stream) const override;
 
@@ -1594,6 +1607,8 @@ class WindowNode : public PlanNode {
 
   const std::vector<Function> windowFunctions_;
 
+  const bool inputsSorted_;
+
   const std::vector<PlanNodePtr> sources_;
 
   const RowTypePtr outputType_;
@@ -58,6 +58,18 @@ class QueryConfig {
   static constexpr const char* kExprTrackCpuUsage =
       "expression.track_cpu_usage";
 
+  // Maximum number of compiled regular expressions of non-constant patterns
+  // kept by each instance of a regular expression function. The least
+  // recently used is evicted beyond this.
+  static constexpr const char* kExprMaxCompiledRegexes =
+      "expression.max_compiled_regexes";
+
+  // Maximum number of results kept across batches by each deterministic
+  // function call whose only non-constant argument is a string. The results
+  // are keyed on the value of that argument. 0 disables the cache.
+  static constexpr const char* kExprResultCacheMaxEntries =
+      "expression.result_cache_max_entries";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied
@@ -77,6 +89,12 @@ class QueryConfig {
   static constexpr const char* kMaxPartialAggregationMemory =
       "max_partial_aggregation_memory";
 
+  static constexpr const char* kAbandonPartialAggregationMinRows =
+      "abandon_partial_aggregation_min_rows";
+
+  static constexpr const char* kAbandonPartialAggregationMinPct =
+      "abandon_partial_aggregation_min_pct";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "driver.max-page-partitioning-buffer-size";
 
@@ -97,11 +115,33 @@ class QueryConfig {
 
   static constexpr const char* kTestingSpillPct = "testing.spill-pct";
 
+  static constexpr const char* kSpillCompressionCodec =
+      "spill_compression_codec";
+
+  static constexpr const char* kSpillChecksumEnabled = "spill_checksum_enabled";
+
+  static constexpr const char* kParallelSortMinRunSize =
+      "parallel_sort_min_run_size";
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
   }
 
+  // Returns the number of input rows a partial aggregation must see before it
+  // may give up on reducing its input, see
+  // abandonPartialAggregationMinPct().
+  int32_t abandonPartialAggregationMinRows() const {
+    return get<int32_t>(kAbandonPartialAggregationMinRows, 100'000);
+  }
+
+  // Returns the percentage of groups to input rows at or above which a
+  // partial aggregation stops grouping and passes each input row through as
+  // its own group. A value of 100 or more disables this.
+  int32_t abandonPartialAggregationMinPct() const {
+    return get<int32_t>(kAbandonPartialAggregationMinPct, 80);
+  }
+
   // Returns the target size for a Task's buffered output. The
   // producer Drivers are blocked when the buffered size exceeds
   // this. The Drivers are resumed when the buffered size goes below
@@ -192,10 +232,39 @@ class QueryConfig {
     return get<int32_t>(kTestingSpillPct, 0);
   }
 
+  /// Returns the compression of spill files, one of 'none', 'lz4' or
+  /// 'zstd'.
+  std::string spillCompressionCodec() const {
+    return get<std::string>(kSpillCompressionCodec, "none");
+  }
+
+  /// Returns true if the blocks of spill files are checksummed and verified
+  /// when read back.
+  bool spillChecksumEnabled() const {
+    return get<bool>(kSpillChecksumEnabled, false);
+  }
+
+  // Returns the minimum number of rows in each sorted run of a parallel sort
+  // in OrderBy. OrderBy sorts fewer than twice this many rows on the Driver
+  // thread. 0 disables the parallel sort.
+  uint32_t parallelSortMinRunSize() const {
+    static constexpr uint32_t kDefault = 100'000;
+    return get<uint32_t>(kParallelSortMinRunSize, kDefault);
+  }
+
   bool exprTrackCpuUsage() const {
     return get<bool>(kExprTrackCpuUsage, false);
   }
 
+  uint32_t exprMaxCompiledRegexes() const {
+    static constexpr uint32_t kDefault = 100;
+    return get<uint32_t>(kExprMaxCompiledRegexes, kDefault);
+  }
+
+  uint32_t exprResultCacheMaxEntries() const {
+    return get<uint32_t>(kExprResultCacheMaxEntries, 0);
+  }
+
   template <typename T>
   T get(const std::string& key, const T& defaultValue) const {
     return config_->get<T>(key, defaultValue);
@@ -466,6 +466,17 @@ class SimpleFunctionMetadata : public ISimpleFunctionMetadata {
   uint32_t priority_;
 };
 
+// True if the result and all arguments are stored in arrays of values, so
+// that a UDF can provide callBatch().
+template <typename TReturn, typename... TArgs>
+struct is_callBatch_supported
+    : std::bool_constant<
+          CppToType<TReturn>::isFixedWidth &&
+          CppToType<TReturn>::typeKind != TypeKind::BOOLEAN &&
+          ((CppToType<TArgs>::isFixedWidth &&
+            CppToType<TArgs>::typeKind != TypeKind::BOOLEAN) &&
+           ...)> {};
+
 // wraps a UDF object to provide the inheritance
 // this is basically just boilerplate-avoidance
 template <typename Fun, typename Exec, typename TReturn, typename... TArgs>
@@ -503,6 +514,7 @@ class UDFHolder final
   DECLARE_METHOD_RESOLVER(callNullFree_method_resolver, callNullFree);
   DECLARE_METHOD_RESOLVER(callAscii_method_resolver, callAscii);
   DECLARE_METHOD_RESOLVER(initialize_method_resolver, initialize);
+  DECLARE_METHOD_RESOLVER(callBatch_method_resolver, callBatch);
 
   // Check which flavor of the call() method is provided by the UDF object. UDFs
   // are required to provide at least one of the following methods:
@@ -518,6 +530,7 @@ class UDFHolder final
   //
   // - bool|void callAscii(...)
   // - void initialize(...)
+  // - void callBatch(out*, const arg*..., int32_t size)
 
   // call():
   static constexpr bool udf_has_call_return_bool = util::has_method<
@@ -609,6 +622,24 @@ class UDFHolder final
       const core::QueryConfig&,
       const exec_arg_type<TArgs>*...>::value;
 
+  // callBatch(): computes 'size' consecutive results from arrays of
+  // arguments. Used instead of call() for batches where all arguments are
+  // flat or constant without nulls, e.g. to run a hand-written SIMD kernel.
+  // 'out' may point to the same memory as one of the arguments.
+  static constexpr bool udf_has_callBatch = util::has_method<
+      Fun,
+      callBatch_method_resolver,
+      void,
+      exec_return_type*,
+      const exec_arg_type<TArgs>*...,
+      int32_t>::value;
+  static_assert(
+      std::conditional_t<
+          udf_has_callBatch,
+          is_callBatch_supported<TReturn, TArgs...>,
+          std::true_type>::value,
+      "callBatch() requires fixed-width, non-boolean result and arguments.");
+
   static_assert(
       udf_has_call || udf_has_callNullable || udf_has_callNullFree,
       "UDF must implement at least one of `call`, `callNullable`, or `callNullFree`");
@@ -639,6 +670,11 @@ class UDFHolder final
   // NULL directly, skipping evaluation.
   static constexpr bool is_default_contains_nulls_behavior =
       !udf_has_call && !udf_has_callNullable;
+
+  static_assert(
+      !(udf_has_callBatch && can_produce_null_output),
+      "callBatch() cannot be combined with call methods returning bool.");
+
   static constexpr bool has_ascii = udf_has_callAscii;
   static constexpr bool is_default_ascii_behavior =
       udf_is_default_ascii_behavior<Fun>();
@@ -726,6 +762,19 @@ class UDFHolder final
     }
   }
 
+  FOLLY_ALWAYS_INLINE void callBatch(
+      exec_return_type* out,
+      const typename exec_resolver<TArgs>::in_type*... args,
+      int32_t size) {
+    if constexpr (udf_has_callBatch) {
+      instance_.callBatch(out, args..., size);
+    } else {
+      VELOX_UNREACHABLE(
+          "callBatch should never be called if the UDF does not "
+          "implement callBatch.");
+    }
+  }
+
   // Helper functions to handle void vs bool return type.
 
   FOLLY_ALWAYS_INLINE bool callImpl(
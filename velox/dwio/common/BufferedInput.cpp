@@ -71,6 +71,12 @@ std::unique_ptr<SeekableInputStream> BufferedInput::enqueue(
         static_cast<const char*>(nullptr), 0);
   }
 
+  // Data that is already in memory, e.g. memory mapped, is decoded in place.
+  if (input_.hasReadView()) {
+    auto data = input_.readView(region.offset, region.length, LogType::STREAM);
+    return std::make_unique<SeekableArrayInputStream>(data.data(), data.size());
+  }
+
   // if the region is already in buffer - such as metadata
   auto ret = readBuffer(region.offset, region.length);
   if (ret) {
@@ -52,11 +52,16 @@ class BufferedInput {
   virtual void load(const LogType);
 
   virtual bool isBuffered(uint64_t offset, uint64_t length) const {
-    return !!readBuffer(offset, length);
+    return input_.hasReadView() || !!readBuffer(offset, length);
   }
 
   virtual std::unique_ptr<SeekableInputStream>
   read(uint64_t offset, uint64_t length, LogType logType) const {
+    if (input_.hasReadView()) {
+      auto data = input_.readView(offset, length, logType);
+      return std::make_unique<SeekableArrayInputStream>(
+          data.data(), data.size());
+    }
     std::unique_ptr<SeekableInputStream> ret = readBuffer(offset, length);
     if (!ret) {
       VLOG(1) << "Unplanned read. Offset: " << offset << ", Length: " << length;
@@ -42,6 +42,12 @@ std::unique_ptr<SeekableInputStream> CachedBufferedInput::enqueue(
         static_cast<const char*>(nullptr), 0);
   }
 
+  // A memory mapped file is its own cache. Its data is decoded in place.
+  if (input_.hasReadView()) {
+    auto data = input_.readView(region.offset, region.length, LogType::STREAM);
+    return std::make_unique<SeekableArrayInputStream>(data.data(), data.size());
+  }
+
   TrackingId id;
   if (si) {
     id = TrackingId(si->getId());
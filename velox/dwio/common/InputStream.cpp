@@ -211,6 +211,17 @@ bool ReadFileInputStream::hasReadAsync() const {
   return readFile_->hasPreadvAsync();
 }
 
+std::string_view ReadFileInputStream::readView(
+    uint64_t offset,
+    uint64_t length,
+    LogType logType) {
+  logRead(offset, length, logType);
+  if (stats_) {
+    stats_->incRawBytesRead(length);
+  }
+  return readFile_->preadView(offset, length);
+}
+
 bool Region::operator<(const Region& other) const {
   return offset < other.offset ||
       (offset == other.offset && length < other.length);
@@ -26,6 +26,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -125,6 +126,20 @@ class InputStream {
     return false;
   }
 
+  /// Returns 'length' bytes at 'offset' as a view of memory that stays
+  /// valid for the lifetime of 'this', without copying. Use only if
+  /// hasReadView() is true.
+  virtual std::string_view
+  readView(uint64_t /*offset*/, uint64_t /*length*/, LogType /*logType*/) {
+    VELOX_NYI("readView not supported");
+  }
+
+  /// Returns true if the data is in memory that readView() can reference,
+  /// e.g. a memory mapped file.
+  virtual bool hasReadView() const {
+    return false;
+  }
+
   /**
    * Take advantage of vectorized read API provided by some file system.
    * Allow file system to do optimzied reading plan to disk to minimize
@@ -216,6 +231,13 @@ class ReadFileInputStream final : public InputStream {
 
   bool hasReadAsync() const override;
 
+  std::string_view readView(uint64_t offset, uint64_t length, LogType logType)
+      override;
+
+  bool hasReadView() const override {
+    return readFile_->hasPreadView();
+  }
+
  private:
   velox::ReadFile* FOLLY_NONNULL readFile_;
 };
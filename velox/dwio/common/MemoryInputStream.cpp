@@ -36,6 +36,18 @@ void MemoryInputStream::read(
   memcpy(buf, buffer + offset, length);
 }
 
+std::string_view MemoryInputStream::readView(
+    uint64_t offset,
+    uint64_t length,
+    MetricsLog::MetricsType /* UNUSED */) {
+  VELOX_CHECK(
+      offset <= size && length <= size - offset,
+      "Read past end of MemoryInputStream, offset {} length {}",
+      offset,
+      length);
+  return {buffer + offset, length};
+}
+
 const char* MemoryInputStream::getData() const {
   return buffer;
 }
@@ -50,6 +50,21 @@ class MemoryInputStream : public ReferenceableInputStream {
       uint64_t offset,
       MetricsLog::MetricsType /* UNUSED */) override;
 
+  std::string_view readView(
+      uint64_t offset,
+      uint64_t length,
+      MetricsLog::MetricsType /* UNUSED */) override;
+
+  // Mainly for testing. Off by default, so that readers of memory streams
+  // go through the same copying paths as for other streams.
+  void setHasReadView(bool hasReadView) {
+    hasReadView_ = hasReadView;
+  }
+
+  bool hasReadView() const override {
+    return hasReadView_;
+  }
+
   const char* FOLLY_NULLABLE getData() const;
 
   const void* FOLLY_NULLABLE readReference(
@@ -67,6 +82,7 @@ class MemoryInputStream : public ReferenceableInputStream {
   const char* FOLLY_NULLABLE buffer;
   uint64_t size;
   uint64_t naturalReadSize;
+  bool hasReadView_{false};
 };
 
 } // namespace facebook::velox::dwio::common
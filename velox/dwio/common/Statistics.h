@@ -514,12 +514,20 @@ struct RuntimeStatistics {
   // Number of strides (row groups) skipped based on statistics.
   int64_t skippedStrides{0};
 
+  // Number of pages skipped based on page level statistics.
+  int64_t skippedPages{0};
+
   std::unordered_map<std::string, RuntimeCounter> toMap() {
-    return {
+    std::unordered_map<std::string, RuntimeCounter> result = {
         {"skippedSplits", RuntimeCounter(skippedSplits)},
         {"skippedSplitBytes",
          RuntimeCounter(skippedSplitBytes, RuntimeCounter::Unit::kBytes)},
         {"skippedStrides", RuntimeCounter(skippedStrides)}};
+    // Only readers with page level statistics skip pages.
+    if (skippedPages > 0) {
+      result.emplace("skippedPages", RuntimeCounter(skippedPages));
+    }
+    return result;
   }
 };
 
@@ -44,3 +44,18 @@ TEST(ReadFileInputStream, SimpleUsage) {
   read_value = {buf.get(), 15};
   ASSERT_EQ(read_value, "aaaaabbbbbccccc");
 }
+
+TEST(ReadFileInputStream, readView) {
+  std::string fileData = "aaaaabbbbbccccc";
+  InMemoryReadFile readFile(fileData);
+  ReadFileInputStream inputStream(&readFile);
+  ASSERT_FALSE(inputStream.hasReadView());
+  readFile.setHasPreadView(true);
+  ASSERT_TRUE(inputStream.hasReadView());
+  auto view = inputStream.readView(4, 7, LogType::STREAM);
+  ASSERT_EQ(view, "abbbbbc");
+  ASSERT_EQ(view.data(), fileData.data() + 4);
+  ASSERT_EQ(inputStream.readView(15, 0, LogType::STREAM).size(), 0);
+  EXPECT_THROW(
+      inputStream.readView(10, 6, LogType::STREAM), VeloxRuntimeError);
+}
@@ -32,3 +32,38 @@ TEST(TestBufferedInput, ZeroLengthStream) {
   EXPECT_FALSE(ret->Next(&buf, &size));
   EXPECT_EQ(size, 0);
 }
+
+TEST(TestBufferedInput, readInPlace) {
+  std::string data = "aaaaabbbbbccccc";
+  MemoryInputStream stream{data.data(), data.size()};
+  stream.setHasReadView(true);
+  auto scopedPool = facebook::velox::memory::getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  BufferedInput input{stream, pool};
+  auto ret = input.enqueue({5, 5});
+  input.load(LogType::STREAM);
+  const void* buf = nullptr;
+  int32_t size = 0;
+  ASSERT_TRUE(ret->Next(&buf, &size));
+  // The stream references the data of 'stream' without a copy.
+  EXPECT_EQ(buf, data.data() + 5);
+  EXPECT_EQ(size, 5);
+  EXPECT_FALSE(ret->Next(&buf, &size));
+}
+
+TEST(TestBufferedInput, readCopy) {
+  // Without views the data is loaded into a buffer of the BufferedInput.
+  std::string data = "aaaaabbbbbccccc";
+  MemoryInputStream stream{data.data(), data.size()};
+  auto scopedPool = facebook::velox::memory::getDefaultScopedMemoryPool();
+  auto& pool = scopedPool->getPool();
+  BufferedInput input{stream, pool};
+  auto ret = input.enqueue({5, 5});
+  input.load(LogType::STREAM);
+  const void* buf = nullptr;
+  int32_t size = 0;
+  ASSERT_TRUE(ret->Next(&buf, &size));
+  EXPECT_NE(buf, data.data() + 5);
+  EXPECT_EQ(std::string_view(static_cast<const char*>(buf), size), "bbbbb");
+  EXPECT_FALSE(ret->Next(&buf, &size));
+}
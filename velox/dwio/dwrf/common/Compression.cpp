@@ -57,6 +57,56 @@ ZstdCompressor::compress(const void* src, void* dest, uint64_t length) {
   return ret;
 }
 
+class Lz4Compressor : public Compressor {
+ public:
+  // 'level' is the LZ4 acceleration factor. Higher values are faster and
+  // compress less.
+  explicit Lz4Compressor(int32_t level) : Compressor{level} {}
+
+  uint64_t compress(const void* src, void* dest, uint64_t length) override;
+};
+
+uint64_t
+Lz4Compressor::compress(const void* src, void* dest, uint64_t length) {
+  auto ret = LZ4_compress_fast(
+      reinterpret_cast<const char*>(src),
+      reinterpret_cast<char*>(dest),
+      static_cast<int32_t>(length),
+      static_cast<int32_t>(length),
+      level_);
+  // 0 means the output does not fit in 'length' bytes, in which case the
+  // caller writes the original data
+  return ret > 0 ? ret : length;
+}
+
+class SnappyCompressor : public Compressor {
+ public:
+  SnappyCompressor() : Compressor{0} {}
+
+  uint64_t compress(const void* src, void* dest, uint64_t length) override;
+
+ private:
+  // snappy needs up to MaxCompressedLength() bytes of output, which is more
+  // than the 'length' bytes available in 'dest'
+  std::vector<char> buffer_;
+};
+
+uint64_t
+SnappyCompressor::compress(const void* src, void* dest, uint64_t length) {
+  buffer_.resize(snappy::MaxCompressedLength(length));
+  size_t compressedLength;
+  snappy::RawCompress(
+      reinterpret_cast<const char*>(src),
+      length,
+      buffer_.data(),
+      &compressedLength);
+  if (compressedLength >= length) {
+    return length;
+  }
+  std::memcpy(dest, buffer_.data(), compressedLength);
+  return compressedLength;
+}
+
 class ZlibCompressor : public Compressor {
  public:
   explicit ZlibCompressor(int32_t level);
@@ -463,11 +513,22 @@ std::unique_ptr<BufferedOutputStream> createCompressor(
           zstdCompressionLevel);
       break;
     }
+    case dwio::common::CompressionKind_LZ4: {
+      int32_t lz4Acceleration = config.get(Config::LZ4_ACCELERATION);
+      compressor = std::make_unique<Lz4Compressor>(lz4Acceleration);
+      XLOG_FIRST_N(INFO, 1) << fmt::format(
+          "Initialized lz4 compressor with acceleration {}", lz4Acceleration);
+      break;
+    }
     case dwio::common::CompressionKind_SNAPPY:
+      compressor = std::make_unique<SnappyCompressor>();
+      XLOG_FIRST_N(INFO, 1) << "Initialized snappy compressor";
+      break;
     case dwio::common::CompressionKind_LZO:
-    case dwio::common::CompressionKind_LZ4:
     default:
-      DWIO_RAISE("compression codec");
+      DWIO_RAISE(
+          "Unsupported compression codec for writing: ",
+          compressionKindToString(kind));
   }
   return std::make_unique<PagedOutputStream>(
       bufferPool, bufferHolder, config, std::move(compressor), encrypter);
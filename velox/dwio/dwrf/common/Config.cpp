@@ -36,6 +36,10 @@ Config::Entry<int32_t> Config::ZSTD_COMPRESSION_LEVEL(
     "hive.exec.orc.compress.zstd.level",
     7);
 
+Config::Entry<int32_t> Config::LZ4_ACCELERATION(
+    "hive.exec.orc.compress.lz4.acceleration",
+    1);
+
 Config::Entry<uint64_t> Config::COMPRESSION_BLOCK_SIZE{
     "hive.exec.orc.compress.size",
     256 * 1024};
@@ -82,6 +82,7 @@ class Config {
   static Entry<dwio::common::CompressionKind> COMPRESSION;
   static Entry<int32_t> ZLIB_COMPRESSION_LEVEL;
   static Entry<int32_t> ZSTD_COMPRESSION_LEVEL;
+  static Entry<int32_t> LZ4_ACCELERATION;
   static Entry<uint64_t> COMPRESSION_BLOCK_SIZE;
   static Entry<uint64_t> COMPRESSION_BLOCK_SIZE_MIN;
   static Entry<float> COMPRESSION_BLOCK_SIZE_EXTEND_RATIO;
@@ -238,6 +238,26 @@ template void RleDecoderV2<false>::next(
     const uint64_t numValues,
     const uint64_t* const nulls);
 
+template <bool isSigned>
+void RleDecoderV2<isSigned>::nextLengths(
+    int32_t* const data,
+    const int32_t numValues) {
+  constexpr int32_t N = 64;
+  int64_t buffer[N];
+  for (int32_t position = 0; position < numValues; position += N) {
+    const auto count = std::min(N, numValues - position);
+    next(buffer, count, nullptr);
+    std::copy(buffer, buffer + count, data + position);
+  }
+}
+
+template void RleDecoderV2<true>::nextLengths(
+    int32_t* const data,
+    const int32_t numValues);
+template void RleDecoderV2<false>::nextLengths(
+    int32_t* const data,
+    const int32_t numValues);
+
 template <bool isSigned>
 uint64_t RleDecoderV2<isSigned>::nextShortRepeats(
     int64_t* const data,
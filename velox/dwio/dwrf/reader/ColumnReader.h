@@ -45,8 +45,10 @@ class ColumnReader {
   // the reader has no nulls and there are no incoming
   //          nulls.Takes 'nulls' from 'result' if '*result' is non -
   //      null.Otherwise ensures that 'nulls' has a buffer of sufficient
-  //          size and uses this.
-  void readNulls(
+  //          size and uses this. Virtual so that formats which keep nulls
+  //          in the same stream as values, e.g. Parquet definition levels,
+  //          can decode them together.
+  virtual void readNulls(
       vector_size_t numValues,
       const uint64_t* incomingNulls,
       VectorPtr* result,
@@ -142,10 +142,13 @@ std::unique_ptr<DwrfReader> DwrfReader::create(
 
 void registerDwrfReaderFactory() {
   dwio::common::registerReaderFactory(std::make_shared<DwrfReaderFactory>());
+  dwio::common::registerReaderFactory(
+      std::make_shared<DwrfReaderFactory>(dwio::common::FileFormat::ORC));
 }
 
 void unregisterDwrfReaderFactory() {
   dwio::common::unregisterReaderFactory(dwio::common::FileFormat::DWRF);
+  dwio::common::unregisterReaderFactory(dwio::common::FileFormat::ORC);
 }
 
 } // namespace facebook::velox::dwrf
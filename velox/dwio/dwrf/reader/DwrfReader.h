@@ -127,17 +127,27 @@ class DwrfReader : public DwrfReaderShared {
   friend class E2EEncryptionTest;
 };
 
+// Creates DwrfReaders for DWRF files or, with FileFormat::ORC, for ORC files.
 class DwrfReaderFactory : public dwio::common::ReaderFactory {
  public:
-  DwrfReaderFactory() : ReaderFactory(dwio::common::FileFormat::DWRF) {}
+  explicit DwrfReaderFactory(
+      dwio::common::FileFormat format = dwio::common::FileFormat::DWRF)
+      : ReaderFactory(format) {}
 
   std::unique_ptr<dwio::common::Reader> createReader(
       std::unique_ptr<dwio::common::InputStream> stream,
       const dwio::common::ReaderOptions& options) override {
+    if (fileFormat() == dwio::common::FileFormat::ORC &&
+        options.getFileFormat() != dwio::common::FileFormat::ORC) {
+      auto orcOptions = options;
+      orcOptions.setFileFormat(dwio::common::FileFormat::ORC);
+      return DwrfReader::create(std::move(stream), orcOptions);
+    }
     return DwrfReader::create(std::move(stream), options);
   }
 };
 
+// Registers DwrfReaderFactory for both DWRF and ORC files.
 void registerDwrfReaderFactory();
 
 void unregisterDwrfReaderFactory();
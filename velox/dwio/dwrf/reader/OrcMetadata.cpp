@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/dwrf/reader/OrcMetadata.h"
+
+#include "velox/dwio/common/exception/Exception.h"
+
+namespace facebook::velox::dwrf {
+
+namespace {
+
+proto::Type_Kind toDwrfTypeKind(proto::orc::Type_Kind kind) {
+  switch (kind) {
+    case proto::orc::Type_Kind_BOOLEAN:
+    case proto::orc::Type_Kind_BYTE:
+    case proto::orc::Type_Kind_SHORT:
+    case proto::orc::Type_Kind_INT:
+    case proto::orc::Type_Kind_LONG:
+    case proto::orc::Type_Kind_FLOAT:
+    case proto::orc::Type_Kind_DOUBLE:
+    case proto::orc::Type_Kind_STRING:
+    case proto::orc::Type_Kind_BINARY:
+    case proto::orc::Type_Kind_TIMESTAMP:
+    case proto::orc::Type_Kind_LIST:
+    case proto::orc::Type_Kind_MAP:
+    case proto::orc::Type_Kind_STRUCT:
+    case proto::orc::Type_Kind_UNION:
+      // These share their values with the DWRF enum.
+      return static_cast<proto::Type_Kind>(kind);
+    case proto::orc::Type_Kind_DATE:
+      return proto::Type_Kind_INT;
+    case proto::orc::Type_Kind_DECIMAL:
+      return proto::Type_Kind_LONG;
+    case proto::orc::Type_Kind_VARCHAR:
+    case proto::orc::Type_Kind_CHAR:
+      return proto::Type_Kind_STRING;
+    case proto::orc::Type_Kind_TIMESTAMP_INSTANT:
+      return proto::Type_Kind_TIMESTAMP;
+    default:
+      DWIO_RAISE("Unknown ORC type kind ", static_cast<int32_t>(kind));
+  }
+}
+
+proto::Stream_Kind toDwrfStreamKind(proto::orc::Stream_Kind kind) {
+  switch (kind) {
+    case proto::orc::Stream_Kind_PRESENT:
+      return proto::Stream_Kind_PRESENT;
+    case proto::orc::Stream_Kind_DATA:
+      return proto::Stream_Kind_DATA;
+    case proto::orc::Stream_Kind_LENGTH:
+      return proto::Stream_Kind_LENGTH;
+    case proto::orc::Stream_Kind_DICTIONARY_DATA:
+      return proto::Stream_Kind_DICTIONARY_DATA;
+    case proto::orc::Stream_Kind_DICTIONARY_COUNT:
+      return proto::Stream_Kind_DICTIONARY_COUNT;
+    case proto::orc::Stream_Kind_SECONDARY:
+      // Timestamp nanos and decimal scales.
+      return proto::Stream_Kind_NANO_DATA;
+    case proto::orc::Stream_Kind_ROW_INDEX:
+      return proto::Stream_Kind_ROW_INDEX;
+    default:
+      // Bloom filters are not read. Streams of unknown kind keep their place
+      // so that the offsets of the following streams stay correct.
+      return proto::Stream_Kind_BLOOM_FILTER_UTF8;
+  }
+}
+
+} // namespace
+
+void convertOrcFooter(const proto::orc::Footer& orc, proto::Footer* dwrf) {
+  DWIO_ENSURE(!orc.has_encryption(), "ORC column encryption is not supported");
+  dwrf->set_headerlength(orc.headerlength());
+  dwrf->set_contentlength(orc.contentlength());
+  for (const auto& orcStripe : orc.stripes()) {
+    auto stripe = dwrf->add_stripes();
+    stripe->set_offset(orcStripe.offset());
+    stripe->set_indexlength(orcStripe.indexlength());
+    stripe->set_datalength(orcStripe.datalength());
+    stripe->set_footerlength(orcStripe.footerlength());
+    stripe->set_numberofrows(orcStripe.numberofrows());
+  }
+  for (const auto& orcType : orc.types()) {
+    auto type = dwrf->add_types();
+    type->set_kind(toDwrfTypeKind(orcType.kind()));
+    type->mutable_subtypes()->CopyFrom(orcType.subtypes());
+    type->mutable_fieldnames()->CopyFrom(orcType.fieldnames());
+  }
+  for (const auto& orcItem : orc.metadata()) {
+    auto item = dwrf->add_metadata();
+    item->set_name(orcItem.name());
+    item->set_value(orcItem.value());
+  }
+  dwrf->set_numberofrows(orc.numberofrows());
+  for (const auto& orcStats : orc.statistics()) {
+    convertOrcStatistics(orcStats, dwrf->add_statistics());
+  }
+  if (orc.has_rowindexstride()) {
+    dwrf->set_rowindexstride(orc.rowindexstride());
+  }
+}
+
+void convertOrcStripeFooter(
+    const proto::orc::StripeFooter& orc,
+    proto::StripeFooter* dwrf) {
+  DWIO_ENSURE_EQ(
+      orc.encryption_size(), 0, "ORC column encryption is not supported");
+  dwrf->Clear();
+  for (const auto& orcStream : orc.streams()) {
+    auto stream = dwrf->add_streams();
+    stream->set_kind(toDwrfStreamKind(orcStream.kind()));
+    stream->set_node(orcStream.column());
+    stream->set_length(orcStream.length());
+    // ORC integers are always variable length encoded.
+    stream->set_usevints(true);
+  }
+  for (auto i = 0; i < orc.columns_size(); ++i) {
+    const auto& orcEncoding = orc.columns(i);
+    auto encoding = dwrf->add_encoding();
+    encoding->set_kind(
+        static_cast<proto::ColumnEncoding_Kind>(orcEncoding.kind()));
+    encoding->set_dictionarysize(orcEncoding.dictionarysize());
+    encoding->set_node(i);
+  }
+}
+
+void convertOrcRowIndex(
+    const proto::orc::RowIndex& orc,
+    proto::RowIndex* dwrf) {
+  for (const auto& orcEntry : orc.entry()) {
+    auto entry = dwrf->add_entry();
+    entry->mutable_positions()->CopyFrom(orcEntry.positions());
+    if (orcEntry.has_statistics()) {
+      convertOrcStatistics(orcEntry.statistics(), entry->mutable_statistics());
+    }
+  }
+}
+
+void convertOrcStatistics(
+    const proto::orc::ColumnStatistics& orc,
+    proto::ColumnStatistics* dwrf) {
+  if (orc.has_numberofvalues()) {
+    dwrf->set_numberofvalues(orc.numberofvalues());
+  }
+  if (orc.has_hasnull()) {
+    dwrf->set_hasnull(orc.hasnull());
+  }
+  if (orc.has_bytesondisk()) {
+    dwrf->set_size(orc.bytesondisk());
+  }
+  if (orc.has_intstatistics()) {
+    const auto& stats = orc.intstatistics();
+    auto intStats = dwrf->mutable_intstatistics();
+    if (stats.has_minimum()) {
+      intStats->set_minimum(stats.minimum());
+    }
+    if (stats.has_maximum()) {
+      intStats->set_maximum(stats.maximum());
+    }
+    if (stats.has_sum()) {
+      intStats->set_sum(stats.sum());
+    }
+  } else if (orc.has_datestatistics()) {
+    // Dates are days since the epoch and are filtered as integers.
+    const auto& stats = orc.datestatistics();
+    auto intStats = dwrf->mutable_intstatistics();
+    if (stats.has_minimum()) {
+      intStats->set_minimum(stats.minimum());
+    }
+    if (stats.has_maximum()) {
+      intStats->set_maximum(stats.maximum());
+    }
+  }
+  if (orc.has_doublestatistics()) {
+    const auto& stats = orc.doublestatistics();
+    auto doubleStats = dwrf->mutable_doublestatistics();
+    if (stats.has_minimum()) {
+      doubleStats->set_minimum(stats.minimum());
+    }
+    if (stats.has_maximum()) {
+      doubleStats->set_maximum(stats.maximum());
+    }
+    if (stats.has_sum()) {
+      doubleStats->set_sum(stats.sum());
+    }
+  }
+  if (orc.has_stringstatistics()) {
+    const auto& stats = orc.stringstatistics();
+    auto stringStats = dwrf->mutable_stringstatistics();
+    // lowerBound and upperBound of truncated strings are not used.
+    if (stats.has_minimum()) {
+      stringStats->set_minimum(stats.minimum());
+    }
+    if (stats.has_maximum()) {
+      stringStats->set_maximum(stats.maximum());
+    }
+    if (stats.has_sum()) {
+      stringStats->set_sum(stats.sum());
+    }
+  }
+  if (orc.has_bucketstatistics()) {
+    dwrf->mutable_bucketstatistics()->mutable_count()->CopyFrom(
+        orc.bucketstatistics().count());
+  }
+  if (orc.has_binarystatistics()) {
+    dwrf->mutable_binarystatistics()->set_sum(orc.binarystatistics().sum());
+  }
+}
+
+} // namespace facebook::velox::dwrf
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/dwrf/common/Common.h"
+
+namespace facebook::velox::dwrf {
+
+// Translation of ORC file metadata into the DWRF protos consumed by the
+// reader. ORC and DWRF share the overall file layout but assign different
+// field numbers and enum values to some of the messages, so ORC metadata is
+// parsed with the ORC protos and then copied field by field.
+
+// Fills 'dwrf' from the ORC file footer. ORC types that have no DWRF
+// counterpart are mapped to the DWRF type of their physical encoding:
+// DATE to INT, DECIMAL to LONG, CHAR and VARCHAR to STRING. The logical type
+// is recovered from the ORC footer when building the schema.
+void convertOrcFooter(const proto::orc::Footer& orc, proto::Footer* dwrf);
+
+// Fills 'dwrf' from the ORC stripe footer. Streams are kept in file order so
+// that the stream offsets, which are computed from the lengths, are unchanged.
+void convertOrcStripeFooter(
+    const proto::orc::StripeFooter& orc,
+    proto::StripeFooter* dwrf);
+
+void convertOrcRowIndex(const proto::orc::RowIndex& orc, proto::RowIndex* dwrf);
+
+void convertOrcStatistics(
+    const proto::orc::ColumnStatistics& orc,
+    proto::ColumnStatistics* dwrf);
+
+} // namespace facebook::velox::dwrf
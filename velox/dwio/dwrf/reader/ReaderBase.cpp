@@ -19,6 +19,7 @@
 #include <fmt/format.h>
 
 #include "velox/dwio/common/exception/Exception.h"
+#include "velox/dwio/dwrf/reader/OrcMetadata.h"
 
 namespace facebook::velox::dwrf {
 
@@ -175,11 +176,17 @@ ReaderBase::ReaderBase(
   auto footerStream = input_->read(
       fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
   footer_ = google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
-  ProtoUtils::readProtoInto<proto::Footer>(
-      createDecompressedStream(std::move(footerStream), "File Footer"),
-      footer_);
-
-  schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*footer_));
+  if (getFileFormat() == FileFormat::DWRF) {
+    ProtoUtils::readProtoInto<proto::Footer>(
+        createDecompressedStream(std::move(footerStream), "File Footer"),
+        footer_);
+    schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*footer_));
+  } else {
+    auto orcFooter = ProtoUtils::readProto<proto::orc::Footer>(
+        createDecompressedStream(std::move(footerStream), "File Footer"));
+    convertOrcFooter(*orcFooter, footer_);
+    schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*orcFooter));
+  }
   DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
 
   // load stripe index/footer cache
@@ -313,4 +320,67 @@ std::shared_ptr<const Type> ReaderBase::convertType(
   }
 }
 
+std::shared_ptr<const Type> ReaderBase::convertType(
+    const proto::orc::Footer& footer,
+    uint32_t index) {
+  DWIO_ENSURE_LT(
+      index,
+      folly::to<uint32_t>(footer.types_size()),
+      "Corrupted file, invalid types");
+  const auto& type = footer.types(index);
+  switch (static_cast<int64_t>(type.kind())) {
+    case proto::orc::Type_Kind_BOOLEAN:
+    case proto::orc::Type_Kind_BYTE:
+    case proto::orc::Type_Kind_SHORT:
+    case proto::orc::Type_Kind_INT:
+    case proto::orc::Type_Kind_LONG:
+    case proto::orc::Type_Kind_FLOAT:
+    case proto::orc::Type_Kind_DOUBLE:
+    case proto::orc::Type_Kind_STRING:
+    case proto::orc::Type_Kind_BINARY:
+    case proto::orc::Type_Kind_TIMESTAMP:
+      return createScalarType(static_cast<TypeKind>(type.kind()));
+    case proto::orc::Type_Kind_TIMESTAMP_INSTANT:
+      return TIMESTAMP();
+    case proto::orc::Type_Kind_VARCHAR:
+    case proto::orc::Type_Kind_CHAR:
+      return VARCHAR();
+    case proto::orc::Type_Kind_DATE:
+      return DATE();
+    case proto::orc::Type_Kind_DECIMAL: {
+      // Hive 0.11 decimals have no precision and are read at the maximum.
+      const uint8_t precision = type.precision() > 0
+          ? type.precision()
+          : LongDecimalType::kMaxPrecision;
+      if (precision <= ShortDecimalType::kMaxPrecision) {
+        return SHORT_DECIMAL(precision, type.scale());
+      }
+      return LONG_DECIMAL(precision, type.scale());
+    }
+    case proto::orc::Type_Kind_LIST:
+      return ARRAY(convertType(footer, type.subtypes(0)));
+    case proto::orc::Type_Kind_MAP:
+      return MAP(
+          convertType(footer, type.subtypes(0)),
+          convertType(footer, type.subtypes(1)));
+    case proto::orc::Type_Kind_UNION: {
+      DWIO_RAISE("Union type is deprecated!");
+    }
+    case proto::orc::Type_Kind_STRUCT: {
+      std::vector<std::shared_ptr<const Type>> tl;
+      tl.reserve(type.subtypes_size());
+      std::vector<std::string> names;
+      names.reserve(type.subtypes_size());
+      for (int32_t i = 0; i < type.subtypes_size(); ++i) {
+        auto child = convertType(footer, type.subtypes(i));
+        names.push_back(type.fieldnames(i));
+        tl.push_back(std::move(child));
+      }
+      return ROW(std::move(names), std::move(tl));
+    }
+    default:
+      DWIO_RAISE("Unknown type kind");
+  }
+}
+
 } // namespace facebook::velox::dwrf
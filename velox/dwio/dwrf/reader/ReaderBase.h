@@ -240,6 +240,12 @@ class ReaderBase {
       const proto::Footer& footer,
       uint32_t index = 0);
 
+  // Builds the schema from the ORC footer, which has the logical types that
+  // the translated DWRF footer does not.
+  static std::shared_ptr<const Type> convertType(
+      const proto::orc::Footer& footer,
+      uint32_t index = 0);
+
   memory::MemoryPool& pool_;
   std::unique_ptr<dwio::common::InputStream> stream_;
   std::unique_ptr<google::protobuf::Arena> arena_;
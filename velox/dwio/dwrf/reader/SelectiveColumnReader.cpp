@@ -17,6 +17,7 @@
 #include "velox/dwio/dwrf/reader/SelectiveByteRleColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveColumnReaderInternal.h"
 
+#include "velox/dwio/dwrf/reader/SelectiveDecimalColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveFloatingPointColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveIntegerDictionaryColumnReader.h"
 #include "velox/dwio/dwrf/reader/SelectiveIntegerDirectColumnReader.h"
@@ -64,6 +65,7 @@ SelectiveColumnReader::SelectiveColumnReader(
     : ColumnReader(std::move(requestedType), stripe, std::move(flatMapContext)),
       scanSpec_(scanSpec),
       type_{type},
+      isOrc_{stripe.getFormat() == dwio::common::FileFormat::ORC},
       rowsPerRowGroup_{stripe.rowsPerRowGroup()} {
   EncodingKey encodingKey{nodeType_->id, flatMapContext_.sequence};
   // We always initialize indexStream_ because indices are needed as
@@ -75,6 +77,16 @@ SelectiveColumnReader::SelectiveColumnReader(
       encodingKey.forKind(proto::Stream_Kind_ROW_INDEX), false);
 }
 
+SelectiveColumnReader::SelectiveColumnReader(
+    memory::MemoryPool& pool,
+    std::shared_ptr<const dwio::common::TypeWithId> requestedType,
+    common::ScanSpec* scanSpec,
+    const TypePtr& type)
+    : ColumnReader(pool, requestedType),
+      scanSpec_(scanSpec),
+      type_{type},
+      rowsPerRowGroup_{kRowGroupNotSet} {}
+
 std::vector<uint32_t> SelectiveColumnReader::filterRowGroups(
     uint64_t rowGroupSize,
     const StatsContext& context) const {
@@ -215,6 +227,10 @@ void SelectiveColumnReader::getIntValues(
             VELOX_FAIL("Unsupported value size");
         }
         break;
+      case TypeKind::DATE:
+        VELOX_CHECK_EQ(valueSize_, sizeof(int32_t));
+        getFlatValues<int32_t, Date>(rows, result, nodeType_->type);
+        break;
       default:
         VELOX_FAIL(
             "Not a valid type for integer reader: {}",
@@ -356,6 +372,7 @@ std::unique_ptr<SelectiveColumnReader> buildIntegerReader(
       return std::make_unique<SelectiveIntegerDictionaryColumnReader>(
           requestedType, dataType, stripe, scanSpec, numBytes);
     case proto::ColumnEncoding_Kind_DIRECT:
+    case proto::ColumnEncoding_Kind_DIRECT_V2:
       return std::make_unique<SelectiveIntegerDirectColumnReader>(
           requestedType, dataType, stripe, numBytes, scanSpec);
     default:
@@ -397,6 +414,21 @@ std::unique_ptr<SelectiveColumnReader> SelectiveColumnReader::build(
           stripe,
           SHORT_BYTE_SIZE,
           scanSpec);
+    case TypeKind::DATE:
+      // ORC dates are days since the epoch stored as integers.
+      return buildIntegerReader(
+          requestedType,
+          std::move(flatMapContext),
+          dataType,
+          stripe,
+          INT_BYTE_SIZE,
+          scanSpec);
+    case TypeKind::SHORT_DECIMAL:
+      return std::make_unique<SelectiveDecimalColumnReader<ShortDecimal>>(
+          requestedType, stripe, scanSpec, std::move(flatMapContext));
+    case TypeKind::LONG_DECIMAL:
+      return std::make_unique<SelectiveDecimalColumnReader<LongDecimal>>(
+          requestedType, stripe, scanSpec, std::move(flatMapContext));
     case TypeKind::ARRAY:
       return std::make_unique<SelectiveListColumnReader>(
           requestedType, dataType, stripe, scanSpec, flatMapContext);
@@ -444,9 +476,11 @@ std::unique_ptr<SelectiveColumnReader> SelectiveColumnReader::build(
     case TypeKind::VARCHAR:
       switch (static_cast<int64_t>(stripe.getEncoding(ek).kind())) {
         case proto::ColumnEncoding_Kind_DIRECT:
+        case proto::ColumnEncoding_Kind_DIRECT_V2:
           return std::make_unique<SelectiveStringDirectColumnReader>(
               requestedType, stripe, scanSpec, std::move(flatMapContext));
         case proto::ColumnEncoding_Kind_DICTIONARY:
+        case proto::ColumnEncoding_Kind_DICTIONARY_V2:
           return std::make_unique<SelectiveStringDictionaryColumnReader>(
               requestedType, stripe, scanSpec, std::move(flatMapContext));
         default:
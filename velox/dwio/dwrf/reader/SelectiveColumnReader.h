@@ -21,6 +21,7 @@
 #include "velox/dwio/common/ColumnSelector.h"
 #include "velox/dwio/common/ScanSpec.h"
 #include "velox/dwio/dwrf/reader/ColumnReader.h"
+#include "velox/dwio/dwrf/reader/OrcMetadata.h"
 #include "velox/type/Filter.h"
 
 namespace facebook::velox::dwrf {
@@ -317,6 +318,21 @@ class SelectiveColumnReader : public ColumnReader {
   static constexpr int8_t kNoValueSize = -1;
   static constexpr uint32_t kRowGroupNotSet = ~0;
 
+  // Constructs a reader that does not read its data from DWRF stripe
+  // streams, e.g. a Parquet column chunk reader. Such a reader has no
+  // row group index and no null stream of its own.
+  SelectiveColumnReader(
+      memory::MemoryPool& pool,
+      std::shared_ptr<const dwio::common::TypeWithId> requestedType,
+      common::ScanSpec* scanSpec,
+      const TypePtr& type);
+
+  // Returns true if the column may have nulls in the current
+  // stripe. If false, null filters are decided without reading.
+  virtual bool mayHaveNulls() const {
+    return notNullDecoder_ != nullptr;
+  }
+
   template <typename T>
   void ensureValuesCapacity(vector_size_t numRows);
 
@@ -371,7 +387,15 @@ class SelectiveColumnReader : public ColumnReader {
   void ensureRowGroupIndex() const {
     VELOX_CHECK(index_ || indexStream_, "Reader needs to have an index stream");
     if (indexStream_) {
-      index_ = ProtoUtils::readProto<proto::RowIndex>(std::move(indexStream_));
+      if (isOrc_) {
+        auto orcIndex = ProtoUtils::readProto<proto::orc::RowIndex>(
+            std::move(indexStream_));
+        index_ = std::make_unique<proto::RowIndex>();
+        convertOrcRowIndex(*orcIndex, index_.get());
+      } else {
+        index_ =
+            ProtoUtils::readProto<proto::RowIndex>(std::move(indexStream_));
+      }
     }
   }
 
@@ -382,6 +406,8 @@ class SelectiveColumnReader : public ColumnReader {
   TypePtr type_;
   mutable std::unique_ptr<dwio::common::SeekableInputStream> indexStream_;
   mutable std::unique_ptr<proto::RowIndex> index_;
+  // True if the row index is in ORC format.
+  bool isOrc_{false};
   // Number of rows in a row group. Last row group may have fewer rows.
   uint32_t rowsPerRowGroup_;
 
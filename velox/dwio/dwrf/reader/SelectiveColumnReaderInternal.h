@@ -21,6 +21,7 @@
 #include "velox/dwio/dwrf/common/DirectDecoder.h"
 #include "velox/dwio/dwrf/common/FloatingPointDecoder.h"
 #include "velox/dwio/dwrf/common/RLEv1.h"
+#include "velox/dwio/dwrf/common/RLEv2.h"
 #include "velox/dwio/dwrf/reader/ColumnVisitors.h"
 #include "velox/dwio/dwrf/reader/SelectiveColumnReader.h"
 #include "velox/dwio/dwrf/utils/ProtoUtils.h"
@@ -287,6 +288,7 @@ inline int32_t sizeOfIntKind(TypeKind kind) {
     case TypeKind::SMALLINT:
       return 2;
     case TypeKind::INTEGER:
+    case TypeKind::DATE:
       return 4;
     case TypeKind::BIGINT:
       return 8;
@@ -295,12 +297,37 @@ inline int32_t sizeOfIntKind(TypeKind kind) {
   }
 }
 
+// Reads the rows of 'visitor' from 'decoder', which was created by
+// IntDecoder::createRle() with 'version'. RLEv2 only occurs in ORC files.
+template <bool isSigned, typename Visitor>
+void readRleWithVisitor(
+    IntDecoder<isSigned>& decoder,
+    RleVersion version,
+    const uint64_t* nulls,
+    Visitor visitor) {
+  if (version == RleVersion_1) {
+    auto& rle = static_cast<RleDecoderV1<isSigned>&>(decoder);
+    if (nulls) {
+      rle.template readWithVisitor<true>(nulls, visitor);
+    } else {
+      rle.template readWithVisitor<false>(nullptr, visitor);
+    }
+  } else {
+    auto& rle = static_cast<RleDecoderV2<isSigned>&>(decoder);
+    if (nulls) {
+      rle.template readWithVisitor<true>(nulls, visitor);
+    } else {
+      rle.template readWithVisitor<false>(nullptr, visitor);
+    }
+  }
+}
+
 template <typename T>
 void SelectiveColumnReader::filterNulls(
     RowSet rows,
     bool isNull,
     bool extractValues) {
-  if (!notNullDecoder_) {
+  if (!mayHaveNulls()) {
     if (isNull) {
       // The whole stripe will be empty. We do not update
       // 'readOffset' since nothing is read from either nulls or data.
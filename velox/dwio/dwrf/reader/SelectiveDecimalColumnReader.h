@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/dwrf/reader/SelectiveColumnReaderInternal.h"
+
+namespace facebook::velox::dwrf {
+
+// Reads ORC decimals. The unscaled values are zigzag encoded varints of up to
+// 128 bits in the DATA stream. The scale of each value is in the run length
+// encoded NANO_DATA (ORC SECONDARY) stream and values are rescaled to the
+// scale of the column type. 'TVector' is ShortDecimal or LongDecimal.
+template <typename TVector>
+class SelectiveDecimalColumnReader : public SelectiveColumnReader {
+ public:
+  using ValueType = TVector;
+  using DataType = decltype(TVector().unscaledValue());
+
+  SelectiveDecimalColumnReader(
+      const std::shared_ptr<const dwio::common::TypeWithId>& nodeType,
+      StripeStreams& stripe,
+      common::ScanSpec* scanSpec,
+      FlatMapContext flatMapContext)
+      : SelectiveColumnReader(
+            nodeType,
+            stripe,
+            scanSpec,
+            nodeType->type,
+            std::move(flatMapContext)) {
+    EncodingKey encodingKey{nodeType_->id, flatMapContext_.sequence};
+    int precision;
+    getDecimalPrecisionScale(*type_, precision, scale_);
+    valueStream_ =
+        stripe.getStream(encodingKey.forKind(proto::Stream_Kind_DATA), true);
+    const auto scaleId = encodingKey.forKind(proto::Stream_Kind_NANO_DATA);
+    scales_ = IntDecoder</*isSigned*/ true>::createRle(
+        stripe.getStream(scaleId, true),
+        convertRleVersion(stripe.getEncoding(encodingKey).kind()),
+        memoryPool_,
+        stripe.getUseVInts(scaleId),
+        LONG_BYTE_SIZE);
+  }
+
+  // Values are decoded one at a time with nulls set by the reader.
+  bool hasBulkPath() const override {
+    return false;
+  }
+
+  void seekToRowGroup(uint32_t index) override {
+    ensureRowGroupIndex();
+
+    auto positions = toPositions(index_->entry(index));
+    dwio::common::PositionProvider positionsProvider(positions);
+
+    if (notNullDecoder_) {
+      notNullDecoder_->seekToRowGroup(positionsProvider);
+    }
+
+    valueStream_->seekToPosition(positionsProvider);
+    bufferStart_ = bufferEnd_;
+    scales_->seekToRowGroup(positionsProvider);
+
+    VELOX_CHECK(!positionsProvider.hasNext());
+  }
+
+  uint64_t skip(uint64_t numValues) override {
+    numValues = ColumnReader::skip(numValues);
+    for (uint64_t i = 0; i < numValues; ++i) {
+      skipVarint();
+    }
+    scales_->skip(numValues);
+    return numValues;
+  }
+
+  void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
+      override {
+    prepareRead<TVector>(offset, rows, incomingNulls);
+    VELOX_CHECK(
+        !scanSpec_->filter(), "Filters on ORC decimals are not supported");
+    const vector_size_t numRows = rows.back() + 1;
+    const auto* nulls =
+        nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+    const auto numNonNulls =
+        nulls ? bits::countNonNulls(nulls, 0, numRows) : numRows;
+    scaleValues_.resize(numNonNulls);
+    scales_->next(scaleValues_.data(), numNonNulls, nullptr);
+
+    int32_t nonNullIndex = 0;
+    int32_t rowIndex = 0;
+    for (vector_size_t row = 0; row < numRows; ++row) {
+      const bool selected = rows[rowIndex] == row;
+      if (nulls && bits::isBitNull(nulls, row)) {
+        if (selected) {
+          addNull<TVector>();
+        }
+      } else if (selected) {
+        addValue(TVector(
+            rescale(readVarint(), scaleValues_[nonNullIndex++], scale_)));
+      } else {
+        skipVarint();
+        ++nonNullIndex;
+      }
+      rowIndex += selected;
+    }
+    readOffset_ += numRows;
+  }
+
+  void getValues(RowSet rows, VectorPtr* result) override {
+    getFlatValues<TVector, TVector>(rows, result, type_);
+  }
+
+ private:
+  static DataType rescale(DataType value, int32_t fromScale, int32_t toScale) {
+    for (; fromScale < toScale; ++fromScale) {
+      value *= 10;
+    }
+    for (; fromScale > toScale; --fromScale) {
+      value /= 10;
+    }
+    return value;
+  }
+
+  uint8_t readByte() {
+    if (bufferStart_ == bufferEnd_) {
+      const void* buffer;
+      int32_t length;
+      VELOX_CHECK(
+          valueStream_->Next(&buffer, &length),
+          "Unexpected end of ORC decimal stream");
+      bufferStart_ = static_cast<const char*>(buffer);
+      bufferEnd_ = bufferStart_ + length;
+    }
+    return *bufferStart_++;
+  }
+
+  DataType readVarint() {
+    using UnsignedType =
+        std::conditional_t<sizeof(DataType) == 8, uint64_t, __uint128_t>;
+    UnsignedType value = 0;
+    for (int32_t shift = 0;; shift += 7) {
+      VELOX_CHECK_LT(shift, 8 * sizeof(DataType), "ORC decimal is too long");
+      const auto byte = readByte();
+      value |= static_cast<UnsignedType>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        break;
+      }
+    }
+    // Zigzag decoding.
+    return static_cast<DataType>(value >> 1) ^
+        -static_cast<DataType>(value & 1);
+  }
+
+  void skipVarint() {
+    while (readByte() & 0x80) {
+    }
+  }
+
+  std::unique_ptr<dwio::common::SeekableInputStream> valueStream_;
+  const char* bufferStart_{nullptr};
+  const char* bufferEnd_{nullptr};
+  std::unique_ptr<IntDecoder</*isSigned*/ true>> scales_;
+  raw_vector<int64_t> scaleValues_;
+  // Scale of the column type.
+  int32_t scale_;
+};
+
+} // namespace facebook::velox::dwrf
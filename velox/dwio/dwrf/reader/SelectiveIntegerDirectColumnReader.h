@@ -38,15 +38,23 @@ class SelectiveIntegerDirectColumnReader : public SelectiveIntegerColumnReader {
     EncodingKey encodingKey{nodeType_->id, flatMapContext_.sequence};
     auto data = encodingKey.forKind(proto::Stream_Kind_DATA);
     bool dataVInts = stripe.getUseVInts(data);
-    auto decoder = IntDecoder</*isSigned*/ true>::createDirect(
-        stripe.getStream(data, true), dataVInts, numBytes);
-    auto rawDecoder = decoder.release();
-    auto directDecoder = dynamic_cast<DirectDecoder<true>*>(rawDecoder);
-    ints.reset(directDecoder);
+    if (stripe.getFormat() == dwio::common::FileFormat::DWRF) {
+      ints = IntDecoder</*isSigned*/ true>::createDirect(
+          stripe.getStream(data, true), dataVInts, numBytes);
+    } else {
+      // ORC direct integers are run length encoded.
+      rleVersion_ = convertRleVersion(stripe.getEncoding(encodingKey).kind());
+      ints = IntDecoder</*isSigned*/ true>::createRle(
+          stripe.getStream(data, true),
+          rleVersion_.value(),
+          memoryPool_,
+          dataVInts,
+          numBytes);
+    }
   }
 
   bool hasBulkPath() const override {
-    return true;
+    return rleVersion_ != RleVersion_2;
   }
 
   void seekToRowGroup(uint32_t index) override {
@@ -73,7 +81,10 @@ class SelectiveIntegerDirectColumnReader : public SelectiveIntegerColumnReader {
   void readWithVisitor(RowSet rows, ColumnVisitor visitor);
 
  private:
-  std::unique_ptr<DirectDecoder</*isSigned*/ true>> ints;
+  // DirectDecoder for DWRF, RleDecoderV1 or RleDecoderV2 for ORC.
+  std::unique_ptr<IntDecoder</*isSigned*/ true>> ints;
+  // The run length encoding of 'ints' for ORC.
+  std::optional<RleVersion> rleVersion_;
 };
 
 template <typename ColumnVisitor>
@@ -81,10 +92,21 @@ void SelectiveIntegerDirectColumnReader::readWithVisitor(
     RowSet rows,
     ColumnVisitor visitor) {
   vector_size_t numRows = rows.back() + 1;
-  if (nullsInReadRange_) {
-    ints->readWithVisitor<true>(nullsInReadRange_->as<uint64_t>(), visitor);
+  if (rleVersion_.has_value()) {
+    readRleWithVisitor(
+        *ints,
+        rleVersion_.value(),
+        nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr,
+        visitor);
   } else {
-    ints->readWithVisitor<false>(nullptr, visitor);
+    auto directInts =
+        static_cast<DirectDecoder</*isSigned*/ true>*>(ints.get());
+    if (nullsInReadRange_) {
+      directInts->readWithVisitor<true>(
+          nullsInReadRange_->as<uint64_t>(), visitor);
+    } else {
+      directInts->readWithVisitor<false>(nullptr, visitor);
+    }
   }
   readOffset_ += numRows;
 }
@@ -34,8 +34,7 @@ SelectiveStringDictionaryColumnReader::SelectiveStringDictionaryColumnReader(
       lastStrideIndex_(-1),
       provider_(stripe.getStrideIndexProvider()) {
   EncodingKey encodingKey{nodeType_->id, flatMapContext_.sequence};
-  RleVersion rleVersion =
-      convertRleVersion(stripe.getEncoding(encodingKey).kind());
+  version_ = convertRleVersion(stripe.getEncoding(encodingKey).kind());
   scanState_.dictionary.numValues =
       stripe.getEncoding(encodingKey).dictionarysize();
 
@@ -43,7 +42,7 @@ SelectiveStringDictionaryColumnReader::SelectiveStringDictionaryColumnReader(
   bool dictVInts = stripe.getUseVInts(dataId);
   dictIndex_ = IntDecoder</*isSigned*/ false>::createRle(
       stripe.getStream(dataId, true),
-      rleVersion,
+      version_,
       memoryPool_,
       dictVInts,
       INT_BYTE_SIZE);
@@ -52,7 +51,7 @@ SelectiveStringDictionaryColumnReader::SelectiveStringDictionaryColumnReader(
   bool lenVInts = stripe.getUseVInts(lenId);
   lengthDecoder_ = IntDecoder</*isSigned*/ false>::createRle(
       stripe.getStream(lenId, false),
-      rleVersion,
+      version_,
       memoryPool_,
       lenVInts,
       INT_BYTE_SIZE);
@@ -79,7 +78,7 @@ SelectiveStringDictionaryColumnReader::SelectiveStringDictionaryColumnReader(
     bool strideLenVInt = stripe.getUseVInts(strideDictLenId);
     strideDictLengthDecoder_ = IntDecoder</*isSigned*/ false>::createRle(
         stripe.getStream(strideDictLenId, true),
-        rleVersion,
+        version_,
         memoryPool_,
         strideLenVInt,
         INT_BYTE_SIZE);
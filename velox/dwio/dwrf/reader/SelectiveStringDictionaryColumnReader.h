@@ -67,6 +67,10 @@ class SelectiveStringDictionaryColumnReader : public SelectiveColumnReader {
 
   void getValues(RowSet rows, VectorPtr* result) override;
 
+  bool hasBulkPath() const override {
+    return version_ == RleVersion_1;
+  }
+
  private:
   void loadStrideDictionary();
   void makeDictionaryBaseVector();
@@ -90,6 +94,7 @@ class SelectiveStringDictionaryColumnReader : public SelectiveColumnReader {
       IntDecoder</*isSigned*/ false>& lengthDecoder,
       DictionaryValues& values);
   void ensureInitialized();
+  RleVersion version_;
   std::unique_ptr<IntDecoder</*isSigned*/ false>> dictIndex_;
   std::unique_ptr<ByteRleDecoder> inDictionaryReader_;
   std::unique_ptr<dwio::common::SeekableInputStream> strideDictStream_;
@@ -114,14 +119,11 @@ void SelectiveStringDictionaryColumnReader::readWithVisitor(
     RowSet rows,
     TVisitor visitor) {
   vector_size_t numRows = rows.back() + 1;
-  auto decoder = dynamic_cast<RleDecoderV1<false>*>(dictIndex_.get());
-  VELOX_CHECK(decoder, "Only RLEv1 is supported");
-  if (nullsInReadRange_) {
-    decoder->readWithVisitor<true, TVisitor>(
-        nullsInReadRange_->as<uint64_t>(), visitor);
-  } else {
-    decoder->readWithVisitor<false, TVisitor>(nullptr, visitor);
-  }
+  readRleWithVisitor(
+      *dictIndex_,
+      version_,
+      nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr,
+      visitor);
   readOffset_ += numRows;
 }
 
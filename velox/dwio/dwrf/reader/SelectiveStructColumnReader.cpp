@@ -64,6 +64,15 @@ SelectiveStructColumnReader::SelectiveStructColumnReader(
   }
 }
 
+SelectiveStructColumnReader::SelectiveStructColumnReader(
+    memory::MemoryPool& pool,
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    common::ScanSpec* scanSpec)
+    : SelectiveColumnReader(pool, dataType, scanSpec, dataType->type),
+      requestedType_{requestedType},
+      debugString_(getExceptionContext().message()) {}
+
 std::vector<uint32_t> SelectiveStructColumnReader::filterRowGroups(
     uint64_t rowGroupSize,
     const StatsContext& context) const {
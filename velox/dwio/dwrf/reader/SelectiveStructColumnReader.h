@@ -128,9 +128,19 @@ class SelectiveStructColumnReader : public SelectiveColumnReader {
     return debugString_;
   }
 
- private:
+ protected:
+  // For readers of other formats. The subclass fills 'children_' and sets
+  // the subscripts of the child ScanSpecs.
+  SelectiveStructColumnReader(
+      memory::MemoryPool& pool,
+      const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+      common::ScanSpec* scanSpec);
+
   const std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
   std::vector<std::unique_ptr<SelectiveColumnReader>> children_;
+
+ private:
   // Sequence number of output batch. Checked against ColumnLoaders
   // created by 'this' to verify they are still valid at load.
   uint64_t numReads_ = 0;
@@ -32,16 +32,20 @@ SelectiveTimestampColumnReader::SelectiveTimestampColumnReader(
           nodeType->type,
           std::move(flatMapContext)) {
   EncodingKey encodingKey{nodeType_->id, flatMapContext_.sequence};
-  RleVersion vers = convertRleVersion(stripe.getEncoding(encodingKey).kind());
+  version_ = convertRleVersion(stripe.getEncoding(encodingKey).kind());
   auto data = encodingKey.forKind(proto::Stream_Kind_DATA);
   bool vints = stripe.getUseVInts(data);
   seconds_ = IntDecoder</*isSigned*/ true>::createRle(
-      stripe.getStream(data, true), vers, memoryPool_, vints, LONG_BYTE_SIZE);
+      stripe.getStream(data, true),
+      version_,
+      memoryPool_,
+      vints,
+      LONG_BYTE_SIZE);
   auto nanoData = encodingKey.forKind(proto::Stream_Kind_NANO_DATA);
   bool nanoVInts = stripe.getUseVInts(nanoData);
   nano_ = IntDecoder</*isSigned*/ false>::createRle(
       stripe.getStream(nanoData, true),
-      vers,
+      version_,
       memoryPool_,
       nanoVInts,
       LONG_BYTE_SIZE);
@@ -74,25 +78,16 @@ void SelectiveTimestampColumnReader::readHelper(RowSet rows) {
   vector_size_t numRows = rows.back() + 1;
   ExtractToReader extractValues(this);
   common::AlwaysTrue filter;
-  auto secondsV1 = dynamic_cast<RleDecoderV1<true>*>(seconds_.get());
-  VELOX_CHECK(secondsV1, "Only RLEv1 is supported");
-  if (nullsInReadRange_) {
-    secondsV1->readWithVisitor<true>(
-        nullsInReadRange_->as<uint64_t>(),
-        DirectRleColumnVisitor<
-            int64_t,
-            common::AlwaysTrue,
-            decltype(extractValues),
-            dense>(filter, this, rows, extractValues));
-  } else {
-    secondsV1->readWithVisitor<false>(
-        nullptr,
-        DirectRleColumnVisitor<
-            int64_t,
-            common::AlwaysTrue,
-            decltype(extractValues),
-            dense>(filter, this, rows, extractValues));
-  }
+  auto nulls = nullsInReadRange_ ? nullsInReadRange_->as<uint64_t>() : nullptr;
+  readRleWithVisitor(
+      *seconds_,
+      version_,
+      nulls,
+      DirectRleColumnVisitor<
+          int64_t,
+          common::AlwaysTrue,
+          decltype(extractValues),
+          dense>(filter, this, rows, extractValues));
 
   // Save the seconds into their own buffer before reading nanos into
   // 'values_'
@@ -105,25 +100,15 @@ void SelectiveTimestampColumnReader::readHelper(RowSet rows) {
 
   // We read the nanos into 'values_' starting at index 0.
   numValues_ = 0;
-  auto nanosV1 = dynamic_cast<RleDecoderV1<false>*>(nano_.get());
-  VELOX_CHECK(nanosV1, "Only RLEv1 is supported");
-  if (nullsInReadRange_) {
-    nanosV1->readWithVisitor<true>(
-        nullsInReadRange_->as<uint64_t>(),
-        DirectRleColumnVisitor<
-            int64_t,
-            common::AlwaysTrue,
-            decltype(extractValues),
-            dense>(filter, this, rows, extractValues));
-  } else {
-    nanosV1->readWithVisitor<false>(
-        nullptr,
-        DirectRleColumnVisitor<
-            int64_t,
-            common::AlwaysTrue,
-            decltype(extractValues),
-            dense>(filter, this, rows, extractValues));
-  }
+  readRleWithVisitor(
+      *nano_,
+      version_,
+      nulls,
+      DirectRleColumnVisitor<
+          int64_t,
+          common::AlwaysTrue,
+          decltype(extractValues),
+          dense>(filter, this, rows, extractValues));
   readOffset_ += numRows;
 }
 
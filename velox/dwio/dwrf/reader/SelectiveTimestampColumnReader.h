@@ -38,10 +38,15 @@ class SelectiveTimestampColumnReader : public SelectiveColumnReader {
 
   void getValues(RowSet rows, VectorPtr* result) override;
 
+  bool hasBulkPath() const override {
+    return version_ == RleVersion_1;
+  }
+
  private:
   template <bool dense>
   void readHelper(RowSet rows);
 
+  RleVersion version_;
   std::unique_ptr<IntDecoder</*isSigned*/ true>> seconds_;
   std::unique_ptr<IntDecoder</*isSigned*/ false>> nano_;
 
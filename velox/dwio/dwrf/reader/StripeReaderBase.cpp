@@ -16,6 +16,8 @@
 
 #include "velox/dwio/dwrf/reader/StripeReaderBase.h"
 
+#include "velox/dwio/dwrf/reader/OrcMetadata.h"
+
 namespace facebook::velox::dwrf {
 
 using dwio::common::LogType;
@@ -77,9 +79,15 @@ const proto::StripeInformation& StripeReaderBase::loadStripe(
   }
 
   auto streamDebugInfo = fmt::format("Stripe {} Footer ", index);
-  ProtoUtils::readProtoInto<proto::StripeFooter>(
-      reader_->createDecompressedStream(std::move(stream), streamDebugInfo),
-      footer_);
+  if (reader_->getFileFormat() == dwio::common::FileFormat::DWRF) {
+    ProtoUtils::readProtoInto<proto::StripeFooter>(
+        reader_->createDecompressedStream(std::move(stream), streamDebugInfo),
+        footer_);
+  } else {
+    auto orcFooter = ProtoUtils::readProto<proto::orc::StripeFooter>(
+        reader_->createDecompressedStream(std::move(stream), streamDebugInfo));
+    convertOrcStripeFooter(*orcFooter, footer_);
+  }
 
   // refresh stripe encryption key if necessary
   loadEncryptionKeys(index);
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "folly/Benchmark.h"
+#include "folly/init/Init.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/vector/tests/VectorMaker.h"
+
+#include <deque>
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox::dwrf;
+
+// Compares write throughput and file size of the DWRF compression codecs.
+// Throughput is reported by the benchmarks, file sizes are printed after
+// them.
+
+namespace {
+
+constexpr int32_t kNumBatches = 10;
+constexpr vector_size_t kBatchSize = 10'000;
+
+std::shared_ptr<memory::ScopedMemoryPool> pool;
+std::vector<RowVectorPtr> batches;
+std::deque<std::string> strings;
+
+void makeBatches() {
+  test::VectorMaker maker{&pool->getPool()};
+  for (auto i = 0; i < kNumBatches; ++i) {
+    const auto offset = i * kBatchSize;
+    batches.push_back(maker.rowVector(
+        {maker.flatVector<int64_t>(
+             kBatchSize, [&](auto row) { return offset + row; }),
+         maker.flatVector<int32_t>(
+             kBatchSize, [&](auto row) { return (offset + row) % 1'000; }),
+         maker.flatVector<double>(
+             kBatchSize, [&](auto row) { return (offset + row) % 97 * 0.25; }),
+         maker.flatVector<StringView>(kBatchSize, [&](auto row) {
+           strings.push_back(
+               fmt::format("user_{}_session_{}", (offset + row) % 5'003, row));
+           return StringView(strings.back());
+         })}));
+  }
+}
+
+// Writes all batches with 'kind' and returns the file size.
+uint64_t writeFile(CompressionKind kind) {
+  auto& memoryPool = pool->getPool();
+  auto sink = std::make_unique<MemorySink>(memoryPool, 64 << 20);
+  auto sinkPtr = sink.get();
+  auto config = std::make_shared<Config>();
+  config->set(Config::COMPRESSION, kind);
+  // Dictionary encoding would hide most of the codec differences.
+  config->set<float>(Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD, 0.0);
+  config->set<float>(Config::DICTIONARY_STRING_KEY_SIZE_THRESHOLD, 0.0);
+  WriterOptions options;
+  options.config = config;
+  options.schema = batches[0]->type();
+  Writer writer{options, std::move(sink), memoryPool};
+  for (const auto& batch : batches) {
+    writer.write(batch);
+  }
+  writer.close();
+  return sinkPtr->size();
+}
+
+void runWrite(uint32_t iterations, CompressionKind kind) {
+  for (auto i = 0; i < iterations; ++i) {
+    folly::doNotOptimizeAway(writeFile(kind));
+  }
+}
+
+} // namespace
+
+BENCHMARK(writeNone, n) {
+  runWrite(n, CompressionKind_NONE);
+}
+
+BENCHMARK_RELATIVE(writeLz4, n) {
+  runWrite(n, CompressionKind_LZ4);
+}
+
+BENCHMARK_RELATIVE(writeSnappy, n) {
+  runWrite(n, CompressionKind_SNAPPY);
+}
+
+BENCHMARK_RELATIVE(writeZstd, n) {
+  runWrite(n, CompressionKind_ZSTD);
+}
+
+BENCHMARK_RELATIVE(writeZlib, n) {
+  runWrite(n, CompressionKind_ZLIB);
+}
+
+int32_t main(int32_t argc, char* argv[]) {
+  folly::init(&argc, &argv);
+  pool = memory::getDefaultScopedMemoryPool();
+  makeBatches();
+  folly::runBenchmarks();
+  for (auto kind :
+       {CompressionKind_NONE,
+        CompressionKind_LZ4,
+        CompressionKind_SNAPPY,
+        CompressionKind_ZSTD,
+        CompressionKind_ZLIB}) {
+    LOG(INFO) << fmt::format(
+        "{}: {} bytes", compressionKindToString(kind), writeFile(kind));
+  }
+  batches.clear();
+  return 0;
+}
@@ -15,6 +15,7 @@
  */
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <random>
 #include "velox/dwio/common/MemoryInputStream.h"
 #include "velox/dwio/common/Options.h"
@@ -150,6 +151,147 @@ TEST(E2EWriterTests, E2E) {
   E2EWriterTestUtil::testWriter(pool, type, batches, 1, 1, config);
 }
 
+TEST(E2EWriterTests, parallelColumns) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "bool_val:boolean,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "double_val:double,"
+      "string_val:string,"
+      "timestamp_val:timestamp,"
+      "array_val:array<float>,"
+      "map_val:map<int,double>,"
+      "flat_map_val:map<bigint,double>," /* this is column 8 */
+      "struct_val:struct<a:float,b:double>"
+      ">");
+
+  auto config = std::make_shared<Config>();
+  config->set(Config::ROW_INDEX_STRIDE, static_cast<uint32_t>(1000));
+  config->set(Config::FLATTEN_MAP, true);
+  config->set(Config::MAP_FLAT_COLS, {8});
+
+  std::vector<VectorPtr> batches;
+  for (size_t i = 0; i < 4; ++i) {
+    batches.push_back(BatchMaker::createBatch(type, 2'000, pool, nullptr, i));
+  }
+
+  // Writes 'batches' in a stripe per batch and returns the file.
+  auto writeFile = [&](folly::Executor* executor) {
+    auto sink = std::make_unique<MemorySink>(pool, 200 * 1024 * 1024);
+    auto sinkPtr = sink.get();
+    WriterOptions options;
+    options.config = config;
+    options.schema = type;
+    options.flushPolicyFactory =
+        E2EWriterTestUtil::simpleFlushPolicyFactory(true);
+    options.executor = executor;
+    Writer writer{options, std::move(sink), pool};
+    for (const auto& batch : batches) {
+      writer.write(batch);
+    }
+    writer.close();
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  };
+
+  folly::CPUThreadPoolExecutor executor(4);
+  auto serial = writeFile(nullptr);
+  auto parallel = writeFile(&executor);
+  // The file does not depend on the executor.
+  ASSERT_EQ(serial, parallel);
+
+  auto reader = std::make_unique<DwrfReader>(
+      ReaderOptions{},
+      std::make_unique<MemoryInputStream>(parallel.data(), parallel.size()));
+  EXPECT_EQ(reader->getNumberOfStripes(), batches.size());
+  EXPECT_EQ(reader->getFooter().numberofrows(), 8'000);
+}
+
+// Flushes many dictionary encoded columns in parallel. Columns that abandon
+// their dictionary on the first flush add their direct streams to the
+// WriterContext while other columns flush. Meant to be run under TSAN as
+// well.
+TEST(E2EWriterTests, parallelDictionaryColumns) {
+  auto scopedPool = memory::getDefaultScopedMemoryPool();
+  auto& pool = *scopedPool;
+
+  constexpr int32_t kNumColumns = 16;
+  constexpr vector_size_t kBatchSize = 5'000;
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto i = 0; i < kNumColumns; ++i) {
+    names.push_back(fmt::format("c{}", i));
+    types.push_back(
+        i % 3 == 0       ? VARCHAR()
+            : i % 3 == 1 ? BIGINT()
+                         : INTEGER());
+  }
+  auto type = ROW(std::vector<std::string>(names), std::move(types));
+
+  // Low cardinality values, so that the dictionaries are kept unless the
+  // thresholds are 0.
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 37; ++i) {
+    strings.push_back(fmt::format("dictionary value {}", i));
+  }
+  VectorMaker maker(&pool);
+  std::vector<VectorPtr> batches;
+  for (auto batch = 0; batch < 4; ++batch) {
+    std::vector<VectorPtr> children;
+    for (auto i = 0; i < kNumColumns; ++i) {
+      auto value = [&](auto row) { return (row * (i + 1) + batch) % 37; };
+      auto isNull = [&](auto row) { return (row + i) % 11 == 0; };
+      if (i % 3 == 0) {
+        children.push_back(maker.flatVector<StringView>(
+            kBatchSize,
+            [&](auto row) { return StringView(strings[value(row)]); },
+            isNull));
+      } else if (i % 3 == 1) {
+        children.push_back(
+            maker.flatVector<int64_t>(kBatchSize, value, isNull));
+      } else {
+        children.push_back(
+            maker.flatVector<int32_t>(kBatchSize, value, isNull));
+      }
+    }
+    batches.push_back(maker.rowVector(names, children));
+  }
+
+  for (auto threshold : {1.0f, 0.0f}) {
+    SCOPED_TRACE(threshold);
+    auto config = std::make_shared<Config>();
+    config->set(Config::DICTIONARY_NUMERIC_KEY_SIZE_THRESHOLD, threshold);
+    config->set(Config::DICTIONARY_STRING_KEY_SIZE_THRESHOLD, threshold);
+
+    auto writeFile = [&](folly::Executor* executor) {
+      auto sink = std::make_unique<MemorySink>(pool, 200 * 1024 * 1024);
+      auto sinkPtr = sink.get();
+      WriterOptions options;
+      options.config = config;
+      options.schema = type;
+      options.flushPolicyFactory =
+          E2EWriterTestUtil::simpleFlushPolicyFactory(true);
+      options.executor = executor;
+      Writer writer{options, std::move(sink), pool};
+      for (const auto& batch : batches) {
+        writer.write(batch);
+      }
+      writer.close();
+      return std::string(sinkPtr->getData(), sinkPtr->size());
+    };
+
+    folly::CPUThreadPoolExecutor executor(8);
+    auto serial = writeFile(nullptr);
+    for (auto repeat = 0; repeat < 10; ++repeat) {
+      ASSERT_EQ(serial, writeFile(&executor));
+    }
+  }
+}
+
 TEST(E2EWriterTests, FlatMapDictionaryEncoding) {
   const size_t batchCount = 4;
   // Start with a size larger than stride to cover splitting into
@@ -1380,3 +1380,273 @@ TEST(TestReader, testOrcReaderSimple) {
   }
   EXPECT_EQ(rowNumber, 32768);
 }
+
+TEST(TestReader, testOrcSelectiveReader) {
+  const std::string test1(
+      getExampleFilePath("TestStringDictionary.testRowIndex.orc"));
+  ReaderOptions readerOpts;
+  readerOpts.setFileFormat(dwio::common::FileFormat::ORC);
+  auto reader =
+      DwrfReader::create(std::make_unique<FileInputStream>(test1), readerOpts);
+
+  // The filter is checked against the ORC row index statistics and then
+  // against the RLEv2 encoded values.
+  auto rowType = reader->rowType();
+  auto scanSpec = std::make_shared<common::ScanSpec>("root");
+  auto fieldSpec =
+      scanSpec->getOrCreateChild(common::Subfield(rowType->nameOf(0)));
+  fieldSpec->setProjectOut(true);
+  fieldSpec->setChannel(0);
+  fieldSpec->setFilter(std::make_unique<common::BytesRange>(
+      "row 010000", false, false, "row 010099", false, false, false));
+  RowReaderOptions rowReaderOptions;
+  rowReaderOptions.setScanSpec(scanSpec);
+  auto rowReader = reader->createRowReader(rowReaderOptions);
+
+  VectorPtr batch;
+  size_t rowNumber = 10'000;
+  while (rowReader->next(500, batch)) {
+    auto rowVector = batch->as<RowVector>();
+    auto strings = rowVector->childAt(0)->as<SimpleVector<StringView>>();
+    for (size_t i = 0; i < rowVector->size(); ++i) {
+      EXPECT_EQ(fmt::format("row {:06}", rowNumber), strings->valueAt(i).str());
+      rowNumber++;
+    }
+  }
+  EXPECT_EQ(rowNumber, 10'100);
+}
+
+namespace {
+// orc_types*.orc have 10'000 rows written by pyarrow.orc.write_table() with
+// row_index_stride=500 and no, LZ4 and ZSTD compression. The values and
+// nulls of the columns are functions of the row number below. The integer
+// columns are RLEv2 encoded. 'i' has runs of repeats, ascending, random and
+// mostly small values with outliers.
+std::optional<int32_t> orcTypesInt(int32_t row) {
+  if (row % 11 == 0) {
+    return std::nullopt;
+  }
+  switch ((row / 1'000) % 4) {
+    case 0:
+      return row / 1'000;
+    case 1:
+      return row;
+    case 2:
+      return (row * 7'919) % 10'007;
+    default:
+      return row % 97 == 0 ? 1'000'000'000 : row % 100;
+  }
+}
+
+std::optional<int64_t> orcTypesBigint(int32_t row) {
+  if (row % 13 == 0) {
+    return std::nullopt;
+  }
+  return (row - 5'000) * 1'000'000'007L;
+}
+
+std::optional<int32_t> orcTypesDate(int32_t row) {
+  if (row % 17 == 0) {
+    return std::nullopt;
+  }
+  return 18'000 + row % 400;
+}
+
+std::optional<Timestamp> orcTypesTimestamp(int32_t row) {
+  if (row % 19 == 0) {
+    return std::nullopt;
+  }
+  return Timestamp(1'500'000'000 + row * 37, (row % 1'000) * 1'000'000);
+}
+
+// DECIMAL(10, 2).
+std::optional<int64_t> orcTypesShortDecimal(int32_t row) {
+  if (row % 23 == 0) {
+    return std::nullopt;
+  }
+  return row * 101 - 500'000;
+}
+
+// DECIMAL(30, 5).
+std::optional<int128_t> orcTypesLongDecimal(int32_t row) {
+  if (row % 29 == 0) {
+    return std::nullopt;
+  }
+  const auto kPow20 = static_cast<int128_t>(100'000'000'000) * 1'000'000'000;
+  return (row - 5'000) * kPow20 + row;
+}
+
+template <typename T, typename U>
+void checkOrcTypesValue(
+    const std::string& name,
+    const VectorPtr& vector,
+    vector_size_t index,
+    int32_t row,
+    const std::optional<U>& expected,
+    std::function<U(const T&)> toExpected) {
+  auto values = vector->as<SimpleVector<T>>();
+  ASSERT_EQ(values->isNullAt(index), !expected.has_value())
+      << name << " at row " << row;
+  if (expected.has_value()) {
+    ASSERT_TRUE(toExpected(values->valueAt(index)) == expected.value())
+        << name << " at row " << row;
+  }
+}
+
+// Reads all columns of 'fileName' with 'filters' on 'i', 'b' and 'd' and
+// checks that the rows for which 'expectedRow' is true come back.
+void checkOrcTypes(
+    const std::string& fileName,
+    CompressionKind compression,
+    std::unique_ptr<common::Filter> intFilter,
+    std::unique_ptr<common::Filter> bigintFilter,
+    std::unique_ptr<common::Filter> dateFilter,
+    std::function<bool(int32_t)> expectedRow) {
+  ReaderOptions readerOpts;
+  readerOpts.setFileFormat(dwio::common::FileFormat::ORC);
+  auto reader = DwrfReader::create(
+      std::make_unique<FileInputStream>(getExampleFilePath(fileName)),
+      readerOpts);
+  EXPECT_EQ(reader->getCompression(), compression);
+  auto rowType = reader->rowType();
+  ASSERT_EQ(
+      *rowType,
+      *ROW({"i", "b", "d", "t", "sd", "ld"},
+           {INTEGER(),
+            BIGINT(),
+            DATE(),
+            TIMESTAMP(),
+            SHORT_DECIMAL(10, 2),
+            LONG_DECIMAL(30, 5)}));
+
+  auto scanSpec = std::make_shared<common::ScanSpec>("root");
+  for (auto i = 0; i < rowType->size(); ++i) {
+    auto fieldSpec =
+        scanSpec->getOrCreateChild(common::Subfield(rowType->nameOf(i)));
+    fieldSpec->setProjectOut(true);
+    fieldSpec->setChannel(i);
+  }
+  if (intFilter) {
+    scanSpec->childByName("i")->setFilter(std::move(intFilter));
+  }
+  if (bigintFilter) {
+    scanSpec->childByName("b")->setFilter(std::move(bigintFilter));
+  }
+  if (dateFilter) {
+    scanSpec->childByName("d")->setFilter(std::move(dateFilter));
+  }
+  RowReaderOptions rowReaderOptions;
+  rowReaderOptions.setScanSpec(scanSpec);
+  auto rowReader = reader->createRowReader(rowReaderOptions);
+
+  std::vector<int32_t> expectedRows;
+  for (auto row = 0; row < 10'000; ++row) {
+    if (expectedRow(row)) {
+      expectedRows.push_back(row);
+    }
+  }
+
+  // A batch size that is not a multiple of the row group size.
+  VectorPtr batch;
+  size_t numRows = 0;
+  while (rowReader->next(777, batch)) {
+    auto rowVector = batch->as<RowVector>();
+    for (vector_size_t i = 0; i < rowVector->size(); ++i) {
+      ASSERT_LT(numRows, expectedRows.size());
+      const auto row = expectedRows[numRows++];
+      checkOrcTypesValue<int32_t, int32_t>(
+          "i", rowVector->childAt(0), i, row, orcTypesInt(row), [](auto v) {
+            return v;
+          });
+      checkOrcTypesValue<int64_t, int64_t>(
+          "b", rowVector->childAt(1), i, row, orcTypesBigint(row), [](auto v) {
+            return v;
+          });
+      checkOrcTypesValue<Date, int32_t>(
+          "d", rowVector->childAt(2), i, row, orcTypesDate(row), [](auto v) {
+            return v.days();
+          });
+      checkOrcTypesValue<Timestamp, Timestamp>(
+          "t",
+          rowVector->childAt(3),
+          i,
+          row,
+          orcTypesTimestamp(row),
+          [](auto v) { return v; });
+      checkOrcTypesValue<ShortDecimal, int64_t>(
+          "sd",
+          rowVector->childAt(4),
+          i,
+          row,
+          orcTypesShortDecimal(row),
+          [](auto v) { return v.unscaledValue(); });
+      checkOrcTypesValue<LongDecimal, int128_t>(
+          "ld",
+          rowVector->childAt(5),
+          i,
+          row,
+          orcTypesLongDecimal(row),
+          [](auto v) { return v.unscaledValue(); });
+    }
+  }
+  EXPECT_EQ(numRows, expectedRows.size());
+}
+} // namespace
+
+TEST(TestReader, testOrcTypes) {
+  const std::vector<std::pair<std::string, CompressionKind>> files = {
+      {"orc_types.orc", CompressionKind_NONE},
+      {"orc_types_lz4.orc", CompressionKind_LZ4},
+      {"orc_types_zstd.orc", CompressionKind_ZSTD}};
+  for (const auto& [fileName, compression] : files) {
+    SCOPED_TRACE(fileName);
+    // All rows with their nulls.
+    checkOrcTypes(
+        fileName, compression, nullptr, nullptr, nullptr, [](auto /*row*/) {
+          return true;
+        });
+
+    // Filters on RLEv2 integers and dates select scattered rows. The
+    // decimals and timestamps skip the rows in between.
+    checkOrcTypes(
+        fileName,
+        compression,
+        std::make_unique<common::BigintRange>(0, 50, false),
+        nullptr,
+        std::make_unique<common::BigintRange>(18'100, 18'150, false),
+        [](auto row) {
+          auto value = orcTypesInt(row);
+          auto date = orcTypesDate(row);
+          return value.has_value() && value.value() <= 50 &&
+              date.has_value() && date.value() >= 18'100 &&
+              date.value() <= 18'150;
+        });
+
+    // The row index statistics of the ascending bigints exclude all row
+    // groups but the one of rows 6'000 to 6'499. The other readers seek to
+    // it.
+    const int64_t lower = 1'200 * 1'000'000'007L;
+    const int64_t upper = 1'299 * 1'000'000'007L;
+    checkOrcTypes(
+        fileName,
+        compression,
+        nullptr,
+        std::make_unique<common::BigintRange>(lower, upper, false),
+        nullptr,
+        [&](auto row) {
+          auto value = orcTypesBigint(row);
+          return value.has_value() && value.value() >= lower &&
+              value.value() <= upper;
+        });
+
+    // Outliers in the patched base runs.
+    checkOrcTypes(
+        fileName,
+        compression,
+        std::make_unique<common::BigintRange>(
+            1'000'000'000, 1'000'000'000, false),
+        nullptr,
+        nullptr,
+        [](auto row) { return orcTypesInt(row) == 1'000'000'000; });
+  }
+}
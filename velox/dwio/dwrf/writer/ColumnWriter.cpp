@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
+#include "velox/common/base/AsyncSource.h"
 #include "velox/dwio/common/ChainedBuffer.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
 #include "velox/dwio/dwrf/writer/EntropyEncodingSelector.h"
@@ -25,6 +26,8 @@
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/FlatVector.h"
 
+#include <deque>
+
 using namespace facebook::velox::dwio::common;
 using namespace facebook::velox::memory;
 
@@ -33,16 +36,17 @@ namespace facebook::velox::dwrf {
 WriterContext::LocalDecodedVector BaseColumnWriter::decode(
     const VectorPtr& slice,
     const Ranges& ranges) {
-  auto& selected = context_.getSharedSelectivityVector(slice->size());
+  auto selected = context_.getSelectivityVector(slice->size());
   // initialize
-  selected.clearAll();
+  selected->clearAll();
   for (auto& range : ranges.getRanges()) {
-    selected.setValidRange(std::get<0>(range), std::get<1>(range), true);
+    selected->setValidRange(std::get<0>(range), std::get<1>(range), true);
   }
-  selected.updateBounds();
+  selected->updateBounds();
   // decode
   auto localDecoded = context_.getLocalDecodedVector();
-  localDecoded.get().decode(*slice, selected);
+  localDecoded.get().decode(*slice, *selected);
+  context_.releaseSelectivityVector(std::move(selected));
   return localDecoded;
 }
 
@@ -1577,28 +1581,114 @@ class StructColumnWriter : public BaseColumnWriter {
 
   void flush(
       std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
-      std::function<void(proto::ColumnEncoding&)> encodingOverride) override {
-    BaseColumnWriter::flush(encodingFactory, encodingOverride);
-    for (auto& c : children_) {
-      c->flush(encodingFactory);
-    }
-  }
+      std::function<void(proto::ColumnEncoding&)> encodingOverride) override;
 
  private:
   uint64_t writeChildrenAndStats(
       const RowVector* rowSlice,
       const Ranges& ranges,
       uint64_t nullCount);
+
+  // Calls 'fn' with the index of each child. If the context has an executor,
+  // the children of the root run on the executor and the calling thread.
+  // Children that add streams to the context while writing (flat maps) run
+  // on the calling thread after the others are done. Files with encrypted
+  // columns are always written serially.
+  void forEachChild(const std::function<void(size_t)>& fn);
 };
 
+void StructColumnWriter::forEachChild(const std::function<void(size_t)>& fn) {
+  auto* executor = context_.executor();
+  if (!executor || !isRoot() || children_.size() < 2 ||
+      context_.getEncryptionHandler().isEncrypted()) {
+    for (size_t i = 0; i < children_.size(); ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  const auto flatMapCols = getConfig(Config::MAP_FLAT_COLS);
+  const bool flattenMap = getConfig(Config::FLATTEN_MAP);
+  std::vector<size_t> serial;
+  std::vector<std::shared_ptr<AsyncSource<std::exception_ptr>>> sources;
+  for (size_t i = 0; i < children_.size(); ++i) {
+    const auto& type = children_[i]->getType();
+    if (flattenMap && type.type->kind() == TypeKind::MAP &&
+        std::find(flatMapCols.begin(), flatMapCols.end(), type.column) !=
+            flatMapCols.end()) {
+      serial.push_back(i);
+      continue;
+    }
+    sources.push_back(std::make_shared<AsyncSource<std::exception_ptr>>(
+        [&fn, i]() {
+          auto error = std::make_unique<std::exception_ptr>();
+          try {
+            fn(i);
+          } catch (const std::exception&) {
+            *error = std::current_exception();
+          }
+          return error;
+        }));
+    executor->add([source = sources.back()]() { source->prepare(); });
+  }
+  // Waits for all children before rethrowing since 'fn' references the
+  // caller's state.
+  std::exception_ptr error;
+  for (auto& source : sources) {
+    auto result = source->move();
+    if (result && *result && !error) {
+      error = *result;
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  for (auto i : serial) {
+    fn(i);
+  }
+}
+
+void StructColumnWriter::flush(
+    std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
+    std::function<void(proto::ColumnEncoding&)> encodingOverride) {
+  BaseColumnWriter::flush(encodingFactory, encodingOverride);
+  if (!context_.executor()) {
+    for (auto& c : children_) {
+      c->flush(encodingFactory);
+    }
+    return;
+  }
+  // The children flush in parallel into local encodings, which are added to
+  // the footer in child order so that the file is the same as when flushing
+  // serially.
+  using Encodings = std::deque<std::pair<uint32_t, proto::ColumnEncoding>>;
+  std::vector<Encodings> childEncodings(children_.size());
+  forEachChild([&](size_t i) {
+    auto& encodings = childEncodings[i];
+    children_[i]->flush([&](uint32_t nodeId) -> proto::ColumnEncoding& {
+      encodings.emplace_back(nodeId, proto::ColumnEncoding{});
+      return encodings.back().second;
+    });
+  });
+  for (auto& encodings : childEncodings) {
+    for (auto& [nodeId, encoding] : encodings) {
+      encodingFactory(nodeId).Swap(&encoding);
+    }
+  }
+}
+
 uint64_t StructColumnWriter::writeChildrenAndStats(
     const RowVector* rowSlice,
     const Ranges& ranges,
     uint64_t nullCount) {
   uint64_t rawSize = 0;
   if (ranges.size() > 0) {
-    for (size_t i = 0; i < children_.size(); ++i) {
-      rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
+    std::vector<uint64_t> childRawSizes(children_.size());
+    forEachChild([&](size_t i) {
+      childRawSizes[i] = children_[i]->write(rowSlice->childAt(i), ranges);
+    });
+    for (auto childRawSize : childRawSizes) {
+      rawSize += childRawSize;
     }
   }
   if (nullCount) {
@@ -24,6 +24,10 @@
 #include "velox/dwio/dwrf/writer/RatioTracker.h"
 #include "velox/vector/DecodedVector.h"
 
+#include <folly/Executor.h>
+
+#include <mutex>
+
 namespace facebook::velox::dwrf {
 
 enum class MemoryUsageCategory { DICTIONARY, OUTPUT_STREAM, GENERAL };
@@ -69,25 +73,32 @@ class WriterContext : public CompressionBufferPool {
     }
     validateConfigs();
     VLOG(1) << fmt::format("Compression config: {}", compression);
-    compressionBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
-        generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    compressionBuffers_.push_back(newCompressionBuffer());
   }
 
   bool hasStream(const DwrfStreamIdentifier& stream) const {
+    std::lock_guard<std::mutex> l(streamsMutex_);
     return streams_.find(stream) != streams_.end();
   }
 
   const DataBufferHolder& getStream(const DwrfStreamIdentifier& stream) const {
+    std::lock_guard<std::mutex> l(streamsMutex_);
     return streams_.at(stream);
   }
 
   void addBuffer(
       const DwrfStreamIdentifier& stream,
       folly::StringPiece buffer) {
-    streams_.at(stream).take(buffer);
+    DataBufferHolder* holder;
+    {
+      std::lock_guard<std::mutex> l(streamsMutex_);
+      holder = &streams_.at(stream);
+    }
+    holder->take(buffer);
   }
 
   size_t getStreamCount() const {
+    std::lock_guard<std::mutex> l(streamsMutex_);
     return streams_.size();
   }
 
@@ -97,22 +108,29 @@ class WriterContext : public CompressionBufferPool {
   // flush policy evaluation and would be more accurate after flush.
   std::unique_ptr<BufferedOutputStream> newStream(
       const DwrfStreamIdentifier& stream) {
-    DWIO_ENSURE(
-        !hasStream(stream), "Stream already exists ", stream.toString());
-    streams_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(stream),
-        std::forward_as_tuple(
-            getMemoryPool(MemoryUsageCategory::OUTPUT_STREAM),
-            compressionBlockSize,
-            getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
-            getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
-    auto& holder = streams_.at(stream);
+    DataBufferHolder* holder;
+    {
+      // Column writers flushing in parallel add streams on first flush.
+      std::lock_guard<std::mutex> l(streamsMutex_);
+      DWIO_ENSURE(
+          streams_.find(stream) == streams_.end(),
+          "Stream already exists ",
+          stream.toString());
+      auto result = streams_.emplace(
+          std::piecewise_construct,
+          std::forward_as_tuple(stream),
+          std::forward_as_tuple(
+              getMemoryPool(MemoryUsageCategory::OUTPUT_STREAM),
+              compressionBlockSize,
+              getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
+              getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
+      holder = &result.first->second;
+    }
     auto encrypter = handler_->isEncrypted(stream.encodingKey().node)
         ? std::addressof(
               handler_->getEncryptionProvider(stream.encodingKey().node))
         : nullptr;
-    return newStream(compression, holder, encrypter);
+    return newStream(compression, *holder, encrypter);
   }
 
   std::unique_ptr<DataBufferHolder> newDataBufferHolder(
@@ -168,9 +186,14 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void suppressStream(const DwrfStreamIdentifier& stream) {
-    DWIO_ENSURE(hasStream(stream));
-    auto& collector = streams_.at(stream);
-    collector.suppress();
+    DataBufferHolder* collector;
+    {
+      std::lock_guard<std::mutex> l(streamsMutex_);
+      auto it = streams_.find(stream);
+      DWIO_ENSURE(it != streams_.end());
+      collector = &it->second;
+    }
+    collector->suppress();
   }
 
   bool isStreamPaged(uint32_t nodeId) const {
@@ -256,6 +279,7 @@ class WriterContext : public CompressionBufferPool {
     return *config_;
   }
 
+  // Not synchronized. Called between stripes, when no column writer runs.
   void iterateUnSuppressedStreams(
       std::function<void(
           std::pair<const DwrfStreamIdentifier, DataBufferHolder>&)> callback) {
@@ -293,29 +317,52 @@ class WriterContext : public CompressionBufferPool {
     }
   }
 
+  // Returns a compression buffer. Column writers running in parallel on
+  // 'executor()' compress concurrently, so the context keeps a buffer per
+  // concurrent user.
   std::unique_ptr<dwio::common::DataBuffer<char>> getBuffer(
       uint64_t size) override {
-    DWIO_ENSURE_NOT_NULL(compressionBuffer_);
-    DWIO_ENSURE_GE(compressionBuffer_->size(), size);
-    return std::move(compressionBuffer_);
+    std::unique_ptr<dwio::common::DataBuffer<char>> buffer;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (!compressionBuffers_.empty()) {
+        buffer = std::move(compressionBuffers_.back());
+        compressionBuffers_.pop_back();
+      }
+    }
+    if (!buffer) {
+      buffer = newCompressionBuffer();
+    }
+    DWIO_ENSURE_GE(buffer->size(), size);
+    return buffer;
   }
 
   void returnBuffer(
       std::unique_ptr<dwio::common::DataBuffer<char>> buffer) override {
     DWIO_ENSURE_NOT_NULL(buffer);
-    DWIO_ENSURE(!compressionBuffer_);
-    compressionBuffer_ = std::move(buffer);
+    std::lock_guard<std::mutex> l(mutex_);
+    compressionBuffers_.push_back(std::move(buffer));
+  }
+
+  // Executor for encoding and flushing independent columns in parallel.
+  // nullptr if the columns are written on the calling thread.
+  folly::Executor* FOLLY_NULLABLE executor() const {
+    return executor_;
+  }
+
+  void setExecutor(folly::Executor* FOLLY_NULLABLE executor) {
+    executor_ = executor;
   }
 
   void incrementNodeSize(uint32_t node, uint64_t size) {
+    std::lock_guard<std::mutex> l(streamsMutex_);
     nodeSize[node] += size;
   }
 
   uint64_t getNodeSize(uint32_t node) {
-    if (nodeSize.count(node) > 0) {
-      return nodeSize[node];
-    }
-    return 0;
+    std::lock_guard<std::mutex> l(streamsMutex_);
+    auto it = nodeSize.find(node);
+    return it == nodeSize.end() ? 0 : it->second;
   }
 
   void recordCompressionRatio(uint64_t compressedSize) {
@@ -413,19 +460,39 @@ class WriterContext : public CompressionBufferPool {
     return LocalDecodedVector{*this};
   }
 
-  SelectivityVector& getSharedSelectivityVector(velox::vector_size_t size) {
-    if (UNLIKELY(!selectivityVector_)) {
-      selectivityVector_ = std::make_unique<velox::SelectivityVector>(size);
-    } else {
-      selectivityVector_->resize(size);
+  std::unique_ptr<velox::SelectivityVector> getSelectivityVector(
+      velox::vector_size_t size) {
+    std::unique_ptr<velox::SelectivityVector> vector;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (!selectivityVectorPool_.empty()) {
+        vector = std::move(selectivityVectorPool_.back());
+        selectivityVectorPool_.pop_back();
+      }
+    }
+    if (!vector) {
+      return std::make_unique<velox::SelectivityVector>(size);
     }
-    return *selectivityVector_;
+    vector->resize(size);
+    return vector;
+  }
+
+  void releaseSelectivityVector(
+      std::unique_ptr<velox::SelectivityVector>&& vector) {
+    std::lock_guard<std::mutex> l(mutex_);
+    selectivityVectorPool_.push_back(std::move(vector));
   }
 
  private:
   void validateConfigs() const;
 
+  std::unique_ptr<dwio::common::DataBuffer<char>> newCompressionBuffer() {
+    return std::make_unique<dwio::common::DataBuffer<char>>(
+        generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+  }
+
   std::unique_ptr<velox::DecodedVector> getDecodedVector() {
+    std::lock_guard<std::mutex> l(mutex_);
     if (decodedVectorPool_.empty()) {
       return std::make_unique<velox::DecodedVector>();
     }
@@ -435,6 +502,7 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void releaseDecodedVector(std::unique_ptr<velox::DecodedVector>&& vector) {
+    std::lock_guard<std::mutex> l(mutex_);
     decodedVectorPool_.push_back(std::move(vector));
   }
 
@@ -459,11 +527,19 @@ class WriterContext : public CompressionBufferPool {
   std::function<std::unique_ptr<IndexBuilder>(
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
-  std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
+  // Serializes adding and looking up 'streams_' and 'nodeSize' from column
+  // writers running in parallel on 'executor_'.
+  mutable std::mutex streamsMutex_;
+  folly::Executor* FOLLY_NULLABLE executor_{nullptr};
+  // Serializes access to the pools below from parallel column writers.
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<dwio::common::DataBuffer<char>>>
+      compressionBuffers_;
   // A pool of reusable DecodedVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
-  // Reusable SelectivityVector
-  std::unique_ptr<velox::SelectivityVector> selectivityVector_;
+  // A pool of reusable SelectivityVectors.
+  std::vector<std::unique_ptr<velox::SelectivityVector>>
+      selectivityVectorPool_;
 
   std::unique_ptr<encryption::EncryptionHandler> handler_;
   folly::F14FastMap<uint32_t, uint64_t> nodeSize;
@@ -119,6 +119,10 @@ struct WriterOptionsShared {
   std::shared_ptr<encryption::EncryptionSpecification> encryptionSpec;
   std::shared_ptr<dwio::common::encryption::EncrypterFactory> encrypterFactory;
   int64_t memoryBudget = std::numeric_limits<int64_t>::max();
+  // If set, the top-level columns are encoded and flushed in parallel on
+  // this executor. The file is the same as when writing serially. Must
+  // outlive the writer.
+  folly::Executor* FOLLY_NULLABLE executor{nullptr};
 };
 
 class WriterShared : public WriterBase {
@@ -144,6 +148,7 @@ class WriterShared : public WriterBase {
                 folly::to<std::string>(folly::Random::rand64())),
             std::min(options.memoryBudget, parentPool.getCap())),
         std::move(handler));
+    getContext().setExecutor(options.executor);
     if (!options.flushPolicyFactory) {
       auto& context = getContext();
       flushPolicy_ = std::make_unique<DefaultFlushPolicy>(
@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/parquet/RegisterParquetReader.h"
+#include "velox/dwio/parquet/reader/ParquetReader.h"
 
 namespace facebook::velox::parquet {
 
@@ -24,6 +25,10 @@ void registerParquetReaderFactory(ParquetReaderType parquetReaderType) {
       dwio::common::registerReaderFactory(
           std::make_shared<duckdb_reader::ParquetReaderFactory>());
       break;
+    case ParquetReaderType::NATIVE:
+      dwio::common::registerReaderFactory(
+          std::make_shared<ParquetReaderFactory>());
+      break;
     default:
       VELOX_UNSUPPORTED(
           "Velox does not support ParquetReaderType ", parquetReaderType);
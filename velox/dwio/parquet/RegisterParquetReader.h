@@ -20,7 +20,9 @@
 
 namespace facebook::velox::parquet {
 
-enum class ParquetReaderType { DUCKDB };
+// DUCKDB wraps the DuckDB Parquet reader. NATIVE reads flat schemas with
+// ScanSpec filter pushdown and LazyVectors on SelectiveColumnReaders.
+enum class ParquetReaderType { DUCKDB, NATIVE };
 
 void registerParquetReaderFactory(ParquetReaderType parquetReaderType);
 
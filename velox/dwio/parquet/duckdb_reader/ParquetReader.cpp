@@ -68,6 +68,32 @@ void buildConjunctOrFilter(
   }
 }
 
+void buildRangeFilter(
+    uint64_t colIdx,
+    ::duckdb::LogicalType type,
+    int64_t lower,
+    int64_t upper,
+    ::duckdb::TableFilterSet& filters) {
+  if (lower == upper) {
+    filters.PushFilter(colIdx, constantEqualFilter(makeValue(type, lower)));
+    return;
+  }
+  if (lower != std::numeric_limits<int64_t>::min()) {
+    filters.PushFilter(
+        colIdx,
+        constantFilter(
+            ::duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+            makeValue(type, lower)));
+  }
+  if (upper != std::numeric_limits<int64_t>::max()) {
+    filters.PushFilter(
+        colIdx,
+        constantFilter(
+            ::duckdb::ExpressionType::COMPARE_LESSTHANOREQUALTO,
+            makeValue(type, upper)));
+  }
+}
+
 void toDuckDbFilter(
     uint64_t colIdx,
     ::duckdb::LogicalType type,
@@ -76,25 +102,8 @@ void toDuckDbFilter(
   switch (filter->kind()) {
     case common::FilterKind::kBigintRange: {
       auto rangeFilter = static_cast<common::BigintRange*>(filter);
-      if (rangeFilter->isSingleValue()) {
-        filters.PushFilter(
-            colIdx, constantEqualFilter(makeValue(type, rangeFilter->lower())));
-      } else {
-        if (rangeFilter->lower() != std::numeric_limits<int64_t>::min()) {
-          filters.PushFilter(
-              colIdx,
-              constantFilter(
-                  ::duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO,
-                  makeValue(type, rangeFilter->lower())));
-        }
-        if (rangeFilter->upper() != std::numeric_limits<int64_t>::max()) {
-          filters.PushFilter(
-              colIdx,
-              constantFilter(
-                  ::duckdb::ExpressionType::COMPARE_LESSTHANOREQUALTO,
-                  makeValue(type, rangeFilter->upper())));
-        }
-      }
+      buildRangeFilter(
+          colIdx, type, rangeFilter->lower(), rangeFilter->upper(), filters);
       break;
     }
 
@@ -172,6 +181,16 @@ void toDuckDbFilter(
       buildConjunctOrFilter(colIdx, type, values, filters);
       break;
     }
+    case common::FilterKind::kBigintValuesUsingBloomFilter: {
+      // DuckDB has no Bloom filter. The range of the values passes a
+      // superset of the rows, which is fine since a Bloom filter may pass
+      // extra values anyway.
+      auto bloomFilter =
+          static_cast<common::BigintValuesUsingBloomFilter*>(filter);
+      buildRangeFilter(
+          colIdx, type, bloomFilter->min(), bloomFilter->max(), filters);
+      break;
+    }
     case common::FilterKind::kAlwaysFalse:
     case common::FilterKind::kAlwaysTrue:
     case common::FilterKind::kIsNull:
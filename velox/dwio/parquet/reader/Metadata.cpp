@@ -0,0 +1,622 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/Metadata.h"
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/dwio/common/StreamUtil.h"
+
+namespace facebook::velox::parquet::thrift {
+
+namespace {
+
+// Field and element types of the Thrift compact protocol.
+enum class CType : uint8_t {
+  kStop = 0,
+  kBoolTrue = 1,
+  kBoolFalse = 2,
+  kByte = 3,
+  kI16 = 4,
+  kI32 = 5,
+  kI64 = 6,
+  kDouble = 7,
+  kBinary = 8,
+  kList = 9,
+  kSet = 10,
+  kMap = 11,
+  kStruct = 12,
+};
+
+// Reads the Thrift compact protocol from a SeekableInputStream. Values may
+// straddle the buffers returned by the stream.
+class CompactReader {
+ public:
+  CompactReader(
+      dwio::common::SeekableInputStream& input,
+      const char*& bufferStart,
+      const char*& bufferEnd)
+      : input_(input), bufferStart_(bufferStart), bufferEnd_(bufferEnd) {}
+
+  uint8_t readByte() {
+    if (bufferStart_ == bufferEnd_) {
+      const void* buffer;
+      int32_t size;
+      do {
+        VELOX_CHECK(
+            input_.Next(&buffer, &size),
+            "Reading past end of Parquet metadata");
+      } while (size == 0);
+      bufferStart_ = static_cast<const char*>(buffer);
+      bufferEnd_ = bufferStart_ + size;
+    }
+    return *bufferStart_++;
+  }
+
+  uint64_t readVarint() {
+    uint64_t result = 0;
+    for (int32_t shift = 0;; shift += 7) {
+      VELOX_CHECK_LT(shift, 64, "Malformed varint in Parquet metadata");
+      auto byte = readByte();
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return result;
+      }
+    }
+  }
+
+  int64_t readI64() {
+    auto value = readVarint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+  int32_t readI32() {
+    return static_cast<int32_t>(readI64());
+  }
+
+  // Reads a bool element of a container. These take a byte, 1 for true.
+  bool readBoolElement() {
+    return readByte() == static_cast<uint8_t>(CType::kBoolTrue);
+  }
+
+  std::string readBinary() {
+    auto length = readVarint();
+    std::string result(length, '\0');
+    dwio::common::readBytes(
+        length, &input_, result.data(), bufferStart_, bufferEnd_);
+    return result;
+  }
+
+  void skipBytes(uint64_t numBytes) {
+    dwio::common::skipBytes(numBytes, &input_, bufferStart_, bufferEnd_);
+  }
+
+  // Reads a field header. Returns false at the end of the enclosing struct.
+  // The value of a bool field is encoded in 'type'.
+  bool readFieldBegin(int16_t& fieldId, CType& type) {
+    auto byte = readByte();
+    type = static_cast<CType>(byte & 0x0f);
+    if (type == CType::kStop) {
+      return false;
+    }
+    auto delta = byte >> 4;
+    fieldId = delta ? lastFieldId_ + delta : static_cast<int16_t>(readI64());
+    lastFieldId_ = fieldId;
+    return true;
+  }
+
+  void structBegin() {
+    fieldIdStack_.push_back(lastFieldId_);
+    lastFieldId_ = 0;
+  }
+
+  void structEnd() {
+    lastFieldId_ = fieldIdStack_.back();
+    fieldIdStack_.pop_back();
+  }
+
+  int32_t readListBegin(CType& elementType) {
+    auto byte = readByte();
+    elementType = static_cast<CType>(byte & 0x0f);
+    int32_t size = byte >> 4;
+    if (size == 15) {
+      size = static_cast<int32_t>(readVarint());
+    }
+    return size;
+  }
+
+  // Skips a value of 'type'. Bools inside containers take a byte, bools in
+  // fields are encoded in the field header.
+  void skip(CType type, bool inContainer = false) {
+    switch (type) {
+      case CType::kBoolTrue:
+      case CType::kBoolFalse:
+        if (inContainer) {
+          readByte();
+        }
+        break;
+      case CType::kByte:
+        readByte();
+        break;
+      case CType::kI16:
+      case CType::kI32:
+      case CType::kI64:
+        readVarint();
+        break;
+      case CType::kDouble:
+        skipBytes(sizeof(double));
+        break;
+      case CType::kBinary:
+        skipBytes(readVarint());
+        break;
+      case CType::kList:
+      case CType::kSet: {
+        CType elementType;
+        auto size = readListBegin(elementType);
+        for (auto i = 0; i < size; ++i) {
+          skip(elementType, true);
+        }
+        break;
+      }
+      case CType::kMap: {
+        auto size = readVarint();
+        if (size) {
+          auto types = readByte();
+          for (uint64_t i = 0; i < size; ++i) {
+            skip(static_cast<CType>(types >> 4), true);
+            skip(static_cast<CType>(types & 0x0f), true);
+          }
+        }
+        break;
+      }
+      case CType::kStruct: {
+        structBegin();
+        int16_t fieldId;
+        CType fieldType;
+        while (readFieldBegin(fieldId, fieldType)) {
+          skip(fieldType);
+        }
+        structEnd();
+        break;
+      }
+      default:
+        VELOX_FAIL(
+            "Unexpected Thrift type in Parquet metadata: {}",
+            static_cast<int32_t>(type));
+    }
+  }
+
+ private:
+  dwio::common::SeekableInputStream& input_;
+  const char*& bufferStart_;
+  const char*& bufferEnd_;
+  int16_t lastFieldId_{0};
+  std::vector<int16_t> fieldIdStack_;
+};
+
+// Calls 'onField' for each field of a struct. 'onField' returns false if it
+// did not consume the field, in which case the field is skipped.
+template <typename OnField>
+void readStruct(CompactReader& reader, OnField onField) {
+  reader.structBegin();
+  int16_t fieldId;
+  CType type;
+  while (reader.readFieldBegin(fieldId, type)) {
+    if (!onField(fieldId, type)) {
+      reader.skip(type);
+    }
+  }
+  reader.structEnd();
+}
+
+template <typename T, typename ReadElement>
+std::vector<T> readList(CompactReader& reader, ReadElement readElement) {
+  CType elementType;
+  auto size = reader.readListBegin(elementType);
+  std::vector<T> result;
+  result.reserve(size);
+  for (auto i = 0; i < size; ++i) {
+    result.push_back(readElement());
+  }
+  return result;
+}
+
+template <typename E>
+E readEnum(CompactReader& reader) {
+  return static_cast<E>(reader.readI32());
+}
+
+Statistics readStatistics(CompactReader& reader) {
+  Statistics stats;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        stats.max = reader.readBinary();
+        return true;
+      case 2:
+        stats.min = reader.readBinary();
+        return true;
+      case 3:
+        stats.nullCount = reader.readI64();
+        return true;
+      case 4:
+        stats.distinctCount = reader.readI64();
+        return true;
+      case 5:
+        stats.maxValue = reader.readBinary();
+        return true;
+      case 6:
+        stats.minValue = reader.readBinary();
+        return true;
+      default:
+        return false;
+    }
+  });
+  return stats;
+}
+
+SchemaElement readSchemaElement(CompactReader& reader) {
+  SchemaElement element;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        element.type = readEnum<Type>(reader);
+        return true;
+      case 2:
+        element.typeLength = reader.readI32();
+        return true;
+      case 3:
+        element.repetitionType = readEnum<FieldRepetitionType>(reader);
+        return true;
+      case 4:
+        element.name = reader.readBinary();
+        return true;
+      case 5:
+        element.numChildren = reader.readI32();
+        return true;
+      case 6:
+        element.convertedType = readEnum<ConvertedType>(reader);
+        return true;
+      case 7:
+        element.scale = reader.readI32();
+        return true;
+      case 8:
+        element.precision = reader.readI32();
+        return true;
+      default:
+        return false;
+    }
+  });
+  return element;
+}
+
+ColumnMetaData readColumnMetaData(CompactReader& reader) {
+  ColumnMetaData metaData;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        metaData.type = readEnum<Type>(reader);
+        return true;
+      case 2:
+        metaData.encodings = readList<Encoding>(
+            reader, [&]() { return readEnum<Encoding>(reader); });
+        return true;
+      case 3:
+        metaData.pathInSchema = readList<std::string>(
+            reader, [&]() { return reader.readBinary(); });
+        return true;
+      case 4:
+        metaData.codec = readEnum<CompressionCodec>(reader);
+        return true;
+      case 5:
+        metaData.numValues = reader.readI64();
+        return true;
+      case 6:
+        metaData.totalUncompressedSize = reader.readI64();
+        return true;
+      case 7:
+        metaData.totalCompressedSize = reader.readI64();
+        return true;
+      case 9:
+        metaData.dataPageOffset = reader.readI64();
+        return true;
+      case 10:
+        metaData.indexPageOffset = reader.readI64();
+        return true;
+      case 11:
+        metaData.dictionaryPageOffset = reader.readI64();
+        return true;
+      case 12:
+        metaData.statistics = readStatistics(reader);
+        return true;
+      default:
+        return false;
+    }
+  });
+  return metaData;
+}
+
+ColumnChunk readColumnChunk(CompactReader& reader) {
+  ColumnChunk chunk;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        chunk.filePath = reader.readBinary();
+        return true;
+      case 2:
+        chunk.fileOffset = reader.readI64();
+        return true;
+      case 3:
+        chunk.metaData = readColumnMetaData(reader);
+        return true;
+      case 4:
+        chunk.offsetIndexOffset = reader.readI64();
+        return true;
+      case 5:
+        chunk.offsetIndexLength = reader.readI32();
+        return true;
+      case 6:
+        chunk.columnIndexOffset = reader.readI64();
+        return true;
+      case 7:
+        chunk.columnIndexLength = reader.readI32();
+        return true;
+      default:
+        return false;
+    }
+  });
+  return chunk;
+}
+
+RowGroup readRowGroup(CompactReader& reader) {
+  RowGroup rowGroup;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        rowGroup.columns = readList<ColumnChunk>(
+            reader, [&]() { return readColumnChunk(reader); });
+        return true;
+      case 2:
+        rowGroup.totalByteSize = reader.readI64();
+        return true;
+      case 3:
+        rowGroup.numRows = reader.readI64();
+        return true;
+      case 5:
+        rowGroup.fileOffset = reader.readI64();
+        return true;
+      case 6:
+        rowGroup.totalCompressedSize = reader.readI64();
+        return true;
+      default:
+        return false;
+    }
+  });
+  return rowGroup;
+}
+
+DataPageHeader readDataPageHeader(CompactReader& reader) {
+  DataPageHeader header;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        header.numValues = reader.readI32();
+        return true;
+      case 2:
+        header.encoding = readEnum<Encoding>(reader);
+        return true;
+      case 3:
+        header.definitionLevelEncoding = readEnum<Encoding>(reader);
+        return true;
+      case 4:
+        header.repetitionLevelEncoding = readEnum<Encoding>(reader);
+        return true;
+      default:
+        return false;
+    }
+  });
+  return header;
+}
+
+DictionaryPageHeader readDictionaryPageHeader(CompactReader& reader) {
+  DictionaryPageHeader header;
+  readStruct(reader, [&](int16_t id, CType type) {
+    switch (id) {
+      case 1:
+        header.numValues = reader.readI32();
+        return true;
+      case 2:
+        header.encoding = readEnum<Encoding>(reader);
+        return true;
+      case 3:
+        header.isSorted = type == CType::kBoolTrue;
+        return true;
+      default:
+        return false;
+    }
+  });
+  return header;
+}
+
+DataPageHeaderV2 readDataPageHeaderV2(CompactReader& reader) {
+  DataPageHeaderV2 header;
+  readStruct(reader, [&](int16_t id, CType type) {
+    switch (id) {
+      case 1:
+        header.numValues = reader.readI32();
+        return true;
+      case 2:
+        header.numNulls = reader.readI32();
+        return true;
+      case 3:
+        header.numRows = reader.readI32();
+        return true;
+      case 4:
+        header.encoding = readEnum<Encoding>(reader);
+        return true;
+      case 5:
+        header.definitionLevelsByteLength = reader.readI32();
+        return true;
+      case 6:
+        header.repetitionLevelsByteLength = reader.readI32();
+        return true;
+      case 7:
+        header.isCompressed = type == CType::kBoolTrue;
+        return true;
+      default:
+        return false;
+    }
+  });
+  return header;
+}
+
+PageLocation readPageLocation(CompactReader& reader) {
+  PageLocation location;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        location.offset = reader.readI64();
+        return true;
+      case 2:
+        location.compressedPageSize = reader.readI32();
+        return true;
+      case 3:
+        location.firstRowIndex = reader.readI64();
+        return true;
+      default:
+        return false;
+    }
+  });
+  return location;
+}
+
+} // namespace
+
+FileMetaData readFileMetaData(dwio::common::SeekableInputStream& input) {
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  CompactReader reader(input, bufferStart, bufferEnd);
+  FileMetaData metaData;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        metaData.version = reader.readI32();
+        return true;
+      case 2:
+        metaData.schema = readList<SchemaElement>(
+            reader, [&]() { return readSchemaElement(reader); });
+        return true;
+      case 3:
+        metaData.numRows = reader.readI64();
+        return true;
+      case 4:
+        metaData.rowGroups = readList<RowGroup>(
+            reader, [&]() { return readRowGroup(reader); });
+        return true;
+      case 6:
+        metaData.createdBy = reader.readBinary();
+        return true;
+      default:
+        return false;
+    }
+  });
+  return metaData;
+}
+
+PageHeader readPageHeader(
+    dwio::common::SeekableInputStream& input,
+    const char*& bufferStart,
+    const char*& bufferEnd) {
+  CompactReader reader(input, bufferStart, bufferEnd);
+  PageHeader header;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        header.type = readEnum<PageType>(reader);
+        return true;
+      case 2:
+        header.uncompressedPageSize = reader.readI32();
+        return true;
+      case 3:
+        header.compressedPageSize = reader.readI32();
+        return true;
+      case 5:
+        header.dataPageHeader = readDataPageHeader(reader);
+        return true;
+      case 7:
+        header.dictionaryPageHeader = readDictionaryPageHeader(reader);
+        return true;
+      case 8:
+        header.dataPageHeaderV2 = readDataPageHeaderV2(reader);
+        return true;
+      default:
+        return false;
+    }
+  });
+  return header;
+}
+
+ColumnIndex readColumnIndex(dwio::common::SeekableInputStream& input) {
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  CompactReader reader(input, bufferStart, bufferEnd);
+  ColumnIndex index;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        index.nullPages = readList<bool>(
+            reader, [&]() { return reader.readBoolElement(); });
+        return true;
+      case 2:
+        index.minValues = readList<std::string>(
+            reader, [&]() { return reader.readBinary(); });
+        return true;
+      case 3:
+        index.maxValues = readList<std::string>(
+            reader, [&]() { return reader.readBinary(); });
+        return true;
+      case 4:
+        index.boundaryOrder = readEnum<BoundaryOrder>(reader);
+        return true;
+      case 5:
+        index.nullCounts = readList<int64_t>(
+            reader, [&]() { return reader.readI64(); });
+        return true;
+      default:
+        return false;
+    }
+  });
+  return index;
+}
+
+OffsetIndex readOffsetIndex(dwio::common::SeekableInputStream& input) {
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  CompactReader reader(input, bufferStart, bufferEnd);
+  OffsetIndex index;
+  readStruct(reader, [&](int16_t id, CType /*type*/) {
+    switch (id) {
+      case 1:
+        index.pageLocations = readList<PageLocation>(
+            reader, [&]() { return readPageLocation(reader); });
+        return true;
+      default:
+        return false;
+    }
+  });
+  return index;
+}
+
+} // namespace facebook::velox::parquet::thrift
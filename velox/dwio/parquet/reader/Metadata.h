@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "velox/dwio/common/SeekableInputStream.h"
+
+// Subset of the Parquet file metadata defined in parquet.thrift. Only the
+// fields that the native reader uses are decoded, all others are skipped. The
+// names and numeric values follow parquet.thrift.
+namespace facebook::velox::parquet::thrift {
+
+enum class Type : int32_t {
+  BOOLEAN = 0,
+  INT32 = 1,
+  INT64 = 2,
+  INT96 = 3,
+  FLOAT = 4,
+  DOUBLE = 5,
+  BYTE_ARRAY = 6,
+  FIXED_LEN_BYTE_ARRAY = 7,
+};
+
+enum class ConvertedType : int32_t {
+  UTF8 = 0,
+  MAP = 1,
+  MAP_KEY_VALUE = 2,
+  LIST = 3,
+  ENUM = 4,
+  DECIMAL = 5,
+  DATE = 6,
+  TIME_MILLIS = 7,
+  TIME_MICROS = 8,
+  TIMESTAMP_MILLIS = 9,
+  TIMESTAMP_MICROS = 10,
+  UINT_8 = 11,
+  UINT_16 = 12,
+  UINT_32 = 13,
+  UINT_64 = 14,
+  INT_8 = 15,
+  INT_16 = 16,
+  INT_32 = 17,
+  INT_64 = 18,
+  JSON = 19,
+  BSON = 20,
+  INTERVAL = 21,
+};
+
+enum class FieldRepetitionType : int32_t {
+  REQUIRED = 0,
+  OPTIONAL = 1,
+  REPEATED = 2,
+};
+
+enum class Encoding : int32_t {
+  PLAIN = 0,
+  PLAIN_DICTIONARY = 2,
+  RLE = 3,
+  BIT_PACKED = 4,
+  DELTA_BINARY_PACKED = 5,
+  DELTA_LENGTH_BYTE_ARRAY = 6,
+  DELTA_BYTE_ARRAY = 7,
+  RLE_DICTIONARY = 8,
+  BYTE_STREAM_SPLIT = 9,
+};
+
+enum class CompressionCodec : int32_t {
+  UNCOMPRESSED = 0,
+  SNAPPY = 1,
+  GZIP = 2,
+  LZO = 3,
+  BROTLI = 4,
+  LZ4 = 5,
+  ZSTD = 6,
+  LZ4_RAW = 7,
+};
+
+enum class PageType : int32_t {
+  DATA_PAGE = 0,
+  INDEX_PAGE = 1,
+  DICTIONARY_PAGE = 2,
+  DATA_PAGE_V2 = 3,
+};
+
+struct Statistics {
+  std::optional<std::string> max;
+  std::optional<std::string> min;
+  std::optional<int64_t> nullCount;
+  std::optional<int64_t> distinctCount;
+  std::optional<std::string> maxValue;
+  std::optional<std::string> minValue;
+};
+
+struct SchemaElement {
+  std::optional<Type> type;
+  int32_t typeLength{0};
+  std::optional<FieldRepetitionType> repetitionType;
+  std::string name;
+  int32_t numChildren{0};
+  std::optional<ConvertedType> convertedType;
+  int32_t scale{0};
+  int32_t precision{0};
+};
+
+struct ColumnMetaData {
+  Type type{Type::BOOLEAN};
+  std::vector<Encoding> encodings;
+  std::vector<std::string> pathInSchema;
+  CompressionCodec codec{CompressionCodec::UNCOMPRESSED};
+  int64_t numValues{0};
+  int64_t totalUncompressedSize{0};
+  int64_t totalCompressedSize{0};
+  int64_t dataPageOffset{0};
+  std::optional<int64_t> indexPageOffset;
+  std::optional<int64_t> dictionaryPageOffset;
+  std::optional<Statistics> statistics;
+};
+
+struct ColumnChunk {
+  std::optional<std::string> filePath;
+  int64_t fileOffset{0};
+  std::optional<ColumnMetaData> metaData;
+  std::optional<int64_t> offsetIndexOffset;
+  std::optional<int32_t> offsetIndexLength;
+  std::optional<int64_t> columnIndexOffset;
+  std::optional<int32_t> columnIndexLength;
+};
+
+struct RowGroup {
+  std::vector<ColumnChunk> columns;
+  int64_t totalByteSize{0};
+  int64_t numRows{0};
+  std::optional<int64_t> fileOffset;
+  std::optional<int64_t> totalCompressedSize;
+};
+
+struct FileMetaData {
+  int32_t version{0};
+  std::vector<SchemaElement> schema;
+  int64_t numRows{0};
+  std::vector<RowGroup> rowGroups;
+  std::optional<std::string> createdBy;
+};
+
+struct DataPageHeader {
+  int32_t numValues{0};
+  Encoding encoding{Encoding::PLAIN};
+  Encoding definitionLevelEncoding{Encoding::RLE};
+  Encoding repetitionLevelEncoding{Encoding::RLE};
+};
+
+struct DictionaryPageHeader {
+  int32_t numValues{0};
+  Encoding encoding{Encoding::PLAIN};
+  bool isSorted{false};
+};
+
+struct DataPageHeaderV2 {
+  int32_t numValues{0};
+  int32_t numNulls{0};
+  int32_t numRows{0};
+  Encoding encoding{Encoding::PLAIN};
+  int32_t definitionLevelsByteLength{0};
+  int32_t repetitionLevelsByteLength{0};
+  bool isCompressed{true};
+};
+
+struct PageHeader {
+  PageType type{PageType::DATA_PAGE};
+  int32_t uncompressedPageSize{0};
+  int32_t compressedPageSize{0};
+  std::optional<DataPageHeader> dataPageHeader;
+  std::optional<DictionaryPageHeader> dictionaryPageHeader;
+  std::optional<DataPageHeaderV2> dataPageHeaderV2;
+};
+
+enum class BoundaryOrder : int32_t {
+  UNORDERED = 0,
+  ASCENDING = 1,
+  DESCENDING = 2,
+};
+
+// Page level min/max statistics of a column chunk. The vectors have an
+// element per data page.
+struct ColumnIndex {
+  std::vector<bool> nullPages;
+  std::vector<std::string> minValues;
+  std::vector<std::string> maxValues;
+  BoundaryOrder boundaryOrder{BoundaryOrder::UNORDERED};
+  std::vector<int64_t> nullCounts;
+};
+
+struct PageLocation {
+  int64_t offset{0};
+  int32_t compressedPageSize{0};
+  int64_t firstRowIndex{0};
+};
+
+// File offsets and first rows of the data pages of a column chunk.
+struct OffsetIndex {
+  std::vector<PageLocation> pageLocations;
+};
+
+// Decodes a FileMetaData in the Thrift compact protocol from 'input'.
+FileMetaData readFileMetaData(dwio::common::SeekableInputStream& input);
+
+// Decodes a PageHeader in the Thrift compact protocol. 'bufferStart' and
+// 'bufferEnd' delimit the unread part of the last buffer returned by
+// 'input'. They are advanced past the header, so that the page data can be
+// read from the same position.
+PageHeader readPageHeader(
+    dwio::common::SeekableInputStream& input,
+    const char*& bufferStart,
+    const char*& bufferEnd);
+
+// Decode a ColumnIndex and an OffsetIndex of the page index in the Thrift
+// compact protocol from 'input'.
+ColumnIndex readColumnIndex(dwio::common::SeekableInputStream& input);
+OffsetIndex readOffsetIndex(dwio::common::SeekableInputStream& input);
+
+} // namespace facebook::velox::parquet::thrift
@@ -0,0 +1,533 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageReader.h"
+
+#include <folly/Range.h>
+#include <snappy.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#include "velox/dwio/common/StreamUtil.h"
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox::parquet {
+
+using thrift::CompressionCodec;
+using thrift::Encoding;
+using thrift::PageType;
+using thrift::Type;
+
+namespace {
+
+int32_t valueSizeOf(Type type) {
+  switch (type) {
+    case Type::BOOLEAN:
+      return 1;
+    case Type::INT32:
+    case Type::FLOAT:
+      return 4;
+    case Type::INT64:
+    case Type::DOUBLE:
+      return 8;
+    case Type::BYTE_ARRAY:
+      return sizeof(folly::StringPiece);
+    default:
+      VELOX_UNSUPPORTED(
+          "Parquet physical type {} is not supported", static_cast<int>(type));
+  }
+}
+
+uint8_t bitWidth(int16_t maxLevel) {
+  return 32 - __builtin_clz(static_cast<uint32_t>(maxLevel));
+}
+
+uint32_t readUint32(const char* data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+void ensureBuffer(BufferPtr& buffer, int32_t size, memory::MemoryPool& pool) {
+  if (!buffer || buffer->capacity() < size) {
+    buffer = AlignedBuffer::allocate<char>(size, &pool);
+  }
+}
+
+void decompress(
+    CompressionCodec codec,
+    const char* input,
+    int32_t inputSize,
+    char* output,
+    int32_t outputSize) {
+  switch (codec) {
+    case CompressionCodec::SNAPPY: {
+      size_t uncompressedSize;
+      VELOX_CHECK(
+          snappy::GetUncompressedLength(input, inputSize, &uncompressedSize) &&
+              uncompressedSize == outputSize,
+          "Corrupt Snappy compressed Parquet page");
+      VELOX_CHECK(
+          snappy::RawUncompress(input, inputSize, output),
+          "Corrupt Snappy compressed Parquet page");
+      return;
+    }
+    case CompressionCodec::GZIP: {
+      z_stream stream{};
+      // Accept both gzip and zlib headers.
+      VELOX_CHECK_EQ(inflateInit2(&stream, 32 + MAX_WBITS), Z_OK);
+      stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input));
+      stream.avail_in = inputSize;
+      stream.next_out = reinterpret_cast<Bytef*>(output);
+      stream.avail_out = outputSize;
+      auto result = inflate(&stream, Z_FINISH);
+      inflateEnd(&stream);
+      VELOX_CHECK(
+          result == Z_STREAM_END && stream.total_out == outputSize,
+          "Corrupt GZIP compressed Parquet page, error {}",
+          result);
+      return;
+    }
+    case CompressionCodec::ZSTD: {
+      auto result = ZSTD_decompress(output, outputSize, input, inputSize);
+      VELOX_CHECK(
+          !ZSTD_isError(result) && result == outputSize,
+          "Corrupt ZSTD compressed Parquet page: {}",
+          ZSTD_getErrorName(result));
+      return;
+    }
+    default:
+      VELOX_UNSUPPORTED(
+          "Parquet compression codec {} is not supported",
+          static_cast<int>(codec));
+  }
+}
+
+std::vector<PageRun> singleRun(
+    std::unique_ptr<dwio::common::SeekableInputStream> input) {
+  std::vector<PageRun> runs;
+  runs.push_back({0, std::move(input)});
+  return runs;
+}
+
+template <typename T>
+void gather(const T* dictionary, const int32_t* indices, int32_t size, T* out) {
+  for (auto i = 0; i < size; ++i) {
+    out[i] = dictionary[indices[i]];
+  }
+}
+
+} // namespace
+
+PageReader::PageReader(
+    std::unique_ptr<dwio::common::SeekableInputStream> stream,
+    memory::MemoryPool& pool,
+    thrift::Type type,
+    thrift::CompressionCodec codec,
+    int16_t maxDefine)
+    : PageReader(
+          nullptr,
+          singleRun(std::move(stream)),
+          pool,
+          type,
+          codec,
+          maxDefine) {}
+
+PageReader::PageReader(
+    std::unique_ptr<dwio::common::SeekableInputStream> dictionaryInput,
+    std::vector<PageRun> runs,
+    memory::MemoryPool& pool,
+    thrift::Type type,
+    thrift::CompressionCodec codec,
+    int16_t maxDefine)
+    : dictionaryInput_(std::move(dictionaryInput)),
+      runs_(std::move(runs)),
+      pool_(pool),
+      type_(type),
+      codec_(codec),
+      maxDefine_(maxDefine),
+      valueSize_(valueSizeOf(type)) {}
+
+void PageReader::seekToRun(int64_t row) {
+  auto run = nextRun_;
+  while (run < runs_.size() && runs_[run].firstRow <= row) {
+    ++run;
+  }
+  if (run == nextRun_) {
+    return;
+  }
+  VELOX_CHECK_GE(runs_[run - 1].firstRow, row_);
+  input_ = std::move(runs_[run - 1].input);
+  bufferStart_ = nullptr;
+  bufferEnd_ = nullptr;
+  rowsLeftInPage_ = 0;
+  row_ = runs_[run - 1].firstRow;
+  nextRun_ = run;
+}
+
+void PageReader::readDictionaryPage() {
+  // The dictionary is decoded into buffers of 'this', so the input can
+  // be dropped after reading.
+  auto dictionaryInput = std::move(dictionaryInput_);
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  std::swap(input_, dictionaryInput);
+  std::swap(bufferStart_, bufferStart);
+  std::swap(bufferEnd_, bufferEnd);
+  auto header = thrift::readPageHeader(*input_, bufferStart_, bufferEnd_);
+  if (header.type == PageType::DICTIONARY_PAGE) {
+    prepareDictionary(header);
+  }
+  std::swap(input_, dictionaryInput);
+  std::swap(bufferStart_, bufferStart);
+  std::swap(bufferEnd_, bufferEnd);
+}
+
+void PageReader::readNextPage(int64_t& rowsToSkip) {
+  if (dictionaryInput_) {
+    readDictionaryPage();
+  }
+  VELOX_CHECK_NOT_NULL(input_, "No loaded Parquet page for row {}", row_);
+  for (;;) {
+    auto header = thrift::readPageHeader(*input_, bufferStart_, bufferEnd_);
+    switch (header.type) {
+      case PageType::DICTIONARY_PAGE:
+        prepareDictionary(header);
+        break;
+      case PageType::DATA_PAGE:
+      case PageType::DATA_PAGE_V2: {
+        int64_t numRows = header.type == PageType::DATA_PAGE
+            ? header.dataPageHeader.value().numValues
+            : header.dataPageHeaderV2.value().numRows;
+        if (numRows > rowsToSkip) {
+          prepareDataPage(header);
+          return;
+        }
+        dwio::common::skipBytes(
+            header.compressedPageSize, input_.get(), bufferStart_, bufferEnd_);
+        rowsToSkip -= numRows;
+        row_ += numRows;
+        if (!rowsToSkip) {
+          return;
+        }
+        break;
+      }
+      default:
+        dwio::common::skipBytes(
+            header.compressedPageSize, input_.get(), bufferStart_, bufferEnd_);
+        break;
+    }
+  }
+}
+
+const char* PageReader::readPageData(
+    const thrift::PageHeader& header,
+    BufferPtr& buffer,
+    bool mayReference) {
+  auto compressedSize = header.compressedPageSize;
+  auto uncompressedSize = header.uncompressedPageSize;
+  // Levels of V2 pages are not compressed.
+  int32_t levelsSize = 0;
+  bool isCompressed = codec_ != CompressionCodec::UNCOMPRESSED;
+  if (header.type == PageType::DATA_PAGE_V2) {
+    auto& v2Header = header.dataPageHeaderV2.value();
+    levelsSize = v2Header.definitionLevelsByteLength +
+        v2Header.repetitionLevelsByteLength;
+    isCompressed = isCompressed && v2Header.isCompressed;
+  }
+  const bool isContiguous = bufferEnd_ - bufferStart_ >= compressedSize;
+  if (!isCompressed) {
+    if (mayReference && isContiguous) {
+      auto data = bufferStart_;
+      bufferStart_ += compressedSize;
+      return data;
+    }
+    ensureBuffer(buffer, compressedSize, pool_);
+    dwio::common::readBytes(
+        compressedSize,
+        input_.get(),
+        buffer->asMutable<char>(),
+        bufferStart_,
+        bufferEnd_);
+    return buffer->as<char>();
+  }
+  const char* compressedData;
+  if (isContiguous) {
+    compressedData = bufferStart_;
+    bufferStart_ += compressedSize;
+  } else {
+    ensureBuffer(compressedBuffer_, compressedSize, pool_);
+    dwio::common::readBytes(
+        compressedSize,
+        input_.get(),
+        compressedBuffer_->asMutable<char>(),
+        bufferStart_,
+        bufferEnd_);
+    compressedData = compressedBuffer_->as<char>();
+  }
+  ensureBuffer(buffer, uncompressedSize, pool_);
+  auto data = buffer->asMutable<char>();
+  memcpy(data, compressedData, levelsSize);
+  decompress(
+      codec_,
+      compressedData + levelsSize,
+      compressedSize - levelsSize,
+      data + levelsSize,
+      uncompressedSize - levelsSize);
+  return data;
+}
+
+void PageReader::prepareDictionary(const thrift::PageHeader& header) {
+  auto& dictionaryHeader = header.dictionaryPageHeader.value();
+  VELOX_CHECK(
+      dictionaryHeader.encoding == Encoding::PLAIN ||
+          dictionaryHeader.encoding == Encoding::PLAIN_DICTIONARY,
+      "Unsupported Parquet dictionary encoding {}",
+      static_cast<int>(dictionaryHeader.encoding));
+  // The strings of the dictionary point into the page, so the page is
+  // always copied.
+  dictionaryPage_ = nullptr;
+  auto data = readPageData(header, dictionaryPage_, false);
+  dictionarySize_ = dictionaryHeader.numValues;
+  dictionary_ = AlignedBuffer::allocate<char>(
+      std::max(1, dictionarySize_) * valueSize_, &pool_);
+  decodePlain(
+      data,
+      data + header.uncompressedPageSize,
+      dictionarySize_,
+      dictionary_->asMutable<char>());
+}
+
+void PageReader::prepareDataPage(const thrift::PageHeader& header) {
+  // String values point into the page, so a page with strings is always
+  // copied and the copy is retained while the strings are referenced.
+  if (type_ == Type::BYTE_ARRAY && pageBuffer_) {
+    retainedPages_.push_back(std::move(pageBuffer_));
+  }
+  auto data = readPageData(header, pageBuffer_, type_ != Type::BYTE_ARRAY);
+  auto end = data + header.uncompressedPageSize;
+  Encoding encoding;
+  if (header.type == PageType::DATA_PAGE_V2) {
+    auto& v2Header = header.dataPageHeaderV2.value();
+    VELOX_CHECK_EQ(
+        v2Header.repetitionLevelsByteLength,
+        0,
+        "Repeated Parquet columns are not supported");
+    rowsLeftInPage_ = v2Header.numRows;
+    encoding = v2Header.encoding;
+    if (maxDefine_ > 0) {
+      defineDecoder_ = RleBpDecoder(
+          data,
+          data + v2Header.definitionLevelsByteLength,
+          bitWidth(maxDefine_));
+    }
+    data += v2Header.definitionLevelsByteLength;
+  } else {
+    auto& v1Header = header.dataPageHeader.value();
+    rowsLeftInPage_ = v1Header.numValues;
+    encoding = v1Header.encoding;
+    if (maxDefine_ > 0) {
+      VELOX_CHECK(
+          v1Header.definitionLevelEncoding == Encoding::RLE,
+          "Only RLE encoded Parquet definition levels are supported");
+      auto length = readUint32(data);
+      data += sizeof(uint32_t);
+      defineDecoder_ = RleBpDecoder(data, data + length, bitWidth(maxDefine_));
+      data += length;
+    }
+  }
+  isDictionary_ = false;
+  isRleBoolean_ = false;
+  switch (encoding) {
+    case Encoding::PLAIN:
+      break;
+    case Encoding::PLAIN_DICTIONARY:
+    case Encoding::RLE_DICTIONARY: {
+      VELOX_CHECK(
+          dictionary_, "Dictionary encoded Parquet page without a dictionary");
+      isDictionary_ = true;
+      auto indexWidth = static_cast<uint8_t>(*data);
+      valueDecoder_ = RleBpDecoder(data + 1, end, indexWidth);
+      break;
+    }
+    case Encoding::RLE: {
+      VELOX_CHECK(
+          type_ == Type::BOOLEAN, "RLE encoding is only supported for BOOLEAN");
+      isRleBoolean_ = true;
+      auto length = readUint32(data);
+      data += sizeof(uint32_t);
+      valueDecoder_ = RleBpDecoder(data, data + length, 1);
+      break;
+    }
+    default:
+      VELOX_UNSUPPORTED(
+          "Parquet encoding {} is not supported", static_cast<int>(encoding));
+  }
+  pageData_ = data;
+  pageEnd_ = end;
+  boolBitOffset_ = 0;
+}
+
+void PageReader::decodePlain(
+    const char*& data,
+    const char* end,
+    int32_t numValues,
+    char* values) {
+  switch (type_) {
+    case Type::BYTE_ARRAY: {
+      auto strings = reinterpret_cast<folly::StringPiece*>(values);
+      for (auto i = 0; i < numValues; ++i) {
+        VELOX_CHECK_LE(data + sizeof(uint32_t), end);
+        auto length = readUint32(data);
+        data += sizeof(uint32_t);
+        VELOX_CHECK_LE(data + length, end);
+        strings[i] = folly::StringPiece(data, length);
+        data += length;
+      }
+      break;
+    }
+    case Type::BOOLEAN: {
+      VELOX_CHECK_LE(data + bits::nbytes(boolBitOffset_ + numValues), end);
+      auto bytes = reinterpret_cast<const uint8_t*>(data);
+      for (auto i = 0; i < numValues; ++i) {
+        auto bit = boolBitOffset_ + i;
+        values[i] = (bytes[bit / 8] >> (bit % 8)) & 1;
+      }
+      boolBitOffset_ += numValues;
+      break;
+    }
+    default: {
+      auto numBytes = numValues * valueSize_;
+      VELOX_CHECK_LE(data + numBytes, end);
+      memcpy(values, data, numBytes);
+      data += numBytes;
+    }
+  }
+}
+
+void PageReader::readValues(int32_t numValues, char* values) {
+  if (isRleBoolean_) {
+    valueDecoder_.next(reinterpret_cast<int8_t*>(values), numValues);
+    return;
+  }
+  if (!isDictionary_) {
+    decodePlain(pageData_, pageEnd_, numValues, values);
+    return;
+  }
+  indices_.resize(numValues);
+  valueDecoder_.next(indices_.data(), numValues);
+  for (auto i = 0; i < numValues; ++i) {
+    VELOX_DCHECK_LT(indices_[i], dictionarySize_);
+  }
+  switch (valueSize_) {
+    case 4:
+      gather(
+          dictionary_->as<int32_t>(),
+          indices_.data(),
+          numValues,
+          reinterpret_cast<int32_t*>(values));
+      break;
+    case 8:
+      gather(
+          dictionary_->as<int64_t>(),
+          indices_.data(),
+          numValues,
+          reinterpret_cast<int64_t*>(values));
+      break;
+    default:
+      gather(
+          dictionary_->as<folly::StringPiece>(),
+          indices_.data(),
+          numValues,
+          reinterpret_cast<folly::StringPiece*>(values));
+  }
+}
+
+void PageReader::skipValues(int32_t numValues) {
+  if (isDictionary_ || isRleBoolean_) {
+    valueDecoder_.skip(numValues);
+    return;
+  }
+  switch (type_) {
+    case Type::BOOLEAN:
+      boolBitOffset_ += numValues;
+      break;
+    case Type::BYTE_ARRAY:
+      for (auto i = 0; i < numValues; ++i) {
+        pageData_ += sizeof(uint32_t) + readUint32(pageData_);
+      }
+      VELOX_CHECK_LE(pageData_, pageEnd_);
+      break;
+    default:
+      pageData_ += numValues * valueSize_;
+  }
+}
+
+void PageReader::skip(int64_t numRows) {
+  if (numRows >= rowsLeftInPage_) {
+    auto targetRow = row_ + numRows;
+    seekToRun(targetRow);
+    numRows = targetRow - row_;
+  }
+  while (numRows > 0) {
+    if (!rowsLeftInPage_) {
+      readNextPage(numRows);
+      continue;
+    }
+    int32_t count = std::min<int64_t>(numRows, rowsLeftInPage_);
+    int32_t numValues = count;
+    if (maxDefine_ > 0) {
+      tempNulls_.resize(bits::nwords(count));
+      numValues =
+          defineDecoder_.readNulls(tempNulls_.data(), 0, count, maxDefine_);
+    }
+    skipValues(numValues);
+    rowsLeftInPage_ -= count;
+    row_ += count;
+    numRows -= count;
+  }
+}
+
+int32_t PageReader::readRows(int32_t numRows, uint64_t* nulls, void* values) {
+  VELOX_CHECK(nulls || !maxDefine_);
+  retainedPages_.clear();
+  auto rawValues = reinterpret_cast<char*>(values);
+  int32_t numValues = 0;
+  int32_t row = 0;
+  while (row < numRows) {
+    if (!rowsLeftInPage_) {
+      seekToRun(row_);
+      int64_t noSkip = 0;
+      readNextPage(noSkip);
+      continue;
+    }
+    auto count = std::min(numRows - row, rowsLeftInPage_);
+    auto numNonNulls = count;
+    if (maxDefine_ > 0) {
+      numNonNulls = defineDecoder_.readNulls(nulls, row, count, maxDefine_);
+    } else if (nulls) {
+      bits::fillBits(nulls, row, row + count, bits::kNotNull);
+    }
+    readValues(numNonNulls, rawValues + numValues * valueSize_);
+    numValues += numNonNulls;
+    rowsLeftInPage_ -= count;
+    row_ += count;
+    row += count;
+  }
+  return numValues;
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/common/base/RawVector.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/dwio/common/SeekableInputStream.h"
+#include "velox/dwio/parquet/reader/Metadata.h"
+#include "velox/dwio/parquet/reader/RleBpDecoder.h"
+
+namespace facebook::velox::parquet {
+
+// A run of consecutive data pages of a column chunk. 'firstRow' is the row
+// number of the first page of the run in the row group.
+struct PageRun {
+  int64_t firstRow;
+  std::unique_ptr<dwio::common::SeekableInputStream> input;
+};
+
+// Reads the pages of a column chunk of a flat column. Decodes the
+// definition levels into null flags and the values into a dense array
+// of the non-null values. Supports data pages V1 and V2 with PLAIN,
+// dictionary and RLE boolean encodings.
+class PageReader {
+ public:
+  PageReader(
+      std::unique_ptr<dwio::common::SeekableInputStream> stream,
+      memory::MemoryPool& pool,
+      thrift::Type type,
+      thrift::CompressionCodec codec,
+      int16_t maxDefine);
+
+  // Reads a column chunk of which only the data pages in 'runs' are
+  // loaded. Rows before the first run and between runs may only be
+  // skipped. 'dictionaryInput' has the dictionary page of the chunk, or
+  // is nullptr if the chunk has no dictionary.
+  PageReader(
+      std::unique_ptr<dwio::common::SeekableInputStream> dictionaryInput,
+      std::vector<PageRun> runs,
+      memory::MemoryPool& pool,
+      thrift::Type type,
+      thrift::CompressionCodec codec,
+      int16_t maxDefine);
+
+  // Returns the width of a value produced by readRows(). BOOLEAN
+  // values are one byte each and BYTE_ARRAY values are
+  // folly::StringPieces.
+  int32_t valueSize() const {
+    return valueSize_;
+  }
+
+  int16_t maxDefine() const {
+    return maxDefine_;
+  }
+
+  // Skips 'numRows' rows. Pages that are entirely skipped are not
+  // decompressed. Page runs that are entirely skipped are not read.
+  void skip(int64_t numRows);
+
+  // Decodes the next 'numRows' rows. Sets the bits of 'nulls' for
+  // non-null rows. 'nulls' may be nullptr if maxDefine() is 0. Writes
+  // the non-null values to consecutive positions of 'values', which
+  // must have space for 'numRows' values of valueSize(). Returns the
+  // number of non-null values. String values stay valid until the
+  // next call to readRows().
+  int32_t readRows(int32_t numRows, uint64_t* nulls, void* values);
+
+ private:
+  // Reads page headers until the next data page and prepares it for
+  // decoding. Data pages that are fully covered by 'rowsToSkip' are
+  // skipped without decoding and their rows are subtracted from
+  // 'rowsToSkip'. Returns without preparing a page if this brings
+  // 'rowsToSkip' to 0.
+  void readNextPage(int64_t& rowsToSkip);
+
+  // Moves to the last page run that starts at or before 'row' if this
+  // is after the current run.
+  void seekToRun(int64_t row);
+
+  void readDictionaryPage();
+
+  void prepareDataPage(const thrift::PageHeader& header);
+
+  void prepareDictionary(const thrift::PageHeader& header);
+
+  // Returns the uncompressed contents of the page described by
+  // 'header'. The data is copied to 'buffer' unless 'mayReference' is
+  // true and the page is uncompressed and contiguous in the input, in
+  // which case the input buffer is returned.
+  const char* readPageData(
+      const thrift::PageHeader& header,
+      BufferPtr& buffer,
+      bool mayReference);
+
+  // Decodes 'numValues' PLAIN encoded values starting at 'data' into
+  // 'values'. Advances 'data' past the decoded values.
+  void decodePlain(
+      const char*& data,
+      const char* end,
+      int32_t numValues,
+      char* values);
+
+  void readValues(int32_t numValues, char* values);
+
+  void skipValues(int32_t numValues);
+
+  std::unique_ptr<dwio::common::SeekableInputStream> dictionaryInput_;
+  std::vector<PageRun> runs_;
+
+  // Index of the first run in 'runs_' that has not been started.
+  int32_t nextRun_{0};
+
+  // Input of the current page run.
+  std::unique_ptr<dwio::common::SeekableInputStream> input_;
+  const char* bufferStart_{nullptr};
+  const char* bufferEnd_{nullptr};
+  memory::MemoryPool& pool_;
+  const thrift::Type type_;
+  const thrift::CompressionCodec codec_;
+  const int16_t maxDefine_;
+  const int32_t valueSize_;
+
+  // Row number of the next row to read or skip.
+  int64_t row_{0};
+
+  // Number of rows not yet read or skipped in the current data page.
+  int32_t rowsLeftInPage_{0};
+
+  RleBpDecoder defineDecoder_;
+
+  // True if the current page has dictionary indices in 'valueDecoder_'.
+  bool isDictionary_{false};
+
+  // True if the current page has RLE booleans in 'valueDecoder_'.
+  bool isRleBoolean_{false};
+
+  RleBpDecoder valueDecoder_;
+
+  // Position of the next PLAIN value in the current page and end of the
+  // page.
+  const char* pageData_{nullptr};
+  const char* pageEnd_{nullptr};
+
+  // Bit offset from 'pageData_' of the next PLAIN boolean.
+  uint64_t boolBitOffset_{0};
+
+  // Uncompressed data of the current page if not referenced from the
+  // input.
+  BufferPtr pageBuffer_;
+
+  // Compressed data of a page that is not contiguous in the input.
+  BufferPtr compressedBuffer_;
+
+  // Pages referenced by string values returned from the last
+  // readRows().
+  std::vector<BufferPtr> retainedPages_;
+
+  // Decoded dictionary values and the page that backs string values.
+  BufferPtr dictionary_;
+  BufferPtr dictionaryPage_;
+  int32_t dictionarySize_{0};
+
+  // Scratch for dictionary indices and for the nulls of skipped rows.
+  raw_vector<int32_t> indices_;
+  raw_vector<uint64_t> tempNulls_;
+};
+
+} // namespace facebook::velox::parquet
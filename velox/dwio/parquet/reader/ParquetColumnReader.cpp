@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ParquetColumnReader.h"
+
+namespace facebook::velox::parquet {
+
+using dwio::common::TypeWithId;
+
+std::unique_ptr<dwrf::SelectiveColumnReader> ParquetColumnReader::build(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    RowGroupStreams& streams,
+    common::ScanSpec* scanSpec) {
+  switch (dataType->type->kind()) {
+    case TypeKind::ROW:
+      return std::make_unique<ParquetStructColumnReader>(
+          requestedType, dataType, streams, scanSpec);
+    case TypeKind::BOOLEAN:
+      return std::make_unique<ParquetLeafColumnReader<int8_t>>(
+          requestedType, dataType, streams, scanSpec);
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      return std::make_unique<ParquetLeafColumnReader<int32_t>>(
+          requestedType, dataType, streams, scanSpec);
+    case TypeKind::BIGINT:
+      return std::make_unique<ParquetLeafColumnReader<int64_t>>(
+          requestedType, dataType, streams, scanSpec);
+    case TypeKind::REAL:
+      return std::make_unique<ParquetLeafColumnReader<float>>(
+          requestedType, dataType, streams, scanSpec);
+    case TypeKind::DOUBLE:
+      return std::make_unique<ParquetLeafColumnReader<double>>(
+          requestedType, dataType, streams, scanSpec);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return std::make_unique<ParquetLeafColumnReader<folly::StringPiece>>(
+          requestedType, dataType, streams, scanSpec);
+    default:
+      VELOX_NYI(
+          "Parquet reader does not support type {}",
+          dataType->type->toString());
+  }
+}
+
+ParquetStructColumnReader::ParquetStructColumnReader(
+    const std::shared_ptr<const TypeWithId>& requestedType,
+    const std::shared_ptr<const TypeWithId>& dataType,
+    RowGroupStreams& streams,
+    common::ScanSpec* scanSpec)
+    : SelectiveStructColumnReader(
+          streams.pool(),
+          requestedType,
+          dataType,
+          scanSpec) {
+  VELOX_CHECK_EQ(
+      dataType->id, 0, "Nested Parquet structs are not supported");
+  auto& childSpecs = scanSpec->children();
+  for (auto i = 0; i < childSpecs.size(); ++i) {
+    auto childSpec = childSpecs[i].get();
+    if (childSpec->isConstant()) {
+      continue;
+    }
+    auto childDataType = nodeType_->childByName(childSpec->fieldName());
+    auto childRequestedType =
+        requestedType_->childByName(childSpec->fieldName());
+    children_.push_back(ParquetColumnReader::build(
+        childRequestedType, childDataType, streams, childSpec));
+    childSpec->setSubscript(children_.size() - 1);
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/dwrf/reader/SelectiveColumnReaderInternal.h"
+#include "velox/dwio/dwrf/reader/SelectiveStructColumnReader.h"
+#include "velox/dwio/parquet/reader/PageReader.h"
+
+namespace facebook::velox::parquet {
+
+// Supplies the column readers of a row group with the pages of their
+// column chunks. Corresponds to dwrf::StripeStreams.
+class RowGroupStreams {
+ public:
+  virtual ~RowGroupStreams() = default;
+
+  virtual memory::MemoryPool& pool() const = 0;
+
+  // Returns a reader for the column chunk of the top level column
+  // 'column.column'.
+  virtual std::unique_ptr<PageReader> pageReader(
+      const dwio::common::TypeWithId& column) = 0;
+};
+
+class ParquetColumnReader {
+ public:
+  // Creates a reader for the column 'dataType' of the row group in
+  // 'streams'. Only flat columns and the root struct are supported.
+  static std::unique_ptr<dwrf::SelectiveColumnReader> build(
+      const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+      RowGroupStreams& streams,
+      common::ScanSpec* scanSpec);
+};
+
+class ParquetStructColumnReader : public dwrf::SelectiveStructColumnReader {
+ public:
+  ParquetStructColumnReader(
+      const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+      RowGroupStreams& streams,
+      common::ScanSpec* scanSpec);
+};
+
+// Reads a flat column from a Parquet column chunk. 'T' is the type of
+// the decoded values: int8_t for BOOLEAN, int32_t, int64_t, float,
+// double or folly::StringPiece for BYTE_ARRAY. Definition levels and
+// values are decoded together for the read range by readNulls(), after
+// which filters and value extraction run over the dense non-null values.
+template <typename T>
+class ParquetLeafColumnReader : public dwrf::SelectiveColumnReader {
+ public:
+  ParquetLeafColumnReader(
+      const std::shared_ptr<const dwio::common::TypeWithId>& requestedType,
+      const std::shared_ptr<const dwio::common::TypeWithId>& dataType,
+      RowGroupStreams& streams,
+      common::ScanSpec* scanSpec)
+      : SelectiveColumnReader(
+            streams.pool(),
+            requestedType,
+            scanSpec,
+            dataType->type),
+        pageReader_(streams.pageReader(*dataType)) {
+    VELOX_CHECK_EQ(pageReader_->valueSize(), sizeof(T));
+  }
+
+  bool hasBulkPath() const override {
+    return false;
+  }
+
+  uint64_t skip(uint64_t numValues) override {
+    pageReader_->skip(numValues);
+    return numValues;
+  }
+
+  void read(vector_size_t offset, RowSet rows, const uint64_t* incomingNulls)
+      override;
+
+  void getValues(RowSet rows, VectorPtr* result) override;
+
+ protected:
+  bool mayHaveNulls() const override {
+    return pageReader_->maxDefine() > 0;
+  }
+
+  void readNulls(
+      vector_size_t numValues,
+      const uint64_t* incomingNulls,
+      VectorPtr* result,
+      BufferPtr& nulls) override;
+
+ private:
+  template <bool hasNulls, typename TVisitor>
+  void decode(const uint64_t* nulls, TVisitor& visitor);
+
+  template <typename TVisitor>
+  void readWithVisitor(RowSet rows, TVisitor visitor);
+
+  template <typename TFilter, bool isDense, typename ExtractValues>
+  void readHelper(common::Filter* filter, RowSet rows, ExtractValues values);
+
+  template <bool isDense, typename ExtractValues>
+  void processFilter(
+      common::Filter* filter,
+      RowSet rows,
+      ExtractValues extractValues);
+
+  std::unique_ptr<PageReader> pageReader_;
+
+  // The non-null values of the read range, decoded by readNulls().
+  BufferPtr decodedValues_;
+};
+
+template <typename T>
+void ParquetLeafColumnReader<T>::readNulls(
+    vector_size_t numValues,
+    const uint64_t* incomingNulls,
+    VectorPtr* /*result*/,
+    BufferPtr& nulls) {
+  VELOX_CHECK(!incomingNulls, "Nested Parquet columns are not supported");
+  dwrf::detail::ensureCapacity<T>(decodedValues_, numValues, &memoryPool_);
+  if (!mayHaveNulls()) {
+    nulls = nullptr;
+    pageReader_->readRows(
+        numValues, nullptr, decodedValues_->asMutable<T>());
+    return;
+  }
+  auto numBytes = bits::nbytes(numValues);
+  if (!nulls || nulls->capacity() < numBytes) {
+    nulls = AlignedBuffer::allocate<char>(numBytes, &memoryPool_);
+  }
+  nulls->setSize(numBytes);
+  auto numNonNulls = pageReader_->readRows(
+      numValues, nulls->asMutable<uint64_t>(), decodedValues_->asMutable<T>());
+  if (numNonNulls == numValues) {
+    nulls = nullptr;
+  }
+}
+
+template <typename T>
+template <bool hasNulls, typename TVisitor>
+void ParquetLeafColumnReader<T>::decode(
+    const uint64_t* nulls,
+    TVisitor& visitor) {
+  auto values = decodedValues_->as<T>();
+  int32_t current = visitor.start();
+  // Index in 'values' of the value of row 'current'.
+  int32_t valueIndex =
+      hasNulls ? bits::countNonNulls(nulls, 0, current) : current;
+  bool atEnd = false;
+  bool allowNulls = hasNulls && visitor.allowNulls();
+  for (;;) {
+    int32_t toSkip;
+    if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+      toSkip = visitor.processNull(atEnd);
+    } else {
+      if (hasNulls && !allowNulls) {
+        toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+        if (!TVisitor::dense) {
+          valueIndex += toSkip;
+        }
+        if (atEnd) {
+          return;
+        }
+      }
+      toSkip = visitor.process(values[valueIndex++], atEnd);
+    }
+    ++current;
+    if (toSkip) {
+      valueIndex += hasNulls
+          ? bits::countNonNulls(nulls, current, current + toSkip)
+          : toSkip;
+      current += toSkip;
+    }
+    if (atEnd) {
+      return;
+    }
+  }
+}
+
+template <typename T>
+template <typename TVisitor>
+void ParquetLeafColumnReader<T>::readWithVisitor(
+    RowSet rows,
+    TVisitor visitor) {
+  if (nullsInReadRange_) {
+    decode<true>(nullsInReadRange_->as<uint64_t>(), visitor);
+  } else {
+    decode<false>(nullptr, visitor);
+  }
+}
+
+template <typename T>
+template <typename TFilter, bool isDense, typename ExtractValues>
+void ParquetLeafColumnReader<T>::readHelper(
+    common::Filter* filter,
+    RowSet rows,
+    ExtractValues extractValues) {
+  readWithVisitor(
+      rows,
+      dwrf::ColumnVisitor<T, TFilter, ExtractValues, isDense>(
+          *reinterpret_cast<TFilter*>(filter), this, rows, extractValues));
+}
+
+template <typename T>
+template <bool isDense, typename ExtractValues>
+void ParquetLeafColumnReader<T>::processFilter(
+    common::Filter* filter,
+    RowSet rows,
+    ExtractValues extractValues) {
+  constexpr bool isDrop =
+      std::is_same<decltype(extractValues), dwrf::DropValues>::value;
+  switch (filter ? filter->kind() : common::FilterKind::kAlwaysTrue) {
+    case common::FilterKind::kAlwaysTrue:
+      readHelper<common::AlwaysTrue, isDense>(filter, rows, extractValues);
+      return;
+    case common::FilterKind::kIsNull:
+      filterNulls<T>(rows, true, !isDrop);
+      return;
+    case common::FilterKind::kIsNotNull:
+      if (isDrop) {
+        filterNulls<T>(rows, false, false);
+      } else {
+        readHelper<common::IsNotNull, isDense>(filter, rows, extractValues);
+      }
+      return;
+    case common::FilterKind::kBigintRange:
+      if constexpr (std::is_integral_v<T>) {
+        readHelper<common::BigintRange, isDense>(filter, rows, extractValues);
+        return;
+      }
+      break;
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      if constexpr (std::is_integral_v<T>) {
+        readHelper<common::BigintValuesUsingHashTable, isDense>(
+            filter, rows, extractValues);
+        return;
+      }
+      break;
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      if constexpr (std::is_integral_v<T>) {
+        readHelper<common::BigintValuesUsingBitmask, isDense>(
+            filter, rows, extractValues);
+        return;
+      }
+      break;
+    case common::FilterKind::kDoubleRange:
+    case common::FilterKind::kFloatRange:
+      if constexpr (std::is_floating_point_v<T>) {
+        readHelper<common::FloatingPointRange<T>, isDense>(
+            filter, rows, extractValues);
+        return;
+      }
+      break;
+    case common::FilterKind::kBytesRange:
+      if constexpr (std::is_same_v<T, folly::StringPiece>) {
+        readHelper<common::BytesRange, isDense>(filter, rows, extractValues);
+        return;
+      }
+      break;
+    case common::FilterKind::kBytesValues:
+      if constexpr (std::is_same_v<T, folly::StringPiece>) {
+        readHelper<common::BytesValues, isDense>(filter, rows, extractValues);
+        return;
+      }
+      break;
+    default:
+      break;
+  }
+  readHelper<common::Filter, isDense>(filter, rows, extractValues);
+}
+
+template <typename T>
+void ParquetLeafColumnReader<T>::read(
+    vector_size_t offset,
+    RowSet rows,
+    const uint64_t* incomingNulls) {
+  // Nulls and values are decoded together, so skipping to 'offset' goes
+  // through the page reader also when only nulls are needed.
+  seekTo(offset, false);
+  prepareRead<T>(offset, rows, incomingNulls);
+  bool isDense = rows.back() == rows.size() - 1;
+  if (scanSpec_->keepValues()) {
+    if (scanSpec_->valueHook()) {
+      if (isDense) {
+        readHelper<common::AlwaysTrue, true>(
+            &dwrf::alwaysTrue(),
+            rows,
+            dwrf::ExtractToGenericHook(scanSpec_->valueHook()));
+      } else {
+        readHelper<common::AlwaysTrue, false>(
+            &dwrf::alwaysTrue(),
+            rows,
+            dwrf::ExtractToGenericHook(scanSpec_->valueHook()));
+      }
+    } else if (isDense) {
+      processFilter<true>(
+          scanSpec_->filter(), rows, dwrf::ExtractToReader(this));
+    } else {
+      processFilter<false>(
+          scanSpec_->filter(), rows, dwrf::ExtractToReader(this));
+    }
+  } else {
+    if (isDense) {
+      processFilter<true>(scanSpec_->filter(), rows, dwrf::DropValues());
+    } else {
+      processFilter<false>(scanSpec_->filter(), rows, dwrf::DropValues());
+    }
+  }
+  // All rows up to the last of 'rows' were consumed by readNulls().
+  readOffset_ = offset + rows.back() + 1;
+}
+
+template <typename T>
+void ParquetLeafColumnReader<T>::getValues(RowSet rows, VectorPtr* result) {
+  if constexpr (std::is_same_v<T, folly::StringPiece>) {
+    rawStringBuffer_ = nullptr;
+    rawStringSize_ = 0;
+    rawStringUsed_ = 0;
+    getFlatValues<StringView, StringView>(rows, result, type_);
+  } else if constexpr (std::is_same_v<T, int8_t>) {
+    getFlatValues<int8_t, bool>(rows, result);
+  } else if constexpr (std::is_floating_point_v<T>) {
+    getFlatValues<T, T>(rows, result);
+  } else {
+    auto& requestedType = nodeType_->type;
+    switch (requestedType->kind()) {
+      case TypeKind::TINYINT:
+        getFlatValues<T, int8_t>(rows, result, requestedType);
+        break;
+      case TypeKind::SMALLINT:
+        getFlatValues<T, int16_t>(rows, result, requestedType);
+        break;
+      case TypeKind::INTEGER:
+        getFlatValues<T, int32_t>(rows, result, requestedType);
+        break;
+      case TypeKind::BIGINT:
+        getFlatValues<T, int64_t>(rows, result, requestedType);
+        break;
+      case TypeKind::DATE:
+        getFlatValues<T, Date>(rows, result, requestedType);
+        break;
+      default:
+        VELOX_FAIL(
+            "Unsupported requested type for Parquet integer column: {}",
+            requestedType->toString());
+    }
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,565 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+
+#include "velox/dwio/common/StreamUtil.h"
+#include "velox/dwio/parquet/reader/Statistics.h"
+
+namespace facebook::velox::parquet {
+
+using dwio::common::LogType;
+using dwio::common::TypeWithId;
+using thrift::ConvertedType;
+
+namespace {
+
+constexpr const char* kMagic = "PAR1";
+constexpr int32_t kMagicSize = 4;
+
+TypePtr toVeloxType(const thrift::SchemaElement& element) {
+  VELOX_CHECK(
+      element.type.has_value(),
+      "Nested Parquet column {} is not supported",
+      element.name);
+  auto converted = element.convertedType;
+  switch (element.type.value()) {
+    case thrift::Type::BOOLEAN:
+      return BOOLEAN();
+    case thrift::Type::INT32:
+      if (converted == ConvertedType::DATE) {
+        return DATE();
+      }
+      if (converted == ConvertedType::INT_8) {
+        return TINYINT();
+      }
+      if (converted == ConvertedType::INT_16) {
+        return SMALLINT();
+      }
+      if (!converted.has_value() || converted == ConvertedType::INT_32) {
+        return INTEGER();
+      }
+      break;
+    case thrift::Type::INT64:
+      if (!converted.has_value() || converted == ConvertedType::INT_64) {
+        return BIGINT();
+      }
+      break;
+    case thrift::Type::FLOAT:
+      return REAL();
+    case thrift::Type::DOUBLE:
+      return DOUBLE();
+    case thrift::Type::BYTE_ARRAY:
+      if (converted == ConvertedType::UTF8 ||
+          converted == ConvertedType::JSON ||
+          converted == ConvertedType::ENUM) {
+        return VARCHAR();
+      }
+      if (!converted.has_value()) {
+        return VARBINARY();
+      }
+      break;
+    default:
+      break;
+  }
+  VELOX_NYI(
+      "Parquet column {} of physical type {} and converted type {} is not supported",
+      element.name,
+      static_cast<int>(element.type.value()),
+      converted.has_value() ? static_cast<int>(converted.value()) : -1);
+}
+
+// Returns the offset of the first page of 'chunk'.
+int64_t chunkStart(const thrift::ColumnMetaData& chunk) {
+  if (chunk.dictionaryPageOffset.has_value() &&
+      chunk.dictionaryPageOffset.value() > 0) {
+    return std::min(chunk.dictionaryPageOffset.value(), chunk.dataPageOffset);
+  }
+  return chunk.dataPageOffset;
+}
+
+int64_t rowGroupStart(const thrift::RowGroup& rowGroup) {
+  if (rowGroup.fileOffset.has_value() && rowGroup.fileOffset.value() > 0) {
+    return rowGroup.fileOffset.value();
+  }
+  VELOX_CHECK(!rowGroup.columns.empty());
+  return chunkStart(rowGroup.columns[0].metaData.value());
+}
+
+// Returns false if no value in a range described by 'stats' passes
+// 'filter'.
+bool testStatistics(
+    common::Filter* filter,
+    dwio::common::ColumnStatistics* stats,
+    int64_t numRows,
+    const TypePtr& type) {
+  // Dates are compared as integers.
+  return common::testFilter(
+      filter,
+      stats,
+      numRows,
+      type->kind() == TypeKind::DATE ? INTEGER() : type);
+}
+
+} // namespace
+
+ParquetRowReader::ParquetRowReader(
+    const ParquetReader& reader,
+    const dwio::common::RowReaderOptions& options)
+    : reader_(reader), scanSpec_(options.getScanSpec()) {
+  auto selector = options.getSelector();
+  if (!selector) {
+    selector =
+        std::make_shared<dwio::common::ColumnSelector>(reader_.rowType());
+  }
+  requestedType_ = selector->getSchemaWithId();
+  outputType_ = selector->buildSelectedReordered();
+  if (!scanSpec_) {
+    scanSpec_ = std::make_shared<common::ScanSpec>("root");
+    for (auto i = 0; i < outputType_->size(); ++i) {
+      auto child =
+          scanSpec_->getOrCreateChild(common::Subfield(outputType_->nameOf(i)));
+      child->setProjectOut(true);
+      child->setChannel(i);
+    }
+  }
+
+  auto& rowGroups = reader_.metadata().rowGroups;
+  auto splitEnd = options.getOffset() + options.getLength();
+  for (auto i = 0; i < rowGroups.size(); ++i) {
+    auto start = rowGroupStart(rowGroups[i]);
+    if (start >= options.getOffset() && start < splitEnd) {
+      rowGroups_.push_back(i);
+    }
+  }
+}
+
+memory::MemoryPool& ParquetRowReader::pool() const {
+  return reader_.memoryPool();
+}
+
+std::unique_ptr<PageReader> ParquetRowReader::pageReader(
+    const TypeWithId& column) {
+  auto it = chunkInputs_.find(column.column);
+  VELOX_CHECK(
+      it != chunkInputs_.end(),
+      "Column chunk {} is not loaded",
+      column.column);
+  auto& element = reader_.schemaElement(column.column);
+  auto& chunk = reader_.metadata()
+                    .rowGroups[rowGroups_[nextRowGroup_ - 1]]
+                    .columns[column.column]
+                    .metaData.value();
+  int16_t maxDefine =
+      element.repetitionType == thrift::FieldRepetitionType::REQUIRED ? 0 : 1;
+  return std::make_unique<PageReader>(
+      std::move(it->second.dictionary),
+      std::move(it->second.runs),
+      reader_.memoryPool(),
+      chunk.type,
+      chunk.codec,
+      maxDefine);
+}
+
+bool ParquetRowReader::testRowGroup(const thrift::RowGroup& rowGroup) const {
+  auto& fileType = *reader_.typeWithId();
+  for (auto& childSpec : scanSpec_->children()) {
+    if (childSpec->isConstant() || !childSpec->filter()) {
+      continue;
+    }
+    auto column = fileType.childByName(childSpec->fieldName());
+    auto& chunk = rowGroup.columns[column->column].metaData.value();
+    if (!chunk.statistics.has_value()) {
+      continue;
+    }
+    auto stats = buildColumnStatistics(
+        chunk.statistics.value(), column->type, rowGroup.numRows);
+    if (!testStatistics(
+            childSpec->filter(), stats.get(), rowGroup.numRows, column->type)) {
+      VLOG(1) << "Drop row group on " << childSpec->toString();
+      return false;
+    }
+  }
+  return true;
+}
+
+void ParquetRowReader::filterPages(const thrift::RowGroup& rowGroup) {
+  rowRanges_ = {{0, rowGroup.numRows}};
+  nextRowRange_ = 0;
+  offsetIndices_.clear();
+  auto& fileType = *reader_.typeWithId();
+  std::vector<common::ScanSpec*> filteredSpecs;
+  for (auto& childSpec : scanSpec_->children()) {
+    if (childSpec->isConstant() || !childSpec->filter()) {
+      continue;
+    }
+    auto column = fileType.childByName(childSpec->fieldName())->column;
+    auto& chunk = rowGroup.columns[column];
+    if (chunk.columnIndexOffset.has_value() &&
+        chunk.columnIndexLength.has_value() &&
+        chunk.offsetIndexOffset.has_value() &&
+        chunk.offsetIndexLength.has_value()) {
+      filteredSpecs.push_back(childSpec.get());
+    }
+  }
+  if (filteredSpecs.empty()) {
+    return;
+  }
+
+  // The offset indices of all columns are read so that the pages of
+  // unfiltered columns can be skipped too.
+  auto input = reader_.bufferedInputFactory().create(
+      reader_.stream(), reader_.memoryPool(), reader_.fileNum());
+  std::unordered_map<
+      uint32_t,
+      std::unique_ptr<dwio::common::SeekableInputStream>>
+      offsetIndexInputs;
+  for (auto& childSpec : scanSpec_->children()) {
+    if (childSpec->isConstant()) {
+      continue;
+    }
+    auto column = fileType.childByName(childSpec->fieldName())->column;
+    auto& chunk = rowGroup.columns[column];
+    if (chunk.offsetIndexOffset.has_value() &&
+        chunk.offsetIndexLength.has_value()) {
+      offsetIndexInputs[column] = input->enqueue(
+          {static_cast<uint64_t>(chunk.offsetIndexOffset.value()),
+           static_cast<uint64_t>(chunk.offsetIndexLength.value())});
+    }
+  }
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>>
+      columnIndexInputs;
+  for (auto* childSpec : filteredSpecs) {
+    auto column = fileType.childByName(childSpec->fieldName())->column;
+    auto& chunk = rowGroup.columns[column];
+    columnIndexInputs.push_back(input->enqueue(
+        {static_cast<uint64_t>(chunk.columnIndexOffset.value()),
+         static_cast<uint64_t>(chunk.columnIndexLength.value())}));
+  }
+  input->load(LogType::STRIPE_INDEX);
+  for (auto& [column, offsetIndexInput] : offsetIndexInputs) {
+    offsetIndices_[column] = thrift::readOffsetIndex(*offsetIndexInput);
+  }
+
+  for (auto i = 0; i < filteredSpecs.size(); ++i) {
+    auto* childSpec = filteredSpecs[i];
+    auto column = fileType.childByName(childSpec->fieldName());
+    auto it = offsetIndices_.find(column->column);
+    if (it == offsetIndices_.end()) {
+      continue;
+    }
+    auto& pages = it->second.pageLocations;
+    auto columnIndex = thrift::readColumnIndex(*columnIndexInputs[i]);
+    VELOX_CHECK_EQ(
+        pages.size(),
+        columnIndex.nullPages.size(),
+        "Parquet column index and offset index do not match");
+    // Intersects the rows of the pages that may pass with 'rowRanges_'.
+    std::vector<RowRange> ranges;
+    auto range = rowRanges_.begin();
+    for (auto page = 0; page < pages.size(); ++page) {
+      int64_t begin = pages[page].firstRowIndex;
+      int64_t end = page + 1 < pages.size() ? pages[page + 1].firstRowIndex
+                                            : rowGroup.numRows;
+      auto stats =
+          buildPageStatistics(columnIndex, page, column->type, end - begin);
+      if (testStatistics(
+              childSpec->filter(), stats.get(), end - begin, column->type)) {
+        continue;
+      }
+      // The page cannot pass. Removes its rows.
+      for (; range != rowRanges_.end() && range->begin < end; ++range) {
+        if (range->end <= begin) {
+          ranges.push_back(*range);
+          continue;
+        }
+        if (range->begin < begin) {
+          ranges.push_back({range->begin, begin});
+        }
+        if (range->end > end) {
+          // Keeps the part after the page for the next pages.
+          range->begin = end;
+          break;
+        }
+      }
+    }
+    ranges.insert(ranges.end(), range, rowRanges_.end());
+    rowRanges_ = std::move(ranges);
+  }
+}
+
+void ParquetRowReader::enqueueChunk(
+    const thrift::ColumnChunk& chunk,
+    uint32_t column) {
+  auto& metaData = chunk.metaData.value();
+  auto start = chunkStart(metaData);
+  dwio::common::StreamIdentifier streamId(column);
+  auto& chunkInput = chunkInputs_[column];
+  auto it = offsetIndices_.find(column);
+  if (it == offsetIndices_.end() || it->second.pageLocations.empty()) {
+    chunkInput.runs.push_back(
+        {0,
+         input_->enqueue(
+             {static_cast<uint64_t>(start),
+              static_cast<uint64_t>(metaData.totalCompressedSize)},
+             &streamId)});
+    return;
+  }
+  auto& pages = it->second.pageLocations;
+  if (pages[0].offset > start) {
+    chunkInput.dictionary = input_->enqueue(
+        {static_cast<uint64_t>(start),
+         static_cast<uint64_t>(pages[0].offset - start)},
+        &streamId);
+  }
+  auto range = rowRanges_.begin();
+  auto overlapsRange = [&](int32_t page) {
+    int64_t begin = pages[page].firstRowIndex;
+    int64_t end = page + 1 < pages.size() ? pages[page + 1].firstRowIndex
+                                          : rowsInRowGroup_;
+    while (range != rowRanges_.end() && range->end <= begin) {
+      ++range;
+    }
+    return range != rowRanges_.end() && range->begin < end;
+  };
+  for (auto page = 0; page < pages.size();) {
+    if (!overlapsRange(page)) {
+      ++skippedPages_;
+      ++page;
+      continue;
+    }
+    // Loads the consecutive pages that have rows in 'rowRanges_' in one
+    // run.
+    auto firstPage = page;
+    do {
+      ++page;
+    } while (page < pages.size() && overlapsRange(page));
+    auto& lastPage = pages[page - 1];
+    chunkInput.runs.push_back(
+        {pages[firstPage].firstRowIndex,
+         input_->enqueue(
+             {static_cast<uint64_t>(pages[firstPage].offset),
+              static_cast<uint64_t>(
+                  lastPage.offset + lastPage.compressedPageSize -
+                  pages[firstPage].offset)},
+             &streamId)});
+  }
+}
+
+bool ParquetRowReader::startNextRowGroup() {
+  const thrift::RowGroup* rowGroup = nullptr;
+  while (!rowGroup) {
+    if (nextRowGroup_ >= rowGroups_.size()) {
+      return false;
+    }
+    auto& candidate =
+        reader_.metadata().rowGroups[rowGroups_[nextRowGroup_++]];
+    if (!testRowGroup(candidate)) {
+      ++skippedRowGroups_;
+      continue;
+    }
+    filterPages(candidate);
+    if (rowRanges_.empty()) {
+      ++skippedRowGroups_;
+      continue;
+    }
+    rowGroup = &candidate;
+  }
+  // The readers of the previous row group may be referenced by
+  // LazyVectors of the previous batch until now.
+  columnReader_.reset();
+  chunkInputs_.clear();
+  rowsInRowGroup_ = rowGroup->numRows;
+  rowsRead_ = 0;
+  input_ = reader_.bufferedInputFactory().create(
+      reader_.stream(), reader_.memoryPool(), reader_.fileNum());
+  auto& fileType = *reader_.typeWithId();
+  for (auto& childSpec : scanSpec_->children()) {
+    if (childSpec->isConstant()) {
+      continue;
+    }
+    auto column = fileType.childByName(childSpec->fieldName())->column;
+    enqueueChunk(rowGroup->columns[column], column);
+  }
+  input_->load(LogType::STRIPE);
+  columnReader_ = ParquetColumnReader::build(
+      requestedType_, reader_.typeWithId(), *this, scanSpec_.get());
+  columnReader_->setIsTopLevel();
+  return true;
+}
+
+uint64_t ParquetRowReader::next(uint64_t size, velox::VectorPtr& result) {
+  for (;;) {
+    if (rowsRead_ >= rowsInRowGroup_ && !startNextRowGroup()) {
+      return 0;
+    }
+    while (nextRowRange_ < rowRanges_.size() &&
+           rowRanges_[nextRowRange_].end <= rowsRead_) {
+      ++nextRowRange_;
+    }
+    if (nextRowRange_ < rowRanges_.size()) {
+      break;
+    }
+    rowsRead_ = rowsInRowGroup_;
+  }
+  auto& range = rowRanges_[nextRowRange_];
+  if (rowsRead_ < range.begin) {
+    // The column readers skip to the new position when they next read.
+    rowsRead_ = range.begin;
+    columnReader_->setReadOffset(rowsRead_);
+  }
+  auto rowsToRead = std::min<uint64_t>(size, range.end - rowsRead_);
+  if (!result) {
+    result = BaseVector::create(outputType_, 0, &reader_.memoryPool());
+  }
+  columnReader_->next(rowsToRead, result, nullptr);
+  rowsRead_ += rowsToRead;
+  return rowsToRead;
+}
+
+void ParquetRowReader::updateRuntimeStats(
+    dwio::common::RuntimeStatistics& stats) const {
+  stats.skippedStrides += skippedRowGroups_;
+  stats.skippedPages += skippedPages_;
+}
+
+void ParquetRowReader::resetFilterCaches() {
+  if (columnReader_) {
+    columnReader_->resetFilterCaches();
+  }
+}
+
+std::optional<size_t> ParquetRowReader::estimatedRowSize() const {
+  return std::nullopt;
+}
+
+ParquetReader::ParquetReader(
+    std::unique_ptr<dwio::common::InputStream> stream,
+    const dwio::common::ReaderOptions& options)
+    : stream_(std::move(stream)),
+      pool_(options.getMemoryPool()),
+      bufferedInputFactory_(
+          options.getBufferedInputFactory()
+              ? options.getBufferedInputFactory()
+              : dwio::common::BufferedInputFactory::baseFactoryShared()),
+      fileNum_(options.getFileNum()) {
+  readFooter();
+  makeType();
+}
+
+void ParquetReader::readFooter() {
+  uint64_t fileLength = stream_->getLength();
+  VELOX_CHECK_GE(
+      fileLength, 3 * kMagicSize, "Parquet file is too small: {}", fileLength);
+  auto input = bufferedInputFactory_->create(*stream_, pool_, fileNum_);
+  auto tailSize = std::min(fileLength, kFooterSizeGuess);
+  input->enqueue({fileLength - tailSize, tailSize});
+  input->load(LogType::FOOTER);
+
+  // The file ends with the footer length and the magic number.
+  char tail[sizeof(uint32_t) + kMagicSize];
+  {
+    auto tailStream =
+        input->read(fileLength - sizeof(tail), sizeof(tail), LogType::FOOTER);
+    const char* bufferStart = nullptr;
+    const char* bufferEnd = nullptr;
+    dwio::common::readBytes(
+        sizeof(tail), tailStream.get(), tail, bufferStart, bufferEnd);
+  }
+  VELOX_CHECK_EQ(
+      memcmp(tail + sizeof(uint32_t), kMagic, kMagicSize),
+      0,
+      "Not a Parquet file: {}",
+      stream_->getName());
+  uint32_t footerLength;
+  memcpy(&footerLength, tail, sizeof(footerLength));
+  VELOX_CHECK_LE(
+      footerLength + sizeof(tail) + kMagicSize,
+      fileLength,
+      "Corrupt Parquet footer length {}",
+      footerLength);
+  auto footerStream = input->read(
+      fileLength - sizeof(tail) - footerLength, footerLength, LogType::FOOTER);
+  metadata_ = thrift::readFileMetaData(*footerStream);
+}
+
+void ParquetReader::makeType() {
+  auto& schema = metadata_.schema;
+  VELOX_CHECK(!schema.empty(), "Parquet file has no schema");
+  VELOX_CHECK_EQ(
+      schema[0].numChildren + 1,
+      schema.size(),
+      "Nested Parquet schemas are not supported");
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  for (auto i = 1; i < schema.size(); ++i) {
+    VELOX_CHECK(
+        schema[i].repetitionType != thrift::FieldRepetitionType::REPEATED,
+        "Repeated Parquet column {} is not supported",
+        schema[i].name);
+    names.push_back(schema[i].name);
+    types.push_back(toVeloxType(schema[i]));
+  }
+  type_ = ROW(std::move(names), std::move(types));
+  typeWithId_ = TypeWithId::create(type_);
+}
+
+std::optional<uint64_t> ParquetReader::numberOfRows() const {
+  return metadata_.numRows;
+}
+
+std::unique_ptr<dwio::common::ColumnStatistics> ParquetReader::columnStatistics(
+    uint32_t index) const {
+  VELOX_CHECK_LT(index, metadata_.schema.size());
+  if (index == 0) {
+    return std::make_unique<dwio::common::ColumnStatistics>(
+        metadata_.numRows, std::nullopt, std::nullopt, std::nullopt);
+  }
+  // Node ids of a flat schema are 1 + the column index.
+  uint64_t numValues = 0;
+  uint64_t rawSize = 0;
+  uint64_t size = 0;
+  std::optional<bool> hasNull = false;
+  for (auto& rowGroup : metadata_.rowGroups) {
+    auto& chunk = rowGroup.columns[index - 1].metaData.value();
+    numValues += chunk.numValues;
+    rawSize += chunk.totalUncompressedSize;
+    size += chunk.totalCompressedSize;
+    if (!chunk.statistics.has_value() ||
+        !chunk.statistics->nullCount.has_value()) {
+      hasNull = std::nullopt;
+    } else if (hasNull.has_value() && chunk.statistics->nullCount.value()) {
+      hasNull = true;
+    }
+  }
+  return std::make_unique<dwio::common::ColumnStatistics>(
+      numValues, hasNull, rawSize, size);
+}
+
+const velox::RowTypePtr& ParquetReader::rowType() const {
+  return type_;
+}
+
+const std::shared_ptr<const TypeWithId>& ParquetReader::typeWithId() const {
+  return typeWithId_;
+}
+
+std::unique_ptr<dwio::common::RowReader> ParquetReader::createRowReader(
+    const dwio::common::RowReaderOptions& options) const {
+  return std::make_unique<ParquetRowReader>(*this, options);
+}
+
+} // namespace facebook::velox::parquet
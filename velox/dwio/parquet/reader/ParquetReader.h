@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/common/Reader.h"
+#include "velox/dwio/common/ReaderFactory.h"
+#include "velox/dwio/parquet/reader/Metadata.h"
+#include "velox/dwio/parquet/reader/ParquetColumnReader.h"
+
+namespace facebook::velox::parquet {
+
+class ParquetReader;
+
+// Reads the row groups of a split with SelectiveColumnReaders. The
+// column chunks of each row group are read through a BufferedInput
+// from the ReaderOptions' BufferedInputFactory, so that a caching
+// factory coalesces the reads and keeps the data in AsyncDataCache.
+//
+// Row groups whose column chunk statistics show that no row passes the
+// filters of the ScanSpec are skipped. If the filtered columns have a
+// page index, the pages that cannot pass are not read either.
+class ParquetRowReader : public dwio::common::RowReader,
+                         private RowGroupStreams {
+ public:
+  ParquetRowReader(
+      const ParquetReader& reader,
+      const dwio::common::RowReaderOptions& options);
+  ~ParquetRowReader() override = default;
+
+  uint64_t next(uint64_t size, velox::VectorPtr& result) override;
+
+  void updateRuntimeStats(
+      dwio::common::RuntimeStatistics& stats) const override;
+
+  void resetFilterCaches() override;
+
+  std::optional<size_t> estimatedRowSize() const override;
+
+ private:
+  // Half open range of rows of a row group.
+  struct RowRange {
+    int64_t begin;
+    int64_t end;
+  };
+
+  // The loaded parts of a column chunk.
+  struct ChunkInput {
+    // The dictionary page if only some data pages are loaded.
+    std::unique_ptr<dwio::common::SeekableInputStream> dictionary;
+    std::vector<PageRun> runs;
+  };
+
+  memory::MemoryPool& pool() const override;
+
+  std::unique_ptr<PageReader> pageReader(
+      const dwio::common::TypeWithId& column) override;
+
+  // Makes the reader for the next row group in 'rowGroups_' that may
+  // have rows passing the filters. Returns false if there are no more
+  // row groups.
+  bool startNextRowGroup();
+
+  // Returns false if the column chunk statistics of 'rowGroup' show
+  // that no row passes the filters.
+  bool testRowGroup(const thrift::RowGroup& rowGroup) const;
+
+  // Sets 'rowRanges_' to the rows of 'rowGroup' in pages that may pass
+  // the filters according to the page index. Reads the offset indices
+  // of the columns to read into 'offsetIndices_'.
+  void filterPages(const thrift::RowGroup& rowGroup);
+
+  // Enqueues the pages of the column chunk of 'column' that have rows
+  // in 'rowRanges_' on 'input_'.
+  void enqueueChunk(const thrift::ColumnChunk& chunk, uint32_t column);
+
+  const ParquetReader& reader_;
+  std::shared_ptr<const dwio::common::TypeWithId> requestedType_;
+  RowTypePtr outputType_;
+  std::shared_ptr<common::ScanSpec> scanSpec_;
+
+  // Indices of the row groups of the split.
+  std::vector<int32_t> rowGroups_;
+  int32_t nextRowGroup_{0};
+
+  // Rows of the current row group and the number of rows read from it.
+  int64_t rowsInRowGroup_{0};
+  int64_t rowsRead_{0};
+
+  // Rows of the current row group that may pass the filters and the
+  // index of the first range not fully read.
+  std::vector<RowRange> rowRanges_;
+  int32_t nextRowRange_{0};
+
+  // Offset indices of the columns of the current row group, if the page
+  // index is used.
+  std::unordered_map<uint32_t, thrift::OffsetIndex> offsetIndices_;
+
+  std::unique_ptr<dwio::common::BufferedInput> input_;
+
+  // Inputs of the column chunks of the current row group, by column.
+  std::unordered_map<uint32_t, ChunkInput> chunkInputs_;
+
+  std::unique_ptr<dwrf::SelectiveColumnReader> columnReader_;
+
+  int64_t skippedRowGroups_{0};
+  int64_t skippedPages_{0};
+};
+
+// Native Parquet reader. Reads flat schemas with BOOLEAN, INT32, INT64,
+// FLOAT, DOUBLE and BYTE_ARRAY columns.
+class ParquetReader : public dwio::common::Reader {
+ public:
+  ParquetReader(
+      std::unique_ptr<dwio::common::InputStream> stream,
+      const dwio::common::ReaderOptions& options);
+  ~ParquetReader() override = default;
+
+  std::optional<uint64_t> numberOfRows() const override;
+
+  std::unique_ptr<dwio::common::ColumnStatistics> columnStatistics(
+      uint32_t index) const override;
+
+  const velox::RowTypePtr& rowType() const override;
+
+  const std::shared_ptr<const dwio::common::TypeWithId>& typeWithId()
+      const override;
+
+  std::unique_ptr<dwio::common::RowReader> createRowReader(
+      const dwio::common::RowReaderOptions& options = {}) const override;
+
+  const thrift::FileMetaData& metadata() const {
+    return metadata_;
+  }
+
+  memory::MemoryPool& memoryPool() const {
+    return pool_;
+  }
+
+  dwio::common::InputStream& stream() const {
+    return *stream_;
+  }
+
+  const dwio::common::BufferedInputFactory& bufferedInputFactory() const {
+    return *bufferedInputFactory_;
+  }
+
+  uint64_t fileNum() const {
+    return fileNum_;
+  }
+
+  // Returns the schema element of the top level column 'column'.
+  const thrift::SchemaElement& schemaElement(uint32_t column) const {
+    return metadata_.schema[column + 1];
+  }
+
+ private:
+  // Expected upper bound of the footer size. The footer is read in one
+  // IO if it is smaller.
+  static constexpr uint64_t kFooterSizeGuess = 256 << 10;
+
+  void readFooter();
+
+  void makeType();
+
+  std::unique_ptr<dwio::common::InputStream> stream_;
+  memory::MemoryPool& pool_;
+  std::shared_ptr<dwio::common::BufferedInputFactory> bufferedInputFactory_;
+  const uint64_t fileNum_;
+
+  thrift::FileMetaData metadata_;
+  RowTypePtr type_;
+  std::shared_ptr<const dwio::common::TypeWithId> typeWithId_;
+};
+
+class ParquetReaderFactory : public dwio::common::ReaderFactory {
+ public:
+  ParquetReaderFactory() : ReaderFactory(dwio::common::FileFormat::PARQUET) {}
+
+  std::unique_ptr<dwio::common::Reader> createReader(
+      std::unique_ptr<dwio::common::InputStream> stream,
+      const dwio::common::ReaderOptions& options) override {
+    return std::make_unique<ParquetReader>(std::move(stream), options);
+  }
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/Nulls.h"
+
+namespace facebook::velox::parquet {
+
+// Decodes the RLE/bit-packed hybrid encoding that Parquet uses for
+// definition levels, dictionary indices and booleans. The input is a
+// sequence of runs. Each run starts with a varint header whose low bit tells
+// whether the run is bit-packed (groups of 8 values of 'bitWidth' bits each)
+// or a single value of ceil(bitWidth / 8) bytes repeated n times.
+class RleBpDecoder {
+ public:
+  RleBpDecoder() = default;
+
+  RleBpDecoder(const char* start, const char* end, uint8_t bitWidth)
+      : current_(start), end_(end), bitWidth_(bitWidth) {
+    VELOX_CHECK_LE(bitWidth, 32, "Parquet RLE bit width too large");
+  }
+
+  // Fills 'values' with the next 'numValues' values.
+  template <typename T>
+  void next(T* values, int32_t numValues) {
+    while (numValues > 0) {
+      if (!remainingValues_) {
+        readHeader();
+      }
+      auto count = std::min(numValues, remainingValues_);
+      if (repeating_) {
+        std::fill(values, values + count, static_cast<T>(value_));
+      } else {
+        for (auto i = 0; i < count; ++i) {
+          values[i] = static_cast<T>(readBitPacked());
+        }
+      }
+      values += count;
+      numValues -= count;
+      remainingValues_ -= count;
+    }
+  }
+
+  // Decodes the next 'numValues' levels into null flags, starting at bit
+  // 'offset' of 'nulls'. A level equal to 'maxLevel' is not null. Returns
+  // the number of non-null values.
+  int32_t readNulls(
+      uint64_t* nulls,
+      int32_t offset,
+      int32_t numValues,
+      int16_t maxLevel) {
+    int32_t numNonNulls = 0;
+    while (numValues > 0) {
+      if (!remainingValues_) {
+        readHeader();
+      }
+      auto count = std::min(numValues, remainingValues_);
+      if (repeating_) {
+        bool notNull = value_ == static_cast<uint64_t>(maxLevel);
+        bits::fillBits(nulls, offset, offset + count, notNull);
+        numNonNulls += notNull ? count : 0;
+      } else {
+        for (auto i = 0; i < count; ++i) {
+          bool notNull = readBitPacked() == static_cast<uint64_t>(maxLevel);
+          bits::setBit(nulls, offset + i, notNull);
+          numNonNulls += notNull;
+        }
+      }
+      offset += count;
+      numValues -= count;
+      remainingValues_ -= count;
+    }
+    return numNonNulls;
+  }
+
+  void skip(int64_t numValues) {
+    while (numValues > 0) {
+      if (!remainingValues_) {
+        readHeader();
+      }
+      auto count = std::min<int64_t>(numValues, remainingValues_);
+      if (!repeating_) {
+        bitOffset_ += count * bitWidth_;
+      }
+      numValues -= count;
+      remainingValues_ -= count;
+    }
+  }
+
+ private:
+  void readHeader() {
+    uint64_t header = 0;
+    for (int32_t shift = 0;; shift += 7) {
+      VELOX_CHECK(current_ < end_, "Reading past end of Parquet RLE data");
+      auto byte = static_cast<uint8_t>(*current_++);
+      header |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        break;
+      }
+    }
+    repeating_ = !(header & 1);
+    if (repeating_) {
+      remainingValues_ = header >> 1;
+      auto numBytes = bits::roundUp(bitWidth_, 8) / 8;
+      VELOX_CHECK_LE(current_ + numBytes, end_);
+      value_ = 0;
+      for (auto i = 0; i < numBytes; ++i) {
+        value_ |= static_cast<uint64_t>(static_cast<uint8_t>(current_[i]))
+            << (8 * i);
+      }
+      current_ += numBytes;
+    } else {
+      auto numGroups = header >> 1;
+      remainingValues_ = numGroups * 8;
+      bitPackedStart_ = current_;
+      bitOffset_ = 0;
+      current_ = std::min(end_, current_ + numGroups * bitWidth_);
+    }
+  }
+
+  uint64_t readBitPacked() {
+    auto byteOffset = bitOffset_ / 8;
+    auto bitInByte = bitOffset_ % 8;
+    auto numBytes = (bitInByte + bitWidth_ + 7) / 8;
+    uint64_t word = 0;
+    for (auto i = 0; i < numBytes; ++i) {
+      word |= static_cast<uint64_t>(
+                  static_cast<uint8_t>(bitPackedStart_[byteOffset + i]))
+          << (8 * i);
+    }
+    bitOffset_ += bitWidth_;
+    return (word >> bitInByte) & bits::lowMask(bitWidth_);
+  }
+
+  const char* current_{nullptr};
+  const char* end_{nullptr};
+  uint8_t bitWidth_{0};
+
+  // Number of values left in the current run.
+  int32_t remainingValues_{0};
+
+  // True if the current run is a repeated value.
+  bool repeating_{false};
+
+  // The value of a repeated run.
+  uint64_t value_{0};
+
+  // Start of the current bit-packed run and the bit position of the next
+  // value in it.
+  const char* bitPackedStart_{nullptr};
+  uint64_t bitOffset_{0};
+};
+
+} // namespace facebook::velox::parquet
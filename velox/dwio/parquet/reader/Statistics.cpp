@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/Statistics.h"
+
+#include <cmath>
+
+namespace facebook::velox::parquet {
+
+using dwio::common::ColumnStatistics;
+
+namespace {
+
+// Decodes a PLAIN encoded fixed width value. Returns std::nullopt if 'value'
+// is missing or has the wrong size.
+template <typename T>
+std::optional<T> decodeValue(const std::string* value) {
+  if (!value || value->size() != sizeof(T)) {
+    return std::nullopt;
+  }
+  T result;
+  memcpy(&result, value->data(), sizeof(T));
+  return result;
+}
+
+std::optional<double> decodeDouble(const std::string* value, TypeKind kind) {
+  std::optional<double> result;
+  if (kind == TypeKind::REAL) {
+    auto floatValue = decodeValue<float>(value);
+    if (floatValue.has_value()) {
+      result = floatValue.value();
+    }
+  } else {
+    result = decodeValue<double>(value);
+  }
+  // NaN is not ordered and does not bound anything.
+  if (result.has_value() && std::isnan(result.value())) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+// Makes statistics from the PLAIN encoded 'min' and 'max'. Either may be
+// nullptr if unknown.
+std::unique_ptr<ColumnStatistics> makeStatistics(
+    const TypePtr& type,
+    const std::string* min,
+    const std::string* max,
+    std::optional<int64_t> nullCount,
+    int64_t numRows) {
+  // The value count is the number of non-null values.
+  std::optional<uint64_t> valueCount;
+  std::optional<bool> hasNull;
+  if (nullCount.has_value()) {
+    valueCount = numRows - nullCount.value();
+    hasNull = nullCount.value() > 0;
+  }
+  ColumnStatistics base(valueCount, hasNull, std::nullopt, std::nullopt);
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN: {
+      auto minValue = decodeValue<bool>(min);
+      auto maxValue = decodeValue<bool>(max);
+      std::optional<uint64_t> trueCount;
+      if (valueCount.has_value() && minValue.has_value() &&
+          minValue == maxValue) {
+        trueCount = minValue.value() ? valueCount.value() : 0;
+      }
+      return std::make_unique<dwio::common::BooleanColumnStatistics>(
+          base, trueCount);
+    }
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      return std::make_unique<dwio::common::IntegerColumnStatistics>(
+          base,
+          decodeValue<int32_t>(min),
+          decodeValue<int32_t>(max),
+          std::nullopt);
+    case TypeKind::BIGINT:
+      return std::make_unique<dwio::common::IntegerColumnStatistics>(
+          base,
+          decodeValue<int64_t>(min),
+          decodeValue<int64_t>(max),
+          std::nullopt);
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+      return std::make_unique<dwio::common::DoubleColumnStatistics>(
+          base,
+          decodeDouble(min, type->kind()),
+          decodeDouble(max, type->kind()),
+          std::nullopt);
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return std::make_unique<dwio::common::StringColumnStatistics>(
+          base,
+          min ? std::optional<std::string>(*min) : std::nullopt,
+          max ? std::optional<std::string>(*max) : std::nullopt,
+          std::nullopt);
+    default:
+      return std::make_unique<ColumnStatistics>(base);
+  }
+}
+
+} // namespace
+
+std::unique_ptr<ColumnStatistics> buildColumnStatistics(
+    const thrift::Statistics& stats,
+    const TypePtr& type,
+    int64_t numRows) {
+  const std::string* min =
+      stats.minValue.has_value() ? &stats.minValue.value() : nullptr;
+  const std::string* max =
+      stats.maxValue.has_value() ? &stats.maxValue.value() : nullptr;
+  // The deprecated 'min' and 'max' are ordered by signed comparison,
+  // which is only right for numbers.
+  if (type->kind() != TypeKind::VARCHAR &&
+      type->kind() != TypeKind::VARBINARY) {
+    if (!min && stats.min.has_value()) {
+      min = &stats.min.value();
+    }
+    if (!max && stats.max.has_value()) {
+      max = &stats.max.value();
+    }
+  }
+  return makeStatistics(type, min, max, stats.nullCount, numRows);
+}
+
+std::unique_ptr<ColumnStatistics> buildPageStatistics(
+    const thrift::ColumnIndex& index,
+    int32_t page,
+    const TypePtr& type,
+    int64_t numRows) {
+  if (page < index.nullPages.size() && index.nullPages[page]) {
+    return makeStatistics(type, nullptr, nullptr, numRows, numRows);
+  }
+  std::optional<int64_t> nullCount;
+  if (page < index.nullCounts.size()) {
+    nullCount = index.nullCounts[page];
+  }
+  return makeStatistics(
+      type,
+      page < index.minValues.size() ? &index.minValues[page] : nullptr,
+      page < index.maxValues.size() ? &index.maxValues[page] : nullptr,
+      nullCount,
+      numRows);
+}
+
+} // namespace facebook::velox::parquet
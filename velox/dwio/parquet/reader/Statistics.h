@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/Statistics.h"
+#include "velox/dwio/parquet/reader/Metadata.h"
+#include "velox/type/Type.h"
+
+namespace facebook::velox::parquet {
+
+// Builds the statistics of a column chunk of 'type' with 'numRows' rows from
+// its footer statistics, for testing filters with common::testFilter().
+std::unique_ptr<dwio::common::ColumnStatistics> buildColumnStatistics(
+    const thrift::Statistics& stats,
+    const TypePtr& type,
+    int64_t numRows);
+
+// Builds the statistics of data page 'page' with 'numRows' rows from the
+// ColumnIndex of its column chunk.
+std::unique_ptr<dwio::common::ColumnStatistics> buildPageStatistics(
+    const thrift::ColumnIndex& index,
+    int32_t page,
+    const TypePtr& type,
+    int64_t numRows);
+
+} // namespace facebook::velox::parquet
@@ -98,18 +98,13 @@ class ParquetReaderTestBase : public testing::Test {
       RowVectorPtr expected) {
     uint64_t total = 0;
     VectorPtr result;
-    while (total < expected->size()) {
-      auto part = reader.next(1000, result);
-      EXPECT_GT(part, 0);
-      if (part > 0) {
-        assertEqualVectorPart(expected, result, total);
-        total += part;
-      } else {
-        break;
-      }
+    // next() returns the number of rows scanned. Filters may leave fewer
+    // rows, possibly none, in 'result'.
+    while (reader.next(1000, result) > 0) {
+      assertEqualVectorPart(expected, result, total);
+      total += result->size();
     }
     EXPECT_EQ(total, expected->size());
-    EXPECT_EQ(reader.next(1000, result), 0);
   }
 
   std::shared_ptr<velox::common::ScanSpec> makeScanSpec(
@@ -19,6 +19,7 @@
 #include "velox/dwio/dwrf/test/utils/DataFiles.h"
 #include "velox/dwio/parquet/RegisterParquetReader.h"
 #include "velox/dwio/parquet/duckdb_reader/ParquetReader.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
@@ -227,6 +228,45 @@ TEST_F(ParquetTableScanTest, countStar) {
   assertQuery(plan, {split}, "SELECT 20");
 }
 
+TEST_F(ParquetTableScanTest, bloomFilterPushdown) {
+  // sample.parquet has a = [1, 20]. More distinct build side keys than
+  // VectorHasher keeps track of, so the filter pushed down into the scan is
+  // a Bloom filter. The Parquet reader applies its range [10, 300'008].
+  const int32_t numRowsBuild = 150'000;
+  auto buildVectors = {makeRowVector({makeFlatVector<int64_t>(
+      numRowsBuild, [](auto row) { return 10 + row * 2; })})};
+  createDuckDbTable("u", {buildVectors});
+  loadData(
+      getExampleFilePath("sample.parquet"),
+      ROW({"a", "b"}, {BIGINT(), DOUBLE()}),
+      makeRowVector(
+          {"a", "b"},
+          {
+              makeFlatVector<int64_t>(20, [](auto row) { return row + 1; }),
+              makeFlatVector<double>(20, [](auto row) { return row + 1; }),
+          }));
+
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto buildSide = PlanBuilder(planNodeIdGenerator)
+                       .values(buildVectors)
+                       .project({"c0 AS u_c0"})
+                       .planNode();
+  for (auto joinType : {core::JoinType::kInner, core::JoinType::kLeftSemi}) {
+    core::PlanNodeId scanId;
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .tableScan(ROW({"a", "b"}, {BIGINT(), DOUBLE()}))
+                    .capturePlanNodeId(scanId)
+                    .hashJoin({"a"}, {"u_c0"}, buildSide, "", {"b"}, joinType)
+                    .planNode();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .split(scanId, makeSplit(getExampleFilePath("sample.parquet")))
+            .assertResults("SELECT b FROM tmp WHERE a IN (SELECT c0 FROM u)");
+    auto stats = task->taskStats().pipelineStats.front().operatorStats;
+    EXPECT_EQ(1, stats[0].runtimeStats["dynamicFiltersAccepted"].sum);
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   folly::init(&argc, &argv, false);
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/Writer.h"
+#include "velox/dwio/common/MemoryInputStream.h"
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/reader/Statistics.h"
+#include "velox/dwio/parquet/tests/ParquetReaderTestBase.h"
+#include "velox/type/Filter.h"
+#include "velox/vector/ComplexVector.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox::dwio::parquet;
+
+using NativeParquetReader = facebook::velox::parquet::ParquetReader;
+using facebook::velox::parquet::Writer;
+using facebook::velox::parquet::WriterOptions;
+namespace thrift = facebook::velox::parquet::thrift;
+
+class ParquetWriterTest : public ParquetReaderTestBase {
+ protected:
+  // Writes 'batches' with 'options' and returns a reader of the result.
+  std::unique_ptr<NativeParquetReader> writeAndOpen(
+      const std::vector<RowVectorPtr>& batches,
+      const WriterOptions& options) {
+    auto sink = std::make_unique<MemorySink>(*pool_, 64 << 20);
+    auto sinkPtr = sink.get();
+    Writer writer(
+        std::move(sink),
+        options,
+        *pool_,
+        asRowType(batches[0]->type()));
+    for (const auto& batch : batches) {
+      writer.write(batch);
+    }
+    writer.close();
+    data_.assign(sinkPtr->getData(), sinkPtr->size());
+    return std::make_unique<NativeParquetReader>(
+        std::make_unique<MemoryInputStream>(data_.data(), data_.size()),
+        ReaderOptions{});
+  }
+
+  RowVectorPtr makeData(vector_size_t size, vector_size_t offset = 0) {
+    auto strings = [](auto row) {
+      return fmt::format("string value {}", row % 113);
+    };
+    return vectorMaker_->rowVector(
+        {"b", "ti", "si", "i", "bi", "r", "d", "s", "dt"},
+        {vectorMaker_->flatVector<bool>(
+             size,
+             [&](auto row) { return (row + offset) % 3 == 0; },
+             nullEvery(7)),
+         vectorMaker_->flatVector<int8_t>(
+             size, [&](auto row) { return (row + offset) % 100; }),
+         vectorMaker_->flatVector<int16_t>(
+             size,
+             [&](auto row) { return (row + offset) * 3; },
+             nullEvery(5)),
+         vectorMaker_->flatVector<int32_t>(
+             size, [&](auto row) { return (row + offset) % 17; }),
+         vectorMaker_->flatVector<int64_t>(
+             size,
+             [&](auto row) { return (row + offset) * 1'000'000'007L; },
+             nullEvery(11)),
+         vectorMaker_->flatVector<float>(
+             size, [&](auto row) { return (row + offset) * 0.5; }),
+         vectorMaker_->flatVector<double>(
+             size,
+             [&](auto row) { return (row + offset) % 31 * 1.25; },
+             nullEvery(3)),
+         vectorMaker_->flatVector<StringView>(
+             size,
+             [&](auto row) {
+               strings_.push_back(strings(row + offset));
+               return StringView(strings_.back());
+             },
+             nullEvery(13)),
+         vectorMaker_->flatVector<Date>(
+             size, [&](auto row) { return Date(18'000 + row + offset); })});
+  }
+
+  static std::function<bool(vector_size_t)> nullEvery(int32_t n) {
+    return [n](auto row) { return row % n == 0; };
+  }
+
+  void assertRoundTrip(
+      const std::vector<RowVectorPtr>& batches,
+      const WriterOptions& options) {
+    auto reader = writeAndOpen(batches, options);
+    auto rowType = asRowType(batches[0]->type());
+    std::vector<VectorPtr> columns;
+    for (auto i = 0; i < rowType->size(); ++i) {
+      auto column = BaseVector::create(rowType->childAt(i), 0, pool_.get());
+      for (const auto& batch : batches) {
+        column->append(batch->childAt(i).get());
+      }
+      columns.push_back(column);
+    }
+    auto rowReaderOpts = getReaderOpts(rowType);
+    rowReaderOpts.setScanSpec(makeScanSpec(rowType));
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    assertReadExpected(
+        *rowReader, vectorMaker_->rowVector(rowType->names(), columns));
+  }
+
+  std::deque<std::string> strings_;
+  std::string data_;
+};
+
+TEST_F(ParquetWriterTest, roundTrip) {
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 5; ++i) {
+    batches.push_back(makeData(3'000, i * 3'000));
+  }
+  for (auto codec :
+       {thrift::CompressionCodec::UNCOMPRESSED,
+        thrift::CompressionCodec::SNAPPY,
+        thrift::CompressionCodec::GZIP,
+        thrift::CompressionCodec::ZSTD}) {
+    for (auto enableDictionary : {true, false}) {
+      SCOPED_TRACE(fmt::format(
+          "codec {}, dictionary {}",
+          static_cast<int>(codec),
+          enableDictionary));
+      WriterOptions options;
+      options.compression = codec;
+      options.enableDictionary = enableDictionary;
+      options.maxRowsPerPage = 1'000;
+      options.rowGroupSize = 32 << 10;
+      assertRoundTrip(batches, options);
+    }
+  }
+}
+
+TEST_F(ParquetWriterTest, pagesAndRowGroups) {
+  WriterOptions options;
+  options.maxRowsPerPage = 1'000;
+  options.rowGroupSize = 64 << 10;
+  auto reader = writeAndOpen({makeData(10'000), makeData(10'000)}, options);
+  const auto& metadata = reader->metadata();
+  EXPECT_EQ(metadata.numRows, 20'000);
+  EXPECT_GT(metadata.rowGroups.size(), 1);
+  int64_t numRows = 0;
+  for (const auto& rowGroup : metadata.rowGroups) {
+    numRows += rowGroup.numRows;
+    for (const auto& chunk : rowGroup.columns) {
+      EXPECT_EQ(chunk.metaData->numValues, rowGroup.numRows);
+      EXPECT_TRUE(chunk.offsetIndexOffset.has_value());
+      EXPECT_TRUE(chunk.columnIndexOffset.has_value());
+    }
+  }
+  EXPECT_EQ(numRows, 20'000);
+}
+
+TEST_F(ParquetWriterTest, dictionaryFallback) {
+  auto batch = vectorMaker_->rowVector(
+      {"s"},
+      {vectorMaker_->flatVector<StringView>(20'000, [&](auto row) {
+        strings_.push_back(fmt::format("distinct string {}", row));
+        return StringView(strings_.back());
+      })});
+  WriterOptions options;
+  options.dictionaryPageSizeLimit = 16 << 10;
+  auto reader = writeAndOpen({batch}, options);
+  // The first pages use the dictionary, the rest are PLAIN encoded.
+  const auto& metaData =
+      reader->metadata().rowGroups[0].columns[0].metaData.value();
+  ASSERT_TRUE(metaData.dictionaryPageOffset.has_value());
+  EXPECT_LT(
+      metaData.dataPageOffset - metaData.dictionaryPageOffset.value(),
+      options.dictionaryPageSizeLimit * 2);
+  EXPECT_NE(
+      std::find(
+          metaData.encodings.begin(),
+          metaData.encodings.end(),
+          thrift::Encoding::RLE_DICTIONARY),
+      metaData.encodings.end());
+  assertRoundTrip({batch}, options);
+}
+
+TEST_F(ParquetWriterTest, statistics) {
+  WriterOptions options;
+  options.maxRowsPerPage = 1'000;
+  auto batch = vectorMaker_->rowVector(
+      {"a", "s"},
+      {vectorMaker_->flatVector<int64_t>(
+           10'000, [](auto row) { return row; }, nullEvery(10)),
+       vectorMaker_->flatVector<StringView>(10'000, [&](auto row) {
+         strings_.push_back(fmt::format("{:05}", row));
+         return StringView(strings_.back());
+       })});
+  auto reader = writeAndOpen({batch}, options);
+
+  const auto& rowGroup = reader->metadata().rowGroups[0];
+  auto stats = facebook::velox::parquet::buildColumnStatistics(
+      rowGroup.columns[0].metaData->statistics.value(),
+      BIGINT(),
+      rowGroup.numRows);
+  auto intStats = dynamic_cast<const IntegerColumnStatistics*>(stats.get());
+  ASSERT_NE(intStats, nullptr);
+  EXPECT_EQ(intStats->getMinimum(), 1);
+  EXPECT_EQ(intStats->getMaximum(), 9'999);
+  EXPECT_EQ(intStats->getNumberOfValues(), 9'000);
+  EXPECT_EQ(intStats->hasNull(), true);
+  stats = facebook::velox::parquet::buildColumnStatistics(
+      rowGroup.columns[1].metaData->statistics.value(),
+      VARCHAR(),
+      rowGroup.numRows);
+  auto stringStats = dynamic_cast<const StringColumnStatistics*>(stats.get());
+  ASSERT_NE(stringStats, nullptr);
+  EXPECT_EQ(stringStats->getMinimum(), "00000");
+  EXPECT_EQ(stringStats->getMaximum(), "09999");
+
+  // The page index skips the pages without rows between 2500 and 3100.
+  auto rowType = asRowType(batch->type());
+  auto scanSpec = makeScanSpec(rowType);
+  scanSpec->getOrCreateChild(facebook::velox::common::Subfield("a"))
+      ->setFilter(std::make_unique<facebook::velox::common::BigintRange>(
+          2'500, 3'100, false));
+  auto rowReaderOpts = getReaderOpts(rowType);
+  rowReaderOpts.setScanSpec(scanSpec);
+  auto rowReader = reader->createRowReader(rowReaderOpts);
+  VectorPtr result;
+  int64_t numRows = 0;
+  while (rowReader->next(1'000, result) > 0) {
+    numRows += result->size();
+  }
+  EXPECT_EQ(numRows, 601 - 61);
+  RuntimeStatistics runtimeStats;
+  rowReader->updateRuntimeStats(runtimeStats);
+  EXPECT_GT(runtimeStats.skippedPages, 0);
+}
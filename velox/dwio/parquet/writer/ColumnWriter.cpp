@@ -0,0 +1,700 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/ColumnWriter.h"
+
+#include <cmath>
+#include <deque>
+
+#include <folly/container/F14Map.h>
+#include <snappy.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/dwio/parquet/writer/MetadataWriter.h"
+
+namespace facebook::velox::parquet {
+
+using thrift::CompressionCodec;
+using thrift::ConvertedType;
+using thrift::Encoding;
+using thrift::PageType;
+
+namespace {
+
+constexpr int32_t kZstdLevel = 1;
+
+void compress(
+    CompressionCodec codec,
+    const std::string& input,
+    std::string& output) {
+  switch (codec) {
+    case CompressionCodec::SNAPPY: {
+      output.resize(snappy::MaxCompressedLength(input.size()));
+      size_t size;
+      snappy::RawCompress(input.data(), input.size(), output.data(), &size);
+      output.resize(size);
+      return;
+    }
+    case CompressionCodec::GZIP: {
+      z_stream stream{};
+      // 16 + MAX_WBITS writes a gzip header.
+      VELOX_CHECK_EQ(
+          deflateInit2(
+              &stream,
+              Z_DEFAULT_COMPRESSION,
+              Z_DEFLATED,
+              16 + MAX_WBITS,
+              8,
+              Z_DEFAULT_STRATEGY),
+          Z_OK);
+      output.resize(deflateBound(&stream, input.size()));
+      stream.next_in =
+          reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+      stream.avail_in = input.size();
+      stream.next_out = reinterpret_cast<Bytef*>(output.data());
+      stream.avail_out = output.size();
+      auto result = deflate(&stream, Z_FINISH);
+      deflateEnd(&stream);
+      VELOX_CHECK_EQ(
+          result, Z_STREAM_END, "GZIP compression of Parquet page failed");
+      output.resize(stream.total_out);
+      return;
+    }
+    case CompressionCodec::ZSTD: {
+      output.resize(ZSTD_compressBound(input.size()));
+      auto size = ZSTD_compress(
+          output.data(), output.size(), input.data(), input.size(), kZstdLevel);
+      VELOX_CHECK(
+          !ZSTD_isError(size),
+          "ZSTD compression of Parquet page failed: {}",
+          ZSTD_getErrorName(size));
+      output.resize(size);
+      return;
+    }
+    default:
+      VELOX_UNSUPPORTED(
+          "Parquet compression codec {} is not supported",
+          static_cast<int>(codec));
+  }
+}
+
+void addEncoding(std::vector<Encoding>& encodings, Encoding encoding) {
+  if (std::find(encodings.begin(), encodings.end(), encoding) ==
+      encodings.end()) {
+    encodings.push_back(encoding);
+  }
+}
+
+// The Parquet physical type of a Velox type.
+template <typename T>
+struct Physical {
+  using type = T;
+};
+
+template <>
+struct Physical<int8_t> {
+  using type = int32_t;
+};
+
+template <>
+struct Physical<int16_t> {
+  using type = int32_t;
+};
+
+template <>
+struct Physical<Date> {
+  using type = int32_t;
+};
+
+template <typename T>
+T toPhysical(T value) {
+  return value;
+}
+
+inline int32_t toPhysical(int8_t value) {
+  return value;
+}
+
+inline int32_t toPhysical(int16_t value) {
+  return value;
+}
+
+inline int32_t toPhysical(Date value) {
+  return value.days();
+}
+
+// Appends the PLAIN encoding of 'value' to 'out'.
+template <typename P>
+void appendPlain(P value, std::string& out) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(P));
+}
+
+inline void appendPlain(StringView value, std::string& out) {
+  uint32_t length = value.size();
+  out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+  out.append(value.data(), value.size());
+}
+
+template <typename P>
+int32_t plainSize(P /*value*/) {
+  return sizeof(P);
+}
+
+inline int32_t plainSize(StringView value) {
+  return sizeof(uint32_t) + value.size();
+}
+
+// Min and max of a set of values. NaNs are ignored since they are not
+// ordered. The bounds are PLAIN encoded without the length of strings.
+template <typename P>
+class Bounds {
+ public:
+  void add(P value) {
+    if constexpr (std::is_floating_point_v<P>) {
+      if (std::isnan(value)) {
+        return;
+      }
+    }
+    if (!min_.has_value() || value < min_.value()) {
+      min_ = value;
+    }
+    if (!max_.has_value() || value > max_.value()) {
+      max_ = value;
+    }
+  }
+
+  void add(const Bounds<P>& other) {
+    if (other.min_.has_value()) {
+      add(other.min_.value());
+      add(other.max_.value());
+    }
+  }
+
+  bool encode(std::string& min, std::string& max) const {
+    if (!min_.has_value()) {
+      return false;
+    }
+    min.assign(reinterpret_cast<const char*>(&min_.value()), sizeof(P));
+    max.assign(reinterpret_cast<const char*>(&max_.value()), sizeof(P));
+    return true;
+  }
+
+  void clear() {
+    min_.reset();
+    max_.reset();
+  }
+
+ private:
+  std::optional<P> min_;
+  std::optional<P> max_;
+};
+
+template <>
+class Bounds<StringView> {
+ public:
+  void add(StringView value) {
+    if (!min_.has_value() || value < StringView(min_.value())) {
+      min_ = std::string(value.data(), value.size());
+    }
+    if (!max_.has_value() || value > StringView(max_.value())) {
+      max_ = std::string(value.data(), value.size());
+    }
+  }
+
+  void add(const Bounds<StringView>& other) {
+    if (other.min_.has_value()) {
+      add(StringView(other.min_.value()));
+      add(StringView(other.max_.value()));
+    }
+  }
+
+  bool encode(std::string& min, std::string& max) const {
+    if (!min_.has_value()) {
+      return false;
+    }
+    min = min_.value();
+    max = max_.value();
+    return true;
+  }
+
+  void clear() {
+    min_.reset();
+    max_.reset();
+  }
+
+ private:
+  std::optional<std::string> min_;
+  std::optional<std::string> max_;
+};
+
+// Dictionary key of a value. Floating point values are compared by their
+// bits, so that NaNs have an entry and -0.0 is kept.
+template <typename P>
+struct DictionaryKey {
+  using type = P;
+
+  static P of(P value) {
+    return value;
+  }
+};
+
+template <>
+struct DictionaryKey<float> {
+  using type = uint32_t;
+
+  static uint32_t of(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+};
+
+template <>
+struct DictionaryKey<double> {
+  using type = uint64_t;
+
+  static uint64_t of(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+};
+
+// Writes columns of fixed width types and strings. The values are
+// dictionary encoded until the dictionary is full, then PLAIN encoded.
+template <typename T>
+class FlatColumnWriter : public ColumnWriter {
+ public:
+  using P = typename Physical<T>::type;
+  using Key = typename DictionaryKey<P>::type;
+
+  FlatColumnWriter(
+      const std::string& name,
+      thrift::Type type,
+      std::optional<ConvertedType> convertedType,
+      const WriterOptions& options,
+      memory::MemoryPool& pool)
+      : ColumnWriter(name, type, convertedType, options, pool),
+        useDictionary_(options.enableDictionary) {}
+
+  void append(
+      const DecodedVector& decoded,
+      vector_size_t begin,
+      vector_size_t end) override {
+    for (auto row = begin; row < end; ++row) {
+      const bool isNull = decoded.isNullAt(row);
+      addRow(isNull);
+      if (!isNull) {
+        addValue(toPhysical(decoded.valueAt<T>(row)));
+      }
+      maybeFinishPage();
+    }
+  }
+
+ protected:
+  int64_t pageValueBytes() const override {
+    if (useDictionary_) {
+      return bits::roundUp(indices_.size() * indexBitWidth(), 8) / 8;
+    }
+    return plainValues_.size();
+  }
+
+  int64_t dictionaryBytes() const override {
+    return dictionaryBytes_;
+  }
+
+  bool mustFinishPage() const override {
+    return useDictionary_ &&
+        dictionaryBytes_ >= options_.dictionaryPageSizeLimit;
+  }
+
+  Encoding encodePageValues(std::string& out) override {
+    if (!useDictionary_ || indices_.size() == 0) {
+      out.append(plainValues_);
+      plainValues_.clear();
+      return Encoding::PLAIN;
+    }
+    dictionaryUsed_ = true;
+    const auto bitWidth = indexBitWidth();
+    out.push_back(static_cast<char>(bitWidth));
+    indices_.setBitWidth(bitWidth);
+    indices_.finish(out);
+    // The rest of the column chunk is PLAIN encoded once the dictionary is
+    // full.
+    if (dictionaryBytes_ >= options_.dictionaryPageSizeLimit) {
+      useDictionary_ = false;
+    }
+    return Encoding::RLE_DICTIONARY;
+  }
+
+  bool finishPageBounds(std::string& min, std::string& max) override {
+    const bool hasBounds = pageBounds_.encode(min, max);
+    chunkBounds_.add(pageBounds_);
+    pageBounds_.clear();
+    return hasBounds;
+  }
+
+  bool chunkBounds(std::string& min, std::string& max) const override {
+    return chunkBounds_.encode(min, max);
+  }
+
+  int32_t encodeDictionary(std::string& out) override {
+    if (!dictionaryUsed_) {
+      return 0;
+    }
+    for (auto value : dictionary_) {
+      appendPlain(value, out);
+    }
+    return dictionary_.size();
+  }
+
+  void resetChunk() override {
+    dictionaryIndex_.clear();
+    dictionary_.clear();
+    dictionaryStrings_.clear();
+    dictionaryBytes_ = 0;
+    dictionaryUsed_ = false;
+    useDictionary_ = options_.enableDictionary;
+    chunkBounds_.clear();
+  }
+
+ private:
+  void addValue(P value) {
+    pageBounds_.add(value);
+    if (!useDictionary_) {
+      appendPlain(value, plainValues_);
+      return;
+    }
+    auto it = dictionaryIndex_.find(DictionaryKey<P>::of(value));
+    if (it == dictionaryIndex_.end()) {
+      if constexpr (std::is_same_v<P, StringView>) {
+        // The dictionary owns its strings.
+        if (!value.isInline()) {
+          dictionaryStrings_.emplace_back(value.data(), value.size());
+          value = StringView(dictionaryStrings_.back());
+        }
+      }
+      it = dictionaryIndex_
+               .emplace(DictionaryKey<P>::of(value), dictionary_.size())
+               .first;
+      dictionary_.push_back(value);
+      dictionaryBytes_ += plainSize(value);
+    }
+    indices_.put(it->second);
+  }
+
+  uint8_t indexBitWidth() const {
+    if (dictionary_.size() <= 1) {
+      return 1;
+    }
+    return 32 - __builtin_clz(static_cast<uint32_t>(dictionary_.size() - 1));
+  }
+
+  // True if the values of the current page are dictionary encoded.
+  bool useDictionary_;
+
+  // True if a page of the column chunk is dictionary encoded.
+  bool dictionaryUsed_{false};
+
+  folly::F14FastMap<Key, int32_t> dictionaryIndex_;
+  std::vector<P> dictionary_;
+  // Backing storage of non-inline strings in 'dictionary_'.
+  std::deque<std::string> dictionaryStrings_;
+  int64_t dictionaryBytes_{0};
+
+  // Dictionary indices or PLAIN encoded values of the current page.
+  RleBpEncoder indices_;
+  std::string plainValues_;
+
+  Bounds<P> pageBounds_;
+  Bounds<P> chunkBounds_;
+};
+
+// Writes BOOLEAN columns with RLE encoded values.
+class BooleanColumnWriter : public ColumnWriter {
+ public:
+  BooleanColumnWriter(
+      const std::string& name,
+      const WriterOptions& options,
+      memory::MemoryPool& pool)
+      : ColumnWriter(name, thrift::Type::BOOLEAN, std::nullopt, options, pool) {
+  }
+
+  void append(
+      const DecodedVector& decoded,
+      vector_size_t begin,
+      vector_size_t end) override {
+    for (auto row = begin; row < end; ++row) {
+      const bool isNull = decoded.isNullAt(row);
+      addRow(isNull);
+      if (!isNull) {
+        auto value = decoded.valueAt<bool>(row);
+        values_.put(value);
+        pageBounds_.add(value);
+      }
+      maybeFinishPage();
+    }
+  }
+
+ protected:
+  int64_t pageValueBytes() const override {
+    return bits::nbytes(values_.size());
+  }
+
+  int64_t dictionaryBytes() const override {
+    return 0;
+  }
+
+  bool mustFinishPage() const override {
+    return false;
+  }
+
+  Encoding encodePageValues(std::string& out) override {
+    // The RLE encoded values are preceded by their length.
+    const auto start = out.size();
+    out.resize(start + sizeof(uint32_t));
+    values_.finish(out);
+    uint32_t length = out.size() - start - sizeof(uint32_t);
+    memcpy(out.data() + start, &length, sizeof(length));
+    return Encoding::RLE;
+  }
+
+  bool finishPageBounds(std::string& min, std::string& max) override {
+    const bool hasBounds = pageBounds_.encode(min, max);
+    chunkBounds_.add(pageBounds_);
+    pageBounds_.clear();
+    return hasBounds;
+  }
+
+  bool chunkBounds(std::string& min, std::string& max) const override {
+    return chunkBounds_.encode(min, max);
+  }
+
+  int32_t encodeDictionary(std::string& /*out*/) override {
+    return 0;
+  }
+
+  void resetChunk() override {
+    chunkBounds_.clear();
+  }
+
+ private:
+  RleBpEncoder values_{1};
+  Bounds<bool> pageBounds_;
+  Bounds<bool> chunkBounds_;
+};
+
+} // namespace
+
+// static
+std::unique_ptr<ColumnWriter> ColumnWriter::create(
+    const std::string& name,
+    const TypePtr& type,
+    const WriterOptions& options,
+    memory::MemoryPool& pool) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+      return std::make_unique<BooleanColumnWriter>(name, options, pool);
+    case TypeKind::TINYINT:
+      return std::make_unique<FlatColumnWriter<int8_t>>(
+          name, thrift::Type::INT32, ConvertedType::INT_8, options, pool);
+    case TypeKind::SMALLINT:
+      return std::make_unique<FlatColumnWriter<int16_t>>(
+          name, thrift::Type::INT32, ConvertedType::INT_16, options, pool);
+    case TypeKind::INTEGER:
+      return std::make_unique<FlatColumnWriter<int32_t>>(
+          name, thrift::Type::INT32, std::nullopt, options, pool);
+    case TypeKind::DATE:
+      return std::make_unique<FlatColumnWriter<Date>>(
+          name, thrift::Type::INT32, ConvertedType::DATE, options, pool);
+    case TypeKind::BIGINT:
+      return std::make_unique<FlatColumnWriter<int64_t>>(
+          name, thrift::Type::INT64, std::nullopt, options, pool);
+    case TypeKind::REAL:
+      return std::make_unique<FlatColumnWriter<float>>(
+          name, thrift::Type::FLOAT, std::nullopt, options, pool);
+    case TypeKind::DOUBLE:
+      return std::make_unique<FlatColumnWriter<double>>(
+          name, thrift::Type::DOUBLE, std::nullopt, options, pool);
+    case TypeKind::VARCHAR:
+      return std::make_unique<FlatColumnWriter<StringView>>(
+          name, thrift::Type::BYTE_ARRAY, ConvertedType::UTF8, options, pool);
+    case TypeKind::VARBINARY:
+      return std::make_unique<FlatColumnWriter<StringView>>(
+          name, thrift::Type::BYTE_ARRAY, std::nullopt, options, pool);
+    default:
+      VELOX_NYI(
+          "Parquet writer does not support type {} of column {}",
+          type->toString(),
+          name);
+  }
+}
+
+ColumnWriter::ColumnWriter(
+    const std::string& name,
+    thrift::Type type,
+    std::optional<ConvertedType> convertedType,
+    const WriterOptions& options,
+    memory::MemoryPool& pool)
+    : options_(options), pool_(pool) {
+  schemaElement_.type = type;
+  schemaElement_.repetitionType = thrift::FieldRepetitionType::OPTIONAL;
+  schemaElement_.name = name;
+  schemaElement_.convertedType = convertedType;
+}
+
+void ColumnWriter::finishPage() {
+  if (pageRows_ == 0) {
+    return;
+  }
+  // The definition levels go first, preceded by their length.
+  pageData_.clear();
+  pageData_.resize(sizeof(uint32_t));
+  defineLevels_.finish(pageData_);
+  uint32_t levelsLength = pageData_.size() - sizeof(uint32_t);
+  memcpy(pageData_.data(), &levelsLength, sizeof(levelsLength));
+  auto encoding = encodePageValues(pageData_);
+  addEncoding(encodings_, encoding);
+
+  std::string min;
+  std::string max;
+  const bool hasBounds = finishPageBounds(min, max);
+  const bool isNullPage = pageNulls_ == pageRows_;
+  if (!hasBounds && !isNullPage) {
+    hasColumnIndex_ = false;
+  }
+  columnIndex_.nullPages.push_back(isNullPage);
+  columnIndex_.minValues.push_back(std::move(min));
+  columnIndex_.maxValues.push_back(std::move(max));
+  columnIndex_.nullCounts.push_back(pageNulls_);
+
+  thrift::PageHeader header;
+  header.type = PageType::DATA_PAGE;
+  thrift::DataPageHeader dataHeader;
+  dataHeader.numValues = pageRows_;
+  dataHeader.encoding = encoding;
+  header.dataPageHeader = dataHeader;
+  auto page = makePage(header, pageData_);
+
+  thrift::PageLocation location;
+  location.offset = pagesBytes_;
+  location.compressedPageSize = page.size();
+  location.firstRowIndex = chunkRows_;
+  offsetIndex_.pageLocations.push_back(location);
+
+  pagesBytes_ += page.size();
+  pages_.push_back(std::move(page));
+  chunkRows_ += pageRows_;
+  chunkNulls_ += pageNulls_;
+  pageRows_ = 0;
+  pageNulls_ = 0;
+}
+
+dwio::common::DataBuffer<char> ColumnWriter::makePage(
+    thrift::PageHeader& header,
+    const std::string& data) {
+  const std::string* body = &data;
+  if (options_.compression != CompressionCodec::UNCOMPRESSED) {
+    compress(options_.compression, data, compressed_);
+    body = &compressed_;
+  }
+  header.uncompressedPageSize = data.size();
+  header.compressedPageSize = body->size();
+  std::string headerBytes;
+  thrift::writePageHeader(header, headerBytes);
+
+  dwio::common::DataBuffer<char> page(pool_);
+  page.reserve(headerBytes.size() + body->size());
+  page.unsafeAppend(0, headerBytes.data(), headerBytes.size());
+  page.unsafeAppend(page.size(), body->data(), body->size());
+  uncompressedBytes_ += headerBytes.size() + data.size();
+  return page;
+}
+
+FlushedColumnChunk ColumnWriter::flush(
+    int64_t offset,
+    std::vector<dwio::common::DataBuffer<char>>& buffers) {
+  finishPage();
+  thrift::ColumnMetaData metaData;
+  metaData.type = schemaElement_.type.value();
+  metaData.pathInSchema = {schemaElement_.name};
+  metaData.codec = options_.compression;
+  metaData.numValues = chunkRows_;
+
+  addEncoding(metaData.encodings, Encoding::RLE);
+  int64_t dataPageOffset = offset;
+  pageData_.clear();
+  const auto dictionarySize = encodeDictionary(pageData_);
+  if (dictionarySize > 0) {
+    thrift::PageHeader header;
+    header.type = PageType::DICTIONARY_PAGE;
+    thrift::DictionaryPageHeader dictionaryHeader;
+    dictionaryHeader.numValues = dictionarySize;
+    dictionaryHeader.encoding = Encoding::PLAIN;
+    header.dictionaryPageHeader = dictionaryHeader;
+    auto page = makePage(header, pageData_);
+    metaData.dictionaryPageOffset = offset;
+    dataPageOffset += page.size();
+    buffers.push_back(std::move(page));
+    addEncoding(metaData.encodings, Encoding::PLAIN);
+  }
+  for (auto encoding : encodings_) {
+    addEncoding(metaData.encodings, encoding);
+  }
+  metaData.dataPageOffset = dataPageOffset;
+  metaData.totalCompressedSize = dataPageOffset - offset + pagesBytes_;
+  metaData.totalUncompressedSize = uncompressedBytes_;
+  for (auto& page : pages_) {
+    buffers.push_back(std::move(page));
+  }
+
+  thrift::Statistics stats;
+  stats.nullCount = chunkNulls_;
+  std::string min;
+  std::string max;
+  if (chunkBounds(min, max)) {
+    stats.minValue = std::move(min);
+    stats.maxValue = std::move(max);
+  }
+  metaData.statistics = std::move(stats);
+
+  FlushedColumnChunk flushed;
+  flushed.chunk.fileOffset = offset;
+  flushed.chunk.metaData = std::move(metaData);
+  if (hasColumnIndex_) {
+    flushed.columnIndex = std::move(columnIndex_);
+  }
+  for (auto& location : offsetIndex_.pageLocations) {
+    location.offset += dataPageOffset;
+  }
+  flushed.offsetIndex = std::move(offsetIndex_);
+
+  pages_.clear();
+  pagesBytes_ = 0;
+  uncompressedBytes_ = 0;
+  chunkRows_ = 0;
+  chunkNulls_ = 0;
+  encodings_.clear();
+  columnIndex_ = {};
+  offsetIndex_ = {};
+  hasColumnIndex_ = true;
+  resetChunk();
+  return flushed;
+}
+
+} // namespace facebook::velox::parquet
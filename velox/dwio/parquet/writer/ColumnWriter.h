@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/parquet/writer/RleBpEncoder.h"
+#include "velox/dwio/parquet/writer/WriterOptions.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::parquet {
+
+// A flushed column chunk and its page index.
+struct FlushedColumnChunk {
+  thrift::ColumnChunk chunk;
+  // Not set if a page has values but no min/max, e.g. only NaNs.
+  std::optional<thrift::ColumnIndex> columnIndex;
+  thrift::OffsetIndex offsetIndex;
+};
+
+// Buffers the pages of the column chunk of a top level column of the
+// current row group. All columns are OPTIONAL, so each page starts with
+// RLE encoded definition levels. The values are dictionary, PLAIN or, for
+// BOOLEAN, RLE encoded. Finished pages are compressed and kept in memory
+// until the row group is flushed, since the dictionary page goes before
+// them.
+class ColumnWriter {
+ public:
+  virtual ~ColumnWriter() = default;
+
+  static std::unique_ptr<ColumnWriter> create(
+      const std::string& name,
+      const TypePtr& type,
+      const WriterOptions& options,
+      memory::MemoryPool& pool);
+
+  // Appends rows ['begin', 'end') of 'decoded'.
+  virtual void append(
+      const DecodedVector& decoded,
+      vector_size_t begin,
+      vector_size_t end) = 0;
+
+  const thrift::SchemaElement& schemaElement() const {
+    return schemaElement_;
+  }
+
+  // Bytes of the finished pages and estimated bytes of the current page
+  // and the dictionary.
+  int64_t bufferedBytes() const {
+    return pagesBytes_ + pageValueBytes() + dictionaryBytes();
+  }
+
+  // Moves the pages of the column chunk to the end of 'buffers' and
+  // returns its metadata. 'offset' is the file offset of the chunk.
+  FlushedColumnChunk flush(
+      int64_t offset,
+      std::vector<dwio::common::DataBuffer<char>>& buffers);
+
+ protected:
+  ColumnWriter(
+      const std::string& name,
+      thrift::Type type,
+      std::optional<thrift::ConvertedType> convertedType,
+      const WriterOptions& options,
+      memory::MemoryPool& pool);
+
+  // Adds a row to the current page.
+  void addRow(bool isNull) {
+    defineLevels_.put(isNull ? 0 : 1);
+    ++pageRows_;
+    pageNulls_ += isNull;
+  }
+
+  // Closes the current page if it is full.
+  void maybeFinishPage() {
+    if (pageRows_ >= options_.maxRowsPerPage ||
+        pageValueBytes() >= options_.dataPageSize || mustFinishPage()) {
+      finishPage();
+    }
+  }
+
+  // Encodes, compresses and buffers the current page.
+  void finishPage();
+
+  // Encoded size of the values of the current page.
+  virtual int64_t pageValueBytes() const = 0;
+
+  // Size of the dictionary page of the column chunk before compression.
+  virtual int64_t dictionaryBytes() const = 0;
+
+  // Returns true if the current page must be closed before the next value,
+  // e.g. because the dictionary is full.
+  virtual bool mustFinishPage() const = 0;
+
+  // Appends the values of the current page to 'out', clears them and
+  // returns their encoding.
+  virtual thrift::Encoding encodePageValues(std::string& out) = 0;
+
+  // Sets 'min' and 'max' to the PLAIN encoded bounds of the values of the
+  // current page, adds them to the bounds of the column chunk and clears
+  // them. Returns false if the page has no bounds.
+  virtual bool finishPageBounds(std::string& min, std::string& max) = 0;
+
+  // Returns the PLAIN encoded bounds of the values of the column chunk.
+  virtual bool chunkBounds(std::string& min, std::string& max) const = 0;
+
+  // Appends the PLAIN encoded dictionary to 'out' and returns the number of
+  // entries. Returns 0 if no page of the column chunk uses the dictionary.
+  virtual int32_t encodeDictionary(std::string& out) = 0;
+
+  // Clears the dictionary and bounds after a flush.
+  virtual void resetChunk() = 0;
+
+  const WriterOptions& options_;
+
+ private:
+  // Compresses 'data' and returns it preceded by 'header'. Sets the page
+  // sizes in 'header'.
+  dwio::common::DataBuffer<char> makePage(
+      thrift::PageHeader& header,
+      const std::string& data);
+
+  memory::MemoryPool& pool_;
+  thrift::SchemaElement schemaElement_;
+
+  RleBpEncoder defineLevels_{1};
+  int32_t pageRows_{0};
+  int32_t pageNulls_{0};
+
+  // Rows and nulls of the finished pages of the column chunk.
+  int64_t chunkRows_{0};
+  int64_t chunkNulls_{0};
+
+  // The finished pages and their total size.
+  std::vector<dwio::common::DataBuffer<char>> pages_;
+  int64_t pagesBytes_{0};
+  int64_t uncompressedBytes_{0};
+
+  // Data page encodings of the column chunk.
+  std::vector<thrift::Encoding> encodings_;
+
+  // Page index of the finished pages. The offsets are relative to the
+  // first data page.
+  thrift::ColumnIndex columnIndex_;
+  bool hasColumnIndex_{true};
+  thrift::OffsetIndex offsetIndex_;
+
+  // Scratch buffers for a page before and after compression.
+  std::string pageData_;
+  std::string compressed_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/MetadataWriter.h"
+
+namespace facebook::velox::parquet::thrift {
+
+namespace {
+
+// Field and element types of the Thrift compact protocol.
+enum class CType : uint8_t {
+  kStop = 0,
+  kBoolTrue = 1,
+  kBoolFalse = 2,
+  kByte = 3,
+  kI16 = 4,
+  kI32 = 5,
+  kI64 = 6,
+  kDouble = 7,
+  kBinary = 8,
+  kList = 9,
+  kSet = 10,
+  kMap = 11,
+  kStruct = 12,
+};
+
+// Writes the Thrift compact protocol at the end of a string.
+class CompactWriter {
+ public:
+  explicit CompactWriter(std::string& out) : out_(out) {}
+
+  void writeByte(uint8_t byte) {
+    out_.push_back(static_cast<char>(byte));
+  }
+
+  void writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+      writeByte(static_cast<uint8_t>(value) | 0x80);
+      value >>= 7;
+    }
+    writeByte(static_cast<uint8_t>(value));
+  }
+
+  void writeI64(int64_t value) {
+    writeVarint(
+        (static_cast<uint64_t>(value) << 1) ^
+        static_cast<uint64_t>(value >> 63));
+  }
+
+  void writeI32(int32_t value) {
+    writeI64(value);
+  }
+
+  void writeBinary(const std::string& value) {
+    writeVarint(value.size());
+    out_.append(value);
+  }
+
+  // Writes a bool element of a container. These take a byte, 1 for true.
+  void writeBoolElement(bool value) {
+    writeByte(
+        static_cast<uint8_t>(value ? CType::kBoolTrue : CType::kBoolFalse));
+  }
+
+  // Writes a field header. The value of a bool field is encoded in 'type'.
+  void writeFieldBegin(int16_t fieldId, CType type) {
+    auto delta = fieldId - lastFieldId_;
+    if (delta > 0 && delta <= 15) {
+      writeByte((delta << 4) | static_cast<uint8_t>(type));
+    } else {
+      writeByte(static_cast<uint8_t>(type));
+      writeI64(fieldId);
+    }
+    lastFieldId_ = fieldId;
+  }
+
+  void structBegin() {
+    fieldIdStack_.push_back(lastFieldId_);
+    lastFieldId_ = 0;
+  }
+
+  void structEnd() {
+    writeByte(static_cast<uint8_t>(CType::kStop));
+    lastFieldId_ = fieldIdStack_.back();
+    fieldIdStack_.pop_back();
+  }
+
+  void writeListBegin(CType elementType, int32_t size) {
+    if (size < 15) {
+      writeByte((size << 4) | static_cast<uint8_t>(elementType));
+    } else {
+      writeByte(0xf0 | static_cast<uint8_t>(elementType));
+      writeVarint(size);
+    }
+  }
+
+  void i32Field(int16_t fieldId, int32_t value) {
+    writeFieldBegin(fieldId, CType::kI32);
+    writeI32(value);
+  }
+
+  void i64Field(int16_t fieldId, int64_t value) {
+    writeFieldBegin(fieldId, CType::kI64);
+    writeI64(value);
+  }
+
+  void binaryField(int16_t fieldId, const std::string& value) {
+    writeFieldBegin(fieldId, CType::kBinary);
+    writeBinary(value);
+  }
+
+  void boolField(int16_t fieldId, bool value) {
+    writeFieldBegin(fieldId, value ? CType::kBoolTrue : CType::kBoolFalse);
+  }
+
+  template <typename E>
+  void enumField(int16_t fieldId, E value) {
+    i32Field(fieldId, static_cast<int32_t>(value));
+  }
+
+ private:
+  std::string& out_;
+  int16_t lastFieldId_{0};
+  std::vector<int16_t> fieldIdStack_;
+};
+
+// Writes a struct field 'fieldId' whose fields are written by 'writeFields'.
+template <typename WriteFields>
+void structField(
+    CompactWriter& writer,
+    int16_t fieldId,
+    WriteFields writeFields) {
+  writer.writeFieldBegin(fieldId, CType::kStruct);
+  writer.structBegin();
+  writeFields();
+  writer.structEnd();
+}
+
+// Writes a list field 'fieldId' of 'elementType'. 'writeElement' is called
+// for each element of 'values'.
+template <typename T, typename WriteElement>
+void listField(
+    CompactWriter& writer,
+    int16_t fieldId,
+    CType elementType,
+    const std::vector<T>& values,
+    WriteElement writeElement) {
+  writer.writeFieldBegin(fieldId, CType::kList);
+  writer.writeListBegin(elementType, values.size());
+  for (const auto& value : values) {
+    writeElement(value);
+  }
+}
+
+// Writes the fields of a struct element of a list.
+template <typename WriteFields>
+void structElement(CompactWriter& writer, WriteFields writeFields) {
+  writer.structBegin();
+  writeFields();
+  writer.structEnd();
+}
+
+void writeStatistics(CompactWriter& writer, const Statistics& stats) {
+  if (stats.max.has_value()) {
+    writer.binaryField(1, stats.max.value());
+  }
+  if (stats.min.has_value()) {
+    writer.binaryField(2, stats.min.value());
+  }
+  if (stats.nullCount.has_value()) {
+    writer.i64Field(3, stats.nullCount.value());
+  }
+  if (stats.distinctCount.has_value()) {
+    writer.i64Field(4, stats.distinctCount.value());
+  }
+  if (stats.maxValue.has_value()) {
+    writer.binaryField(5, stats.maxValue.value());
+  }
+  if (stats.minValue.has_value()) {
+    writer.binaryField(6, stats.minValue.value());
+  }
+}
+
+void writeSchemaElement(CompactWriter& writer, const SchemaElement& element) {
+  if (element.type.has_value()) {
+    writer.enumField(1, element.type.value());
+  }
+  if (element.type == Type::FIXED_LEN_BYTE_ARRAY) {
+    writer.i32Field(2, element.typeLength);
+  }
+  if (element.repetitionType.has_value()) {
+    writer.enumField(3, element.repetitionType.value());
+  }
+  writer.binaryField(4, element.name);
+  if (!element.type.has_value()) {
+    writer.i32Field(5, element.numChildren);
+  }
+  if (element.convertedType.has_value()) {
+    writer.enumField(6, element.convertedType.value());
+  }
+  if (element.convertedType == ConvertedType::DECIMAL) {
+    writer.i32Field(7, element.scale);
+    writer.i32Field(8, element.precision);
+  }
+}
+
+void writeColumnMetaData(
+    CompactWriter& writer,
+    const ColumnMetaData& metaData) {
+  writer.enumField(1, metaData.type);
+  listField(writer, 2, CType::kI32, metaData.encodings, [&](auto encoding) {
+    writer.writeI32(static_cast<int32_t>(encoding));
+  });
+  listField(
+      writer, 3, CType::kBinary, metaData.pathInSchema, [&](const auto& name) {
+        writer.writeBinary(name);
+      });
+  writer.enumField(4, metaData.codec);
+  writer.i64Field(5, metaData.numValues);
+  writer.i64Field(6, metaData.totalUncompressedSize);
+  writer.i64Field(7, metaData.totalCompressedSize);
+  writer.i64Field(9, metaData.dataPageOffset);
+  if (metaData.indexPageOffset.has_value()) {
+    writer.i64Field(10, metaData.indexPageOffset.value());
+  }
+  if (metaData.dictionaryPageOffset.has_value()) {
+    writer.i64Field(11, metaData.dictionaryPageOffset.value());
+  }
+  if (metaData.statistics.has_value()) {
+    structField(writer, 12, [&]() {
+      writeStatistics(writer, metaData.statistics.value());
+    });
+  }
+}
+
+void writeColumnChunk(CompactWriter& writer, const ColumnChunk& chunk) {
+  if (chunk.filePath.has_value()) {
+    writer.binaryField(1, chunk.filePath.value());
+  }
+  writer.i64Field(2, chunk.fileOffset);
+  if (chunk.metaData.has_value()) {
+    structField(writer, 3, [&]() {
+      writeColumnMetaData(writer, chunk.metaData.value());
+    });
+  }
+  if (chunk.offsetIndexOffset.has_value()) {
+    writer.i64Field(4, chunk.offsetIndexOffset.value());
+  }
+  if (chunk.offsetIndexLength.has_value()) {
+    writer.i32Field(5, chunk.offsetIndexLength.value());
+  }
+  if (chunk.columnIndexOffset.has_value()) {
+    writer.i64Field(6, chunk.columnIndexOffset.value());
+  }
+  if (chunk.columnIndexLength.has_value()) {
+    writer.i32Field(7, chunk.columnIndexLength.value());
+  }
+}
+
+void writeRowGroup(CompactWriter& writer, const RowGroup& rowGroup) {
+  listField(
+      writer, 1, CType::kStruct, rowGroup.columns, [&](const auto& chunk) {
+        structElement(writer, [&]() { writeColumnChunk(writer, chunk); });
+      });
+  writer.i64Field(2, rowGroup.totalByteSize);
+  writer.i64Field(3, rowGroup.numRows);
+  if (rowGroup.fileOffset.has_value()) {
+    writer.i64Field(5, rowGroup.fileOffset.value());
+  }
+  if (rowGroup.totalCompressedSize.has_value()) {
+    writer.i64Field(6, rowGroup.totalCompressedSize.value());
+  }
+}
+
+void writeDataPageHeader(CompactWriter& writer, const DataPageHeader& header) {
+  writer.i32Field(1, header.numValues);
+  writer.enumField(2, header.encoding);
+  writer.enumField(3, header.definitionLevelEncoding);
+  writer.enumField(4, header.repetitionLevelEncoding);
+}
+
+void writeDictionaryPageHeader(
+    CompactWriter& writer,
+    const DictionaryPageHeader& header) {
+  writer.i32Field(1, header.numValues);
+  writer.enumField(2, header.encoding);
+  writer.boolField(3, header.isSorted);
+}
+
+void writeDataPageHeaderV2(
+    CompactWriter& writer,
+    const DataPageHeaderV2& header) {
+  writer.i32Field(1, header.numValues);
+  writer.i32Field(2, header.numNulls);
+  writer.i32Field(3, header.numRows);
+  writer.enumField(4, header.encoding);
+  writer.i32Field(5, header.definitionLevelsByteLength);
+  writer.i32Field(6, header.repetitionLevelsByteLength);
+  writer.boolField(7, header.isCompressed);
+}
+
+void writePageLocation(CompactWriter& writer, const PageLocation& location) {
+  writer.i64Field(1, location.offset);
+  writer.i32Field(2, location.compressedPageSize);
+  writer.i64Field(3, location.firstRowIndex);
+}
+
+} // namespace
+
+void writeFileMetaData(const FileMetaData& metaData, std::string& out) {
+  CompactWriter writer(out);
+  structElement(writer, [&]() {
+    writer.i32Field(1, metaData.version);
+    listField(
+        writer, 2, CType::kStruct, metaData.schema, [&](const auto& element) {
+          structElement(
+              writer, [&]() { writeSchemaElement(writer, element); });
+        });
+    writer.i64Field(3, metaData.numRows);
+    listField(
+        writer,
+        4,
+        CType::kStruct,
+        metaData.rowGroups,
+        [&](const auto& rowGroup) {
+          structElement(writer, [&]() { writeRowGroup(writer, rowGroup); });
+        });
+    if (metaData.createdBy.has_value()) {
+      writer.binaryField(6, metaData.createdBy.value());
+    }
+  });
+}
+
+void writePageHeader(const PageHeader& header, std::string& out) {
+  CompactWriter writer(out);
+  structElement(writer, [&]() {
+    writer.enumField(1, header.type);
+    writer.i32Field(2, header.uncompressedPageSize);
+    writer.i32Field(3, header.compressedPageSize);
+    if (header.dataPageHeader.has_value()) {
+      structField(writer, 5, [&]() {
+        writeDataPageHeader(writer, header.dataPageHeader.value());
+      });
+    }
+    if (header.dictionaryPageHeader.has_value()) {
+      structField(writer, 7, [&]() {
+        writeDictionaryPageHeader(writer, header.dictionaryPageHeader.value());
+      });
+    }
+    if (header.dataPageHeaderV2.has_value()) {
+      structField(writer, 8, [&]() {
+        writeDataPageHeaderV2(writer, header.dataPageHeaderV2.value());
+      });
+    }
+  });
+}
+
+void writeColumnIndex(const ColumnIndex& index, std::string& out) {
+  CompactWriter writer(out);
+  structElement(writer, [&]() {
+    listField(writer, 1, CType::kBoolTrue, index.nullPages, [&](bool isNull) {
+      writer.writeBoolElement(isNull);
+    });
+    listField(
+        writer, 2, CType::kBinary, index.minValues, [&](const auto& value) {
+          writer.writeBinary(value);
+        });
+    listField(
+        writer, 3, CType::kBinary, index.maxValues, [&](const auto& value) {
+          writer.writeBinary(value);
+        });
+    writer.enumField(4, index.boundaryOrder);
+    if (!index.nullCounts.empty()) {
+      listField(writer, 5, CType::kI64, index.nullCounts, [&](auto count) {
+        writer.writeI64(count);
+      });
+    }
+  });
+}
+
+void writeOffsetIndex(const OffsetIndex& index, std::string& out) {
+  CompactWriter writer(out);
+  structElement(writer, [&]() {
+    listField(
+        writer,
+        1,
+        CType::kStruct,
+        index.pageLocations,
+        [&](const auto& location) {
+          structElement(
+              writer, [&]() { writePageLocation(writer, location); });
+        });
+  });
+}
+
+} // namespace facebook::velox::parquet::thrift
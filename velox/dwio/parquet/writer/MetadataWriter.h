@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "velox/dwio/parquet/reader/Metadata.h"
+
+// Encoders for the Parquet file metadata in the Thrift compact protocol. The
+// structs are shared with the reader. Optional fields without a value are
+// not written.
+namespace facebook::velox::parquet::thrift {
+
+// Appends the encoding of 'metaData' to 'out'.
+void writeFileMetaData(const FileMetaData& metaData, std::string& out);
+
+// Appends the encoding of 'header' to 'out'.
+void writePageHeader(const PageHeader& header, std::string& out);
+
+// Append the encoding of a ColumnIndex and an OffsetIndex of the page index
+// to 'out'.
+void writeColumnIndex(const ColumnIndex& index, std::string& out);
+void writeOffsetIndex(const OffsetIndex& index, std::string& out);
+
+} // namespace facebook::velox::parquet::thrift
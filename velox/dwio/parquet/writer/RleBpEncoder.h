@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::parquet {
+
+// Encodes the RLE/bit-packed hybrid encoding that Parquet uses for
+// definition levels, dictionary indices and booleans. See RleBpDecoder for
+// the format. The values of a page are buffered and encoded by finish().
+// Runs of at least 8 equal values become repeated runs, everything else is
+// bit-packed in groups of 8.
+class RleBpEncoder {
+ public:
+  explicit RleBpEncoder(uint8_t bitWidth = 1) : bitWidth_(bitWidth) {
+    VELOX_CHECK_LE(bitWidth, 32, "Parquet RLE bit width too large");
+  }
+
+  // Sets the bit width for finish(). May be called with buffered values,
+  // e.g. when the dictionary grows.
+  void setBitWidth(uint8_t bitWidth) {
+    VELOX_CHECK_LE(bitWidth, 32, "Parquet RLE bit width too large");
+    bitWidth_ = bitWidth;
+  }
+
+  void put(uint32_t value) {
+    values_.push_back(value);
+  }
+
+  int32_t size() const {
+    return values_.size();
+  }
+
+  // Upper bound of the encoded size of the buffered values.
+  int64_t maxEncodedSize() const {
+    return (values_.size() + 7) / 8 * (bitWidth_ + 1) + 8;
+  }
+
+  // Appends the encoded values to 'out' and clears them.
+  void finish(std::string& out) {
+    const auto numValues = values_.size();
+    size_t literalStart = 0;
+    size_t i = 0;
+    while (i < numValues) {
+      auto runEnd = i + 1;
+      while (runEnd < numValues && values_[runEnd] == values_[i]) {
+        ++runEnd;
+      }
+      if (runEnd - i >= kMinRepeats) {
+        // Bit-packed runs hold a multiple of 8 values, so the pending
+        // literals are completed with values of the repeated run.
+        i += (8 - (i - literalStart) % 8) % 8;
+        writeBitPacked(literalStart, i, out);
+        writeRepeated(values_[i], runEnd - i, out);
+        literalStart = runEnd;
+      }
+      i = runEnd;
+    }
+    // The last group is padded with zeros. The reader knows the number of
+    // values and ignores the padding.
+    writeBitPacked(literalStart, numValues, out);
+    values_.clear();
+  }
+
+ private:
+  static constexpr size_t kMinRepeats = 8;
+
+  void writeVarint(uint64_t value, std::string& out) {
+    while (value >= 0x80) {
+      out.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  void writeRepeated(uint32_t value, uint64_t count, std::string& out) {
+    writeVarint(count << 1, out);
+    for (auto i = 0; i < (bitWidth_ + 7) / 8; ++i) {
+      out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+  }
+
+  // Bit-packs values_[begin, end), least significant bit first.
+  void writeBitPacked(size_t begin, size_t end, std::string& out) {
+    if (begin == end) {
+      return;
+    }
+    const auto numGroups = (end - begin + 7) / 8;
+    writeVarint((numGroups << 1) | 1, out);
+    const auto start = out.size();
+    out.resize(start + numGroups * bitWidth_);
+    auto bytes = reinterpret_cast<uint8_t*>(out.data() + start);
+    uint64_t bitOffset = 0;
+    for (auto i = begin; i < end; ++i) {
+      uint64_t value = values_[i];
+      for (auto bit = 0; bit < bitWidth_; ++bit, ++bitOffset) {
+        if (value & (1ULL << bit)) {
+          bytes[bitOffset / 8] |= 1 << (bitOffset % 8);
+        }
+      }
+    }
+  }
+
+  uint8_t bitWidth_;
+  std::vector<uint32_t> values_;
+};
+
+} // namespace facebook::velox::parquet
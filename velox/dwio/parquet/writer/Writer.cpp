@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/writer/Writer.h"
+
+#include "velox/dwio/parquet/writer/MetadataWriter.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::parquet {
+
+using dwio::common::DataBuffer;
+
+namespace {
+
+constexpr const char* kMagic = "PAR1";
+constexpr int32_t kMagicSize = 4;
+
+DataBuffer<char> toBuffer(const std::string& data, memory::MemoryPool& pool) {
+  DataBuffer<char> buffer(pool);
+  buffer.append(0, data.data(), data.size());
+  return buffer;
+}
+
+} // namespace
+
+Writer::Writer(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    const WriterOptions& options,
+    memory::MemoryPool& pool,
+    RowTypePtr schema)
+    : options_(options),
+      sink_(std::move(sink)),
+      pool_(pool),
+      schema_(std::move(schema)) {
+  VELOX_CHECK(
+      options_.compression == thrift::CompressionCodec::UNCOMPRESSED ||
+          options_.compression == thrift::CompressionCodec::SNAPPY ||
+          options_.compression == thrift::CompressionCodec::GZIP ||
+          options_.compression == thrift::CompressionCodec::ZSTD,
+      "Parquet compression codec {} is not supported",
+      static_cast<int>(options_.compression));
+  VELOX_CHECK_GT(options_.maxRowsPerPage, 0);
+
+  thrift::SchemaElement root;
+  root.name = "schema";
+  root.numChildren = schema_->size();
+  metadata_.schema.push_back(root);
+  for (auto i = 0; i < schema_->size(); ++i) {
+    columns_.push_back(ColumnWriter::create(
+        schema_->nameOf(i), schema_->childAt(i), options_, pool_));
+    metadata_.schema.push_back(columns_.back()->schemaElement());
+  }
+  decoded_.resize(columns_.size());
+  metadata_.version = 1;
+  metadata_.createdBy = options_.createdBy;
+
+  sink_->write(toBuffer(std::string(kMagic, kMagicSize), pool_));
+}
+
+void Writer::write(const VectorPtr& data) {
+  VELOX_CHECK(!closed_, "Parquet writer is closed");
+  auto input = data->as<RowVector>();
+  VELOX_CHECK_NOT_NULL(input, "Parquet writer expects a RowVector");
+  VELOX_CHECK_EQ(input->childrenSize(), columns_.size());
+  const auto size = input->size();
+  SelectivityVector rows(size);
+  for (auto i = 0; i < columns_.size(); ++i) {
+    decoded_[i].decode(*input->childAt(i), rows);
+  }
+  for (vector_size_t begin = 0; begin < size; begin += kRowsPerCheck) {
+    const auto end = std::min(size, begin + kRowsPerCheck);
+    for (auto i = 0; i < columns_.size(); ++i) {
+      columns_[i]->append(decoded_[i], begin, end);
+    }
+    bufferedRows_ += end - begin;
+    if (bufferedBytes() >= options_.rowGroupSize) {
+      flush();
+    }
+  }
+}
+
+int64_t Writer::bufferedBytes() const {
+  int64_t bytes = 0;
+  for (const auto& column : columns_) {
+    bytes += column->bufferedBytes();
+  }
+  return bytes;
+}
+
+void Writer::flush() {
+  VELOX_CHECK(!closed_, "Parquet writer is closed");
+  if (bufferedRows_ == 0) {
+    return;
+  }
+  const int32_t rowGroupIndex = metadata_.rowGroups.size();
+  thrift::RowGroup rowGroup;
+  rowGroup.numRows = bufferedRows_;
+  const int64_t start = sink_->size();
+  rowGroup.fileOffset = start;
+  int64_t offset = start;
+  std::vector<DataBuffer<char>> buffers;
+  for (auto i = 0; i < columns_.size(); ++i) {
+    auto flushed = columns_[i]->flush(offset, buffers);
+    const auto& metaData = flushed.chunk.metaData.value();
+    offset += metaData.totalCompressedSize;
+    rowGroup.totalByteSize += metaData.totalUncompressedSize;
+    rowGroup.columns.push_back(std::move(flushed.chunk));
+    if (options_.writePageIndex) {
+      pageIndexes_.push_back(
+          {rowGroupIndex,
+           i,
+           std::move(flushed.columnIndex),
+           std::move(flushed.offsetIndex)});
+    }
+  }
+  rowGroup.totalCompressedSize = offset - start;
+  sink_->writeWithLogging(buffers);
+  VELOX_CHECK_EQ(sink_->size(), offset);
+
+  metadata_.numRows += bufferedRows_;
+  metadata_.rowGroups.push_back(std::move(rowGroup));
+  bufferedRows_ = 0;
+}
+
+void Writer::writePageIndex() {
+  // All column indexes go before all offset indexes.
+  std::string data;
+  const int64_t start = sink_->size();
+  for (auto& index : pageIndexes_) {
+    if (!index.columnIndex.has_value()) {
+      continue;
+    }
+    auto& chunk = metadata_.rowGroups[index.rowGroup].columns[index.column];
+    const auto offset = data.size();
+    thrift::writeColumnIndex(index.columnIndex.value(), data);
+    chunk.columnIndexOffset = start + offset;
+    chunk.columnIndexLength = data.size() - offset;
+  }
+  for (auto& index : pageIndexes_) {
+    auto& chunk = metadata_.rowGroups[index.rowGroup].columns[index.column];
+    const auto offset = data.size();
+    thrift::writeOffsetIndex(index.offsetIndex, data);
+    chunk.offsetIndexOffset = start + offset;
+    chunk.offsetIndexLength = data.size() - offset;
+  }
+  pageIndexes_.clear();
+  if (!data.empty()) {
+    sink_->write(toBuffer(data, pool_));
+  }
+}
+
+void Writer::close() {
+  if (closed_) {
+    return;
+  }
+  flush();
+  writePageIndex();
+
+  std::string footer;
+  thrift::writeFileMetaData(metadata_, footer);
+  const uint32_t footerSize = footer.size();
+  footer.append(reinterpret_cast<const char*>(&footerSize), sizeof(footerSize));
+  footer.append(kMagic, kMagicSize);
+  sink_->write(toBuffer(footer, pool_));
+  sink_->close();
+  closed_ = true;
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/parquet/writer/ColumnWriter.h"
+
+namespace facebook::velox::parquet {
+
+// Streaming Parquet writer for flat schemas. Rows are buffered as
+// compressed pages of the column chunks of the current row group, which is
+// written to the sink when it reaches WriterOptions::rowGroupSize. close()
+// writes the page index of all row groups and the footer.
+class Writer {
+ public:
+  Writer(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      const WriterOptions& options,
+      memory::MemoryPool& pool,
+      RowTypePtr schema);
+
+  // Appends the rows of 'data', a RowVector of the schema.
+  void write(const VectorPtr& data);
+
+  // Writes the buffered rows as a row group.
+  void flush();
+
+  void close();
+
+ private:
+  // Number of rows appended to the column writers between checks of the
+  // row group size.
+  static constexpr vector_size_t kRowsPerCheck = 1024;
+
+  // Page indexes of a column chunk and the chunk metadata to patch with
+  // their locations.
+  struct PendingPageIndex {
+    int32_t rowGroup;
+    int32_t column;
+    std::optional<thrift::ColumnIndex> columnIndex;
+    thrift::OffsetIndex offsetIndex;
+  };
+
+  int64_t bufferedBytes() const;
+
+  void writePageIndex();
+
+  const WriterOptions options_;
+  std::unique_ptr<dwio::common::DataSink> sink_;
+  memory::MemoryPool& pool_;
+  const RowTypePtr schema_;
+  std::vector<std::unique_ptr<ColumnWriter>> columns_;
+  std::vector<DecodedVector> decoded_;
+
+  thrift::FileMetaData metadata_;
+  std::vector<PendingPageIndex> pageIndexes_;
+  int64_t bufferedRows_{0};
+  bool closed_{false};
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/parquet/reader/Metadata.h"
+
+namespace facebook::velox::parquet {
+
+struct WriterOptions {
+  // UNCOMPRESSED, SNAPPY, GZIP or ZSTD.
+  thrift::CompressionCodec compression{thrift::CompressionCodec::SNAPPY};
+
+  // A data page is closed when its encoded values reach 'dataPageSize'
+  // bytes or it has 'maxRowsPerPage' rows.
+  int64_t dataPageSize{1 << 20};
+  int32_t maxRowsPerPage{20'000};
+
+  // A row group is flushed when the buffered pages of its column chunks
+  // reach 'rowGroupSize' bytes.
+  int64_t rowGroupSize{128 << 20};
+
+  // Columns other than BOOLEAN are dictionary encoded until the dictionary
+  // of the column chunk reaches 'dictionaryPageSizeLimit' bytes. The rest of
+  // the column chunk is then PLAIN encoded.
+  bool enableDictionary{true};
+  int64_t dictionaryPageSizeLimit{1 << 20};
+
+  // Writes the column and offset indexes of the data pages, so that readers
+  // can skip pages by their min/max values.
+  bool writePageIndex{true};
+
+  std::string createdBy{"velox"};
+};
+
+} // namespace facebook::velox::parquet
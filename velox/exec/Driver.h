@@ -126,6 +126,9 @@ enum class BlockingReason {
   kWaitForJoinBuild,
   kWaitForMemory,
   kWaitForConnector,
+  // Waiting for the peer Drivers of an operator to finish spilling, e.g.
+  // before the spilled partitions of an aggregation are handed out.
+  kWaitForSpill,
 };
 
 std::string blockingReasonToString(BlockingReason reason);
@@ -42,11 +42,16 @@ std::optional<std::string> makeSpillPath(
   if (isPartial) {
     return std::nullopt;
   }
-  auto path = operatorCtx.task()->queryCtx()->config().spillPath();
-  if (path.has_value()) {
-    return path.value() + "/" + operatorCtx.task()->taskId();
+  return makeOperatorSpillPath(operatorCtx);
+}
+
+std::unique_ptr<TreeOfLosers<SpillStream>> startMerge(SpillFiles files) {
+  std::vector<std::unique_ptr<SpillStream>> streams;
+  for (auto& file : files) {
+    file->startRead(files.size());
+    streams.push_back(std::move(file));
   }
-  return std::nullopt;
+  return std::make_unique<TreeOfLosers<SpillStream>>(std::move(streams));
 }
 } // namespace
 
@@ -80,6 +85,7 @@ GroupingSet::GroupingSet(
           operatorCtx->task()->queryCtx()->config().hashAdaptivityEnabled()),
       execCtx_(*operatorCtx->execCtx()),
       spillPath_(makeSpillPath(isPartial, *operatorCtx)),
+      spillFileOptions_(makeSpillFileOptions(*operatorCtx)),
       pool_(*operatorCtx->pool()),
       spillExecutor_(operatorCtx->task()->queryCtx()->spillExecutor()),
       testSpillPct_(
@@ -396,7 +402,7 @@ bool GroupingSet::getOutput(
   if (isGlobal_) {
     return getGlobalAggregationOutput(batchSize, isPartial_, iterator, result);
   }
-  if (spiller_) {
+  if (spiller_ || !peerSpilledPartitions_.empty() || outputPartition_ != -1) {
     return getOutputWithSpill(result);
   }
 
@@ -446,6 +452,66 @@ void GroupingSet::resetPartial() {
   }
 }
 
+void GroupingSet::toIntermediate(
+    const RowVectorPtr& input,
+    RowVectorPtr& result) {
+  VELOX_CHECK(isPartial_ && isRawInput_ && !isGlobal_);
+  VELOX_CHECK(preGroupedKeyChannels_.empty());
+  if (!table_) {
+    createHashTable();
+  }
+  auto* rows = table_->rows();
+  VELOX_CHECK_EQ(0, rows->numRows());
+
+  auto numRows = input->size();
+  activeRows_.resize(numRows);
+  activeRows_.setAll();
+  if (ignoreNullKeys_) {
+    deselectRowsWithNulls(*input, keyChannels_, activeRows_, execCtx_);
+  }
+
+  // Each row gets a group. The groups of rows with null keys are not read.
+  intermediateGroups_.resize(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    intermediateGroups_[i] = rows->newRow();
+  }
+  intermediateRowNumbers_.resize(numRows);
+  std::iota(intermediateRowNumbers_.begin(), intermediateRowNumbers_.end(), 0);
+
+  result->resize(numRows);
+  auto numKeys = keyChannels_.size();
+  for (auto i = 0; i < numKeys; ++i) {
+    result->childAt(i) = input->childAt(keyChannels_[i]);
+  }
+  masks_.addInput(input, activeRows_);
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    aggregates_[i]->initializeNewGroups(
+        intermediateGroups_.data(), intermediateRowNumbers_);
+    const auto& aggregateRows = getSelectivityVector(i);
+    if (aggregateRows.hasSelections()) {
+      populateTempVectors(i, input);
+      aggregates_[i]->addRawInput(
+          intermediateGroups_.data(), aggregateRows, tempVectors_, false);
+    }
+    aggregates_[i]->finalize(intermediateGroups_.data(), numRows);
+    aggregates_[i]->extractAccumulators(
+        intermediateGroups_.data(), numRows, &result->childAt(numKeys + i));
+  }
+  tempVectors_.clear();
+  // Frees the accumulators and the rows.
+  rows->clear();
+
+  if (!activeRows_.isAllSelected()) {
+    auto numActive = activeRows_.countSelected();
+    auto indices = allocateIndices(numActive, execCtx_.pool());
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    vector_size_t numIndices = 0;
+    activeRows_.applyToSelected(
+        [&](auto row) { rawIndices[numIndices++] = row; });
+    result = wrap(numActive, indices, result);
+  }
+}
+
 uint64_t GroupingSet::allocatedBytes() const {
   if (table_) {
     return table_->allocatedBytes();
@@ -549,13 +615,41 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
         spillPath_.value(),
         fileSize,
         Spiller::spillPool(),
-        spillExecutor_);
+        spillExecutor_,
+        std::vector<CompareFlags>{},
+        spillFileOptions_);
   }
   spiller_->spill(targetRows, targetBytes, spillIterator_);
 }
 
+std::vector<SpillFiles> GroupingSet::takeSpilledPartitions() {
+  VELOX_CHECK(noMoreInput_);
+  VELOX_CHECK_EQ(outputPartition_, -1);
+  std::vector<SpillFiles> partitions;
+  if (!spiller_) {
+    return partitions;
+  }
+  auto spilledPartitions = spiller_->spilledPartitions();
+  spiller_->spill(spilledPartitions);
+  for (auto partition : spilledPartitions) {
+    partitions.push_back(spiller_->files(partition));
+  }
+  return partitions;
+}
+
+void GroupingSet::addSpilledPartition(SpillFiles files) {
+  VELOX_CHECK(isSpillEnabled());
+  VELOX_CHECK_EQ(outputPartition_, -1);
+  VELOX_CHECK(!files.empty());
+  peerSpilledPartitions_.push_back(std::move(files));
+}
+
 bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
   if (outputPartition_ == -1) {
+    if (!table_) {
+      // No input, only partitions spilled by peers.
+      createHashTable();
+    }
     mergeArgs_.resize(1);
     std::vector<TypePtr> keyTypes;
     for (auto& hasher : table_->hashers()) {
@@ -577,17 +671,20 @@ bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
     rowsWhileReadingSpill_ = table_->moveRows();
     table_.reset();
     outputPartition_ = 0;
-    nonSpilledRows_ = spiller_->finishSpill();
+    if (spiller_) {
+      nonSpilledRows_ = spiller_->finishSpill();
+    }
   }
 
-  if (nonSpilledIndex_ < nonSpilledRows_.value().size()) {
+  if (nonSpilledRows_.has_value() &&
+      nonSpilledIndex_ < nonSpilledRows_.value().size()) {
     uint64_t bytes = 0;
     vector_size_t numGroups = 0;
     // Produce non-spilled content at max 1000 rows at a time.
     auto limit = std::min<size_t>(
         1000, nonSpilledRows_.value().size() - nonSpilledIndex_);
     for (; numGroups < limit; ++numGroups) {
-      bytes += table_->rows()->rowSize(
+      bytes += rowsWhileReadingSpill_->rowSize(
           nonSpilledRows_.value()[nonSpilledIndex_ + numGroups]);
       if (bytes > maxBatchBytes_) {
         ++numGroups;
@@ -601,7 +698,7 @@ bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
     nonSpilledIndex_ += numGroups;
     return true;
   }
-  while (outputPartition_ < spiller_->state().maxPartitions()) {
+  while (spiller_ && outputPartition_ < spiller_->state().maxPartitions()) {
     if (!merge_) {
       merge_ = spiller_->startMerge(outputPartition_);
     }
@@ -612,6 +709,19 @@ bool GroupingSet::getOutputWithSpill(const RowVectorPtr& result) {
     }
     return true;
   }
+  // The partitions spilled by peers have no rows in memory and are merged
+  // from their files only.
+  while (merge_ || !peerSpilledPartitions_.empty()) {
+    if (!merge_) {
+      merge_ = startMerge(std::move(peerSpilledPartitions_.back()));
+      peerSpilledPartitions_.pop_back();
+    }
+    if (!mergeNext(result)) {
+      merge_ = nullptr;
+      continue;
+    }
+    return true;
+  }
   return false;
 }
 
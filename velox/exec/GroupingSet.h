@@ -63,6 +63,13 @@ class GroupingSet {
 
   void resetPartial();
 
+  /// Computes the intermediate results of a partial aggregation of 'input'
+  /// with each row as its own group and sets 'result' to the grouping keys
+  /// followed by the accumulators. Rows with null keys are left out if null
+  /// keys are ignored. This is for a partial aggregation that does not reduce
+  /// its input enough to be worth grouping. The hash table must be empty.
+  void toIntermediate(const RowVectorPtr& input, RowVectorPtr& result);
+
   const HashLookup& hashLookup() const;
 
   /// Spills content until under 'targetRows' and under 'targetBytes'
@@ -80,6 +87,30 @@ class GroupingSet {
                     : std::pair<int64_t, int64_t>(0, 0);
   }
 
+  // IO counters of the spill files, nullptr if 'this' has not spilled.
+  const SpillStats* FOLLY_NULLABLE spillStats() const {
+    return spiller_ ? &spiller_->spillStats() : nullptr;
+  }
+
+  /// True if this is a final or single aggregation that spills when it runs
+  /// out of memory.
+  bool isSpillEnabled() const {
+    return !isPartial_ && spillPath_.has_value();
+  }
+
+  /// Spills the rows of spilled partitions that are still in memory and
+  /// returns the spill files of each spilled partition. A partition is then
+  /// merged by whichever GroupingSet of the same aggregation receives it in
+  /// addSpilledPartition(). This spreads the merge of spilled data over the
+  /// Drivers of an aggregation. Called after noMoreInput() and before
+  /// getOutput().
+  std::vector<SpillFiles> takeSpilledPartitions();
+
+  /// Adds a spilled partition from takeSpilledPartitions() of a peer
+  /// GroupingSet. Its groups are produced by getOutput() after the groups of
+  /// 'this'.
+  void addSpilledPartition(SpillFiles files);
+
   /// Return the number of rows kept in memory.
   int64_t numRows() const {
     return table_ ? table_->rows()->numRows() : 0;
@@ -187,6 +218,10 @@ class GroupingSet {
   std::unique_ptr<HashLookup> lookup_;
   SelectivityVector activeRows_;
 
+  // Groups and their row numbers for toIntermediate().
+  std::vector<char*> intermediateGroups_;
+  std::vector<vector_size_t> intermediateRowNumbers_;
+
   // Used to allocate memory for a single row accumulating results of global
   // aggregation
   HashStringAllocator stringAllocator_;
@@ -214,6 +249,8 @@ class GroupingSet {
   // Filesystem path for spill files, empty if spilling is disabled.
   const std::optional<std::string> spillPath_;
 
+  const SpillFileOptions spillFileOptions_;
+
   std::unique_ptr<Spiller> spiller_;
   std::unique_ptr<TreeOfLosers<SpillStream>> merge_;
   RowContainerIterator spillIterator_;
@@ -238,6 +275,9 @@ class GroupingSet {
   // one.
   bool nextKeyIsEqual_{false};
 
+  // Spilled partitions received from peers in addSpilledPartition().
+  std::vector<SpillFiles> peerSpilledPartitions_;
+
   // The set of rows that are outside of the spillable hash number
   // ranges. Used when producing output.
   std::optional<Spiller::SpillRows> nonSpilledRows_;
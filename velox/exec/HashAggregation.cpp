@@ -16,6 +16,7 @@
 #include "velox/exec/HashAggregation.h"
 #include <optional>
 #include "velox/exec/Aggregate.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -35,6 +36,10 @@ HashAggregation::HashAggregation(
       outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
       maxPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxPartialAggregationMemoryUsage()),
+      abandonPartialAggregationMinRows_(
+          driverCtx->queryConfig().abandonPartialAggregationMinRows()),
+      abandonPartialAggregationMinPct_(
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()),
       isPartialOutput_(isPartialOutput(aggregationNode->step())),
       isDistinct_(aggregationNode->aggregates().empty()),
       isGlobal_(aggregationNode->groupingKeys().empty()) {
@@ -135,6 +140,11 @@ HashAggregation::HashAggregation(
     }
   }
 
+  mayAbandonPartialAggregation_ =
+      aggregationNode->step() == core::AggregationNode::Step::kPartial &&
+      !isGlobal_ && aggregationNode->preGroupedKeys().empty() &&
+      abandonPartialAggregationMinPct_ < 100;
+
   groupingSet_ = std::make_unique<GroupingSet>(
       std::move(hashers),
       std::move(preGroupedChannels),
@@ -147,9 +157,108 @@ HashAggregation::HashAggregation(
       isPartialOutput_,
       isRawInput(aggregationNode->step()),
       operatorCtx_.get());
+
+  // The Drivers wait for each other at the end of input, so this is not done
+  // if output may be produced before that.
+  shareSpilledPartitions_ = groupingSet_->isSpillEnabled() && !isGlobal_ &&
+      aggregationNode->preGroupedKeys().empty();
+}
+
+void HashAggregation::noMoreInput() {
+  if (noMoreInput_) {
+    return;
+  }
+  groupingSet_->noMoreInput();
+  Operator::noMoreInput();
+  if (!shareSpilledPartitions_) {
+    return;
+  }
+  std::vector<ContinuePromise> promises;
+  std::vector<std::shared_ptr<Driver>> peers;
+  // The last Driver to finish input hands out the spilled partitions of all
+  // Drivers. The others wait until then.
+  if (!operatorCtx_->task()->allPeersFinished(
+          planNodeId(), operatorCtx_->driver(), &future_, promises, peers)) {
+    return;
+  }
+  if (!peers.empty()) {
+    distributeSpilledPartitions(peers);
+  }
+  peers.clear();
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+}
+
+void HashAggregation::distributeSpilledPartitions(
+    const std::vector<std::shared_ptr<Driver>>& peers) {
+  std::vector<GroupingSet*> groupingSets = {groupingSet_.get()};
+  for (auto& peer : peers) {
+    auto op = dynamic_cast<HashAggregation*>(peer->findOperator(planNodeId()));
+    VELOX_CHECK_NOT_NULL(op);
+    groupingSets.push_back(op->groupingSet_.get());
+  }
+
+  // The peers are blocked, so their remaining spill runs are written on the
+  // query executor using their threads.
+  std::vector<std::function<std::unique_ptr<std::vector<SpillFiles>>()>>
+      tasks;
+  for (auto* groupingSet : groupingSets) {
+    tasks.push_back([groupingSet]() {
+      return std::make_unique<std::vector<SpillFiles>>(
+          groupingSet->takeSpilledPartitions());
+    });
+  }
+  auto results = runInParallel<std::vector<SpillFiles>>(
+      std::move(tasks), operatorCtx_->task()->queryCtx()->executor());
+
+  std::vector<std::pair<uint64_t, SpillFiles>> partitions;
+  for (auto& result : results) {
+    for (auto& files : *result) {
+      uint64_t size = 0;
+      for (auto& file : files) {
+        size += file->size();
+      }
+      partitions.emplace_back(size, std::move(files));
+    }
+  }
+  if (partitions.empty()) {
+    return;
+  }
+
+  // The largest partition goes to the GroupingSet with the least bytes to
+  // merge so far.
+  std::sort(
+      partitions.begin(),
+      partitions.end(),
+      [](const auto& left, const auto& right) {
+        return left.first > right.first;
+      });
+  std::vector<uint64_t> assignedBytes(groupingSets.size());
+  for (auto& [size, files] : partitions) {
+    auto target = std::min_element(assignedBytes.begin(), assignedBytes.end()) -
+        assignedBytes.begin();
+    assignedBytes[target] += size;
+    groupingSets[target]->addSpilledPartition(std::move(files));
+  }
+  stats_.addRuntimeStat(
+      "distributedSpillPartitions", RuntimeCounter(partitions.size()));
+}
+
+BlockingReason HashAggregation::isBlocked(ContinueFuture* future) {
+  if (!future_.valid()) {
+    return BlockingReason::kNotBlocked;
+  }
+  *future = std::move(future_);
+  return BlockingReason::kWaitForSpill;
 }
 
 void HashAggregation::addInput(RowVectorPtr input) {
+  if (abandonedPartialAggregation_) {
+    // Converted to intermediate results in getOutput().
+    input_ = input;
+    return;
+  }
   if (!pushdownChecked_) {
     mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
     pushdownChecked_ = true;
@@ -158,12 +267,23 @@ void HashAggregation::addInput(RowVectorPtr input) {
   auto spilled = groupingSet_->spilledBytesAndRows();
   stats_.spilledBytes = spilled.first;
   stats_.spilledRows = spilled.second;
+  if (auto spillStats = groupingSet_->spillStats()) {
+    setSpillRuntimeStats(*spillStats, stats_);
+  }
 
   if (isPartialOutput_ &&
       groupingSet_->allocatedBytes() > maxPartialAggregationMemoryUsage_) {
     partialFull_ = true;
   }
 
+  numInputRows_ += input->size();
+  if (mayAbandonPartialAggregation_ && shouldAbandonPartialAggregation()) {
+    // The groups so far are flushed before the input is passed through.
+    abandonedPartialAggregation_ = true;
+    partialFull_ = true;
+    stats_.addRuntimeStat("abandonedPartialAggregation", RuntimeCounter(1));
+  }
+
   if (isDistinct_) {
     newDistincts_ = !groupingSet_->hashLookup().newGroups.empty();
 
@@ -185,8 +305,26 @@ void HashAggregation::prepareOutput(vector_size_t size) {
   }
 }
 
+bool HashAggregation::shouldAbandonPartialAggregation() const {
+  if (numInputRows_ < abandonPartialAggregationMinRows_) {
+    return false;
+  }
+  auto numGroups = numFlushedGroups_ + groupingSet_->numRows();
+  return 100 * numGroups >= abandonPartialAggregationMinPct_ * numInputRows_;
+}
+
+RowVectorPtr HashAggregation::getAbandonedPartialAggregationOutput() {
+  auto input = std::move(input_);
+  prepareOutput(input->size());
+  groupingSet_->toIntermediate(input, output_);
+  stats_.addRuntimeStat(
+      "abandonedPartialAggregationRows", RuntimeCounter(output_->size()));
+  return output_;
+}
+
 void HashAggregation::flushPartialOutputIfNeed() {
   if (partialFull_) {
+    numFlushedGroups_ += groupingSet_->numRows();
     stats().addRuntimeStat(
         "flushRowCount", RuntimeCounter(groupingSet_->numRows()));
     groupingSet_->resetPartial();
@@ -200,6 +338,12 @@ RowVectorPtr HashAggregation::getOutput() {
     return nullptr;
   }
 
+  // The groups made before abandoning the partial aggregation are flushed
+  // first.
+  if (abandonedPartialAggregation_ && !partialFull_ && input_) {
+    return getAbandonedPartialAggregationOutput();
+  }
+
   // Produce results if one of the following is true:
   // - received no-more-input message;
   // - partial aggregation reached memory limit;
@@ -241,6 +385,10 @@ RowVectorPtr HashAggregation::getOutput() {
   prepareOutput(batchSize);
 
   bool hasData = groupingSet_->getOutput(batchSize, resultIterator_, output_);
+  if (auto spillStats = groupingSet_->spillStats()) {
+    // Output after spilling is read from the spill files.
+    setSpillRuntimeStats(*spillStats, stats_);
+  }
   if (!hasData) {
     resultIterator_.reset();
 
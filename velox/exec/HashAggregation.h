@@ -32,17 +32,15 @@ class HashAggregation : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !partialFull_;
+    // After abandoning partial aggregation, 'input_' is held until
+    // getOutput() passes it through.
+    return !noMoreInput_ && !partialFull_ &&
+        !(abandonedPartialAggregation_ && input_ != nullptr);
   }
 
-  void noMoreInput() override {
-    groupingSet_->noMoreInput();
-    Operator::noMoreInput();
-  }
+  void noMoreInput() override;
 
-  BlockingReason isBlocked(ContinueFuture* /* unused */) override {
-    return BlockingReason::kNotBlocked;
-  }
+  BlockingReason isBlocked(ContinueFuture* future) override;
 
   bool isFinished() override;
 
@@ -55,17 +53,55 @@ class HashAggregation : public Operator {
   void prepareOutput(vector_size_t size);
   void flushPartialOutputIfNeed();
 
+  // Called by the last Driver to finish input. Collects the spilled
+  // partitions of all peers and assigns each to one of them for merging, so
+  // that the merge of different partitions proceeds in parallel.
+  void distributeSpilledPartitions(
+      const std::vector<std::shared_ptr<Driver>>& peers);
+
+  // Returns true if the partial aggregation has seen enough input to tell
+  // that it does not reduce the number of rows enough to be worth grouping.
+  bool shouldAbandonPartialAggregation() const;
+
+  // Returns the intermediate results for 'input_' with each row as its own
+  // group.
+  RowVectorPtr getAbandonedPartialAggregationOutput();
+
   /// Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
   const int64_t maxPartialAggregationMemoryUsage_;
 
+  // Minimum input rows and percentage of groups to input rows for abandoning
+  // a partial aggregation. See QueryConfig.
+  const int64_t abandonPartialAggregationMinRows_;
+  const int32_t abandonPartialAggregationMinPct_;
+
   const bool isPartialOutput_;
   const bool isDistinct_;
   const bool isGlobal_;
 
   std::unique_ptr<GroupingSet> groupingSet_;
 
+  // True if this is a partial aggregation over raw input that may switch to
+  // passing its input through without grouping.
+  bool mayAbandonPartialAggregation_ = false;
+
+  // True after switching to passing the input through.
+  bool abandonedPartialAggregation_ = false;
+
+  // Number of input rows and of groups flushed before switching to passing
+  // the input through.
+  int64_t numInputRows_ = 0;
+  int64_t numFlushedGroups_ = 0;
+
+  // True if the spilled partitions are merged by all Drivers of the
+  // aggregation instead of by the Driver that spilled them.
+  bool shareSpilledPartitions_ = false;
+
+  // Set while waiting for the peers to finish input.
+  ContinueFuture future_;
+
   bool partialFull_ = false;
   bool newDistincts_ = false;
   bool finished_ = false;
@@ -20,7 +20,10 @@
 
 namespace facebook::velox::exec {
 
-void HashJoinBridge::setHashTable(std::unique_ptr<BaseHashTable> table) {
+void HashJoinBridge::setHashTable(
+    std::unique_ptr<BaseHashTable> table,
+    std::shared_ptr<HashJoinSpill> spill,
+    std::vector<std::shared_ptr<common::Filter>> bloomFilters) {
   VELOX_CHECK(table, "setHashTable called with null table");
 
   std::vector<ContinuePromise> promises;
@@ -29,6 +32,8 @@ void HashJoinBridge::setHashTable(std::unique_ptr<BaseHashTable> table) {
     VELOX_CHECK(!table_, "setHashTable may be called only once");
     // Ownership becomes shared.
     table_.reset(table.release());
+    spill_ = std::move(spill);
+    bloomFilters_ = std::move(bloomFilters);
     promises = std::move(promises_);
   }
   notify(std::move(promises));
@@ -54,20 +59,111 @@ std::optional<HashJoinBridge::HashBuildResult> HashJoinBridge::tableOrFuture(
   VELOX_CHECK(
       !cancelled_, "Getting hash table after the build side is aborted");
   if (table_ || antiJoinHasNullKeys_) {
-    return HashBuildResult{table_, antiJoinHasNullKeys_};
+    return HashBuildResult{
+        table_, antiJoinHasNullKeys_, spill_, bloomFilters_};
   }
   promises_.emplace_back("HashJoinBridge::tableOrFuture");
   *future = promises_.back().getSemiFuture();
   return std::nullopt;
 }
 
+namespace {
+// Spill partitions are selected by bits 29-31 of the key hash. The low bits
+// select the hash table slot and bits 32 and up make the hash table tags.
+constexpr uint8_t kSpillBitsBegin = 29;
+} // namespace
+
+std::unique_ptr<BaseHashTable> createJoinTable(
+    const core::HashJoinNode& joinNode,
+    std::vector<std::unique_ptr<VectorHasher>> keyHashers,
+    const std::vector<TypePtr>& dependentTypes,
+    memory::MappedMemory* mappedMemory) {
+  if (joinNode.isRightJoin() || joinNode.isFullJoin()) {
+    // Do not ignore null keys.
+    return HashTable<false>::createForJoin(
+        std::move(keyHashers),
+        dependentTypes,
+        true, // allowDuplicates
+        true, // hasProbedFlag
+        mappedMemory);
+  }
+  // Semi and anti join with no extra filter only needs to know whether there
+  // is a match. Hence, no need to store entries with duplicate keys.
+  const bool dropDuplicates = !joinNode.filter() &&
+      (joinNode.isLeftSemiJoin() || joinNode.isAntiJoin());
+
+  return HashTable<true>::createForJoin(
+      std::move(keyHashers),
+      dependentTypes,
+      !dropDuplicates, // allowDuplicates
+      false, // hasProbedFlag
+      mappedMemory);
+}
+
+void storeJoinBuildRows(
+    const RowVector& input,
+    const SelectivityVector& rows,
+    const std::vector<column_index_t>& dependentChannels,
+    std::vector<std::unique_ptr<DecodedVector>>& decoders,
+    bool& analyzeKeys,
+    raw_vector<uint64_t>& hashes,
+    BaseHashTable& table) {
+  if (analyzeKeys && hashes.size() < rows.size()) {
+    hashes.resize(rows.size());
+  }
+
+  auto& hashers = table.hashers();
+
+  // As long as analyzeKeys is true, we keep running the keys through
+  // the Vectorhashers so that we get a possible mapping of the keys
+  // to small ints for array or normalized key. When mayUseValueIds is
+  // false for the first time we stop. We do not retain the value ids
+  // since the final ones will only be known after all data is
+  // received.
+  for (auto& hasher : hashers) {
+    // TODO: Load only for active rows, except if right/full outer join.
+    if (analyzeKeys) {
+      hasher->computeValueIds(
+          *input.childAt(hasher->channel())->loadedVector(), rows, hashes);
+      analyzeKeys = hasher->mayUseValueIds();
+    } else {
+      hasher->decode(*input.childAt(hasher->channel())->loadedVector(), rows);
+    }
+  }
+  for (auto i = 0; i < dependentChannels.size(); ++i) {
+    decoders[i]->decode(
+        *input.childAt(dependentChannels[i])->loadedVector(), rows);
+  }
+  auto container = table.rows();
+  auto nextOffset = container->nextOffset();
+  rows.applyToSelected([&](auto rowIndex) {
+    char* newRow = container->newRow();
+    if (nextOffset) {
+      *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+    }
+    // Store the columns for each row in sequence. At probe time
+    // strings of the row will probably be in consecutive places, so
+    // reading one will prime the cache for the next.
+    for (auto i = 0; i < hashers.size(); ++i) {
+      container->store(hashers[i]->decodedVector(), rowIndex, newRow, i);
+    }
+    for (auto i = 0; i < dependentChannels.size(); ++i) {
+      container->store(*decoders[i], rowIndex, newRow, i + hashers.size());
+    }
+  });
+}
+
 HashBuild::HashBuild(
     int32_t operatorId,
     DriverCtx* driverCtx,
     std::shared_ptr<const core::HashJoinNode> joinNode)
     : Operator(driverCtx, nullptr, operatorId, joinNode->id(), "HashBuild"),
       joinType_{joinNode->joinType()},
-      mappedMemory_(operatorCtx_->mappedMemory()) {
+      mappedMemory_(operatorCtx_->mappedMemory()),
+      spillPath_(makeOperatorSpillPath(*operatorCtx_)),
+      spillExecutor_(operatorCtx_->task()->queryCtx()->spillExecutor()),
+      testSpillPct_(
+          operatorCtx_->task()->queryCtx()->config().testingSpillPct()) {
   auto type = joinNode->sources()[1]->outputType();
 
   auto numKeys = joinNode->rightKeys().size();
@@ -76,12 +172,18 @@ HashBuild::HashBuild(
   keyChannelSet.reserve(numKeys);
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
   keyHashers.reserve(numKeys);
+  std::vector<std::string> names;
+  std::vector<TypePtr> types;
+  names.reserve(type->size());
+  types.reserve(type->size());
   for (auto& key : joinNode->rightKeys()) {
     auto channel = exprToChannel(key.get(), type);
     keyChannelSet.emplace(channel);
     keyChannels_.emplace_back(channel);
     keyHashers.emplace_back(
         std::make_unique<VectorHasher>(type->childAt(channel), channel));
+    names.emplace_back(type->nameOf(channel));
+    types.emplace_back(type->childAt(channel));
   }
 
   // Identify the non-key build side columns and make a decoder for each.
@@ -95,30 +197,14 @@ HashBuild::HashBuild(
       dependentTypes.emplace_back(type->childAt(i));
       dependentChannels_.emplace_back(i);
       decoders_.emplace_back(std::make_unique<DecodedVector>());
+      names.emplace_back(type->nameOf(i));
+      types.emplace_back(type->childAt(i));
     }
   }
+  tableType_ = ROW(std::move(names), std::move(types));
 
-  if (joinNode->isRightJoin() || joinNode->isFullJoin()) {
-    // Do not ignore null keys.
-    table_ = HashTable<false>::createForJoin(
-        std::move(keyHashers),
-        dependentTypes,
-        true, // allowDuplicates
-        true, // hasProbedFlag
-        mappedMemory_);
-  } else {
-    // Semi and anti join with no extra filter only needs to know whether there
-    // is a match. Hence, no need to store entries with duplicate keys.
-    const bool dropDuplicates = !joinNode->filter() &&
-        (joinNode->isLeftSemiJoin() || joinNode->isAntiJoin());
-
-    table_ = HashTable<true>::createForJoin(
-        std::move(keyHashers),
-        dependentTypes,
-        !dropDuplicates, // allowDuplicates
-        false, // hasProbedFlag
-        mappedMemory_);
-  }
+  table_ = createJoinTable(
+      *joinNode, std::move(keyHashers), dependentTypes, mappedMemory_);
   analyzeKeys_ = table_->hashMode() != BaseHashTable::HashMode::kHash;
 }
 
@@ -140,52 +226,220 @@ void HashBuild::addInput(RowVectorPtr input) {
     }
   }
 
-  if (analyzeKeys_ && hashes_.size() < activeRows_.size()) {
-    hashes_.resize(activeRows_.size());
+  ensureInputFits(input);
+
+  if (spiller_) {
+    spillInput(input);
+    if (!activeRows_.hasSelections()) {
+      return;
+    }
+  }
+
+  storeJoinBuildRows(
+      *input,
+      activeRows_,
+      dependentChannels_,
+      decoders_,
+      analyzeKeys_,
+      hashes_,
+      *table_);
+}
+
+void HashBuild::ensureInputFits(const RowVectorPtr& input) {
+  // Spilling is considered if spillPath is set.
+  if (!spillPath_.has_value()) {
+    return;
+  }
+  auto rows = table_->rows();
+  auto numRows = rows->numRows();
+  if (!numRows) {
+    // Container is empty. Nothing to spill.
+    return;
+  }
+
+  auto [freeRows, outOfLineFreeBytes] = rows->freeSpace();
+  auto outOfLineBytes =
+      rows->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  auto outOfLineBytesPerRow = outOfLineBytes / numRows;
+
+  // Test-only spill path.
+  if (testSpillPct_ &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <= testSpillPct_) {
+    auto rowsToSpill = numRows / 10;
+    spill(
+        numRows - rowsToSpill,
+        outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow));
+    return;
+  }
+
+  int64_t flatBytes = input->estimateFlatSize();
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the
+  // input as a cap on the new variable length data needed.
+  auto increment =
+      rows->sizeIncrement(input->size(), outOfLineBytes ? flatBytes : 0);
+  auto tracker = mappedMemory_->tracker();
+  if (!tracker) {
+    return;
+  }
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * increment) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of
+  // twice the maximum increment from this input and 1/4 of the current
+  // reservation.
+  auto targetIncrement =
+      std::max<int64_t>(increment * 2, tracker->getCurrentUserBytes() / 4);
+  if (tracker->maybeReserve(targetIncrement)) {
+    return;
+  }
+  auto rowsToSpill =
+      targetIncrement / (rows->fixedRowSize() + outOfLineBytesPerRow);
+
+  spill(
+      numRows - rowsToSpill,
+      outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow));
+}
+
+void HashBuild::ensureSpiller() {
+  if (spiller_) {
+    return;
   }
+  VELOX_CHECK(spillPath_.has_value());
+  auto tracker = mappedMemory_->tracker();
+  auto fileSize = tracker ? tracker->getCurrentUserBytes() / 4
+                          : std::numeric_limits<int64_t>::max();
+  auto rows = table_->rows();
+  spiller_ = std::make_unique<Spiller>(
+      *rows,
+      [rows](folly::Range<char**> spilled) { rows->eraseRows(spilled); },
+      tableType_,
+      HashBitRange(
+          kSpillBitsBegin, kSpillBitsBegin + HashJoinSpill::kPartitionBits),
+      // The spilled rows are not sorted.
+      0,
+      spillPath_.value(),
+      fileSize,
+      Spiller::spillPool(),
+      spillExecutor_,
+      std::vector<CompareFlags>{},
+      makeSpillFileOptions(*operatorCtx_));
+}
+
+void HashBuild::spill(int64_t targetRows, int64_t targetBytes) {
+  ensureSpiller();
+  spiller_->spill(targetRows, targetBytes, spillIterator_);
+  updateSpillStats();
+}
 
+void HashBuild::spillInput(const RowVectorPtr& input) {
+  auto partitions = spiller_->spilledPartitions();
+  if (partitions.empty()) {
+    return;
+  }
+  auto numInput = input->size();
+  spillHashes_.resize(numInput);
   auto& hashers = table_->hashers();
+  for (auto i = 0; i < hashers.size(); ++i) {
+    hashers[i]->hash(
+        *input->childAt(keyChannels_[i])->loadedVector(),
+        activeRows_,
+        i > 0,
+        spillHashes_);
+  }
 
-  // As long as analyzeKeys is true, we keep running the keys through
-  // the Vectorhashers so that we get a possible mapping of the keys
-  // to small ints for array or normalized key. When mayUseValueIds is
-  // false for the first time we stop. We do not retain the value ids
-  // since the final ones will only be known after all data is
-  // received.
-  for (auto& hasher : hashers) {
-    // TODO: Load only for active rows, except if right/full outer join.
-    if (analyzeKeys_) {
-      hasher->computeValueIds(
-          *input->childAt(hasher->channel())->loadedVector(),
-          activeRows_,
-          hashes_);
-      analyzeKeys_ = hasher->mayUseValueIds();
-    } else {
-      hasher->decode(
-          *input->childAt(hasher->channel())->loadedVector(), activeRows_);
+  HashBitRange bits(
+      kSpillBitsBegin, kSpillBitsBegin + HashJoinSpill::kPartitionBits);
+  std::vector<std::vector<vector_size_t>> spillRows(bits.numPartitions());
+  activeRows_.applyToSelected([&](auto row) {
+    auto partition = bits.partition(spillHashes_[row], bits.numPartitions());
+    if (partitions.find(partition) != partitions.end()) {
+      spillRows[partition].push_back(row);
     }
+  });
+
+  // The spilled rows are in table order, i.e. keys first.
+  std::vector<VectorPtr> columns;
+  columns.reserve(tableType_->size());
+  for (auto channel : keyChannels_) {
+    columns.push_back(BaseVector::loadedVectorShared(input->childAt(channel)));
   }
-  for (auto i = 0; i < dependentChannels_.size(); ++i) {
-    decoders_[i]->decode(
-        *input->childAt(dependentChannels_[i])->loadedVector(), activeRows_);
+  for (auto channel : dependentChannels_) {
+    columns.push_back(BaseVector::loadedVectorShared(input->childAt(channel)));
   }
-  auto rows = table_->rows();
-  auto nextOffset = rows->nextOffset();
-  activeRows_.applyToSelected([&](auto rowIndex) {
-    char* newRow = rows->newRow();
-    if (nextOffset) {
-      *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+  for (auto partition = 0; partition < spillRows.size(); ++partition) {
+    auto& rows = spillRows[partition];
+    if (rows.empty()) {
+      continue;
     }
-    // Store the columns for each row in sequence. At probe time
-    // strings of the row will probably be in consecutive places, so
-    // reading one will prime the cache for the next.
-    for (auto i = 0; i < hashers.size(); ++i) {
-      rows->store(hashers[i]->decodedVector(), rowIndex, newRow, i);
+    auto numRows = rows.size();
+    auto indices = allocateIndices(numRows, pool());
+    auto rawIndices = indices->asMutable<vector_size_t>();
+    for (auto i = 0; i < numRows; ++i) {
+      rawIndices[i] = rows[i];
+      activeRows_.setValid(rows[i], false);
     }
-    for (auto i = 0; i < dependentChannels_.size(); ++i) {
-      rows->store(*decoders_[i], rowIndex, newRow, i + hashers.size());
+    std::vector<VectorPtr> children;
+    children.reserve(columns.size());
+    for (auto& column : columns) {
+      children.push_back(wrapChild(numRows, indices, column));
     }
-  });
+    spiller_->spill(
+        partition,
+        std::make_shared<RowVector>(
+            pool(), tableType_, nullptr, numRows, std::move(children)));
+  }
+  activeRows_.updateBounds();
+  updateSpillStats();
+}
+
+std::shared_ptr<HashJoinSpill> HashBuild::finishSpill(
+    const std::vector<HashBuild*>& otherBuilds) {
+  std::vector<HashBuild*> builds(otherBuilds.begin(), otherBuilds.end());
+  builds.push_back(this);
+
+  std::unordered_set<int32_t> partitions;
+  for (auto* build : builds) {
+    if (build->spiller_) {
+      auto spilled = build->spiller_->spilledPartitions();
+      partitions.insert(spilled.begin(), spilled.end());
+    }
+  }
+  if (partitions.empty()) {
+    return nullptr;
+  }
+
+  auto spill = std::make_shared<HashJoinSpill>(HashBitRange(
+      kSpillBitsBegin, kSpillBitsBegin + HashJoinSpill::kPartitionBits));
+  for (auto* build : builds) {
+    // A partition is either in memory or spilled in all builds.
+    build->ensureSpiller();
+    build->spiller_->spill(partitions);
+    build->updateSpillStats();
+    for (auto partition : partitions) {
+      auto& files = spill->files[partition];
+      for (auto& file : build->spiller_->files(partition)) {
+        files.push_back(std::move(file));
+      }
+    }
+  }
+  return spill;
+}
+
+void HashBuild::updateSpillStats() {
+  auto spilled = spiller_->spilledBytesAndRows();
+  stats_.spilledBytes = spilled.first;
+  stats_.spilledRows = spilled.second;
+  setSpillRuntimeStats(spiller_->spillStats(), stats_);
 }
 
 void HashBuild::noMoreInput() {
@@ -206,8 +460,8 @@ void HashBuild::noMoreInput() {
     return;
   }
 
-  std::vector<std::unique_ptr<BaseHashTable>> otherTables;
-  otherTables.reserve(peers.size());
+  std::vector<HashBuild*> otherBuilds;
+  otherBuilds.reserve(peers.size());
 
   if (!antiJoinHasNullKeys_) {
     for (auto& peer : peers) {
@@ -218,6 +472,23 @@ void HashBuild::noMoreInput() {
         antiJoinHasNullKeys_ = true;
         break;
       }
+      otherBuilds.push_back(build);
+    }
+  }
+
+  std::shared_ptr<HashJoinSpill> spill;
+  std::vector<std::unique_ptr<BaseHashTable>> otherTables;
+  // The RowContainers of the combined table. These stay in place when
+  // 'otherTables' move into 'table_'.
+  std::vector<RowContainer*> allRows;
+  if (!antiJoinHasNullKeys_) {
+    // The spilled partitions must be the same in all builds before the
+    // tables are combined.
+    spill = finishSpill(otherBuilds);
+    otherTables.reserve(otherBuilds.size());
+    allRows.push_back(table_->rows());
+    for (auto* build : otherBuilds) {
+      allRows.push_back(build->table_->rows());
       otherTables.push_back(std::move(build->table_));
     }
   }
@@ -235,15 +506,136 @@ void HashBuild::noMoreInput() {
             operatorCtx_->driverCtx()->splitGroupId, planNodeId())
         ->setAntiJoinHasNullKeys();
   } else {
-    table_->prepareJoinTable(std::move(otherTables));
+    // The peer Drivers are done, so the table is built on the query
+    // executor using their threads.
+    table_->prepareJoinTable(
+        std::move(otherTables),
+        operatorCtx_->task()->queryCtx()->executor());
 
     addRuntimeStats();
 
+    // A filter that drops probe rows would drop the rows of the spilled
+    // partitions too.
+    std::vector<std::shared_ptr<common::Filter>> bloomFilters;
+    if (!spill) {
+      bloomFilters = makeBloomFilters(allRows);
+    }
+
     operatorCtx_->task()
         ->getHashJoinBridge(
             operatorCtx_->driverCtx()->splitGroupId, planNodeId())
-        ->setHashTable(std::move(table_));
+        ->setHashTable(
+            std::move(table_), std::move(spill), std::move(bloomFilters));
+  }
+}
+
+namespace {
+// Largest build side for which Bloom filters are made. The filters take 2
+// bytes per entry, which are counted against the pool of the HashBuild.
+constexpr uint64_t kMaxBloomFilterEntries = 8 << 20;
+
+template <typename T>
+void addKeysToBloomFilter(
+    const std::vector<RowContainer*>& containers,
+    int32_t keyIndex,
+    BloomFilter<>& bloomFilter,
+    int64_t& min,
+    int64_t& max) {
+  constexpr int32_t kBatchSize = 1'000;
+  std::vector<char*> rows(kBatchSize);
+  for (auto* container : containers) {
+    auto column = container->columnAt(keyIndex);
+    RowContainerIterator iter;
+    while (auto numRows =
+               container->listRows(&iter, kBatchSize, rows.data())) {
+      for (auto i = 0; i < numRows; ++i) {
+        if (RowContainer::isNullAt(
+                rows[i], column.nullByte(), column.nullMask())) {
+          continue;
+        }
+        int64_t value =
+            *reinterpret_cast<const T*>(rows[i] + column.offset());
+        bloomFilter.insert(value);
+        min = std::min(min, value);
+        max = std::max(max, value);
+      }
+    }
+  }
+}
+
+// Counts the bits of 'bloomFilter' against 'tracker' until the last scan that
+// the filter is pushed into drops it, which may be after the HashBuild is
+// gone.
+std::shared_ptr<const BloomFilter<>> trackBloomFilter(
+    std::unique_ptr<BloomFilter<>> bloomFilter,
+    const std::shared_ptr<memory::MemoryUsageTracker>& tracker) {
+  if (!tracker) {
+    return bloomFilter;
+  }
+  const int64_t size = bloomFilter->sizeInBytes();
+  tracker->update(size);
+  return std::shared_ptr<const BloomFilter<>>(
+      bloomFilter.release(), [tracker, size](const BloomFilter<>* filter) {
+        delete filter;
+        tracker->update(-size);
+      });
+}
+} // namespace
+
+std::vector<std::shared_ptr<common::Filter>> HashBuild::makeBloomFilters(
+    const std::vector<RowContainer*>& rows) const {
+  const auto& hashers = table_->hashers();
+  std::vector<std::shared_ptr<common::Filter>> filters(hashers.size());
+  // HashProbe pushes down dynamic filters only for these joins.
+  if (!isInnerJoin(joinType_) && !isLeftSemiJoin(joinType_)) {
+    return filters;
+  }
+  uint64_t numRows = 0;
+  for (auto* container : rows) {
+    numRows += container->numRows();
+  }
+  if (numRows == 0 || numRows > kMaxBloomFilterEntries) {
+    return filters;
+  }
+  const auto& tracker = operatorCtx_->pool()->getMemoryUsageTracker();
+  for (auto i = 0; i < hashers.size(); ++i) {
+    // In kHash mode the hashers may have stopped collecting values, so there
+    // is no exact filter from them for any key.
+    if (table_->hashMode() != BaseHashTable::HashMode::kHash &&
+        !hashers[i]->distinctOverflow()) {
+      continue;
+    }
+    auto bloomFilter = std::make_unique<BloomFilter<>>();
+    bloomFilter->reset(numRows);
+    int64_t min = std::numeric_limits<int64_t>::max();
+    int64_t max = std::numeric_limits<int64_t>::min();
+    switch (hashers[i]->typeKind()) {
+      case TypeKind::TINYINT:
+        addKeysToBloomFilter<int8_t>(rows, i, *bloomFilter, min, max);
+        break;
+      case TypeKind::SMALLINT:
+        addKeysToBloomFilter<int16_t>(rows, i, *bloomFilter, min, max);
+        break;
+      case TypeKind::INTEGER:
+        addKeysToBloomFilter<int32_t>(rows, i, *bloomFilter, min, max);
+        break;
+      case TypeKind::BIGINT:
+        addKeysToBloomFilter<int64_t>(rows, i, *bloomFilter, min, max);
+        break;
+      default:
+        continue;
+    }
+    if (min > max) {
+      // All keys are null.
+      continue;
+    }
+    filters[i] = std::make_shared<common::BigintValuesUsingBloomFilter>(
+        min,
+        max,
+        trackBloomFilter(std::move(bloomFilter), tracker),
+        false);
   }
+  return filters;
 }
 
 void HashBuild::addRuntimeStats() {
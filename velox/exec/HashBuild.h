@@ -18,18 +18,44 @@
 #include "velox/exec/HashTable.h"
 #include "velox/exec/JoinBridge.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/expression/Expr.h"
 
 namespace facebook::velox::exec {
 
+// Describes the part of a hash join build side that did not fit in
+// memory. The build side rows are partitioned on 'bits' of the hash number
+// of the join keys. The rows of the partitions in 'files' are spilled, the
+// rows of all other partitions are in the hash table. The probe side rows of
+// a spilled partition are spilled as well and the partition is joined after
+// the in-memory partitions.
+struct HashJoinSpill {
+  // Number of hash number bits that select a spill partition. A spilled
+  // partition that does not fit in memory is split again on the next bits.
+  static constexpr uint8_t kPartitionBits = 3;
+
+  explicit HashJoinSpill(HashBitRange _bits) : bits(_bits) {}
+
+  const HashBitRange bits;
+
+  // The build side spill files of each spilled partition.
+  std::unordered_map<int32_t, std::vector<std::unique_ptr<SpillFile>>> files;
+};
+
 // Hands over a hash table from a multi-threaded build pipeline to a
 // multi-threaded probe pipeline. This is owned by shared_ptr by all the build
 // and probe Operator instances concerned. Corresponds to the Presto concept of
 // the same name.
 class HashJoinBridge : public JoinBridge {
  public:
-  void setHashTable(std::unique_ptr<BaseHashTable> table);
+  // Sets the hash table built from the in-memory build side rows. 'spill' is
+  // set if part of the build side was spilled. 'bloomFilters' has a filter
+  // or null for each join key.
+  void setHashTable(
+      std::unique_ptr<BaseHashTable> table,
+      std::shared_ptr<HashJoinSpill> spill = nullptr,
+      std::vector<std::shared_ptr<common::Filter>> bloomFilters = {});
 
   void setAntiJoinHasNullKeys();
 
@@ -37,15 +63,23 @@ class HashJoinBridge : public JoinBridge {
   // anti join, a build side entry with a null in a join key makes the join
   // return nothing. In this case, HashBuild operator finishes early without
   // processing all the input and without finishing building the hash table.
+  // If the build side did not fit in memory, 'spill' describes the spilled
+  // partitions and 'table' has the rows of the other partitions.
   struct HashBuildResult {
     std::shared_ptr<BaseHashTable> table;
     bool antiJoinHasNullKeys;
+    std::shared_ptr<HashJoinSpill> spill;
+    // Approximate filters on the join keys for pushdown into the probe side.
+    // One per key, null for keys without a filter.
+    std::vector<std::shared_ptr<common::Filter>> bloomFilters;
   };
 
   std::optional<HashBuildResult> tableOrFuture(ContinueFuture* future);
 
  private:
   std::shared_ptr<BaseHashTable> table_;
+  std::shared_ptr<HashJoinSpill> spill_;
+  std::vector<std::shared_ptr<common::Filter>> bloomFilters_;
   bool antiJoinHasNullKeys_{false};
 };
 
@@ -58,6 +92,12 @@ class HashJoinBridge : public JoinBridge {
 // table. This table is then passed to the probe side pipeline via
 // JoinBridge. After this, all build side Drivers finish and free
 // their state.
+//
+// If spilling is enabled and the build side does not fit in memory, the rows
+// are partitioned on their key hash and whole partitions are spilled. A
+// partition spilled by one Driver is spilled by all Drivers at the
+// barrier. The spilled partitions are handed to the probe side together with
+// the table of the in-memory partitions.
 class HashBuild final : public Operator {
  public:
   HashBuild(
@@ -86,6 +126,37 @@ class HashBuild final : public Operator {
  private:
   void addRuntimeStats();
 
+  // Checks if the build side fits in memory after adding 'input' and spills
+  // part of it if not. Spilling is considered only if 'spillPath_' is set.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Spills partitions of 'table_' until under 'targetRows' rows and
+  // 'targetBytes' of variable length data remain in memory.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  // Makes 'spiller_' if not already made.
+  void ensureSpiller();
+
+  // Spills the rows of 'activeRows_' of 'input' that belong to spilled
+  // partitions and removes them from 'activeRows_'.
+  void spillInput(const RowVectorPtr& input);
+
+  // Called by the last build Driver at the barrier. Spills the partitions
+  // that any of 'this' and 'otherBuilds' has spilled from all of them and
+  // returns the spilled partitions. Returns nullptr if nothing was spilled.
+  std::shared_ptr<HashJoinSpill> finishSpill(
+      const std::vector<HashBuild*>& otherBuilds);
+
+  void updateSpillStats();
+
+  // Makes a Bloom filter over each integer join key for which the probe side
+  // cannot make an exact dynamic filter from the VectorHashers of 'table_'.
+  // This is the case for keys with many distinct values. 'rows' has the
+  // RowContainers of all build side rows. Returns a filter or null for each
+  // key.
+  std::vector<std::shared_ptr<common::Filter>> makeBloomFilters(
+      const std::vector<RowContainer*>& rows) const;
+
   const core::JoinType joinType_;
 
   // Container for the rows being accumulated.
@@ -120,6 +191,55 @@ class HashBuild final : public Operator {
   // True if this is a build side of an anti join and has at least one entry
   // with null join keys.
   bool antiJoinHasNullKeys_{false};
+
+  const std::optional<std::string> spillPath_;
+
+  folly::Executor* const spillExecutor_;
+
+  // Percentage of input batches to be spilled for testing. 0 means no
+  // spilling for test.
+  const int32_t testSpillPct_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct_'.
+  uint64_t spillTestCounter_{0};
+
+  // Type of the spilled rows: the keys in 'keyChannels_' order followed by
+  // the columns in 'dependentChannels_' order. This is the column order of
+  // the RowContainer of 'table_'.
+  RowTypePtr tableType_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Used to resume spilling from where the previous spill left off.
+  RowContainerIterator spillIterator_;
+
+  // Temporary space for the hash numbers that select the spill partition.
+  raw_vector<uint64_t> spillHashes_;
 };
 
+// Makes the hash table for the build side of 'joinNode'. 'keyHashers' give
+// the join keys and 'dependentTypes' the types of the other build side
+// columns.
+std::unique_ptr<BaseHashTable> createJoinTable(
+    const core::HashJoinNode& joinNode,
+    std::vector<std::unique_ptr<VectorHasher>> keyHashers,
+    const std::vector<TypePtr>& dependentTypes,
+    memory::MappedMemory* mappedMemory);
+
+// Stores 'rows' of 'input' in the RowContainer of the join build side
+// 'table'. The keys come from the channels of the hashers of 'table' and the
+// other columns from 'dependentChannels', decoded with the corresponding
+// element of 'decoders'. While 'analyzeKeys' is true, the keys are run through
+// the hashers to see if the table can use value ids. 'analyzeKeys' is set to
+// false when this is no longer possible. 'hashes' is scratch space.
+void storeJoinBuildRows(
+    const RowVector& input,
+    const SelectivityVector& rows,
+    const std::vector<column_index_t>& dependentChannels,
+    std::vector<std::unique_ptr<DecodedVector>>& decoders,
+    bool& analyzeKeys,
+    raw_vector<uint64_t>& hashes,
+    BaseHashTable& table);
+
 } // namespace facebook::velox::exec
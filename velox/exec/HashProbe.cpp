@@ -62,8 +62,14 @@ HashProbe::HashProbe(
           "HashProbe"),
       outputBatchSize_{driverCtx->queryConfig().preferredOutputBatchSize()},
       joinType_{joinNode->joinType()},
+      joinNode_(joinNode),
       filterResult_(1),
-      outputRows_(outputBatchSize_) {
+      outputRows_(outputBatchSize_),
+      spillPath_(makeOperatorSpillPath(*operatorCtx_)),
+      spillFileOptions_(makeSpillFileOptions(*operatorCtx_)),
+      spillStats_(std::make_shared<SpillStats>()),
+      testSpillPct_(
+          operatorCtx_->task()->queryCtx()->config().testingSpillPct()) {
   auto probeType = joinNode->sources()[0]->outputType();
   auto numKeys = joinNode->leftKeys().size();
   keyChannels_.reserve(numKeys);
@@ -76,9 +82,9 @@ HashProbe::HashProbe(
   }
   lookup_ = std::make_unique<HashLookup>(hashers_);
   auto buildType = joinNode->sources()[1]->outputType();
-  auto tableType = makeTableType(buildType.get(), joinNode->rightKeys());
+  tableType_ = makeTableType(buildType.get(), joinNode->rightKeys());
   if (joinNode->filter()) {
-    initializeFilter(joinNode->filter(), probeType, tableType);
+    initializeFilter(joinNode->filter(), probeType, tableType_);
   }
 
   size_t countIdentityProjection = 0;
@@ -94,7 +100,8 @@ HashProbe::HashProbe(
   }
 
   for (column_index_t i = 0; i < outputType_->size(); ++i) {
-    auto tableChannel = tableType->getChildIdxIfExists(outputType_->nameOf(i));
+    auto tableChannel =
+        tableType_->getChildIdxIfExists(outputType_->nameOf(i));
     if (tableChannel.has_value()) {
       tableResultProjections_.emplace_back(tableChannel.value(), i);
     }
@@ -165,28 +172,50 @@ BlockingReason HashProbe::isBlocked(ContinueFuture* future) {
     finished_ = true;
   } else {
     table_ = hashBuildResult->table;
+    buildSpill_ = hashBuildResult->spill;
+    if (buildSpill_) {
+      spilledPartitions_.resize(buildSpill_->bits.numPartitions());
+      for (auto& [partition, files] : buildSpill_->files) {
+        spilledPartitions_[partition] = true;
+      }
+      probeSpill_.resize(spilledPartitions_.size());
+    }
     if (table_->numDistinct() == 0) {
       // Build side is empty. Inner, right and semi joins return nothing in this
-      // case, hence, we can terminate the pipeline early.
-      if (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_) ||
-          isRightJoin(joinType_)) {
+      // case, hence, we can terminate the pipeline early. If the build side
+      // has spilled, only its in-memory part is empty.
+      if (!buildSpill_ &&
+          (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_) ||
+           isRightJoin(joinType_))) {
         finished_ = true;
       }
     } else if (
         (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_)) &&
-        table_->hashMode() != BaseHashTable::HashMode::kHash) {
+        !buildSpill_) {
+      // A dynamic filter made from 'table_' would drop the probe rows of the
+      // spilled partitions, so there is none if the build side has spilled.
       // Find out whether there are any upstream operators that can accept
       // dynamic filters on all or a subset of the join keys. Create dynamic
-      // filters to push down.
+      // filters to push down. The VectorHashers give exact filters for keys
+      // with few distinct values. Other integer keys get the Bloom filters
+      // made by HashBuild.
       const auto& buildHashers = table_->hashers();
+      const auto& bloomFilters = hashBuildResult->bloomFilters;
       auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
           this, keyChannels_);
       for (auto i = 0; i < keyChannels_.size(); i++) {
-        if (channels.find(keyChannels_[i]) != channels.end()) {
+        if (channels.find(keyChannels_[i]) == channels.end()) {
+          continue;
+        }
+        if (table_->hashMode() != BaseHashTable::HashMode::kHash) {
           if (auto filter = buildHashers[i]->getFilter(false)) {
             dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
+            continue;
           }
         }
+        if (i < bloomFilters.size() && bloomFilters[i]) {
+          dynamicFilters_.emplace(keyChannels_[i], bloomFilters[i]);
+        }
       }
     }
   }
@@ -198,9 +227,12 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
+  //  * build side has no dependent columns,
+  //  * the filter is exact, i.e. not a Bloom filter.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
-      tableResultProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
+      tableResultProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
+      dynamicFilters_.begin()->second->kind() !=
+          common::FilterKind::kBigintValuesUsingBloomFilter) {
     canReplaceWithDynamicFilter_ = true;
   }
 
@@ -215,7 +247,27 @@ void HashProbe::addInput(RowVectorPtr input) {
     return;
   }
 
+  if (!spilledPartitions_.empty()) {
+    spillInput();
+    if (!input_) {
+      return;
+    }
+  }
+
+  nonNullRows_.resize(input_->size());
+  nonNullRows_.setAll();
+  deselectRowsWithNulls(
+      *input_, keyChannels_, nonNullRows_, *operatorCtx_->execCtx());
+
   if (table_->numDistinct() == 0) {
+    if (buildSpill_ &&
+        (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_) ||
+         isRightJoin(joinType_))) {
+      // Only the in-memory part of a spilled build side is empty. The probe
+      // rows that are not spilled have no match.
+      input_ = nullptr;
+      return;
+    }
     // Build side is empty. This state is valid only for anti, left and full
     // joins.
     VELOX_CHECK(
@@ -224,11 +276,6 @@ void HashProbe::addInput(RowVectorPtr input) {
     return;
   }
 
-  nonNullRows_.resize(input_->size());
-  nonNullRows_.setAll();
-  deselectRowsWithNulls(
-      *input_, keyChannels_, nonNullRows_, *operatorCtx_->execCtx());
-
   activeRows_ = nonNullRows_;
   lookup_->hashes.resize(input_->size());
   auto mode = table_->hashMode();
@@ -356,7 +403,7 @@ void HashProbe::fillOutput(vector_size_t size) {
 }
 
 RowVectorPtr HashProbe::getNonMatchingOutputForRightJoin() {
-  if (!lastRightJoinProbe_) {
+  if (!lastProbe_) {
     return nullptr;
   }
 
@@ -399,17 +446,29 @@ void HashProbe::clearIdentityProjectedOutput() {
 RowVectorPtr HashProbe::getOutput() {
   clearIdentityProjectedOutput();
   if (!input_) {
-    if (noMoreInput_ && (isRightJoin(joinType_) || isFullJoin(joinType_))) {
-      auto output = getNonMatchingOutputForRightJoin();
-      if (output == nullptr) {
+    if (!noMoreInput_) {
+      return nullptr;
+    }
+    // The probe input for 'table_' is exhausted. The last probe Driver then
+    // produces the non-matching build side rows for a right join and goes on
+    // to join the spilled partitions if any.
+    for (;;) {
+      if (addSpilledProbeInput()) {
+        if (input_) {
+          break;
+        }
+        continue;
+      }
+      if (isRightJoin(joinType_) || isFullJoin(joinType_)) {
+        if (auto output = getNonMatchingOutputForRightJoin()) {
+          return output;
+        }
+      }
+      if (!startSpillPartition()) {
         finished_ = true;
+        return nullptr;
       }
-      return output;
     }
-    if (noMoreInput_) {
-      finished_ = true;
-    }
-    return nullptr;
   }
 
   const auto inputSize = input_->size();
@@ -442,9 +501,21 @@ RowVectorPtr HashProbe::getOutput() {
 
     if (emptyBuildSide) {
       // When build side is empty, anti and left joins return all probe side
-      // rows, including ones with null join keys.
-      std::iota(mapping.begin(), mapping.end(), 0);
-      numOut = inputSize;
+      // rows, including ones with null join keys. If only the in-memory part
+      // of a spilled build side is empty, anti join drops the rows with null
+      // join keys.
+      if (buildSpill_ && isAntiJoin(joinType_)) {
+        for (auto i = 0; i < inputSize; i++) {
+          if (nonNullRows_.isValid(i)) {
+            mapping[numOut] = i;
+            ++numOut;
+          }
+        }
+      } else {
+        std::iota(mapping.begin(), mapping.end(), 0);
+        numOut = inputSize;
+      }
+      std::fill(outputRows_.begin(), outputRows_.begin() + numOut, nullptr);
     } else if (isAntiJoin(joinType_) && !filter_) {
       // When build side is not empty, anti join without a filter returns probe
       // rows with no nulls in the join key and no match in the build side.
@@ -617,18 +688,371 @@ void HashProbe::ensureLoadedIfNotAtEnd(column_index_t channel) {
 
 void HashProbe::noMoreInput() {
   Operator::noMoreInput();
-  if (isRightJoin(joinType_) || isFullJoin(joinType_)) {
+  if (isRightJoin(joinType_) || isFullJoin(joinType_) || buildSpill_) {
     std::vector<ContinuePromise> promises;
     std::vector<std::shared_ptr<Driver>> peers;
     // The last Driver to hit HashProbe::finish is responsible for producing
-    // non-matching build-side rows for the right join.
+    // non-matching build-side rows for the right join and for joining the
+    // spilled partitions.
     ContinueFuture future;
     if (!operatorCtx_->task()->allPeersFinished(
             planNodeId(), operatorCtx_->driver(), &future, promises, peers)) {
       return;
     }
 
-    lastRightJoinProbe_ = true;
+    lastProbe_ = true;
+    if (buildSpill_) {
+      std::vector<HashProbe*> probes{this};
+      for (auto& peer : peers) {
+        auto op = peer->findOperator(planNodeId());
+        HashProbe* probe = dynamic_cast<HashProbe*>(op);
+        VELOX_CHECK(probe);
+        probes.push_back(probe);
+      }
+      prepareSpillPartitions(probes);
+    }
+  }
+}
+
+void HashProbe::spillInput() {
+  const auto numInput = input_->size();
+  SelectivityVector allRows(numInput);
+  spillHashes_.resize(numInput);
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    hashers_[i]->hash(
+        *input_->childAt(keyChannels_[i])->loadedVector(),
+        allRows,
+        i > 0,
+        spillHashes_);
+  }
+
+  // Rows with null keys go by the hash of the null like the build side rows.
+  // These have no match in any partition.
+  const auto& bits = buildSpill_->bits;
+  std::vector<std::vector<IndexRange>> spillRanges(spilledPartitions_.size());
+  auto kept = allocateIndices(numInput, pool());
+  auto rawKept = kept->asMutable<vector_size_t>();
+  vector_size_t numKept = 0;
+  vector_size_t numSpilled = 0;
+  for (auto row = 0; row < numInput; ++row) {
+    auto partition =
+        bits.partition(spillHashes_[row], spilledPartitions_.size());
+    if (!spilledPartitions_[partition]) {
+      rawKept[numKept++] = row;
+      continue;
+    }
+    auto& ranges = spillRanges[partition];
+    if (!ranges.empty() && ranges.back().begin + ranges.back().size == row) {
+      ++ranges.back().size;
+    } else {
+      ranges.push_back(IndexRange{row, 1});
+    }
+    ++numSpilled;
+  }
+  if (!numSpilled) {
+    return;
+  }
+
+  std::vector<VectorPtr> children;
+  children.reserve(input_->childrenSize());
+  for (auto& child : input_->children()) {
+    children.push_back(BaseVector::loadedVectorShared(child));
+  }
+  auto loaded = std::make_shared<RowVector>(
+      pool(), input_->type(), nullptr, numInput, std::move(children));
+
+  for (auto partition = 0; partition < spillRanges.size(); ++partition) {
+    auto& ranges = spillRanges[partition];
+    if (ranges.empty()) {
+      continue;
+    }
+    auto& files = probeSpill_[partition];
+    if (!files) {
+      VELOX_CHECK(spillPath_.has_value());
+      files = std::make_unique<SpillFileList>(
+          asRowType(input_->type()),
+          0,
+          fmt::format("{}-probe-{}", spillPath_.value(), partition),
+          std::numeric_limits<uint64_t>::max(),
+          Spiller::spillPool(),
+          Spiller::spillMappedMemory(),
+          std::vector<CompareFlags>{},
+          spillFileOptions_,
+          spillStats_);
+    }
+    files->write(
+        loaded, folly::Range<IndexRange*>(ranges.data(), ranges.size()));
+  }
+
+  stats_.spilledRows += numSpilled;
+  int64_t spilledBytes = 0;
+  for (auto& files : probeSpill_) {
+    if (files) {
+      spilledBytes += files->spilledBytes();
+    }
+  }
+  stats_.spilledBytes = spilledBytes;
+  setSpillRuntimeStats(*spillStats_, stats_);
+
+  if (!numKept) {
+    input_ = nullptr;
+    return;
+  }
+  input_ = wrap(numKept, kept, loaded);
+}
+
+void HashProbe::prepareSpillPartitions(const std::vector<HashProbe*>& probes) {
+  // The probe input of this Driver is complete. Probe input from the spill
+  // files is not spilled again.
+  spilledPartitions_.clear();
+  for (auto& [partition, buildFiles] : buildSpill_->files) {
+    SpillPartition spillPartition{
+        buildSpill_->bits.end(), std::move(buildFiles), {}};
+    for (auto* probe : probes) {
+      if (auto& files = probe->probeSpill_[partition]) {
+        for (auto& file : files->files()) {
+          spillPartition.probeFiles.push_back(std::move(file));
+        }
+        files = nullptr;
+      }
+    }
+    spillPartitions_.push_back(std::move(spillPartition));
+  }
+}
+
+bool HashProbe::startSpillPartition() {
+  while (!spillPartitions_.empty()) {
+    auto partition = std::move(spillPartitions_.back());
+    spillPartitions_.pop_back();
+    if (partition.probeFiles.empty() &&
+        !(isRightJoin(joinType_) || isFullJoin(joinType_))) {
+      // No probe rows and no build side rows to return.
+      continue;
+    }
+    if (partition.buildFiles.empty() &&
+        (isInnerJoin(joinType_) || isLeftSemiJoin(joinType_) ||
+         isRightJoin(joinType_))) {
+      // No build side rows to match.
+      continue;
+    }
+    if (needsRepartition(partition)) {
+      repartition(std::move(partition));
+      continue;
+    }
+    table_ = makeSpillPartitionTable(std::move(partition.buildFiles));
+    rightJoinIterator_ = BaseHashTable::NotProbedRowsIterator();
+    spillProbeFiles_ = std::move(partition.probeFiles);
+    return true;
+  }
+  return false;
+}
+
+namespace {
+// Bits 32 and up of the hash number make the hash table tags. A spilled
+// partition is split on bits above the tag bits so that the tags of the
+// rows of a partition do not all have the same leading bits.
+constexpr uint8_t kRepartitionMinBit = 40;
+} // namespace
+
+bool HashProbe::needsRepartition(const SpillPartition& partition) {
+  const auto begin = std::max(partition.bitsEnd, kRepartitionMinBit);
+  if (begin + HashJoinSpill::kPartitionBits > 64) {
+    // Out of hash bits. The partition is joined in memory.
+    return false;
+  }
+
+  // Test-only path. Only the partitions spilled by HashBuild are split so
+  // that the recursion stops.
+  if (testSpillPct_) {
+    return partition.bitsEnd == buildSpill_->bits.end() &&
+        (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
+        testSpillPct_;
+  }
+
+  auto tracker = operatorCtx_->mappedMemory()->tracker();
+  if (!tracker) {
+    return false;
+  }
+  // The build side takes about its serialized size in the RowContainer. The
+  // hash table and variable length data take about as much again.
+  int64_t increment = 0;
+  for (auto& file : partition.buildFiles) {
+    increment += 2 * file->size();
+  }
+  if (tracker->getAvailableReservation() > increment) {
+    return false;
+  }
+  return !tracker->maybeReserve(increment);
+}
+
+void HashProbe::repartition(SpillPartition partition) {
+  const auto begin = std::max(partition.bitsEnd, kRepartitionMinBit);
+  HashBitRange bits(begin, begin + HashJoinSpill::kPartitionBits);
+
+  std::vector<column_index_t> buildKeyChannels(keyChannels_.size());
+  std::iota(buildKeyChannels.begin(), buildKeyChannels.end(), 0);
+  auto buildFiles = splitSpillFiles(
+      std::move(partition.buildFiles), tableType_, buildKeyChannels, bits);
+  auto probeFiles = splitSpillFiles(
+      std::move(partition.probeFiles),
+      joinNode_->sources()[0]->outputType(),
+      keyChannels_,
+      bits);
+  for (auto i = 0; i < bits.numPartitions(); ++i) {
+    spillPartitions_.push_back(SpillPartition{
+        bits.end(), std::move(buildFiles[i]), std::move(probeFiles[i])});
+  }
+}
+
+std::vector<std::vector<std::unique_ptr<SpillFile>>>
+HashProbe::splitSpillFiles(
+    std::vector<std::unique_ptr<SpillFile>> files,
+    const RowTypePtr& type,
+    const std::vector<column_index_t>& keyChannels,
+    const HashBitRange& bits) {
+  const auto numPartitions = bits.numPartitions();
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  hashers.reserve(keyChannels.size());
+  for (auto channel : keyChannels) {
+    hashers.push_back(
+        std::make_unique<VectorHasher>(type->childAt(channel), channel));
+  }
+
+  std::vector<std::unique_ptr<SpillFileList>> lists(numPartitions);
+  std::vector<std::vector<IndexRange>> ranges(numPartitions);
+  raw_vector<uint64_t> hashes;
+  SelectivityVector rows;
+  for (auto& file : files) {
+    file->startRead();
+    RowVectorPtr batch;
+    while (file->readBatch(batch)) {
+      const auto numRows = batch->size();
+      rows.resize(numRows);
+      rows.setAll();
+      hashes.resize(numRows);
+      for (auto i = 0; i < hashers.size(); ++i) {
+        hashers[i]->hash(*batch->childAt(keyChannels[i]), rows, i > 0, hashes);
+      }
+      for (auto& partitionRanges : ranges) {
+        partitionRanges.clear();
+      }
+      for (auto row = 0; row < numRows; ++row) {
+        auto& partitionRanges =
+            ranges[bits.partition(hashes[row], numPartitions)];
+        if (!partitionRanges.empty() &&
+            partitionRanges.back().begin + partitionRanges.back().size ==
+                row) {
+          ++partitionRanges.back().size;
+        } else {
+          partitionRanges.push_back(IndexRange{row, 1});
+        }
+      }
+      for (auto partition = 0; partition < numPartitions; ++partition) {
+        auto& partitionRanges = ranges[partition];
+        if (partitionRanges.empty()) {
+          continue;
+        }
+        if (!lists[partition]) {
+          lists[partition] = std::make_unique<SpillFileList>(
+              type,
+              0,
+              fmt::format(
+                  "{}-split-{}-{}",
+                  spillPath_.value(),
+                  bits.begin(),
+                  partition),
+              std::numeric_limits<uint64_t>::max(),
+              Spiller::spillPool(),
+              Spiller::spillMappedMemory(),
+              std::vector<CompareFlags>{},
+              spillFileOptions_,
+              spillStats_);
+        }
+        lists[partition]->write(
+            batch,
+            folly::Range<IndexRange*>(
+                partitionRanges.data(), partitionRanges.size()));
+      }
+    }
+    // Deletes the file.
+    file = nullptr;
+  }
+
+  std::vector<std::vector<std::unique_ptr<SpillFile>>> result(numPartitions);
+  for (auto partition = 0; partition < numPartitions; ++partition) {
+    if (lists[partition]) {
+      result[partition] = lists[partition]->files();
+    }
+  }
+  return result;
+}
+
+std::unique_ptr<BaseHashTable> HashProbe::makeSpillPartitionTable(
+    std::vector<std::unique_ptr<SpillFile>> files) {
+  // The spilled rows have the keys first, followed by the other build side
+  // columns.
+  const auto numKeys = keyChannels_.size();
+  std::vector<std::unique_ptr<VectorHasher>> keyHashers;
+  keyHashers.reserve(numKeys);
+  for (auto i = 0; i < numKeys; ++i) {
+    keyHashers.push_back(
+        std::make_unique<VectorHasher>(tableType_->childAt(i), i));
+  }
+  std::vector<TypePtr> dependentTypes;
+  std::vector<column_index_t> dependentChannels;
+  std::vector<std::unique_ptr<DecodedVector>> decoders;
+  for (auto i = numKeys; i < tableType_->size(); ++i) {
+    dependentTypes.push_back(tableType_->childAt(i));
+    dependentChannels.push_back(i);
+    decoders.push_back(std::make_unique<DecodedVector>());
+  }
+
+  auto table = createJoinTable(
+      *joinNode_,
+      std::move(keyHashers),
+      dependentTypes,
+      operatorCtx_->mappedMemory());
+  bool analyzeKeys = table->hashMode() != BaseHashTable::HashMode::kHash;
+  raw_vector<uint64_t> hashes;
+  SelectivityVector rows;
+  for (auto& file : files) {
+    file->startRead();
+    RowVectorPtr batch;
+    while (file->readBatch(batch)) {
+      rows.resize(batch->size());
+      rows.setAll();
+      storeJoinBuildRows(
+          *batch,
+          rows,
+          dependentChannels,
+          decoders,
+          analyzeKeys,
+          hashes,
+          *table);
+    }
+    // Deletes the file.
+    file = nullptr;
+  }
+  table->prepareJoinTable({});
+  return table;
+}
+
+bool HashProbe::addSpilledProbeInput() {
+  for (;;) {
+    if (!spillProbeFile_) {
+      if (spillProbeFiles_.empty()) {
+        return false;
+      }
+      spillProbeFile_ = std::move(spillProbeFiles_.back());
+      spillProbeFiles_.pop_back();
+      spillProbeFile_->startRead();
+    }
+    RowVectorPtr batch;
+    if (spillProbeFile_->readBatch(batch)) {
+      addInput(std::move(batch));
+      return true;
+    }
+    spillProbeFile_ = nullptr;
   }
 }
 
@@ -22,7 +22,11 @@
 
 namespace facebook::velox::exec {
 
-// Probes a hash table made by HashBuild.
+// Probes a hash table made by HashBuild. If the build side has spilled
+// partitions, the probe input rows of these partitions are spilled too. When
+// all probe input is processed, the last HashProbe Driver joins the spilled
+// partitions one at a time. A spilled partition that does not fit in memory
+// is split again on more bits of the key hash before joining.
 class HashProbe : public Operator {
  public:
   HashProbe(
@@ -88,11 +92,66 @@ class HashProbe : public Operator {
 
   void ensureLoadedIfNotAtEnd(column_index_t channel);
 
+  // A spilled partition of the join. 'bitsEnd' is the first bit above the
+  // hash number bits that selected the partition.
+  struct SpillPartition {
+    uint8_t bitsEnd;
+    std::vector<std::unique_ptr<SpillFile>> buildFiles;
+    std::vector<std::unique_ptr<SpillFile>> probeFiles;
+  };
+
+  // Spills the rows of 'input_' that belong to a spilled partition of the
+  // build side and removes them from 'input_'. Sets 'input_' to nullptr if
+  // all rows are spilled.
+  void spillInput();
+
+  // Called by the last probe Driver. Gathers the probe side spill files of
+  // 'probes' and pairs them with the build side spill files into
+  // 'spillPartitions_'.
+  void prepareSpillPartitions(const std::vector<HashProbe*>& probes);
+
+  // Makes 'table_' from the build side of the next partition of
+  // 'spillPartitions_' and sets up reading its probe side. Returns false if
+  // there are no more spilled partitions.
+  bool startSpillPartition();
+
+  // Returns true if the build side of 'partition' should be split further
+  // before joining because it does not fit in memory.
+  bool needsRepartition(const SpillPartition& partition);
+
+  // Splits 'partition' on the bits above its 'bitsEnd' and adds the parts to
+  // 'spillPartitions_'.
+  void repartition(SpillPartition partition);
+
+  // Partitions the rows of 'files' on 'bits' of the hash of 'keyChannels'.
+  // Returns the new files for each partition. 'files' are deleted after
+  // reading.
+  std::vector<std::vector<std::unique_ptr<SpillFile>>> splitSpillFiles(
+      std::vector<std::unique_ptr<SpillFile>> files,
+      const RowTypePtr& type,
+      const std::vector<column_index_t>& keyChannels,
+      const HashBitRange& bits);
+
+  // Makes a hash table from the build side rows in 'files'.
+  std::unique_ptr<BaseHashTable> makeSpillPartitionTable(
+      std::vector<std::unique_ptr<SpillFile>> files);
+
+  // Sets 'input_' from the next batch of spilled probe input of the partition
+  // being joined. Returns false if the probe side of the partition is
+  // exhausted.
+  bool addSpilledProbeInput();
+
   // TODO: Define batch size as bytes based on RowContainer row sizes.
   const uint32_t outputBatchSize_;
 
   const core::JoinType joinType_;
 
+  const std::shared_ptr<const core::HashJoinNode> joinNode_;
+
+  // Type of the rows of 'table_': the build side keys followed by the other
+  // build side columns.
+  RowTypePtr tableType_;
+
   std::unique_ptr<HashLookup> lookup_;
 
   // Channel of probe keys in 'input_'.
@@ -216,8 +275,9 @@ class HashProbe : public Operator {
   };
 
   /// True if this is the last HashProbe operator in the pipeline. It is
-  /// responsible for producing non-matching build-side rows for the right join.
-  bool lastRightJoinProbe_{false};
+  /// responsible for producing non-matching build-side rows for the right join
+  /// and for joining the spilled partitions.
+  bool lastProbe_{false};
 
   BaseHashTable::NotProbedRowsIterator rightJoinIterator_;
 
@@ -252,6 +312,45 @@ class HashProbe : public Operator {
   // cases where there is more than one batch of output or join filter
   // input.
   SelectivityVector passingInputRows_;
+
+  const std::optional<std::string> spillPath_;
+
+  const SpillFileOptions spillFileOptions_;
+
+  // IO counters of the spill files written by 'this'.
+  const std::shared_ptr<SpillStats> spillStats_;
+
+  // Percentage of spilled partitions to be split further for testing. 0 means
+  // no splitting for test.
+  const int32_t testSpillPct_;
+
+  // Counts spilled partitions and triggers splitting if folly hash of this %
+  // 100 <= 'testSpillPct_'.
+  uint64_t spillTestCounter_{0};
+
+  // The spilled partitions of the build side. Set if the build side did not
+  // fit in memory. Shared with the other HashProbe Drivers.
+  std::shared_ptr<HashJoinSpill> buildSpill_;
+
+  // True for each partition of 'buildSpill_' that is spilled. Probe input
+  // rows of these partitions are spilled and joined after all probe input is
+  // processed. Cleared when the spilled partitions start to be joined.
+  std::vector<bool> spilledPartitions_;
+
+  // Spilled probe input rows for each spilled partition.
+  std::vector<std::unique_ptr<SpillFileList>> probeSpill_;
+
+  // Temporary space for the hash numbers that select the spill partition.
+  raw_vector<uint64_t> spillHashes_;
+
+  // Spilled partitions not yet joined.
+  std::vector<SpillPartition> spillPartitions_;
+
+  // Spilled probe side files of the partition being joined.
+  std::vector<std::unique_ptr<SpillFile>> spillProbeFiles_;
+
+  // The file of 'spillProbeFiles_' being read.
+  std::unique_ptr<SpillFile> spillProbeFile_;
 };
 
 } // namespace facebook::velox::exec
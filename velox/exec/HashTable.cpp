@@ -19,8 +19,11 @@
 #include "velox/common/base/SimdUtil.h"
 #include "velox/common/process/ProcessBase.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/OperatorUtils.h"
 #include "velox/vector/VectorTypeUtils.h"
 
+#include <folly/ScopeGuard.h>
+
 namespace facebook::velox::exec {
 
 template <TypeKind Kind>
@@ -567,7 +570,7 @@ void HashTable<ignoreNullKeys>::checkSize(int32_t numNew) {
 }
 
 template <bool ignoreNullKeys>
-bool HashTable<ignoreNullKeys>::insertBatch(
+bool HashTable<ignoreNullKeys>::computeHashes(
     char** groups,
     int32_t numGroups,
     raw_vector<uint64_t>& hashes) {
@@ -591,6 +594,17 @@ bool HashTable<ignoreNullKeys>::insertBatch(
       }
     }
   }
+  return true;
+}
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::insertBatch(
+    char** groups,
+    int32_t numGroups,
+    raw_vector<uint64_t>& hashes) {
+  if (!computeHashes(groups, numGroups, hashes)) {
+    return false;
+  }
   if (isJoinBuild_) {
     insertForJoin(groups, hashes.data(), numGroups);
   } else {
@@ -661,7 +675,6 @@ bool HashTable<ignoreNullKeys>::arrayPushRow(char* row, int32_t index) {
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::pushNext(char* row, char* next) {
   if (nextOffset_) {
-    hasDuplicates_ = true;
     auto previousNext = nextRow(row);
     nextRow(row) = next;
     nextRow(next) = previousNext;
@@ -684,6 +697,7 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::buildFullProbe(
           if (RowContainer::normalizedKey(group) ==
               RowContainer::normalizedKey(inserted)) {
             if (nextOffset_) {
+              hasDuplicates_ = true;
               pushNext(group, inserted);
             }
             return true;
@@ -704,6 +718,7 @@ FOLLY_ALWAYS_INLINE void HashTable<ignoreNullKeys>::buildFullProbe(
         [&](char* group, int32_t /*row*/) {
           if (compareKeys(group, inserted)) {
             if (nextOffset_) {
+              hasDuplicates_ = true;
               pushNext(group, inserted);
             }
             return true;
@@ -753,6 +768,13 @@ void HashTable<ignoreNullKeys>::insertForJoin(
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::rehash() {
+  if (canApplyParallelJoinBuild()) {
+    if (!parallelJoinBuild()) {
+      VELOX_CHECK(hashMode_ != HashMode::kHash);
+      setHashMode(HashMode::kHash, 0);
+    }
+    return;
+  }
   constexpr int32_t kHashBatchSize = 1024;
   // @lint-ignore CLANGTIDY
   raw_vector<uint64_t> hashes;
@@ -777,6 +799,175 @@ void HashTable<ignoreNullKeys>::rehash() {
   }
 }
 
+namespace {
+// Rows of a join build side with their hash numbers.
+struct JoinBuildRows {
+  std::vector<char*> rows;
+  std::vector<uint64_t> hashes;
+  // Set if some row was linked to an existing row with the same key.
+  bool hasDuplicates{false};
+};
+
+// The rows of one join build side table grouped by the slot range of
+// the hash table their probe starts in.
+struct JoinBuildPartitions {
+  std::vector<JoinBuildRows> partitions;
+  // False if some key could not be mapped to a value id.
+  bool mappable{true};
+};
+} // namespace
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::canApplyParallelJoinBuild() const {
+  // Below this many rows the work is too small to distribute.
+  constexpr int64_t kMinRowsForParallelBuild = 10'000;
+  // kArray mode inserts by storing a pointer and is not worth
+  // parallelizing.
+  return isJoinBuild_ && buildExecutor_ && !otherTables_.empty() &&
+      hashMode_ != HashMode::kArray &&
+      numDistinct_ >= kMinRowsForParallelBuild;
+}
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::insertForJoinWithinRange(
+    char* row,
+    uint64_t hash,
+    int64_t end,
+    bool& hasDuplicates) {
+  const auto wantedTags = TagVector::broadcast(hashTag(hash));
+  const auto kEmptyGroup = TagVector::broadcast(0);
+  for (int64_t tagIndex = ProbeState::tagsByteOffset(hash, sizeMask_);
+       tagIndex < end;
+       tagIndex += sizeof(TagVector)) {
+    auto tagsInTable = loadTags(tags_, tagIndex);
+    MaskType hits =
+        simd::toBitMask(tagsInTable == wantedTags) & ProbeState::kFullMask;
+    while (hits) {
+      auto group =
+          loadRow(table_, tagIndex + bits::getAndClearLastSetBit(hits));
+      bool isMatch = hashMode_ == HashMode::kNormalizedKey
+          ? RowContainer::normalizedKey(group) ==
+              RowContainer::normalizedKey(row)
+          : compareKeys(group, row);
+      if (isMatch) {
+        if (nextOffset_) {
+          hasDuplicates = true;
+          pushNext(group, row);
+        }
+        return true;
+      }
+    }
+    MaskType empty =
+        simd::toBitMask(tagsInTable == kEmptyGroup) & ProbeState::kFullMask;
+    if (empty) {
+      storeRowPointer(
+          tagIndex + bits::getAndClearLastSetBit(empty), hash, row);
+      return true;
+    }
+  }
+  return false;
+}
+
+template <bool ignoreNullKeys>
+bool HashTable<ignoreNullKeys>::parallelJoinBuild() {
+  constexpr int32_t kHashBatchSize = 1024;
+  const int32_t numPartitions = 1 + otherTables_.size();
+  // Each partition is a range of whole tag groups. The last partition
+  // extends to the end of the table.
+  const int64_t partitionSize = std::max<int64_t>(
+      sizeof(TagVector),
+      bits::roundUp(size_ / numPartitions, sizeof(TagVector)));
+  auto partitionEnd = [&](int32_t partition) {
+    return partition == numPartitions - 1
+        ? size_
+        : std::min(size_, (partition + 1) * partitionSize);
+  };
+
+  // Hashes each table and groups its rows by partition. Value ids are
+  // computed with the VectorHashers of 'this', which are not thread
+  // safe, so these are computed on the calling thread.
+  std::vector<std::function<std::unique_ptr<JoinBuildPartitions>()>>
+      hashTasks;
+  for (auto i = 0; i < numPartitions; ++i) {
+    auto rows = (i == 0 ? this : otherTables_[i - 1].get())->rows();
+    hashTasks.push_back([this, rows, numPartitions, partitionSize]() {
+      auto result = std::make_unique<JoinBuildPartitions>();
+      result->partitions.resize(numPartitions);
+      raw_vector<uint64_t> hashes;
+      hashes.resize(kHashBatchSize);
+      char* groups[kHashBatchSize];
+      RowContainerIterator iterator;
+      int32_t numGroups;
+      while ((numGroups = rows->listRows(&iterator, kHashBatchSize, groups))) {
+        if (!computeHashes(groups, numGroups, hashes)) {
+          result->mappable = false;
+          return result;
+        }
+        for (auto j = 0; j < numGroups; ++j) {
+          auto hash = hashes[j];
+          if (hashMode_ == HashMode::kNormalizedKey) {
+            RowContainer::normalizedKey(groups[j]) = hash;
+            hash = mixNormalizedKey(hash, sizeBits_);
+          }
+          auto partition = std::min<int64_t>(
+              numPartitions - 1,
+              ProbeState::tagsByteOffset(hash, sizeMask_) / partitionSize);
+          result->partitions[partition].rows.push_back(groups[j]);
+          result->partitions[partition].hashes.push_back(hash);
+        }
+      }
+      return result;
+    });
+  }
+  auto tables = runInParallel(
+      std::move(hashTasks),
+      hashMode_ == HashMode::kHash ? buildExecutor_ : nullptr);
+  for (auto& table : tables) {
+    if (!table->mappable) {
+      return false;
+    }
+  }
+
+  // Fills each partition from all tables. The rows that do not fit
+  // in their partition are returned.
+  std::vector<std::function<std::unique_ptr<JoinBuildRows>()>> insertTasks;
+  for (auto partition = 0; partition < numPartitions; ++partition) {
+    insertTasks.push_back([this, partition, &tables, &partitionEnd]() {
+      auto overflow = std::make_unique<JoinBuildRows>();
+      auto end = partitionEnd(partition);
+      for (auto& table : tables) {
+        auto& rows = table->partitions[partition];
+        for (auto i = 0; i < rows.rows.size(); ++i) {
+          if (!insertForJoinWithinRange(
+                  rows.rows[i],
+                  rows.hashes[i],
+                  end,
+                  overflow->hasDuplicates)) {
+            overflow->rows.push_back(rows.rows[i]);
+            overflow->hashes.push_back(rows.hashes[i]);
+          }
+        }
+      }
+      return overflow;
+    });
+  }
+  auto overflows = runInParallel(std::move(insertTasks), buildExecutor_);
+
+  // The rows that ran past the end of their partition continue their
+  // probe in the next partitions.
+  ProbeState state;
+  for (auto& overflow : overflows) {
+    hasDuplicates_ |= overflow->hasDuplicates;
+    for (auto i = 0; i < overflow->rows.size(); ++i) {
+      auto hash = overflow->hashes[i];
+      state.preProbe(tags_, sizeMask_, hash, i);
+      state.firstProbe(table_, 0);
+      buildFullProbe(state, hash, overflow->rows[i], false);
+    }
+  }
+  return true;
+}
+
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::setHashMode(HashMode mode, int32_t numNew) {
   VELOX_CHECK(hashMode_ != HashMode::kHash);
@@ -1049,7 +1240,8 @@ bool mayUseValueIds(const BaseHashTable& table) {
 
 template <bool ignoreNullKeys>
 void HashTable<ignoreNullKeys>::prepareJoinTable(
-    std::vector<std::unique_ptr<BaseHashTable>> tables) {
+    std::vector<std::unique_ptr<BaseHashTable>> tables,
+    folly::Executor* executor) {
   otherTables_.reserve(tables.size());
   for (auto& table : tables) {
     otherTables_.emplace_back(std::unique_ptr<HashTable<ignoreNullKeys>>(
@@ -1064,17 +1256,22 @@ void HashTable<ignoreNullKeys>::prepareJoinTable(
       }
     }
     if (useValueIds) {
-      for (auto& other : otherTables_) {
-        for (auto i = 0; i < hashers_.size(); ++i) {
-          hashers_[i]->merge(*other->hashers_[i]);
-          if (!hashers_[i]->mayUseValueIds()) {
-            useValueIds = false;
-            break;
+      // The VectorHashers of different keys are independent, so the
+      // stats of each key are merged on their own thread.
+      std::vector<std::function<std::unique_ptr<bool>()>> mergeTasks;
+      for (auto i = 0; i < hashers_.size(); ++i) {
+        mergeTasks.push_back([this, i]() {
+          for (auto& other : otherTables_) {
+            hashers_[i]->merge(*other->hashers_[i]);
+            if (!hashers_[i]->mayUseValueIds()) {
+              return std::make_unique<bool>(false);
+            }
           }
-        }
-        if (!useValueIds) {
-          break;
-        }
+          return std::make_unique<bool>(true);
+        });
+      }
+      for (auto& mayUseIds : runInParallel(std::move(mergeTasks), executor)) {
+        useValueIds &= *mayUseIds;
       }
     }
   }
@@ -1082,6 +1279,8 @@ void HashTable<ignoreNullKeys>::prepareJoinTable(
   for (auto& other : otherTables_) {
     numDistinct_ += other->rows()->numRows();
   }
+  buildExecutor_ = executor;
+  auto guard = folly::makeGuard([&]() { buildExecutor_ = nullptr; });
   if (!useValueIds) {
     if (hashMode_ != HashMode::kHash) {
       setHashMode(HashMode::kHash, 0);
@@ -133,8 +133,12 @@ class BaseHashTable {
       uint64_t maxBytes,
       char** rows) = 0;
 
+  /// Moves the contents of 'tables' into 'this' and prepares 'this' for use
+  /// in hash join probe. If 'executor' is set, the work is spread over
+  /// 'executor' and the calling thread.
   virtual void prepareJoinTable(
-      std::vector<std::unique_ptr<BaseHashTable>> tables) = 0;
+      std::vector<std::unique_ptr<BaseHashTable>> tables,
+      folly::Executor* executor = nullptr) = 0;
 
   /// Returns the memory footprint in bytes for any data structures
   /// owned by 'this'.
@@ -334,8 +338,12 @@ class HashTable : public BaseHashTable {
   // tables are filled, they are combined into one top level table
   // with prepareJoinTable. This then takes ownership of all the data
   // and VectorHashers and decides the hash mode and representation.
+  // If 'executor' is set, the VectorHasher stats of different keys
+  // are merged in parallel and the rows of the tables are hashed and
+  // inserted in parallel, see parallelJoinBuild().
   void prepareJoinTable(
-      std::vector<std::unique_ptr<BaseHashTable>> tables) override;
+      std::vector<std::unique_ptr<BaseHashTable>> tables,
+      folly::Executor* executor = nullptr) override;
 
   uint64_t hashTableSizeIncrease(int32_t numNewDistinct) const override {
     if (numDistinct_ + numNewDistinct > rehashSize()) {
@@ -382,6 +390,31 @@ class HashTable : public BaseHashTable {
   void clearUseRange(std::vector<bool>& useRange);
 
   void rehash();
+
+  // Returns true if the rows of a join build side with multiple
+  // tables should be inserted with parallelJoinBuild().
+  bool canApplyParallelJoinBuild() const;
+
+  // Inserts the rows of 'this' and 'otherTables_' on 'buildExecutor_'.
+  // The table is divided into one range of slots per build side
+  // table. Each build side table is hashed on its own thread and its
+  // rows are grouped by the range their probe starts in. Then each
+  // range is filled on its own thread. A row that finds no free slot
+  // before the end of its range is inserted after all ranges are
+  // done. Returns false if some key could not be mapped to a value id
+  // in kNormalizedKey mode.
+  bool parallelJoinBuild();
+
+  // Inserts 'row' with 'hash' into a join build table, probing from
+  // the start of 'hash' but not past 'end'. Sets 'hasDuplicates' if
+  // 'row' is linked to an existing row with the same key. Returns
+  // false if there is no free slot before 'end'.
+  bool insertForJoinWithinRange(
+      char* row,
+      uint64_t hash,
+      int64_t end,
+      bool& hasDuplicates);
+
   void initializeNewGroups(HashLookup& lookup);
   void storeKeys(HashLookup& lookup, vector_size_t row);
 
@@ -393,6 +426,14 @@ class HashTable : public BaseHashTable {
 
   void checkSize(int32_t numNew);
 
+  // Computes hash numbers of the appropriate hash mode for 'groups'
+  // and stores these in 'hashes'. Returns false if some key has no
+  // value id in kArray or kNormalizedKey mode.
+  bool computeHashes(
+      char** groups,
+      int32_t numGroups,
+      raw_vector<uint64_t>& hashes);
+
   // Computes hash numbers of the appropriate hash mode for 'groups',
   // stores these in 'hashes' and inserts the groups using
   // insertForJoin or insertForGroupBy.
@@ -427,7 +468,7 @@ class HashTable : public BaseHashTable {
   bool arrayPushRow(char* row, int32_t index);
 
   // Adds a row to a hash join build side entry with multiple rows
-  // with the same key.
+  // with the same key. The caller sets 'hasDuplicates_'.
   void pushNext(char* row, char* next);
 
   // Finishes inserting an entry into a join hash table.
@@ -470,6 +511,9 @@ class HashTable : public BaseHashTable {
   // Owns the memory of multiple build side hash join tables that are
   // combined into a single probe hash table.
   std::vector<std::unique_ptr<HashTable<ignoreNullKeys>>> otherTables_;
+  // Executor for parallelJoinBuild(). Set only for the duration of
+  // prepareJoinTable().
+  folly::Executor* buildExecutor_{nullptr};
 };
 
 } // namespace facebook::velox::exec
@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Task.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/vector/ConstantVector.h"
 #include "velox/vector/FlatVector.h"
@@ -203,4 +204,57 @@ void loadColumns(const RowVectorPtr& input, core::ExecCtx& execCtx) {
   }
 }
 
+std::optional<std::string> makeOperatorSpillPath(
+    const OperatorCtx& operatorCtx) {
+  auto path = operatorCtx.task()->queryCtx()->config().spillPath();
+  if (path.has_value()) {
+    return path.value() + "/" + operatorCtx.task()->taskId();
+  }
+  return std::nullopt;
+}
+
+SpillFileOptions makeSpillFileOptions(const OperatorCtx& operatorCtx) {
+  const auto& config = operatorCtx.task()->queryCtx()->config();
+  SpillFileOptions options;
+  options.compression =
+      spillCompressionFromString(config.spillCompressionCodec());
+  options.checksum = config.spillChecksumEnabled();
+  options.readAheadExecutor = operatorCtx.task()->queryCtx()->spillExecutor();
+  return options;
+}
+
+void setSpillRuntimeStats(
+    const SpillStats& spillStats,
+    OperatorStats& operatorStats) {
+  const uint64_t uncompressedBytes = spillStats.uncompressedBytes;
+  if (uncompressedBytes == 0) {
+    return;
+  }
+  // The stats are running totals, so each call replaces the previous value.
+  auto set = [&](const char* name, int64_t value, RuntimeCounter::Unit unit) {
+    RuntimeMetric metric(unit);
+    metric.addValue(value);
+    operatorStats.runtimeStats[name] = metric;
+  };
+  const uint64_t writtenBytes = spillStats.writtenBytes;
+  set("spillUncompressedBytes",
+      uncompressedBytes,
+      RuntimeCounter::Unit::kBytes);
+  set("spillWrittenBytes", writtenBytes, RuntimeCounter::Unit::kBytes);
+  set("spillCompressionPct",
+      writtenBytes * 100 / uncompressedBytes,
+      RuntimeCounter::Unit::kNone);
+  set("spillWriteNanos",
+      spillStats.writeTimeUs * 1'000,
+      RuntimeCounter::Unit::kNanos);
+  set("spillReadBytes", spillStats.readBytes, RuntimeCounter::Unit::kBytes);
+  set("spillReads", spillStats.numReads, RuntimeCounter::Unit::kNone);
+  set("spillReadNanos",
+      spillStats.readTimeUs * 1'000,
+      RuntimeCounter::Unit::kNanos);
+  set("spillReadWaitNanos",
+      spillStats.readWaitUs * 1'000,
+      RuntimeCounter::Unit::kNanos);
+}
+
 } // namespace facebook::velox::exec
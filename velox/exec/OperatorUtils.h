@@ -15,7 +15,9 @@
  */
 #pragma once
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/Spill.h"
 
 namespace facebook::velox::exec {
 
@@ -77,4 +79,67 @@ wrap(vector_size_t size, BufferPtr mapping, const RowVectorPtr& vector);
 // Ensures that all LazyVectors reachable from 'input' are loaded for all rows.
 void loadColumns(const RowVectorPtr& input, core::ExecCtx& execCtx);
 
+// Returns the file system path prefix for spill files of the Task of
+// 'operatorCtx' or std::nullopt if spilling is not enabled in the query config.
+std::optional<std::string> makeOperatorSpillPath(
+    const OperatorCtx& operatorCtx);
+
+// Returns the spill file compression and checksumming set in the query
+// config of 'operatorCtx'. Spill files read ahead on the spill executor of
+// the query if there is one.
+SpillFileOptions makeSpillFileOptions(const OperatorCtx& operatorCtx);
+
+// Sets the spill IO runtime stats of 'operatorStats' to the totals in
+// 'spillStats'. These are spillUncompressedBytes, spillWrittenBytes,
+// spillCompressionPct (written as a percentage of uncompressed bytes),
+// spillWriteNanos, spillReadBytes, spillReadNanos and spillReadWaitNanos.
+void setSpillRuntimeStats(
+    const SpillStats& spillStats,
+    OperatorStats& operatorStats);
+
+// Runs 'tasks' on 'executor' and the calling thread and returns their
+// results in the order of 'tasks'. Runs all tasks on the calling
+// thread if 'executor' is nullptr. If any task throws, waits for all
+// tasks to finish and rethrows the first error.
+template <typename T>
+std::vector<std::unique_ptr<T>> runInParallel(
+    std::vector<std::function<std::unique_ptr<T>()>> tasks,
+    folly::Executor* executor) {
+  struct Result {
+    std::unique_ptr<T> value;
+    std::exception_ptr error;
+  };
+  std::vector<std::shared_ptr<AsyncSource<Result>>> sources;
+  sources.reserve(tasks.size());
+  for (auto& task : tasks) {
+    sources.push_back(std::make_shared<AsyncSource<Result>>(
+        [task = std::move(task)]() {
+          auto result = std::make_unique<Result>();
+          try {
+            result->value = task();
+          } catch (const std::exception&) {
+            result->error = std::current_exception();
+          }
+          return result;
+        }));
+    if (executor) {
+      executor->add([source = sources.back()]() { source->prepare(); });
+    }
+  }
+  std::vector<std::unique_ptr<T>> results;
+  results.reserve(sources.size());
+  std::exception_ptr error;
+  for (auto& source : sources) {
+    auto result = source->move();
+    if (result->error && !error) {
+      error = result->error;
+    }
+    results.push_back(std::move(result->value));
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return results;
+}
+
 } // namespace facebook::velox::exec
@@ -14,10 +14,63 @@
  * limitations under the License.
  */
 #include "velox/exec/OrderBy.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Task.h"
+#include "velox/exec/TreeOfLosers.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
 
+namespace {
+// A row to sort with a copy of its SortPrefix.
+struct SortEntry {
+  uint64_t prefix;
+  char* row;
+};
+
+// Orders SortEntries by their prefixes. Rows with equal prefixes are
+// compared on their keys unless the prefix covers all keys.
+class SortEntryLess {
+ public:
+  explicit SortEntryLess(RowContainer* data) : data_(data) {}
+
+  bool operator()(const SortEntry& left, const SortEntry& right) const {
+    if (left.prefix != right.prefix) {
+      return left.prefix < right.prefix;
+    }
+    return data_->compareRowsWithSortPrefix(left.row, right.row) < 0;
+  }
+
+ private:
+  RowContainer* const data_;
+};
+
+// A sorted run of SortEntries for merging with TreeOfLosers.
+class SortedRun : public MergeStream {
+ public:
+  SortedRun(const SortEntry* begin, const SortEntry* end, SortEntryLess less)
+      : next_(begin), end_(end), less_(less) {}
+
+  bool hasData() const override {
+    return next_ < end_;
+  }
+
+  bool operator<(const MergeStream& other) const override {
+    return less_(*next_, *static_cast<const SortedRun&>(other).next_);
+  }
+
+  // Returns the first row and removes it from the run.
+  char* pop() {
+    return (next_++)->row;
+  }
+
+ private:
+  const SortEntry* next_;
+  const SortEntry* const end_;
+  const SortEntryLess less_;
+};
+} // namespace
+
 OrderBy::OrderBy(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -28,21 +81,60 @@ OrderBy::OrderBy(
           operatorId,
           orderByNode->id(),
           "OrderBy"),
-      data_(std::make_unique<RowContainer>(
-          outputType_->as<TypeKind::ROW>().children(),
-          operatorCtx_->mappedMemory())) {
+      spillPath_(makeOperatorSpillPath(*operatorCtx_)),
+      spillExecutor_(operatorCtx_->task()->queryCtx()->spillExecutor()),
+      testSpillPct_(
+          operatorCtx_->task()->queryCtx()->config().testingSpillPct()),
+      parallelSortMinRunSize_(operatorCtx_->task()
+                                  ->queryCtx()
+                                  ->config()
+                                  .parallelSortMinRunSize()),
+      executor_(operatorCtx_->task()->queryCtx()->executor()) {
   auto type = orderByNode->outputType();
   auto numKeys = orderByNode->sortingKeys().size();
+  columnMap_.resize(type->size(), kConstantChannel);
+
+  // The sorting keys are the leading columns of 'data_'. A column that appears
+  // more than once in the sorting keys is stored once since only its first
+  // occurrence can decide the order.
+  std::vector<TypePtr> keyTypes;
+  std::vector<std::string> names;
   for (int i = 0; i < numKeys; ++i) {
     auto channel = exprToChannel(orderByNode->sortingKeys()[i].get(), type);
     VELOX_CHECK(
         channel != kConstantChannel,
         "OrderBy doesn't allow constant grouping keys");
-    keyInfo_.emplace_back(channel, orderByNode->sortingOrders()[i]);
+    if (columnMap_[channel] != kConstantChannel) {
+      continue;
+    }
+    columnMap_[channel] = keyTypes.size();
+    keyTypes.push_back(type->childAt(channel));
+    names.push_back(type->nameOf(channel));
+    const auto& sortOrder = orderByNode->sortingOrders()[i];
+    keyCompareFlags_.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
+  }
+
+  std::vector<TypePtr> dependentTypes;
+  for (auto i = 0; i < type->size(); ++i) {
+    if (columnMap_[i] != kConstantChannel) {
+      continue;
+    }
+    columnMap_[i] = keyTypes.size() + dependentTypes.size();
+    dependentTypes.push_back(type->childAt(i));
+    names.push_back(type->nameOf(i));
   }
+
+  auto types = keyTypes;
+  types.insert(types.end(), dependentTypes.begin(), dependentTypes.end());
+  spillType_ = ROW(std::move(names), std::move(types));
+  data_ = std::make_unique<RowContainer>(
+      keyTypes, dependentTypes, keyCompareFlags_, operatorCtx_->mappedMemory());
 }
 
 void OrderBy::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   SelectivityVector allRows(input->size());
   std::vector<char*> rows(input->size());
   for (int row = 0; row < input->size(); ++row) {
@@ -51,13 +143,104 @@ void OrderBy::addInput(RowVectorPtr input) {
   for (size_t col = 0; col < input->childrenSize(); ++col) {
     DecodedVector decoded(*input->childAt(col), allRows);
     for (int i = 0; i < input->size(); ++i) {
-      data_->store(decoded, i, rows[i], col);
+      data_->store(decoded, i, rows[i], columnMap_[col]);
     }
   }
+  for (auto row : rows) {
+    data_->storeSortPrefix(row);
+  }
 
   numRows_ += allRows.size();
 }
 
+void OrderBy::ensureInputFits(const RowVectorPtr& input) {
+  // Spilling is considered if spillPath is set.
+  if (!spillPath_.has_value()) {
+    return;
+  }
+  auto numRows = data_->numRows();
+  if (!numRows) {
+    // Container is empty. Nothing to spill.
+    return;
+  }
+
+  // Test-only spill path.
+  if (testSpillPct_ &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <= testSpillPct_) {
+    spill();
+    return;
+  }
+
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  int64_t flatBytes = input->estimateFlatSize();
+  if (freeRows > input->size() &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatBytes)) {
+    // Enough free rows for input rows and enough variable length free
+    // space for the flat size of the whole vector. If outOfLineBytes
+    // is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the
+  // input as a cap on the new variable length data needed. Sorting takes
+  // a row pointer and a SortEntry per row on top of this.
+  auto increment =
+      data_->sizeIncrement(input->size(), outOfLineBytes ? flatBytes : 0) +
+      (numRows + input->size()) * (sizeof(char*) + sizeof(SortEntry));
+  auto tracker = operatorCtx_->mappedMemory()->tracker();
+  if (!tracker) {
+    return;
+  }
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * increment) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of
+  // twice the maximum increment from this input and 1/4 of the current
+  // reservation.
+  auto targetIncrement =
+      std::max<int64_t>(increment * 2, tracker->getCurrentUserBytes() / 4);
+  if (tracker->maybeReserve(targetIncrement)) {
+    return;
+  }
+  spill();
+}
+
+void OrderBy::spill() {
+  if (!spiller_) {
+    auto tracker = operatorCtx_->mappedMemory()->tracker();
+    // Each spill writes the whole container as one sorted run, so the
+    // target file size only limits the size of a single file of the run.
+    auto fileSize = tracker ? tracker->getCurrentUserBytes() / 4
+                            : std::numeric_limits<int64_t>::max();
+    spiller_ = std::make_unique<Spiller>(
+        *data_,
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillType_,
+        // Order by does not partition the data. All rows go to one partition
+        // where each spill makes a new sorted run.
+        HashBitRange(29, 29),
+        data_->keyTypes().size(),
+        spillPath_.value(),
+        fileSize,
+        Spiller::spillPool(),
+        spillExecutor_,
+        keyCompareFlags_,
+        makeSpillFileOptions(*operatorCtx_));
+  }
+  // A target of 0 rows and bytes spills the whole container.
+  spiller_->spill(0, 0, spillIterator_);
+  VELOX_CHECK_EQ(0, data_->numRows());
+
+  auto spilled = spiller_->spilledBytesAndRows();
+  stats_.spilledBytes = spilled.first;
+  stats_.spilledRows = spilled.second;
+  setSpillRuntimeStats(spiller_->spillStats(), stats_);
+}
+
 void OrderBy::noMoreInput() {
   Operator::noMoreInput();
 
@@ -67,31 +250,73 @@ void OrderBy::noMoreInput() {
     return;
   }
 
+  if (spiller_) {
+    // The rows left in 'data_' are sorted and merged with the spilled runs.
+    auto nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    merge_ = spiller_->startMerge(0);
+    return;
+  }
+
   // Sort the pointers to the rows in RowContainer (data_) instead of sorting
   // the rows.
   returningRows_.resize(numRows_);
   RowContainerIterator iter;
   data_->listRows(&iter, numRows_, returningRows_.data());
+  sortRows();
+}
+
+void OrderBy::sortRows() {
+  SortEntryLess less(data_.get());
+
+  int64_t numRuns = 1;
+  if (parallelSortMinRunSize_ > 0) {
+    numRuns = std::clamp<int64_t>(
+        numRows_ / parallelSortMinRunSize_, 1, kMaxSortRuns);
+  }
 
-  std::sort(
-      returningRows_.begin(),
-      returningRows_.end(),
-      [this](const char* leftRow, const char* rightRow) {
-        for (auto& [channelIndex, sortOrder] : keyInfo_) {
-          if (auto result = data_->compare(
-                  leftRow,
-                  rightRow,
-                  channelIndex,
-                  {sortOrder.isNullsFirst(), sortOrder.isAscending(), false})) {
-            return result < 0;
-          }
-        }
-        return false; // lhs == rhs.
-      });
+  // Each run copies the prefixes of its rows next to the row pointers for
+  // locality and sorts them.
+  std::vector<SortEntry> entries(numRows_);
+  std::vector<std::function<std::unique_ptr<SortedRun>()>> tasks;
+  for (auto i = 0; i < numRuns; ++i) {
+    auto begin = numRows_ * i / numRuns;
+    auto end = numRows_ * (i + 1) / numRuns;
+    tasks.push_back([&, begin, end]() {
+      for (auto row = begin; row < end; ++row) {
+        entries[row] = {
+            data_->sortPrefix(returningRows_[row]), returningRows_[row]};
+      }
+      std::sort(entries.begin() + begin, entries.begin() + end, less);
+      return std::make_unique<SortedRun>(
+          entries.data() + begin, entries.data() + end, less);
+    });
+  }
+  auto runs =
+      runInParallel(std::move(tasks), numRuns > 1 ? executor_ : nullptr);
+
+  if (numRuns == 1) {
+    for (size_t row = 0; row < numRows_; ++row) {
+      returningRows_[row] = entries[row].row;
+    }
+    return;
+  }
+
+  stats_.addRuntimeStat("parallelSortRuns", RuntimeCounter(numRuns));
+  TreeOfLosers<SortedRun> merge(std::move(runs));
+  for (auto& row : returningRows_) {
+    row = merge.next()->pop();
+  }
 }
 
 RowVectorPtr OrderBy::getOutput() {
-  if (finished_ || !noMoreInput_ || returningRows_.size() == numRowsReturned_) {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+  if (merge_) {
+    return getOutputWithSpill();
+  }
+  if (returningRows_.size() == numRowsReturned_) {
     return nullptr;
   }
 
@@ -108,7 +333,7 @@ RowVectorPtr OrderBy::getOutput() {
     data_->extractColumn(
         returningRows_.data() + numRowsReturned_,
         numRowsToReturn,
-        i,
+        columnMap_[i],
         result->childAt(i));
   }
 
@@ -118,4 +343,39 @@ RowVectorPtr OrderBy::getOutput() {
 
   return result;
 }
+
+RowVectorPtr OrderBy::getOutputWithSpill() {
+  const vector_size_t maxRows =
+      data_->estimatedNumRowsPerBatch(kBatchSizeInBytes);
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, maxRows, operatorCtx_->pool()));
+
+  vector_size_t numRows = 0;
+  for (; numRows < maxRows; ++numRows) {
+    auto stream = merge_->next();
+    if (!stream) {
+      finished_ = true;
+      break;
+    }
+    auto& source = stream->current();
+    auto sourceIndex = stream->currentIndex();
+    for (auto i = 0; i < outputType_->size(); ++i) {
+      result->childAt(i)->copy(
+          source.childAt(columnMap_[i]).get(), numRows, sourceIndex, 1);
+    }
+    stream->pop();
+  }
+  setSpillRuntimeStats(spiller_->spillStats(), stats_);
+
+  if (finished_) {
+    merge_ = nullptr;
+    data_->clear();
+  }
+  if (numRows == 0) {
+    return nullptr;
+  }
+  numRowsReturned_ += numRows;
+  result->resize(numRows);
+  return result;
+}
 } // namespace facebook::velox::exec
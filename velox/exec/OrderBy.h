@@ -18,6 +18,7 @@
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
@@ -26,12 +27,20 @@ namespace facebook::velox::exec {
 // it blocks the pipeline. Once all inputs are available, it sorts pointers
 // to the rows using the RowContainer's compare() function. And finally it
 // constructs and returns the sorted output RowVector using the data in the
-// RowContainer.
+// RowContainer. The sorting keys are the leading columns of the RowContainer.
+//
+// Each row in the RowContainer has a SortPrefix of its leading keys. The rows
+// are compared on the prefixes first and on the full keys only if the
+// prefixes are equal. A large input is cut into
+// runs that are sorted in parallel on the query executor and then merged.
+//
+// If spilling is enabled and the RowContainer cannot grow within the memory
+// limit, its content is sorted and written to disk as a sorted run. The output
+// is then produced by merging the sorted runs and the rows that are still in
+// memory.
 // Limitations:
 // * It memcopies twice: 1) input to RowContainer and 2) RowContainer to
 // output.
-// * It does not support spilling. For now, if memory limit exceeds, it will
-// throw an exception: VeloxMemoryCapExceeded.
 class OrderBy : public Operator {
  public:
   OrderBy(
@@ -60,13 +69,71 @@ class OrderBy : public Operator {
  private:
   static const int32_t kBatchSizeInBytes{2 * 1024 * 1024};
 
+  // Maximum number of runs sorted in parallel.
+  static constexpr int32_t kMaxSortRuns = 16;
+
+  // Checks if 'input' will fit in the existing memory and increases the
+  // reservation if not. If the reservation cannot be increased, spills the
+  // content of 'data_' as a sorted run.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Sorts and writes all rows of 'data_' to disk. 'data_' is empty after this.
+  void spill();
+
+  // Produces the next batch of output by merging the spilled runs and the rows
+  // left in 'data_'. Returns nullptr and sets 'finished_' when at end.
+  RowVectorPtr getOutputWithSpill();
+
+  // Sorts 'returningRows_'. If there are at least twice
+  // 'parallelSortMinRunSize_' rows, sorts runs of at least that many rows in
+  // parallel and merges them.
+  void sortRows();
+
   std::unique_ptr<RowContainer> data_;
-  std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
+
+  // Collation of the sorting keys. The keys are the leading columns of
+  // 'data_'.
+  std::vector<CompareFlags> keyCompareFlags_;
+
+  // Maps an output column to its column in 'data_'. Each input column
+  // is stored once in 'data_'.
+  std::vector<column_index_t> columnMap_;
 
   size_t numRows_ = 0;
   size_t numRowsReturned_ = 0;
   std::vector<char*> returningRows_;
 
+  // Minimum number of rows in a run of a parallel sort. 0 disables the
+  // parallel sort.
+  const uint32_t parallelSortMinRunSize_;
+
+  // Executor for the parallel sort.
+  folly::Executor* const executor_;
+
+  // Filesystem path for spill files, empty if spilling is disabled.
+  const std::optional<std::string> spillPath_;
+
+  // Executor for spilling. If nullptr spilling writes on the Driver's thread.
+  folly::Executor* FOLLY_NULLABLE const spillExecutor_;
+
+  // Percentage of input batches to be spilled for testing. 0 means no spilling
+  // for test.
+  const int32_t testSpillPct_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct_'.
+  uint64_t spillTestCounter_{0};
+
+  // The columns of 'data_' in RowContainer order, i.e. keys first. This is the
+  // type of the spilled runs.
+  RowTypePtr spillType_;
+
+  std::unique_ptr<Spiller> spiller_;
+  RowContainerIterator spillIterator_;
+
+  // Merges the spilled runs with the unspilled rows when producing output.
+  std::unique_ptr<TreeOfLosers<SpillStream>> merge_;
+
   bool finished_ = false;
 };
 } // namespace facebook::velox::exec
@@ -17,6 +17,7 @@
 #include "velox/exec/RowContainer.h"
 
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/SortPrefix.h"
 
 namespace facebook::velox::exec {
 namespace {
@@ -44,12 +45,14 @@ RowContainer::RowContainer(
     bool hasProbedFlag,
     bool hasNormalizedKeys,
     memory::MappedMemory* mappedMemory,
-    const RowSerde& serde)
+    const RowSerde& serde,
+    const std::vector<CompareFlags>& sortPrefixCompareFlags)
     : keyTypes_(keyTypes),
       nullableKeys_(nullableKeys),
       aggregates_(aggregates),
       isJoinBuild_(isJoinBuild),
       hasNormalizedKeys_(hasNormalizedKeys),
+      sortPrefixCompareFlags_(sortPrefixCompareFlags),
       rows_(mappedMemory),
       stringAllocator_(mappedMemory),
       serde_(serde) {
@@ -69,7 +72,8 @@ RowContainer::RowContainer(
   // length columns or accumulators, i.e. ones that allocate extra space, this
   // space is tracked by a uint32_t after the dependent columns. If this is a
   // hash join build side, the pointer to the next row with the same key is
-  // after the optional row size.
+  // after the optional row size. An optional SortPrefix of the keys comes
+  // last.
   //
   // In most cases, rows are prefixed with a normalized_key_t at index
   // -1, 8 bytes below the pointer. This space is reserved for a 64
@@ -154,6 +158,10 @@ RowContainer::RowContainer(
     nextOffset_ = offset + nullBytes;
     offset += sizeof(void*);
   }
+  if (!sortPrefixCompareFlags_.empty()) {
+    sortPrefixOffset_ = offset + nullBytes;
+    offset += sizeof(uint64_t);
+  }
   fixedRowSize_ = offset + nullBytes;
 
   // A distinct hash table has no aggregates and if the hash table has
@@ -175,6 +183,18 @@ RowContainer::RowContainer(
         (nullableKeys_ || i >= keyTypes_.size()) ? nullOffsets_[i]
                                                  : RowColumn::kNotNullOffset);
   }
+  if (!sortPrefixCompareFlags_.empty()) {
+    VELOX_CHECK_EQ(sortPrefixCompareFlags_.size(), keyTypes_.size());
+    sortPrefix_ = std::make_unique<SortPrefix>(*this, sortPrefixCompareFlags_);
+    isSortPrefixComplete_ = sortPrefix_->isComplete();
+  }
+}
+
+RowContainer::~RowContainer() = default;
+
+void RowContainer::storeSortPrefix(char* row) {
+  *reinterpret_cast<uint64_t*>(row + sortPrefixOffset_) =
+      sortPrefix_->encode(row);
 }
 
 char* RowContainer::newRow() {
@@ -24,6 +24,8 @@
 #include "velox/vector/VectorTypeUtils.h"
 namespace facebook::velox::exec {
 
+class SortPrefix;
+
 struct RowContainerIterator {
   int32_t allocationIndex = 0;
   int32_t runIndex = 0;
@@ -101,6 +103,47 @@ class RowContainer {
             mappedMemory,
             ContainerRowSerde::instance()) {}
 
+  // Makes a container with nullable keys of 'keyTypes' and non-key payload
+  // columns of 'dependentTypes', e.g. for an order by where the sorting keys
+  // come first.
+  RowContainer(
+      const std::vector<TypePtr>& keyTypes,
+      const std::vector<TypePtr>& dependentTypes,
+      memory::MappedMemory* mappedMemory)
+      : RowContainer(
+            keyTypes,
+            true, // nullableKeys
+            emptyAggregates(),
+            dependentTypes,
+            false, // hasNext
+            false, // isJoinBuild
+            false, // hasProbedFlag
+            false, // hasNormalizedKey
+            mappedMemory,
+            ContainerRowSerde::instance()) {}
+
+  // Makes a container like the one above where each row also has a
+  // SortPrefix of its keys. 'keyCompareFlags' gives the collation of each
+  // key. The prefix must be set with storeSortPrefix() after the keys of a
+  // row are stored.
+  RowContainer(
+      const std::vector<TypePtr>& keyTypes,
+      const std::vector<TypePtr>& dependentTypes,
+      const std::vector<CompareFlags>& keyCompareFlags,
+      memory::MappedMemory* mappedMemory)
+      : RowContainer(
+            keyTypes,
+            true, // nullableKeys
+            emptyAggregates(),
+            dependentTypes,
+            false, // hasNext
+            false, // isJoinBuild
+            false, // hasProbedFlag
+            false, // hasNormalizedKey
+            mappedMemory,
+            ContainerRowSerde::instance(),
+            keyCompareFlags) {}
+
   // 'keyTypes' gives the type of the key of each row. For a group by,
   // order by or right outer join build side these may be
   // nullable. 'nullableKeys' specifies if these have a null flag.
@@ -116,7 +159,9 @@ class RowContainer {
   // below each row for a normalized key that collapses all parts
   // into one word for faster comparison. The bulk allocation is done
   // from 'mappedMemory'.  'serde_' is used for serializing complex
-  // type values into the container.
+  // type values into the container. If 'sortPrefixCompareFlags' is
+  // not empty, an extra word is left in each row for a SortPrefix of
+  // the keys with this collation.
   RowContainer(
       const std::vector<TypePtr>& keyTypes,
       bool nullableKeys,
@@ -127,7 +172,10 @@ class RowContainer {
       bool hasProbedFlag,
       bool hasNormalizedKey,
       memory::MappedMemory* mappedMemory,
-      const RowSerde& serde);
+      const RowSerde& serde,
+      const std::vector<CompareFlags>& sortPrefixCompareFlags = {});
+
+  ~RowContainer();
 
   // Allocates a new row and initializes possible aggregates to null.
   char* newRow();
@@ -328,9 +376,49 @@ class RowContainer {
   // Resets the state to be as after construction. Frees memory for payload.
   void clear();
 
-  int32_t compareRows(const char* left, const char* right) {
+  // True if each row has a SortPrefix of its keys.
+  bool hasSortPrefix() const {
+    return sortPrefix_ != nullptr;
+  }
+
+  // Sets the SortPrefix of 'row' from its keys. The keys must be stored.
+  void storeSortPrefix(char* row);
+
+  // Returns the SortPrefix of 'row'. hasSortPrefix() must be true.
+  uint64_t sortPrefix(const char* row) const {
+    return *reinterpret_cast<const uint64_t*>(row + sortPrefixOffset_);
+  }
+
+  // True if equal sort prefixes mean equal keys.
+  bool isSortPrefixComplete() const {
+    return isSortPrefixComplete_;
+  }
+
+  // Compares the keys of 'left' and 'right' with the collation of the
+  // SortPrefix. The keys are compared only if the prefixes are equal and do
+  // not cover all keys. hasSortPrefix() must be true.
+  int32_t compareRowsWithSortPrefix(const char* left, const char* right) {
+    auto leftPrefix = sortPrefix(left);
+    auto rightPrefix = sortPrefix(right);
+    if (leftPrefix != rightPrefix) {
+      return leftPrefix < rightPrefix ? -1 : 1;
+    }
+    return isSortPrefixComplete_
+        ? 0
+        : compareRows(left, right, sortPrefixCompareFlags_);
+  }
+
+  // Compares the keys of 'left' and 'right'. 'flags' gives the collation of
+  // each key. If 'flags' is empty, all keys are compared ascending with nulls
+  // first.
+  int32_t compareRows(
+      const char* left,
+      const char* right,
+      const std::vector<CompareFlags>& flags = {}) {
+    VELOX_DCHECK(flags.empty() || flags.size() == keyTypes_.size());
     for (auto i = 0; i < keyTypes_.size(); ++i) {
-      auto result = compare(left, right, i);
+      auto result =
+          compare(left, right, i, flags.empty() ? CompareFlags() : flags[i]);
       if (result) {
         return result;
       }
@@ -802,6 +890,13 @@ class RowContainer {
   // Extra bytes to reserve before  each added row for a normalized key. Set to
   // 0 after deciding not to use normalized keys.
   int8_t normalizedKeySize_ = sizeof(normalized_key_t);
+  // Collation of the keys in the SortPrefix of each row. Empty if the rows
+  // have no SortPrefix.
+  const std::vector<CompareFlags> sortPrefixCompareFlags_;
+  std::unique_ptr<SortPrefix> sortPrefix_;
+  bool isSortPrefixComplete_ = false;
+  // Offset of the SortPrefix in each row.
+  int32_t sortPrefixOffset_ = 0;
   // Copied over the null bits of each row on initialization. Keys are
   // not null, aggregates are null.
   std::vector<uint8_t> initialNulls_;
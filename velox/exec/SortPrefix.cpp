@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SortPrefix.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+constexpr int32_t kPrefixBits = 64;
+constexpr uint64_t kHighBit = 1UL << 63;
+
+// Returns a mask of the 'numBits' high bits of a word.
+inline uint64_t highBits(int32_t numBits) {
+  return numBits >= kPrefixBits ? ~0UL : ~(~0UL >> numBits);
+}
+
+// Returns the number of bits in the encoding of 'kind', 0 if 'kind' has no
+// encoding.
+int32_t valueBits(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      return 1;
+    case TypeKind::TINYINT:
+      return 8;
+    case TypeKind::SMALLINT:
+      return 16;
+    case TypeKind::INTEGER:
+    case TypeKind::REAL:
+    case TypeKind::DATE:
+      return 32;
+    case TypeKind::BIGINT:
+    case TypeKind::DOUBLE:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return 64;
+    default:
+      return 0;
+  }
+}
+
+// True if the encoding of 'kind' is only a prefix of the value.
+bool isPartial(TypeKind kind) {
+  return kind == TypeKind::TIMESTAMP || kind == TypeKind::VARCHAR ||
+      kind == TypeKind::VARBINARY;
+}
+
+// Returns 'value' with the sign bit flipped in the high bits of a word.
+template <typename T>
+inline uint64_t encodeInteger(T value) {
+  using U = std::make_unsigned_t<T>;
+  constexpr int32_t kBits = sizeof(T) * 8;
+  auto flipped = static_cast<U>(
+      static_cast<U>(value) ^ static_cast<U>(U(1) << (kBits - 1)));
+  return static_cast<uint64_t>(flipped) << (kPrefixBits - kBits);
+}
+
+// Returns 'value' in the high bits of a word so that the words compare like
+// the values. All NaNs become the largest value and -0.0 becomes 0.0.
+template <typename T, typename U>
+inline uint64_t encodeFloatingPoint(T value) {
+  static_assert(sizeof(T) == sizeof(U));
+  if (std::isnan(value)) {
+    value = std::numeric_limits<T>::quiet_NaN();
+  } else if (value == 0) {
+    value = 0;
+  }
+  U bits;
+  memcpy(&bits, &value, sizeof(T));
+  constexpr int32_t kBits = sizeof(U) * 8;
+  constexpr U kSignBit = U(1) << (kBits - 1);
+  bits = (bits & kSignBit) ? ~bits : bits | kSignBit;
+  return static_cast<uint64_t>(bits) << (kPrefixBits - kBits);
+}
+
+// Returns the first 8 bytes of 'value' padded with zeros. A string that is
+// not inline is longer than 8 bytes and the first block of its storage in
+// HashStringAllocator holds at least 8 bytes of it.
+inline uint64_t encodeString(StringView value) {
+  auto data = reinterpret_cast<const uint8_t*>(value.data());
+  auto size = std::min<int32_t>(value.size(), sizeof(uint64_t));
+  uint64_t bits = 0;
+  for (auto i = 0; i < size; ++i) {
+    bits |= static_cast<uint64_t>(data[i]) << (56 - 8 * i);
+  }
+  return bits;
+}
+
+template <typename T>
+inline const T& valueAt(const char* row, int32_t offset) {
+  return *reinterpret_cast<const T*>(row + offset);
+}
+} // namespace
+
+SortPrefix::SortPrefix(
+    const RowContainer& container,
+    const std::vector<CompareFlags>& keyCompareFlags) {
+  const auto& keyTypes = container.keyTypes();
+  VELOX_CHECK(
+      keyCompareFlags.empty() || keyCompareFlags.size() == keyTypes.size());
+  int32_t numBits = 0;
+  for (auto i = 0; i < keyTypes.size(); ++i) {
+    auto kind = keyTypes[i]->kind();
+    auto width = valueBits(kind);
+    if (width == 0) {
+      isComplete_ = false;
+      break;
+    }
+    keys_.push_back(
+        {kind,
+         container.columnAt(i),
+         keyCompareFlags.empty() ? CompareFlags() : keyCompareFlags[i]});
+    numBits += 1 + width;
+    if (numBits > kPrefixBits || isPartial(kind)) {
+      isComplete_ = false;
+    }
+    if (numBits >= kPrefixBits || isPartial(kind)) {
+      break;
+    }
+  }
+  if (keys_.size() < keyTypes.size()) {
+    isComplete_ = false;
+  }
+}
+
+uint64_t SortPrefix::encode(const char* row) const {
+  uint64_t prefix = 0;
+  int32_t numBits = 0;
+  for (const auto& key : keys_) {
+    auto isNull = RowContainer::isNullAt(
+        row, key.column.nullByte(), key.column.nullMask());
+    if (isNull != key.flags.nullsFirst) {
+      prefix |= kHighBit >> numBits;
+    }
+    if (++numBits == kPrefixBits) {
+      break;
+    }
+    auto width = valueBits(key.kind);
+    if (!isNull) {
+      auto offset = key.column.offset();
+      uint64_t bits;
+      switch (key.kind) {
+        case TypeKind::BOOLEAN:
+          bits = valueAt<bool>(row, offset) ? kHighBit : 0;
+          break;
+        case TypeKind::TINYINT:
+          bits = encodeInteger(valueAt<int8_t>(row, offset));
+          break;
+        case TypeKind::SMALLINT:
+          bits = encodeInteger(valueAt<int16_t>(row, offset));
+          break;
+        case TypeKind::INTEGER:
+          bits = encodeInteger(valueAt<int32_t>(row, offset));
+          break;
+        case TypeKind::BIGINT:
+          bits = encodeInteger(valueAt<int64_t>(row, offset));
+          break;
+        case TypeKind::REAL:
+          bits = encodeFloatingPoint<float, uint32_t>(
+              valueAt<float>(row, offset));
+          break;
+        case TypeKind::DOUBLE:
+          bits = encodeFloatingPoint<double, uint64_t>(
+              valueAt<double>(row, offset));
+          break;
+        case TypeKind::DATE:
+          bits = encodeInteger(valueAt<Date>(row, offset).days());
+          break;
+        case TypeKind::TIMESTAMP:
+          bits = encodeInteger(valueAt<Timestamp>(row, offset).getSeconds());
+          break;
+        case TypeKind::VARCHAR:
+        case TypeKind::VARBINARY:
+          bits = encodeString(valueAt<StringView>(row, offset));
+          break;
+        default:
+          VELOX_UNREACHABLE();
+      }
+      if (!key.flags.ascending) {
+        bits = ~bits & highBits(width);
+      }
+      prefix |= bits >> numBits;
+    }
+    numBits += width;
+    if (numBits >= kPrefixBits) {
+      break;
+    }
+  }
+  return prefix;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+// Encodes the leading keys of a RowContainer row into a 64 bit prefix that
+// compares as an unsigned integer. If the prefix of 'left' is less than the
+// prefix of 'right', 'left' sorts before 'right' under the collation the
+// prefix was made for. Equal prefixes are a tie that must be broken with
+// RowContainer::compareRows(), unless isComplete() is true.
+//
+// Each key is encoded as a null flag bit followed by the bits of its value,
+// high bit first. Signed values have the sign bit flipped and floating point
+// values are ordered as in RowContainer::compare(), with NaN as the largest
+// value and -0.0 equal to 0.0. Values of descending keys are inverted. A key
+// that does not fit in the remaining bits is truncated and ends the prefix.
+// Strings contribute their first 8 bytes and timestamps their seconds, after
+// which the prefix ends. A key of any other type ends the prefix before its
+// null flag.
+class SortPrefix {
+ public:
+  // 'keyCompareFlags' gives the collation of the leading keys of
+  // 'container'. If empty, all keys are ascending with nulls first.
+  SortPrefix(
+      const RowContainer& container,
+      const std::vector<CompareFlags>& keyCompareFlags);
+
+  // Returns the prefix of 'row'.
+  uint64_t encode(const char* row) const;
+
+  // True if no key has an encoding. All prefixes are then 0.
+  bool empty() const {
+    return keys_.empty();
+  }
+
+  // True if all keys are encoded in full. Equal prefixes then mean equal
+  // keys.
+  bool isComplete() const {
+    return isComplete_;
+  }
+
+ private:
+  struct Key {
+    TypeKind kind;
+    RowColumn column;
+    CompareFlags flags;
+  };
+
+  std::vector<Key> keys_;
+  bool isComplete_{true};
+};
+
+} // namespace facebook::velox::exec
@@ -15,18 +15,311 @@
  */
 
 #include "velox/exec/Spill.h"
+
+#include <algorithm>
+
+#include <boost/crc.hpp>
+#include <folly/compression/Compression.h>
+
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/time/Timer.h"
 
 namespace facebook::velox::exec {
 
 std::atomic<int32_t> SpillStream::ordinalCounter_;
 
-void SpillInput::next(bool /*throwIfPastEnd*/) {
-  int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
-  VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
-  setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
-  input_->pread(offset_, readBytes, buffer_->asMutable<char>());
-  offset_ += readBytes;
+namespace {
+// Header of a block of a framed spill file: the stored size, the
+// uncompressed size and the CRC32 of the stored bytes, 4 bytes each,
+// followed by the SpillCompression of the block in 1 byte.
+constexpr int32_t kBlockHeaderSize = 13;
+
+// Serialized batches are buffered up to this size before being written.
+constexpr int64_t kWriteBufferSize = 64 << 10;
+
+std::unique_ptr<folly::io::Codec> makeCodec(SpillCompression compression) {
+  switch (compression) {
+    case SpillCompression::kLz4:
+      return folly::io::getCodec(folly::io::CodecType::LZ4);
+    case SpillCompression::kZstd:
+      return folly::io::getCodec(folly::io::CodecType::ZSTD);
+    default:
+      VELOX_FAIL(
+          "No codec for spill compression {}", static_cast<int>(compression));
+  }
+}
+
+uint32_t checksum(const folly::IOBuf& data) {
+  boost::crc_32_type crc32;
+  for (auto range : data) {
+    crc32.process_bytes(range.data(), range.size());
+  }
+  return crc32.checksum();
+}
+
+struct BlockHeader {
+  uint32_t storedSize;
+  uint32_t uncompressedSize;
+  uint32_t crc;
+  SpillCompression compression;
+};
+
+// Reads the header of the block starting at 'data'.
+BlockHeader readBlockHeader(const char* data) {
+  BlockHeader header;
+  memcpy(&header.storedSize, data, sizeof(uint32_t));
+  memcpy(&header.uncompressedSize, data + 4, sizeof(uint32_t));
+  memcpy(&header.crc, data + 8, sizeof(uint32_t));
+  header.compression =
+      static_cast<SpillCompression>(data[kBlockHeaderSize - 1]);
+  return header;
+}
+
+// Returns 'data' prefixed with a block header. The data is compressed
+// unless this does not make it smaller.
+std::unique_ptr<folly::IOBuf> makeBlock(
+    std::unique_ptr<folly::IOBuf> data,
+    const SpillFileOptions& options) {
+  const uint64_t uncompressedSize = data->computeChainDataLength();
+  VELOX_CHECK_LE(uncompressedSize, std::numeric_limits<uint32_t>::max());
+  auto compression = SpillCompression::kNone;
+  if (options.compression != SpillCompression::kNone) {
+    auto compressed = makeCodec(options.compression)->compress(data.get());
+    if (compressed->computeChainDataLength() < uncompressedSize) {
+      data = std::move(compressed);
+      compression = options.compression;
+    }
+  }
+  const uint32_t sizes[2] = {
+      static_cast<uint32_t>(data->computeChainDataLength()),
+      static_cast<uint32_t>(uncompressedSize)};
+  const uint32_t crc = options.checksum ? checksum(*data) : 0;
+  auto block = folly::IOBuf::create(kBlockHeaderSize);
+  auto header = block->writableData();
+  memcpy(header, sizes, sizeof(sizes));
+  memcpy(header + sizeof(sizes), &crc, sizeof(crc));
+  header[kBlockHeaderSize - 1] = static_cast<uint8_t>(compression);
+  block->append(kBlockHeaderSize);
+  block->prependChain(std::move(data));
+  return block;
+}
+} // namespace
+
+SpillCompression spillCompressionFromString(const std::string& name) {
+  if (name == "none") {
+    return SpillCompression::kNone;
+  }
+  if (name == "lz4") {
+    return SpillCompression::kLz4;
+  }
+  if (name == "zstd") {
+    return SpillCompression::kZstd;
+  }
+  VELOX_USER_FAIL("Unknown spill compression: {}", name);
+}
+
+uint64_t SpillFileOptions::readBufferSize(int32_t numFiles) const {
+  constexpr uint64_t kMinReadBufferSize = 64 << 10;
+  constexpr uint64_t kMaxReadBufferSize =
+      (4 << 20) - AlignedBuffer::kPaddedSize; // 4MB - padding.
+  // A file reading ahead has two buffers.
+  const int32_t buffersPerFile = readAheadExecutor ? 2 : 1;
+  return std::clamp<uint64_t>(
+      readBufferBudget / (std::max(1, numFiles) * buffersPerFile),
+      kMinReadBufferSize,
+      kMaxReadBufferSize);
+}
+
+SpillInput::SpillInput(
+    std::unique_ptr<ReadFile>&& input,
+    BufferPtr buffer,
+    const SpillFileOptions& options,
+    SpillStats* stats)
+    : input_(std::move(input)),
+      size_(input_->size()),
+      options_(options),
+      stats_(stats),
+      current_(std::make_unique<Chunk>()) {
+  current_->buffer = std::move(buffer);
+  next(true);
+}
+
+SpillInput::~SpillInput() {
+  if (readAhead_) {
+    // The read-ahead refers to 'this' and must finish first. Its error, if
+    // any, is of no interest since its data is not consumed.
+    try {
+      readAhead_->move();
+    } catch (const std::exception&) {
+    }
+  }
+}
+
+void SpillInput::next(bool throwIfPastEnd) {
+  if (!ranges().empty() && !ByteStream::atEnd()) {
+    // The next block of the current chunk.
+    ByteStream::next(throwIfPastEnd);
+    return;
+  }
+  if (readAhead_) {
+    uint64_t waitUs = 0;
+    std::unique_ptr<Chunk> chunk;
+    {
+      MicrosecondTimer timer(&waitUs);
+      chunk = readAhead_->move();
+    }
+    readAhead_ = nullptr;
+    if (stats_) {
+      stats_->readWaitUs += waitUs;
+    }
+    if (chunk->error) {
+      std::rethrow_exception(chunk->error);
+    }
+    spare_ = std::move(current_);
+    current_ = std::move(chunk);
+  } else {
+    load(*current_, *current_);
+  }
+  resetInput(std::vector<ByteRange>(current_->ranges));
+  startReadAhead();
+}
+
+void SpillInput::startReadAhead() {
+  if (!options_.readAheadExecutor || !hasMoreToLoad()) {
+    return;
+  }
+  // The consumer does not change 'current_' before the read-ahead is done.
+  readAhead_ = std::make_shared<AsyncSource<Chunk>>(
+      [this, previous = current_.get()]() {
+        auto chunk = std::move(spare_);
+        if (!chunk) {
+          chunk = std::make_unique<Chunk>();
+          chunk->buffer = AlignedBuffer::allocate<char>(
+              previous->buffer->capacity(), previous->buffer->pool());
+        }
+        // The exception is passed to the consumer thread, which checks this
+        // in next().
+        try {
+          load(*chunk, *previous);
+        } catch (const std::exception&) {
+          chunk->error = std::current_exception();
+        }
+        return chunk;
+      });
+  options_.readAheadExecutor->add(
+      [source = readAhead_]() { source->prepare(); });
+}
+
+void SpillInput::load(Chunk& chunk, const Chunk& previous) {
+  uint64_t readTimeUs = 0;
+  {
+    MicrosecondTimer timer(&readTimeUs);
+    if (options_.framed()) {
+      loadBlocks(chunk, previous);
+    } else {
+      int32_t readBytes =
+          std::min(input_->size() - offset_, chunk.buffer->capacity());
+      VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
+      chunk.ranges = {{chunk.buffer->asMutable<uint8_t>(), readBytes, 0}};
+      read(readBytes, chunk.buffer->asMutable<char>());
+    }
+  }
+  if (stats_) {
+    stats_->readTimeUs += readTimeUs;
+  }
+}
+
+uint64_t SpillInput::read(uint64_t length, char* buffer) {
+  input_->pread(offset_, length, buffer);
+  offset_ += length;
+  if (stats_) {
+    ++stats_->numReads;
+    stats_->readBytes += length;
+  }
+  return length;
+}
+
+void SpillInput::loadBlocks(Chunk& chunk, const Chunk& previous) {
+  // The bytes read after the last whole block of 'previous' start 'chunk'.
+  // 'previous' may be 'chunk', so these are moved before anything else is
+  // changed.
+  auto& buffer = chunk.buffer;
+  const uint64_t tailSize = previous.tailEnd - previous.tailBegin;
+  if (buffer->capacity() < tailSize) {
+    buffer = AlignedBuffer::allocate<char>(tailSize, buffer->pool());
+  }
+  memmove(
+      buffer->asMutable<char>(),
+      previous.buffer->as<char>() + previous.tailBegin,
+      tailSize);
+  // File offset of the first byte of 'buffer'.
+  const uint64_t bufferOffset = offset_ - tailSize;
+  uint64_t numBytes = tailSize +
+      read(std::min(buffer->capacity() - tailSize, size_ - offset_),
+           buffer->asMutable<char>() + tailSize);
+  VELOX_CHECK_LE(kBlockHeaderSize, numBytes, "Reading past end of spill file");
+  const uint64_t firstBlockSize =
+      kBlockHeaderSize + readBlockHeader(buffer->as<char>()).storedSize;
+  if (firstBlockSize > numBytes) {
+    VELOX_CHECK_LE(
+        firstBlockSize - numBytes,
+        size_ - offset_,
+        "Truncated spill file block");
+    auto larger =
+        AlignedBuffer::allocate<char>(firstBlockSize, buffer->pool());
+    memcpy(larger->asMutable<char>(), buffer->as<char>(), numBytes);
+    buffer = std::move(larger);
+    numBytes += read(
+        firstBlockSize - numBytes, buffer->asMutable<char>() + numBytes);
+  }
+
+  chunk.blocks.clear();
+  chunk.ranges.clear();
+  uint64_t offset = 0;
+  while (offset + kBlockHeaderSize <= numBytes) {
+    const uint64_t blockSize = kBlockHeaderSize +
+        readBlockHeader(buffer->as<char>() + offset).storedSize;
+    if (offset + blockSize > numBytes) {
+      break;
+    }
+    loadBlock(chunk, offset, bufferOffset + offset);
+    offset += blockSize;
+  }
+  chunk.tailBegin = offset;
+  chunk.tailEnd = numBytes;
+}
+
+void SpillInput::loadBlock(
+    Chunk& chunk,
+    uint64_t offset,
+    uint64_t fileOffset) {
+  const char* data = chunk.buffer->as<char>() + offset;
+  const auto header = readBlockHeader(data);
+  auto stored = folly::IOBuf::wrapBufferAsValue(
+      data + kBlockHeaderSize, header.storedSize);
+  if (options_.checksum) {
+    VELOX_CHECK_EQ(
+        checksum(stored),
+        header.crc,
+        "Spill file checksum mismatch at offset {}",
+        fileOffset);
+  }
+  if (header.compression == SpillCompression::kNone) {
+    chunk.ranges.push_back(
+        {chunk.buffer->asMutable<uint8_t>() + offset + kBlockHeaderSize,
+         static_cast<int32_t>(header.storedSize),
+         0});
+    return;
+  }
+  auto block = makeCodec(header.compression)
+                   ->uncompress(&stored, header.uncompressedSize);
+  block->coalesce();
+  VELOX_CHECK_EQ(block->length(), header.uncompressedSize);
+  chunk.ranges.push_back(
+      {block->writableData(),
+       static_cast<int32_t>(header.uncompressedSize),
+       0});
+  chunk.blocks.push_back(std::move(block));
 }
 
 void SpillStream::pop() {
@@ -52,16 +345,16 @@ WriteFile& SpillFile::output() {
   return *output_;
 }
 
-void SpillFile::startRead() {
-  constexpr uint64_t kMaxReadBufferSize =
-      (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
+void SpillFile::startRead(int32_t numFiles) {
   VELOX_CHECK(!output_);
   VELOX_CHECK(!input_);
   auto fs = filesystems::getFileSystem(path_, nullptr);
   auto file = fs->openFileForRead(path_);
-  auto buffer = AlignedBuffer::allocate<char>(
-      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+  readBufferSize_ =
+      std::min<uint64_t>(fileSize_, fileOptions_.readBufferSize(numFiles));
+  auto buffer = AlignedBuffer::allocate<char>(readBufferSize_, &pool_);
+  input_ = std::make_unique<SpillInput>(
+      std::move(file), std::move(buffer), fileOptions_, stats_.get());
   nextBatch();
 }
 
@@ -75,6 +368,18 @@ void SpillFile::nextBatch() {
   size_ = rowVector_->size();
 }
 
+bool SpillFile::readBatch(RowVectorPtr& batch) {
+  VELOX_CHECK(input_, "startRead() must be called before readBatch()");
+  if (!hasData()) {
+    return false;
+  }
+  // Move the current batch out so that the next one is read into a new
+  // vector.
+  batch = std::move(rowVector_);
+  nextBatch();
+  return true;
+}
+
 WriteFile& SpillFileList::currentOutput() {
   if (files_.empty() || !files_.back()->isWritable() ||
       files_.back()->size() > targetFileSize_ * 1.5) {
@@ -85,37 +390,57 @@ WriteFile& SpillFileList::currentOutput() {
         type_,
         numSortingKeys_,
         fmt::format("{}-{}", path_, files_.size()),
-        pool_));
+        pool_,
+        sortCompareFlags_,
+        fileOptions_,
+        stats_));
   }
   return files_.back()->output();
 }
 
 void SpillFileList::flush() {
-  if (batch_) {
-    IOBufOutputStream out(
-        mappedMemory_, nullptr, std::max<int64_t>(64 * 1024, batch_->size()));
-    batch_->flush(&out);
-    batch_.reset();
-    auto iobuf = out.getIOBuf();
-    auto& file = currentOutput();
-    for (auto& range : *iobuf) {
-      file.append(std::string_view(
-          reinterpret_cast<const char*>(range.data()), range.size()));
+  if (pending_) {
+    auto out = std::move(pending_);
+    uint64_t writeTimeUs = 0;
+    {
+      MicrosecondTimer timer(&writeTimeUs);
+      auto iobuf = out->getIOBuf();
+      const auto uncompressedSize = iobuf->computeChainDataLength();
+      if (fileOptions_.framed()) {
+        iobuf = makeBlock(std::move(iobuf), fileOptions_);
+      }
+      auto& file = currentOutput();
+      for (auto& range : *iobuf) {
+        file.append(std::string_view(
+            reinterpret_cast<const char*>(range.data()), range.size()));
+      }
+      stats_->uncompressedBytes += uncompressedSize;
+      stats_->writtenBytes += iobuf->computeChainDataLength();
     }
+    stats_->writeTimeUs += writeTimeUs;
   }
 }
 
 void SpillFileList::write(
     const RowVectorPtr& rows,
     const folly::Range<IndexRange*>& indices) {
-  if (!batch_) {
-    batch_ = std::make_unique<VectorStreamGroup>(&mappedMemory_);
-    batch_->createStreamTree(
-        std::static_pointer_cast<const RowType>(rows->type()), 1000);
+  VectorStreamGroup batch(&mappedMemory_);
+  batch.createStreamTree(
+      std::static_pointer_cast<const RowType>(rows->type()), 1000);
+  batch.append(rows, indices);
+  if (!pending_) {
+    pending_ = std::make_unique<IOBufOutputStream>(
+        mappedMemory_,
+        nullptr,
+        std::max<int64_t>(kWriteBufferSize, batch.size()));
+  }
+  batch.flush(pending_.get());
+  // The batches of a write are usually small, e.g. 64 rows from a Spiller.
+  // Writing them together makes blocks large enough to compress well and
+  // makes fewer, larger reads.
+  if (pending_->tellp() >= kWriteBufferSize) {
+    flush();
   }
-  batch_->append(rows, indices);
-
-  flush();
 }
 
 void SpillFileList::finishFile() {
@@ -129,7 +454,8 @@ void SpillFileList::finishFile() {
 }
 
 int64_t SpillFileList::spilledBytes() const {
-  int64_t bytes = 0;
+  // The pending batches are counted at their serialized size.
+  int64_t bytes = pending_ ? static_cast<int64_t>(pending_->tellp()) : 0;
   for (auto& file : files_) {
     bytes += file->size();
   }
@@ -153,7 +479,10 @@ void SpillState::appendToPartition(
         fmt::format("{}-spill-{}", path_, partition),
         targetFileSize_,
         pool_,
-        mappedMemory_);
+        mappedMemory_,
+        sortCompareFlags_,
+        fileOptions_,
+        stats_);
   }
 
   IndexRange range{0, rows->size()};
@@ -166,8 +495,9 @@ std::unique_ptr<TreeOfLosers<SpillStream>> SpillState::startMerge(
   VELOX_CHECK_LT(partition, files_.size());
   std::vector<std::unique_ptr<SpillStream>> result;
   if (auto list = std::move(files_[partition]); list) {
-    for (auto& file : list->files()) {
-      file->startRead();
+    auto files = list->files();
+    for (auto& file : files) {
+      file->startRead(files.size());
       result.push_back(std::move(file));
     }
   }
@@ -177,6 +507,14 @@ std::unique_ptr<TreeOfLosers<SpillStream>> SpillState::startMerge(
   return std::make_unique<TreeOfLosers<SpillStream>>(std::move(result));
 }
 
+std::vector<std::unique_ptr<SpillFile>> SpillState::files(int32_t partition) {
+  VELOX_CHECK_LT(partition, files_.size());
+  if (auto list = std::move(files_[partition]); list) {
+    return list->files();
+  }
+  return {};
+}
+
 int64_t SpillState::spilledBytes() const {
   int64_t bytes = 0;
   for (auto& list : files_) {
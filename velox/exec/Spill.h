@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <folly/io/IOBuf.h>
+
+#include "velox/common/base/AsyncSource.h"
+#include "velox/common/base/CompareFlags.h"
 #include "velox/common/file/File.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/vector/ComplexVector.h"
@@ -24,40 +28,162 @@
 
 namespace facebook::velox::exec {
 
+enum class SpillCompression { kNone, kLz4, kZstd };
+
+// Returns the SpillCompression for 'name', one of 'none', 'lz4' or 'zstd'.
+SpillCompression spillCompressionFromString(const std::string& name);
+
+// Format and read options of spill files.
+struct SpillFileOptions {
+  SpillCompression compression{SpillCompression::kNone};
+
+  // Stores a CRC32 of each block and verifies it when reading.
+  bool checksum{false};
+
+  // If set, each file being read reads and decompresses its next buffer on
+  // this executor while the current buffer is being consumed.
+  folly::Executor* FOLLY_NULLABLE readAheadExecutor{nullptr};
+
+  // Bytes of read buffers shared by the files being read at the same time,
+  // e.g. by the inputs of a merge. Each file gets an equal share, so that
+  // reads are large for a merge of few files and memory stays bounded for
+  // a merge of many.
+  uint64_t readBufferBudget{16 << 20};
+
+  // True if the serialized batches are written in blocks with a header
+  // giving their size, codec and checksum. Otherwise the batches are written
+  // as is.
+  bool framed() const {
+    return compression != SpillCompression::kNone || checksum;
+  }
+
+  // Returns the read buffer size of each of 'numFiles' files read at the
+  // same time.
+  uint64_t readBufferSize(int32_t numFiles) const;
+};
+
+// IO counters of the spill files of a SpillState. Shared with the files,
+// which may be read after the SpillState is gone, e.g. the spilled hash
+// join partitions.
+struct SpillStats {
+  // Serialized bytes before compression.
+  std::atomic<uint64_t> uncompressedBytes{0};
+  // Bytes written to spill files.
+  std::atomic<uint64_t> writtenBytes{0};
+  std::atomic<uint64_t> writeTimeUs{0};
+  // Bytes read from spill files.
+  std::atomic<uint64_t> readBytes{0};
+  // Time in reading, checking and decompressing spill files.
+  std::atomic<uint64_t> readTimeUs{0};
+  // Time the readers waited for read-ahead to finish. Low if reading keeps
+  // ahead of the consumer.
+  std::atomic<uint64_t> readWaitUs{0};
+  // Number of reads from spill files.
+  std::atomic<uint64_t> numReads{0};
+};
+
 // Input stream backed by spill file.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
-      : input_(std::move(input)),
-        buffer_(std::move(buffer)),
-        size_(input_->size()) {
-    next(true);
-  }
+  // Reads from 'input' using buffers of the size of 'buffer'. 'options'
+  // must be the options the file was written with. With a read-ahead
+  // executor, a second buffer is allocated from the pool of 'buffer'. Adds
+  // to 'stats' if non-null.
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      const SpillFileOptions& options = {},
+      SpillStats* FOLLY_NULLABLE stats = nullptr);
+
+  ~SpillInput() override;
 
   void next(bool throwIfPastEnd) override;
 
   // True if all of the file has been read into vectors.
   bool atEnd() const {
-    return offset_ >= size_ && ranges()[0].position >= ranges()[0].size;
+    // 'offset_' may be changing while a read-ahead is pending.
+    return !readAhead_ && !hasMoreToLoad() && ByteStream::atEnd();
   }
 
  private:
+  // A buffer read from the file and its content.
+  struct Chunk {
+    BufferPtr buffer;
+    // Decompressed content of the compressed blocks in 'buffer'.
+    std::vector<std::unique_ptr<folly::IOBuf>> blocks;
+    // The content to consume. This is the read bytes of an unframed file or
+    // one range per block of a framed file.
+    std::vector<ByteRange> ranges;
+    // The bytes of 'buffer' in [tailBegin, tailEnd) were read but are not a
+    // whole block. They are moved to the start of the next chunk.
+    uint64_t tailBegin{0};
+    uint64_t tailEnd{0};
+    // Set if the read on the read-ahead executor failed.
+    std::exception_ptr error;
+  };
+
+  // True if there is content after 'current_' in the file or in the tail of
+  // 'current_'.
+  bool hasMoreToLoad() const {
+    return offset_ < size_ || current_->tailBegin < current_->tailEnd;
+  }
+
+  // Reads the next buffer of the file into 'chunk'. 'previous' is the chunk
+  // before it, which is 'chunk' itself if there is no read-ahead.
+  void load(Chunk& chunk, const Chunk& previous);
+
+  // Fills the buffer of 'chunk' from a framed file and loads the whole blocks
+  // in it: verifies their checksums and decompresses them. A block larger
+  // than the buffer is read into a larger one.
+  void loadBlocks(Chunk& chunk, const Chunk& previous);
+
+  // Adds the block at 'offset' in the buffer of 'chunk' to its ranges.
+  // 'fileOffset' is the offset of the block in the file.
+  void loadBlock(Chunk& chunk, uint64_t offset, uint64_t fileOffset);
+
+  // Reads 'length' bytes at 'offset_' into 'buffer' and advances 'offset_'.
+  // Returns 'length'.
+  uint64_t read(uint64_t length, char* FOLLY_NONNULL buffer);
+
+  // Starts reading the chunk after 'current_' on the read-ahead executor.
+  void startReadAhead();
+
   std::unique_ptr<ReadFile> input_;
-  BufferPtr buffer_;
   const uint64_t size_;
-  // Offset of first byte not in 'buffer_'
+  const SpillFileOptions options_;
+  SpillStats* FOLLY_NULLABLE const stats_;
+  // The chunk being consumed.
+  std::unique_ptr<Chunk> current_;
+  // The previously consumed chunk whose buffer is reused for the next
+  // read-ahead.
+  std::unique_ptr<Chunk> spare_;
+  // The next chunk, being read on the read-ahead executor.
+  std::shared_ptr<AsyncSource<Chunk>> readAhead_;
+  // Offset of first byte not in a loaded chunk. Accessed by the read-ahead
+  // while 'readAhead_' is set.
   uint64_t offset_ = 0;
 };
 
 // A source of spilled RowVectors coming either from a file or memory.
 class SpillStream : public MergeStream {
  public:
-  SpillStream(RowTypePtr type, int32_t numSortingKeys, memory::MemoryPool& pool)
+  // 'sortCompareFlags' gives the collation of each of the leading
+  // 'numSortingKeys' columns. If empty, all keys are ascending with nulls
+  // first.
+  SpillStream(
+      RowTypePtr type,
+      int32_t numSortingKeys,
+      memory::MemoryPool& pool,
+      const std::vector<CompareFlags>& sortCompareFlags = {})
       : type_(std::move(type)),
         numSortingKeys_(numSortingKeys),
+        sortCompareFlags_(sortCompareFlags),
         pool_(pool),
-        ordinal_(++ordinalCounter_) {}
+        ordinal_(++ordinalCounter_) {
+    VELOX_CHECK(
+        sortCompareFlags_.empty() ||
+        sortCompareFlags_.size() == numSortingKeys_);
+  }
 
   virtual ~SpillStream() = default;
 
@@ -75,8 +201,14 @@ class SpillStream : public MergeStream {
     auto& otherChildren = otherStream.current().children();
     int32_t key = 0;
     do {
-      auto result = children[key]->compare(
-          otherChildren[key].get(), index_, otherStream.index_);
+      auto result = children[key]
+                        ->compare(
+                            otherChildren[key].get(),
+                            index_,
+                            otherStream.index_,
+                            sortCompareFlags_.empty() ? CompareFlags()
+                                                      : sortCompareFlags_[key])
+                        .value();
       if (result) {
         return result;
       }
@@ -147,6 +279,9 @@ class SpillStream : public MergeStream {
   // 0 if not sorted.
   const int32_t numSortingKeys_;
 
+  // Collation of the sorting keys. Empty means default CompareFlags for all.
+  const std::vector<CompareFlags> sortCompareFlags_;
+
   memory::MemoryPool& pool_;
 
   // Current batch of rows.
@@ -180,9 +315,14 @@ class SpillFile : public SpillStream {
       RowTypePtr type,
       int32_t numSortingKeys,
       const std::string& path,
-      memory::MemoryPool& pool)
-      : SpillStream(std::move(type), numSortingKeys, pool),
-        path_(fmt::format("{}-{}", path, ordinalCounter_++)) {}
+      memory::MemoryPool& pool,
+      const std::vector<CompareFlags>& sortCompareFlags = {},
+      const SpillFileOptions& fileOptions = {},
+      std::shared_ptr<SpillStats> stats = nullptr)
+      : SpillStream(std::move(type), numSortingKeys, pool, sortCompareFlags),
+        path_(fmt::format("{}-{}", path, ordinalCounter_++)),
+        fileOptions_(fileOptions),
+        stats_(std::move(stats)) {}
 
   ~SpillFile() override;
 
@@ -206,7 +346,14 @@ class SpillFile : public SpillStream {
 
   // Prepares 'this' for reading. Positions the read at the first row of
   // content. The caller must call output() and finishWrite() before this.
-  void startRead();
+  // 'numFiles' is the number of files read at the same time, e.g. the
+  // files being merged, among which the read buffer budget is divided.
+  void startRead(int32_t numFiles = 1);
+
+  // Returns the size of each read buffer. Set by startRead().
+  uint64_t readBufferSize() const {
+    return readBufferSize_;
+  }
 
   // Returns the file size in bytes. During the writing phase this is
   // the current size of the file, during reading this is the final
@@ -218,19 +365,28 @@ class SpillFile : public SpillStream {
     return fileSize_;
   }
 
-  // Sets 'result' to refer to the next row of content of 'this'.
-  void read(RowVector& result);
+  // Sets 'batch' to the next batch of content of 'this' and returns true, or
+  // returns false if all content has been read. Used for reading the file
+  // sequentially without merging, e.g. for a spilled hash join
+  // partition. startRead() must be called first.
+  bool readBatch(RowVectorPtr& batch);
 
  private:
   void nextBatch() override;
 
   const std::string path_;
+  const SpillFileOptions fileOptions_;
+  const std::shared_ptr<SpillStats> stats_;
   // Byte size of the backing file. Set when finishing writing.
   uint64_t fileSize_ = 0;
+  uint64_t readBufferSize_ = 0;
   std::unique_ptr<WriteFile> output_;
   std::unique_ptr<SpillInput> input_;
 };
 
+// The spill files of one partition of spilled data.
+using SpillFiles = std::vector<std::unique_ptr<SpillFile>>;
+
 // Sequence of files for one partition of the spilled data. If data is
 // sorted, each file is sorted. The globally sorted order is produced
 // by merging the constituent files.
@@ -241,7 +397,10 @@ class SpillFileList {
   // data is sorted. 'path' is a file path prefix. ' 'targetFileSize' is the
   // target byte size of a single file in the file set. 'pool' and
   // 'mappedMemory' are used for buffering and constructing the result data read
-  // from 'this'.
+  // from 'this'. 'sortCompareFlags' gives the collation of the sorting keys,
+  // empty for ascending with nulls first. 'fileOptions' gives the compression
+  // and checksumming of the files. The IO of the files is counted in 'stats'
+  // if given.
   //
   // When writing sorted spill runs, the caller is responsible for buffering and
   // sorting the data. write is called multiple times, followed by flush().
@@ -251,11 +410,17 @@ class SpillFileList {
       const std::string& path,
       uint64_t targetFileSize,
       memory::MemoryPool& pool,
-      memory::MappedMemory& mappedMemory)
+      memory::MappedMemory& mappedMemory,
+      const std::vector<CompareFlags>& sortCompareFlags = {},
+      const SpillFileOptions& fileOptions = {},
+      std::shared_ptr<SpillStats> stats = nullptr)
       : type_(type),
         numSortingKeys_(numSortingKeys),
+        sortCompareFlags_(sortCompareFlags),
         path_(path),
         targetFileSize_(targetFileSize),
+        fileOptions_(fileOptions),
+        stats_(stats ? std::move(stats) : std::make_shared<SpillStats>()),
         pool_(pool),
         mappedMemory_(mappedMemory) {}
 
@@ -272,25 +437,35 @@ class SpillFileList {
   void finishFile();
 
   std::vector<std::unique_ptr<SpillFile>> files() {
-    VELOX_CHECK(!files_.empty());
+    // Writes the pending batches, which may be all the data.
     finishFile();
+    VELOX_CHECK(!files_.empty());
     return std::move(files_);
   }
 
   int64_t spilledBytes() const;
 
+  const SpillStats& stats() const {
+    return *stats_;
+  }
+
  private:
   // Returns the current file to write to and creates one if needed.
   WriteFile& currentOutput();
-  // Writes data from 'batch_' to the current output file.
+  // Writes the serialized batches in 'pending_' to the current output file.
   void flush();
   const RowTypePtr type_;
   const int32_t numSortingKeys_;
+  const std::vector<CompareFlags> sortCompareFlags_;
   const std::string path_;
   const uint64_t targetFileSize_;
+  const SpillFileOptions fileOptions_;
+  const std::shared_ptr<SpillStats> stats_;
   memory::MemoryPool& pool_;
   memory::MappedMemory& mappedMemory_;
-  std::unique_ptr<VectorStreamGroup> batch_;
+  // Serialized batches not yet written. These are written together, as one
+  // block of a framed file.
+  std::unique_ptr<IOBufOutputStream> pending_;
   std::vector<std::unique_ptr<SpillFile>> files_;
 };
 
@@ -305,18 +480,26 @@ class SpillState {
   // on which the data is sorted, 0 if only hash partitioning is used.
   // 'targetFileSize' is the target size of a single
   // file.  'pool' and 'mappedMemory' own
-  // the memory for state and results.
+  // the memory for state and results. 'sortCompareFlags' gives the
+  // ascending/descending and nulls first/last collation of each sorting key.
+  // If empty, all keys are ascending with nulls first. 'fileOptions' gives
+  // the compression and checksumming of the spill files.
   SpillState(
       const std::string& path,
       int32_t maxPartitions,
       int32_t numSortingKeys,
       uint64_t targetFileSize,
       memory::MemoryPool& pool,
-      memory::MappedMemory& mappedMemory)
+      memory::MappedMemory& mappedMemory,
+      const std::vector<CompareFlags>& sortCompareFlags = {},
+      const SpillFileOptions& fileOptions = {})
       : path_(path),
         maxPartitions_(maxPartitions),
         numSortingKeys_(numSortingKeys),
+        sortCompareFlags_(sortCompareFlags),
         targetFileSize_(targetFileSize),
+        fileOptions_(fileOptions),
+        stats_(std::make_shared<SpillStats>()),
         files_(maxPartitions_),
         pool_(pool),
         mappedMemory_(mappedMemory) {}
@@ -337,6 +520,10 @@ class SpillState {
     return targetFileSize_;
   }
 
+  int32_t numSortingKeys() const {
+    return numSortingKeys_;
+  }
+
   memory::MemoryPool& pool() const {
     return pool_;
   }
@@ -365,16 +552,34 @@ class SpillState {
     return partition < files_.size() && files_[partition];
   }
 
+  // Returns the spill files of 'partition' and transfers their ownership to
+  // the caller. The files are finished for writing but not yet opened for
+  // reading. Returns an empty list if 'partition' has not spilled.
+  std::vector<std::unique_ptr<SpillFile>> files(int32_t partition);
+
   int64_t spilledBytes() const;
 
+  const std::vector<CompareFlags>& sortCompareFlags() const {
+    return sortCompareFlags_;
+  }
+
+  // IO counters of the spill files of 'this', including the reads of files
+  // taken by files().
+  const SpillStats& stats() const {
+    return *stats_;
+  }
+
  private:
   const RowTypePtr type_;
   const std::string path_;
   const int32_t maxPartitions_;
   const int32_t numSortingKeys_;
+  const std::vector<CompareFlags> sortCompareFlags_;
   // Number of currently spilling partitions.
   int32_t numPartitions_ = 0;
   const uint64_t targetFileSize_;
+  const SpillFileOptions fileOptions_;
+  const std::shared_ptr<SpillStats> stats_;
   // A file list for each spilled partition. Only partitions that have
   // started spilling have an entry here.
   std::vector<std::unique_ptr<SpillFileList>> files_;
@@ -81,8 +81,9 @@ class RowContainerSpillStream : public SpillStream {
       int32_t numSortingKeys,
       memory::MemoryPool& pool,
       Spiller::SpillRows&& rows,
-      Spiller& spiller)
-      : SpillStream(std::move(type), numSortingKeys, pool),
+      Spiller& spiller,
+      const std::vector<CompareFlags>& sortCompareFlags)
+      : SpillStream(std::move(type), numSortingKeys, pool, sortCompareFlags),
         rows_(std::move(rows)),
         spiller_(spiller) {
     if (!rows_.empty()) {
@@ -128,17 +129,34 @@ std::unique_ptr<SpillStream> Spiller::spillStreamOverRows(int32_t partition) {
       container_.keyTypes().size(),
       pool_,
       std::move(spillRuns_[partition].rows),
-      *this);
+      *this,
+      state_.sortCompareFlags());
 }
 
 void Spiller::ensureSorted(SpillRun& run) {
+  if (!state_.numSortingKeys()) {
+    // Hash partitioned spill, e.g. for hash join. The rows are not ordered.
+    run.sorted = true;
+    return;
+  }
   if (!run.sorted) {
-    std::sort(
-        run.rows.begin(),
-        run.rows.end(),
-        [&](const char* left, const char* right) {
-          return container_.compareRows(left, right) < 0;
-        });
+    if (container_.hasSortPrefix()) {
+      // The prefix is made with the same collation as the spill.
+      std::sort(
+          run.rows.begin(),
+          run.rows.end(),
+          [&](const char* left, const char* right) {
+            return container_.compareRowsWithSortPrefix(left, right) < 0;
+          });
+    } else {
+      std::sort(
+          run.rows.begin(),
+          run.rows.end(),
+          [&](const char* left, const char* right) {
+            return container_.compareRows(
+                       left, right, state_.sortCompareFlags()) < 0;
+          });
+    }
     run.sorted = true;
   }
 }
@@ -277,6 +295,73 @@ void Spiller::spill(
   }
 }
 
+void Spiller::spill(const std::unordered_set<int32_t>& partitions) {
+  // Number of rows to hash and divide into spill partitions at a time.
+  constexpr int32_t kHashBatchSize = 1024;
+  VELOX_CHECK(!spillFinalized_);
+  VELOX_CHECK(pendingSpillPartitions_.empty());
+  if (partitions.empty() || !container_.numRows()) {
+    return;
+  }
+  for (auto newPartition = spillRuns_.size();
+       newPartition < state_.maxPartitions();
+       ++newPartition) {
+    spillRuns_.emplace_back(spillMappedMemory());
+  }
+  clearSpillRuns();
+
+  RowContainerIterator iterator;
+  std::vector<uint64_t> hashes(kHashBatchSize);
+  std::vector<char*> rows(kHashBatchSize);
+  for (;;) {
+    auto numRows = container_.listRows(
+        &iterator, rows.size(), RowContainer::kUnlimited, rows.data());
+    if (!numRows) {
+      break;
+    }
+    auto rowSet = folly::Range<char**>(rows.data(), numRows);
+    for (auto i = 0; i < container_.keyTypes().size(); ++i) {
+      container_.hash(i, rowSet, i > 0, hashes.data());
+    }
+    for (auto i = 0; i < numRows; ++i) {
+      auto partition = bits_.partition(hashes[i], spillRuns_.size());
+      if (partitions.find(partition) == partitions.end()) {
+        continue;
+      }
+      spillRuns_[partition].rows.push_back(rows[i]);
+      spillRuns_[partition].numBytes += container_.rowSize(rows[i]);
+    }
+  }
+  for (auto partition : partitions) {
+    if (!spillRuns_[partition].rows.empty()) {
+      pendingSpillPartitions_.insert(partition);
+    }
+  }
+  while (!pendingSpillPartitions_.empty()) {
+    advanceSpill(std::numeric_limits<uint64_t>::max());
+  }
+}
+
+void Spiller::spill(int32_t partition, const RowVectorPtr& spillVector) {
+  VELOX_CHECK(!spillFinalized_);
+  VELOX_CHECK_LT(partition, state_.maxPartitions());
+  if (!spillVector->size()) {
+    return;
+  }
+  state_.appendToPartition(partition, spillVector);
+  spilledRows_ += spillVector->size();
+}
+
+std::unordered_set<int32_t> Spiller::spilledPartitions() const {
+  std::unordered_set<int32_t> partitions;
+  for (auto partition = 0; partition < state_.maxPartitions(); ++partition) {
+    if (isSpilled(partition)) {
+      partitions.insert(partition);
+    }
+  }
+  return partitions;
+}
+
 Spiller::SpillRows Spiller::finishSpill() {
   VELOX_CHECK(!spillFinalized_);
   spillFinalized_ = true;
@@ -322,10 +407,16 @@ bool Spiller::fillSpillRuns(
         &iterator, rows.size(), RowContainer::kUnlimited, rows.data());
     numConsidered += numRows;
 
-    // Calculate hashes for this batch of spill candidates.
+    // Calculate hashes for this batch of spill candidates. If there is a
+    // single partition, as for order by, all rows go to partition 0 and the
+    // hash is not needed.
     auto rowSet = folly::Range<char**>(rows.data(), numRows);
-    for (auto i = 0; i < container_.keyTypes().size(); ++i) {
-      container_.hash(i, rowSet, i > 0, hashes.data());
+    if (bits_.numPartitions() > 1) {
+      for (auto i = 0; i < container_.keyTypes().size(); ++i) {
+        container_.hash(i, rowSet, i > 0, hashes.data());
+      }
+    } else {
+      std::fill(hashes.begin(), hashes.begin() + numRows, 0);
     }
 
     // Put each in its run.
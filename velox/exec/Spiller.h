@@ -35,6 +35,14 @@ class HashBitRange {
     return 1 << (end_ - begin_);
   }
 
+  uint8_t begin() const {
+    return begin_;
+  }
+
+  uint8_t end() const {
+    return end_;
+  }
+
  private:
   // Low bit number of hash number bit range.
   const uint8_t begin_;
@@ -44,7 +52,10 @@ class HashBitRange {
   const uint64_t fieldMask_;
 };
 
-// Manages spilling data from a RowContainer.
+// Manages spilling data from a RowContainer. The keys of the RowContainer are
+// the sorting keys of the spill runs. If 'sortCompareFlags' is given, it
+// specifies the collation of each key, e.g. for an order by. Otherwise keys are
+// sorted ascending with nulls first, which suffices for merging groups.
 class Spiller {
  public:
   using SpillRows = std::vector<char*, memory::StlMappedMemoryAllocator<char*>>;
@@ -57,7 +68,9 @@ class Spiller {
       const std::string& path,
       int64_t targetFileSize,
       memory::MemoryPool& pool,
-      folly::Executor* executor)
+      folly::Executor* executor,
+      const std::vector<CompareFlags>& sortCompareFlags = {},
+      const SpillFileOptions& fileOptions = {})
       : container_(container),
         eraser_(eraser),
         rowType_(std::move(rowType)),
@@ -68,7 +81,9 @@ class Spiller {
             numSortingKeys,
             targetFileSize,
             pool,
-            spillMappedMemory()),
+            spillMappedMemory(),
+            sortCompareFlags,
+            fileOptions),
         pool_(pool),
         executor_(executor) {}
 
@@ -88,10 +103,30 @@ class Spiller {
       uint64_t targetBytes,
       RowContainerIterator& iterator);
 
+  // Spills all rows of 'partitions' regardless of the spill targets. This is
+  // used by hash join where a partition that has spilled in one build Driver
+  // must be spilled by all of them.
+  void spill(const std::unordered_set<int32_t>& partitions);
+
+  // Appends 'spillVector' to the spill files of 'partition'. All rows must
+  // hash to 'partition'. Used for adding input rows of a partition that has
+  // already spilled without first storing them in 'container_'.
+  void spill(int32_t partition, const RowVectorPtr& spillVector);
+
   bool isSpilled(int32_t partition) const {
     return state_.hasFiles(partition);
   }
 
+  // Returns the numbers of the partitions that have started spilling.
+  std::unordered_set<int32_t> spilledPartitions() const;
+
+  // Returns the spill files of 'partition' and transfers their ownership to
+  // the caller. This is for unsorted spilling where the files are read
+  // sequentially instead of merged.
+  std::vector<std::unique_ptr<SpillFile>> files(int32_t partition) {
+    return state_.files(partition);
+  }
+
   // Finishes spilling and returns the rows that are in partitions that have not
   // started spilling.
   SpillRows finishSpill();
@@ -114,6 +149,10 @@ class Spiller {
         state_.spilledBytes(), spilledRows_);
   }
 
+  const SpillStats& spillStats() const {
+    return state_.stats();
+  }
+
   // Extracts the keys, dependents or accumulators for 'rows' into '*result'.
   // Creates '*results' in spillPool() if nullptr. Used from Spiller and
   // RowContainerSpillStream.
@@ -196,7 +235,8 @@ class Spiller {
   // Clears runs that have not started spilling.
   void clearNonSpillingRuns();
 
-  // Sorts 'run' if not already sorted.
+  // Sorts 'run' if not already sorted. Does nothing if there are no sorting
+  // keys.
   void ensureSorted(SpillRun& run);
 
   // Function for writing a spill partition on an executor. Writes to
@@ -15,6 +15,8 @@
  */
 #include "velox/exec/TopN.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Task.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
@@ -29,35 +31,57 @@ TopN::TopN(
           topNNode->id(),
           "TopN"),
       count_(topNNode->count()),
-      data_(std::make_unique<RowContainer>(
-          outputType_->children(),
-          operatorCtx_->mappedMemory())),
-      comparator_(
-          outputType_,
-          topNNode->sortingKeys(),
-          topNNode->sortingOrders(),
-          data_.get()),
+      data_(makeRowContainer(*topNNode)),
+      comparator_(keyChannels_, keyCompareFlags_, data_.get()),
       topRows_(comparator_),
-      decodedVectors_(outputType_->children().size()) {}
-
-TopN::Comparator::Comparator(
-    const std::shared_ptr<const RowType>& type,
-    const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
-        sortingKeys,
-    const std::vector<core::SortOrder>& sortingOrders,
-    RowContainer* rowContainer)
-    : rowContainer_(rowContainer) {
-  auto numKeys = sortingKeys.size();
-  for (int i = 0; i < numKeys; ++i) {
-    auto channel = exprToChannel(sortingKeys[i].get(), type);
+      decodedVectors_(outputType_->children().size()),
+      spillPath_(makeOperatorSpillPath(*operatorCtx_)),
+      spillExecutor_(operatorCtx_->task()->queryCtx()->spillExecutor()),
+      testSpillPct_(
+          operatorCtx_->task()->queryCtx()->config().testingSpillPct()) {}
+
+std::unique_ptr<RowContainer> TopN::makeRowContainer(
+    const core::TopNNode& topNNode) {
+  const auto& type = outputType_;
+  columnMap_.resize(type->size(), kConstantChannel);
+  std::vector<TypePtr> keyTypes;
+  std::vector<std::string> names;
+  for (auto i = 0; i < topNNode.sortingKeys().size(); ++i) {
+    auto channel = exprToChannel(topNNode.sortingKeys()[i].get(), type);
     VELOX_CHECK(
         channel != kConstantChannel,
         "TopN doesn't allow constant comparison keys");
-    keyInfo_.push_back(std::make_pair(channel, sortingOrders[i]));
+    if (columnMap_[channel] != kConstantChannel) {
+      continue;
+    }
+    columnMap_[channel] = keyTypes.size();
+    keyTypes.push_back(type->childAt(channel));
+    names.push_back(type->nameOf(channel));
+    keyChannels_.push_back(channel);
+    const auto& sortOrder = topNNode.sortingOrders()[i];
+    keyCompareFlags_.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false});
   }
+
+  std::vector<TypePtr> dependentTypes;
+  for (auto i = 0; i < type->size(); ++i) {
+    if (columnMap_[i] == kConstantChannel) {
+      columnMap_[i] = keyTypes.size() + dependentTypes.size();
+      dependentTypes.push_back(type->childAt(i));
+      names.push_back(type->nameOf(i));
+    }
+  }
+
+  auto types = keyTypes;
+  types.insert(types.end(), dependentTypes.begin(), dependentTypes.end());
+  spillType_ = ROW(std::move(names), std::move(types));
+  return std::make_unique<RowContainer>(
+      keyTypes, dependentTypes, keyCompareFlags_, operatorCtx_->mappedMemory());
 }
 
 void TopN::addInput(RowVectorPtr input) {
+  ensureInputFits(input);
+
   SelectivityVector allRows(input->size());
 
   // TODO Decode keys first, then decode the rest only for passing positions
@@ -68,6 +92,9 @@ void TopN::addInput(RowVectorPtr input) {
   for (int row = 0; row < input->size(); ++row) {
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
+      if (!thresholdKeys_.empty() && isAfterThreshold(row)) {
+        continue;
+      }
       newRow = data_->newRow();
     } else {
       char* topRow = topRows_.top();
@@ -81,17 +108,141 @@ void TopN::addInput(RowVectorPtr input) {
     }
 
     for (int col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedVectors_[col], row, newRow, col);
+      data_->store(decodedVectors_[col], row, newRow, columnMap_[col]);
     }
+    data_->storeSortPrefix(newRow);
 
     topRows_.push(newRow);
   }
 }
 
+bool TopN::isAfterThreshold(vector_size_t index) const {
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    const auto& decoded = decodedVectors_[keyChannels_[i]];
+    if (auto result = decoded.base()
+                          ->compare(
+                              thresholdKeys_[i].get(),
+                              decoded.index(index),
+                              0,
+                              keyCompareFlags_[i])
+                          .value()) {
+      return result > 0;
+    }
+  }
+  return false;
+}
+
+void TopN::ensureInputFits(const RowVectorPtr& input) {
+  // Spilling is considered if spillPath is set.
+  if (!spillPath_.has_value()) {
+    return;
+  }
+  auto numRows = data_->numRows();
+  if (!numRows) {
+    // Container is empty. Nothing to spill.
+    return;
+  }
+
+  // Test-only spill path.
+  if (testSpillPct_ &&
+      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <= testSpillPct_) {
+    spill();
+    return;
+  }
+
+  // Once there are 'count_' rows, new rows replace old ones and only need
+  // variable length space.
+  int64_t numNewRows = std::min<int64_t>(
+      input->size(), count_ - static_cast<int64_t>(topRows_.size()));
+  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
+  auto outOfLineBytes =
+      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
+  int64_t flatBytes = input->estimateFlatSize();
+  if (freeRows >= numNewRows &&
+      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatBytes)) {
+    // Enough free rows for the new rows and enough variable length
+    // free space for the flat size of the whole vector. If
+    // outOfLineBytes is 0 there is no need for variable length space.
+    return;
+  }
+
+  // If there is variable length data we take the flat size of the
+  // input as a cap on the new variable length data needed.
+  auto increment =
+      data_->sizeIncrement(numNewRows, outOfLineBytes ? flatBytes : 0);
+  auto tracker = operatorCtx_->mappedMemory()->tracker();
+  if (!tracker) {
+    return;
+  }
+  // There must be at least 2x the increment in reservation.
+  if (tracker->getAvailableReservation() > 2 * increment) {
+    return;
+  }
+
+  // Check if can increase reservation. The increment is the larger of
+  // twice the maximum increment from this input and 1/4 of the current
+  // reservation.
+  auto targetIncrement =
+      std::max<int64_t>(increment * 2, tracker->getCurrentUserBytes() / 4);
+  if (tracker->maybeReserve(targetIncrement)) {
+    return;
+  }
+  spill();
+}
+
+void TopN::spill() {
+  if (!spiller_) {
+    auto tracker = operatorCtx_->mappedMemory()->tracker();
+    // Each spill writes the whole container as one sorted run, so the
+    // target file size only limits the size of a single file of the run.
+    auto fileSize = tracker ? tracker->getCurrentUserBytes() / 4
+                            : std::numeric_limits<int64_t>::max();
+    spiller_ = std::make_unique<Spiller>(
+        *data_,
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        spillType_,
+        // TopN does not partition the data. All rows go to one partition
+        // where each spill makes a new sorted run.
+        HashBitRange(29, 29),
+        data_->keyTypes().size(),
+        spillPath_.value(),
+        fileSize,
+        Spiller::spillPool(),
+        spillExecutor_,
+        keyCompareFlags_,
+        makeSpillFileOptions(*operatorCtx_));
+  }
+  if (topRows_.size() == count_) {
+    // The runs spilled after this need only the rows before the last of the
+    // current top 'count_' rows. Rows added since the previous full run
+    // come before its last row, so the threshold only gets lower.
+    const auto& keyTypes = data_->keyTypes();
+    thresholdKeys_.resize(keyTypes.size());
+    char* lastRow = topRows_.top();
+    for (auto i = 0; i < keyTypes.size(); ++i) {
+      thresholdKeys_[i] =
+          BaseVector::create(keyTypes[i], 1, operatorCtx_->pool());
+      data_->extractColumn(&lastRow, 1, i, thresholdKeys_[i]);
+    }
+  }
+  // A target of 0 rows and bytes spills the whole container.
+  spiller_->spill(0, 0, spillIterator_);
+  VELOX_CHECK_EQ(0, data_->numRows());
+  topRows_ = decltype(topRows_)(comparator_);
+
+  auto spilled = spiller_->spilledBytesAndRows();
+  stats_.spilledBytes = spilled.first;
+  stats_.spilledRows = spilled.second;
+  setSpillRuntimeStats(spiller_->spillStats(), stats_);
+}
+
 RowVectorPtr TopN::getOutput() {
   if (finished_ || !noMoreInput_) {
     return nullptr;
   }
+  if (merge_) {
+    return getOutputWithSpill();
+  }
 
   uint32_t numRowsToReturn =
       std::min(kMaxNumRowsToReturn, rows_.size() - numRowsReturned_);
@@ -104,7 +255,7 @@ RowVectorPtr TopN::getOutput() {
     data_->extractColumn(
         rows_.data() + numRowsReturned_,
         numRowsToReturn,
-        i,
+        columnMap_[i],
         result->childAt(i));
   }
   numRowsReturned_ += numRowsToReturn;
@@ -112,8 +263,54 @@ RowVectorPtr TopN::getOutput() {
   return result;
 }
 
+RowVectorPtr TopN::getOutputWithSpill() {
+  const vector_size_t maxRows =
+      std::min<size_t>(kMaxNumRowsToReturn, count_ - numRowsReturned_);
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, maxRows, operatorCtx_->pool()));
+
+  vector_size_t numRows = 0;
+  for (; numRows < maxRows; ++numRows) {
+    auto stream = merge_->next();
+    if (!stream) {
+      finished_ = true;
+      break;
+    }
+    auto& source = stream->current();
+    auto sourceIndex = stream->currentIndex();
+    for (auto i = 0; i < outputType_->size(); ++i) {
+      result->childAt(i)->copy(
+          source.childAt(columnMap_[i]).get(), numRows, sourceIndex, 1);
+    }
+    stream->pop();
+  }
+  setSpillRuntimeStats(spiller_->spillStats(), stats_);
+  numRowsReturned_ += numRows;
+  if (numRowsReturned_ == count_) {
+    finished_ = true;
+  }
+
+  if (finished_) {
+    merge_ = nullptr;
+    data_->clear();
+  }
+  if (numRows == 0) {
+    return nullptr;
+  }
+  result->resize(numRows);
+  return result;
+}
+
 void TopN::noMoreInput() {
   Operator::noMoreInput();
+  if (spiller_) {
+    // The rows left in 'data_' are sorted and merged with the spilled runs.
+    auto nonSpilledRows = spiller_->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    topRows_ = decltype(topRows_)(comparator_);
+    merge_ = spiller_->startMerge(0);
+    return;
+  }
   if (topRows_.empty()) {
     finished_ = true;
     return;
@@ -17,9 +17,17 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/Spiller.h"
 
 namespace facebook::velox::exec {
 
+// Keeps the first 'count' rows in the order of the sorting keys in a priority
+// queue over rows of a RowContainer.
+//
+// If spilling is enabled and the RowContainer cannot grow within the memory
+// limit, the rows in the queue are written to disk as a sorted run and the
+// queue starts over. The output is then the first 'count' rows of the merge of
+// the sorted runs and the rows in the queue.
 class TopN : public Operator {
  public:
   TopN(
@@ -45,30 +53,43 @@ class TopN : public Operator {
 
  private:
   static constexpr size_t kMaxNumRowsToReturn = 1024;
+
+  // Checks if 'input' will fit in the existing memory and increases the
+  // reservation if not. If the reservation cannot be increased, spills the
+  // rows in 'topRows_' as a sorted run.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  // Sorts and writes all rows of 'data_' to disk. 'data_' and 'topRows_' are
+  // empty after this.
+  void spill();
+
+  // Returns true if row 'index' of 'decodedVectors_' sorts after
+  // 'thresholdKeys_'. Such a row cannot be in the output.
+  bool isAfterThreshold(vector_size_t index) const;
+
+  // Produces the next batch of output by merging the spilled runs and the rows
+  // left in 'data_'. Sets 'finished_' after 'count_' rows or at end.
+  RowVectorPtr getOutputWithSpill();
+
   class Comparator {
    public:
+    // 'keyChannels' and 'keyCompareFlags' give the input channel and
+    // collation of each sorting key. The keys are the leading columns of
+    // 'rowContainer', which has a SortPrefix with this collation.
     Comparator(
-        const std::shared_ptr<const RowType>& outputType,
-        const std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>>&
-            sortingKeys,
-        const std::vector<core::SortOrder>& sortingOrders,
-        RowContainer* rowContainer);
+        const std::vector<column_index_t>& keyChannels,
+        const std::vector<CompareFlags>& keyCompareFlags,
+        RowContainer* rowContainer)
+        : keyChannels_(keyChannels),
+          keyCompareFlags_(keyCompareFlags),
+          rowContainer_(rowContainer) {}
 
     // Returns true if lhs < rhs, false otherwise.
     bool operator()(const char* lhs, const char* rhs) {
       if (lhs == rhs) {
         return false;
       }
-      for (auto& key : keyInfo_) {
-        if (auto result = rowContainer_->compare(
-                lhs,
-                rhs,
-                key.first,
-                {key.second.isNullsFirst(), key.second.isAscending(), false})) {
-          return result < 0;
-        }
-      }
-      return false;
+      return rowContainer_->compareRowsWithSortPrefix(lhs, rhs) < 0;
     }
 
     // Returns true if lhs < decodeVectors[index], false otherwise.
@@ -76,13 +97,13 @@ class TopN : public Operator {
         const char* lhs,
         const std::vector<DecodedVector>& decodedVectors,
         vector_size_t index) {
-      for (auto& key : keyInfo_) {
+      for (auto i = 0; i < keyChannels_.size(); ++i) {
         if (auto result = rowContainer_->compare(
                 lhs,
-                rowContainer_->columnAt(key.first),
-                decodedVectors[key.first],
+                rowContainer_->columnAt(i),
+                decodedVectors[keyChannels_[i]],
                 index,
-                {key.second.isNullsFirst(), key.second.isAscending(), false})) {
+                keyCompareFlags_[i])) {
           return result < 0;
         }
       }
@@ -90,15 +111,34 @@ class TopN : public Operator {
     }
 
    private:
-    std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
+    std::vector<column_index_t> keyChannels_;
+    std::vector<CompareFlags> keyCompareFlags_;
     RowContainer* rowContainer_;
   };
 
+  // Sets 'keyChannels_', 'keyCompareFlags_', 'columnMap_' and 'spillType_'
+  // and returns a RowContainer with the sorting keys as leading columns.
+  std::unique_ptr<RowContainer> makeRowContainer(
+      const core::TopNNode& topNNode);
+
   const int32_t count_;
 
   bool finished_ = false;
   uint32_t numRowsReturned_ = 0;
 
+  // Input channel and collation of each sorting key. A channel that appears
+  // more than once in the sorting keys is a key only once. Set by
+  // makeRowContainer(), so declared before 'data_'.
+  std::vector<column_index_t> keyChannels_;
+  std::vector<CompareFlags> keyCompareFlags_;
+
+  // Maps an input column to its column in 'data_'.
+  std::vector<column_index_t> columnMap_;
+
+  // The columns of 'data_' in RowContainer order, i.e. keys first. This is the
+  // type of the spilled runs.
+  RowTypePtr spillType_;
+
   // As the inputs are added to TopN operator, we use topRows_ (a priority
   // queue) to keep track of the pointers to rows stored in the
   // RowContainer (data_). We only update the RowContainer if a row is a
@@ -114,5 +154,32 @@ class TopN : public Operator {
   std::vector<char*> rows_;
 
   std::vector<DecodedVector> decodedVectors_;
+
+  // Filesystem path for spill files, empty if spilling is disabled.
+  const std::optional<std::string> spillPath_;
+
+  // Executor for spilling. If nullptr spilling writes on the Driver's thread.
+  folly::Executor* FOLLY_NULLABLE const spillExecutor_;
+
+  // Percentage of input batches to be spilled for testing. 0 means no spilling
+  // for test.
+  const int32_t testSpillPct_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct_'.
+  uint64_t spillTestCounter_{0};
+
+  std::unique_ptr<Spiller> spiller_;
+  RowContainerIterator spillIterator_;
+
+  // The sorting keys of the last of the top 'count_' rows when a full set of
+  // these was last spilled, one single row vector per key. Empty if no such
+  // run was spilled. The output comes before this row, so later input rows
+  // after it are dropped and the runs spilled later hold only rows that may
+  // be in the output.
+  std::vector<VectorPtr> thresholdKeys_;
+
+  // Merges the spilled runs with the unspilled rows when producing output.
+  std::unique_ptr<TreeOfLosers<SpillStream>> merge_;
 };
 } // namespace facebook::velox::exec
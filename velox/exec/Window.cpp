@@ -0,0 +1,432 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/Window.h"
+#include "velox/exec/OperatorUtils.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+void checkFrameOffset(int64_t offset) {
+  VELOX_USER_CHECK_GE(offset, 0, "Window frame offset must not be negative");
+}
+
+int64_t frameOffsetFromConstant(const variant& value) {
+  VELOX_USER_CHECK(!value.isNull(), "Window frame offset must not be null");
+  switch (value.kind()) {
+    case TypeKind::INTEGER:
+      return value.value<int32_t>();
+    case TypeKind::BIGINT:
+      return value.value<int64_t>();
+    default:
+      VELOX_USER_FAIL(
+          "Window frame offset must be INTEGER or BIGINT, not {}",
+          mapTypeKindToName(value.kind()));
+  }
+}
+} // namespace
+
+Window::Window(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::WindowNode>& windowNode)
+    : Operator(
+          driverCtx,
+          windowNode->outputType(),
+          operatorId,
+          windowNode->id(),
+          "Window"),
+      numInputColumns_(windowNode->sources()[0]->outputType()->size()),
+      data_(std::make_unique<RowContainer>(
+          windowNode->sources()[0]->outputType()->children(),
+          operatorCtx_->mappedMemory())),
+      inputsSorted_(windowNode->inputsSorted()) {
+  const auto& inputType = windowNode->sources()[0]->outputType();
+  for (const auto& key : windowNode->partitionKeys()) {
+    partitionKeyInfo_.push_back(
+        {exprToChannel(key.get(), inputType), CompareFlags()});
+  }
+  for (auto i = 0; i < windowNode->sortingKeys().size(); ++i) {
+    const auto& sortOrder = windowNode->sortingOrders()[i];
+    sortKeyInfo_.push_back(
+        {exprToChannel(windowNode->sortingKeys()[i].get(), inputType),
+         {sortOrder.isNullsFirst(), sortOrder.isAscending(), false}});
+  }
+
+  for (auto i = 0; i < windowNode->windowFunctions().size(); ++i) {
+    const auto& function = windowNode->windowFunctions()[i];
+    const auto& frame = function.frame;
+    VELOX_USER_CHECK(
+        frame.startType != core::WindowNode::BoundType::kUnboundedFollowing,
+        "Window frame cannot start with UNBOUNDED FOLLOWING");
+    VELOX_USER_CHECK(
+        frame.endType != core::WindowNode::BoundType::kUnboundedPreceding,
+        "Window frame cannot end with UNBOUNDED PRECEDING");
+    windowFrames_.push_back(
+        {frame.type,
+         makeFrameBound(
+             frame.type, frame.startType, frame.startValue, inputType),
+         makeFrameBound(frame.type, frame.endType, frame.endValue, inputType)});
+    windowFunctions_.push_back(WindowFunction::create(
+        function.functionCall->name(),
+        makeFunctionArgs(function.functionCall, inputType),
+        outputType_->childAt(numInputColumns_ + i),
+        pool(),
+        &data_->stringAllocator()));
+  }
+  frameStarts_.resize(windowFunctions_.size());
+  frameEnds_.resize(windowFunctions_.size());
+}
+
+Window::FrameBound Window::makeFrameBound(
+    core::WindowNode::WindowType windowType,
+    core::WindowNode::BoundType boundType,
+    const core::TypedExprPtr& value,
+    const RowTypePtr& inputType) {
+  FrameBound bound{boundType, std::nullopt, std::nullopt};
+  if (boundType != core::WindowNode::BoundType::kPreceding &&
+      boundType != core::WindowNode::BoundType::kFollowing) {
+    return bound;
+  }
+  if (windowType == core::WindowNode::WindowType::kRange) {
+    VELOX_UNSUPPORTED(
+        "RANGE window frames support only UNBOUNDED and CURRENT ROW bounds");
+  }
+  VELOX_CHECK_NOT_NULL(value, "Window frame bound requires an offset");
+  if (auto constant =
+          std::dynamic_pointer_cast<const core::ConstantTypedExpr>(value)) {
+    bound.constant = frameOffsetFromConstant(
+        constant->hasValueVector()
+            ? constant->valueVector()->variantAt(0)
+            : constant->value());
+    checkFrameOffset(bound.constant.value());
+  } else {
+    auto kind = value->type()->kind();
+    VELOX_USER_CHECK(
+        kind == TypeKind::INTEGER || kind == TypeKind::BIGINT,
+        "Window frame offset must be INTEGER or BIGINT, not {}",
+        value->type()->toString());
+    bound.channel = exprToChannel(value.get(), inputType);
+    VELOX_USER_CHECK_NE(
+        bound.channel.value(),
+        kConstantChannel,
+        "Window frame offset must be a constant or a column");
+  }
+  return bound;
+}
+
+std::vector<WindowFunctionArg> Window::makeFunctionArgs(
+    const core::CallTypedExprPtr& call,
+    const RowTypePtr& inputType) {
+  std::vector<WindowFunctionArg> args;
+  for (const auto& input : call->inputs()) {
+    if (auto constant =
+            std::dynamic_pointer_cast<const core::ConstantTypedExpr>(input)) {
+      VectorPtr value;
+      if (constant->hasValueVector()) {
+        value = constant->valueVector();
+      } else if (constant->value().isNull()) {
+        value = BaseVector::createNullConstant(input->type(), 1, pool());
+      } else {
+        value = BaseVector::createConstant(constant->value(), 1, pool());
+      }
+      args.push_back({input->type(), value, std::nullopt});
+      continue;
+    }
+    auto channel = exprToChannel(input.get(), inputType);
+    VELOX_USER_CHECK_NE(
+        channel,
+        kConstantChannel,
+        "Window function arguments must be constants or columns: {}",
+        call->toString());
+    args.push_back({input->type(), nullptr, channel});
+  }
+  return args;
+}
+
+void Window::addInput(RowVectorPtr input) {
+  if (inputsSorted_) {
+    eraseProcessedPartitions();
+  }
+
+  SelectivityVector allRows(input->size());
+  auto firstNewRow = sortedRows_.size();
+  for (auto row = 0; row < input->size(); ++row) {
+    sortedRows_.push_back(data_->newRow());
+  }
+  for (auto col = 0; col < input->childrenSize(); ++col) {
+    DecodedVector decoded(*input->childAt(col), allRows);
+    for (auto i = 0; i < input->size(); ++i) {
+      data_->store(decoded, i, sortedRows_[firstNewRow + i], col);
+    }
+  }
+
+  if (inputsSorted_) {
+    findPartitionStarts(firstNewRow);
+  }
+}
+
+bool Window::samePartition(const char* left, const char* right) const {
+  for (const auto& [channel, flags] : partitionKeyInfo_) {
+    if (data_->compare(left, right, channel, flags)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Window::arePeers(const char* left, const char* right) const {
+  for (const auto& [channel, flags] : sortKeyInfo_) {
+    if (data_->compare(left, right, channel, flags)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Window::findPartitionStarts(vector_size_t firstNewRow) {
+  for (auto row = firstNewRow; row < sortedRows_.size(); ++row) {
+    if (row == 0 || !samePartition(sortedRows_[row - 1], sortedRows_[row])) {
+      partitionStartRows_.push_back(row);
+    }
+  }
+}
+
+void Window::eraseProcessedPartitions() {
+  if (numProcessedRows_ == 0) {
+    return;
+  }
+  VELOX_CHECK_EQ(numProcessedRows_, numCompleteRows());
+  data_->eraseRows(
+      folly::Range<char**>(sortedRows_.data(), numProcessedRows_));
+  sortedRows_.erase(
+      sortedRows_.begin(), sortedRows_.begin() + numProcessedRows_);
+  // The last partition has not seen all its rows. It now starts at 0.
+  partitionStartRows_ = {0};
+  currentPartition_ = 0;
+  numProcessedRows_ = 0;
+}
+
+void Window::sortPartitions() {
+  std::sort(
+      sortedRows_.begin(),
+      sortedRows_.end(),
+      [this](const char* left, const char* right) {
+        for (const auto& [channel, flags] : partitionKeyInfo_) {
+          if (auto result = data_->compare(left, right, channel, flags)) {
+            return result < 0;
+          }
+        }
+        for (const auto& [channel, flags] : sortKeyInfo_) {
+          if (auto result = data_->compare(left, right, channel, flags)) {
+            return result < 0;
+          }
+        }
+        return false;
+      });
+  findPartitionStarts(0);
+}
+
+void Window::noMoreInput() {
+  Operator::noMoreInput();
+  if (sortedRows_.empty()) {
+    return;
+  }
+  if (!inputsSorted_) {
+    sortPartitions();
+  }
+  // The last partition is now complete.
+  partitionStartRows_.push_back(sortedRows_.size());
+}
+
+void Window::startPartition() {
+  auto start = partitionStartRows_[currentPartition_];
+  auto end = partitionStartRows_[currentPartition_ + 1];
+  windowPartition_ = std::make_unique<WindowPartition>(
+      data_.get(),
+      folly::Range<char**>(sortedRows_.data() + start, end - start));
+  for (auto& function : windowFunctions_) {
+    function->resetPartition(windowPartition_.get());
+  }
+  partitionOffset_ = 0;
+  peerStart_ = 0;
+  peerEnd_ = 0;
+}
+
+namespace {
+// Makes 'buffer' hold 'numRows' vector_size_t values.
+vector_size_t* prepareBoundBuffer(
+    BufferPtr& buffer,
+    vector_size_t numRows,
+    memory::MemoryPool* pool) {
+  auto size = numRows * sizeof(vector_size_t);
+  if (!buffer || buffer->capacity() < size) {
+    buffer = AlignedBuffer::allocate<vector_size_t>(numRows, pool);
+  }
+  buffer->setSize(size);
+  return buffer->asMutable<vector_size_t>();
+}
+} // namespace
+
+void Window::computeFrameBound(
+    const Frame& frame,
+    const FrameBound& bound,
+    bool isStart,
+    vector_size_t numRows,
+    vector_size_t* rawBounds) {
+  const int64_t partitionSize = windowPartition_->numRows();
+  auto rawPeerStarts = peerGroupStarts_->as<vector_size_t>();
+  auto rawPeerEnds = peerGroupEnds_->as<vector_size_t>();
+  if (bound.channel.has_value()) {
+    const auto& type = data_->columnTypes()[bound.channel.value()];
+    if (!frameOffsets_ || frameOffsets_->type() != type) {
+      frameOffsets_ = BaseVector::create(type, 0, pool());
+    }
+    windowPartition_->extractColumn(
+        bound.channel.value(), partitionOffset_, numRows, frameOffsets_);
+  }
+  for (auto i = 0; i < numRows; ++i) {
+    const int64_t row = partitionOffset_ + i;
+    int64_t offset = 0;
+    if (bound.constant.has_value()) {
+      offset = bound.constant.value();
+    } else if (bound.channel.has_value()) {
+      VELOX_USER_CHECK(
+          !frameOffsets_->isNullAt(i), "Window frame offset must not be null");
+      offset = frameOffsets_->type()->kind() == TypeKind::INTEGER
+          ? frameOffsets_->asFlatVector<int32_t>()->valueAt(i)
+          : frameOffsets_->asFlatVector<int64_t>()->valueAt(i);
+      checkFrameOffset(offset);
+    }
+    int64_t value = 0;
+    switch (bound.type) {
+      case core::WindowNode::BoundType::kUnboundedPreceding:
+        value = 0;
+        break;
+      case core::WindowNode::BoundType::kPreceding:
+        // Offsets may be up to INT64_MAX. Saturates instead of overflowing.
+        if (__builtin_sub_overflow(row, offset, &value)) {
+          value = std::numeric_limits<int64_t>::min();
+        }
+        break;
+      case core::WindowNode::BoundType::kCurrentRow:
+        if (frame.type == core::WindowNode::WindowType::kRows) {
+          value = row;
+        } else {
+          value = isStart ? rawPeerStarts[i] : rawPeerEnds[i];
+        }
+        break;
+      case core::WindowNode::BoundType::kFollowing:
+        if (__builtin_add_overflow(row, offset, &value)) {
+          value = std::numeric_limits<int64_t>::max();
+        }
+        break;
+      case core::WindowNode::BoundType::kUnboundedFollowing:
+        value = partitionSize - 1;
+        break;
+    }
+    rawBounds[i] = std::max<int64_t>(-1, std::min(value, partitionSize));
+  }
+}
+
+void Window::computePeerAndFrameBounds(vector_size_t numRows) {
+  auto rawPeerStarts = prepareBoundBuffer(peerGroupStarts_, numRows, pool());
+  auto rawPeerEnds = prepareBoundBuffer(peerGroupEnds_, numRows, pool());
+  auto partitionRows =
+      sortedRows_.data() + partitionStartRows_[currentPartition_];
+  auto partitionSize = windowPartition_->numRows();
+  for (auto i = 0; i < numRows; ++i) {
+    auto row = partitionOffset_ + i;
+    if (row >= peerEnd_) {
+      peerStart_ = row;
+      peerEnd_ = row + 1;
+      while (peerEnd_ < partitionSize &&
+             arePeers(partitionRows[peerStart_], partitionRows[peerEnd_])) {
+        ++peerEnd_;
+      }
+    }
+    rawPeerStarts[i] = peerStart_;
+    rawPeerEnds[i] = peerEnd_ - 1;
+  }
+
+  for (auto i = 0; i < windowFunctions_.size(); ++i) {
+    const auto& frame = windowFrames_[i];
+    auto rawStarts = prepareBoundBuffer(frameStarts_[i], numRows, pool());
+    auto rawEnds = prepareBoundBuffer(frameEnds_[i], numRows, pool());
+    computeFrameBound(frame, frame.start, true, numRows, rawStarts);
+    computeFrameBound(frame, frame.end, false, numRows, rawEnds);
+    for (auto j = 0; j < numRows; ++j) {
+      // A frame that is outside of the partition is empty.
+      rawStarts[j] = std::max(0, rawStarts[j]);
+      rawEnds[j] = std::min(partitionSize - 1, rawEnds[j]);
+    }
+  }
+}
+
+RowVectorPtr Window::getOutput() {
+  if (!hasPendingOutput()) {
+    return nullptr;
+  }
+
+  const vector_size_t maxRows =
+      data_->estimatedNumRowsPerBatch(kBatchSizeInBytes);
+  const vector_size_t numOutputRows =
+      std::min(maxRows, numCompleteRows() - numProcessedRows_);
+  auto result = std::dynamic_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, numOutputRows, pool()));
+
+  for (auto i = 0; i < numInputColumns_; ++i) {
+    data_->extractColumn(
+        sortedRows_.data() + numProcessedRows_,
+        numOutputRows,
+        i,
+        result->childAt(i));
+  }
+
+  vector_size_t resultOffset = 0;
+  while (resultOffset < numOutputRows) {
+    if (!windowPartition_ || partitionOffset_ == windowPartition_->numRows()) {
+      if (windowPartition_) {
+        ++currentPartition_;
+      }
+      startPartition();
+    }
+    auto numRows = std::min(
+        numOutputRows - resultOffset,
+        windowPartition_->numRows() - partitionOffset_);
+    computePeerAndFrameBounds(numRows);
+    for (auto i = 0; i < windowFunctions_.size(); ++i) {
+      windowFunctions_[i]->apply(
+          peerGroupStarts_,
+          peerGroupEnds_,
+          frameStarts_[i],
+          frameEnds_[i],
+          resultOffset,
+          result->childAt(numInputColumns_ + i));
+    }
+    resultOffset += numRows;
+    partitionOffset_ += numRows;
+    numProcessedRows_ += numRows;
+  }
+
+  if (inputsSorted_ && !hasPendingOutput()) {
+    // All complete partitions are output. Their rows are freed at the
+    // next input, after which the next output starts a new partition.
+    windowPartition_ = nullptr;
+  }
+  return result;
+}
+} // namespace facebook::velox::exec
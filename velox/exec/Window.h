@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/Operator.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/WindowFunction.h"
+
+namespace facebook::velox::exec {
+
+// Window operator implementation: Window stores its input in a
+// RowContainer with one column per input column. Once all input is
+// available, it sorts pointers to the rows on the partition keys
+// followed by the sorting keys and finds the partition boundaries.
+// The output has the input columns followed by one column per window
+// function. The window functions are evaluated one partition at a
+// time over runs of consecutive rows, for which the operator computes
+// the peer groups and the frame of each row.
+//
+// If the input is known to be clustered on the partition keys and
+// sorted on the sorting keys (WindowNode::inputsSorted()), the input
+// is not sorted. Each partition is evaluated as soon as the first row
+// of the next partition arrives and its rows are then freed. Only the
+// current partition is kept in memory.
+//
+// Frames are either ROWS or RANGE. ROWS frames may have constant or
+// per row offsets. RANGE frames support UNBOUNDED PRECEDING, CURRENT
+// ROW and UNBOUNDED FOLLOWING bounds.
+class Window : public Operator {
+ public:
+  Window(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::WindowNode>& windowNode);
+
+  bool needsInput() const override {
+    return !noMoreInput_ && !hasPendingOutput();
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  void noMoreInput() override;
+
+  RowVectorPtr getOutput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return noMoreInput_ && !hasPendingOutput();
+  }
+
+ private:
+  static const int32_t kBatchSizeInBytes{2 * 1024 * 1024};
+
+  // A frame bound of a window function.
+  struct FrameBound {
+    core::WindowNode::BoundType type;
+    // Offset of a PRECEDING or FOLLOWING bound with a constant offset.
+    std::optional<int64_t> constant;
+    // Input column with the offset of a PRECEDING or FOLLOWING bound
+    // with per row offsets.
+    std::optional<column_index_t> channel;
+  };
+
+  struct Frame {
+    core::WindowNode::WindowType type;
+    FrameBound start;
+    FrameBound end;
+  };
+
+  FrameBound makeFrameBound(
+      core::WindowNode::WindowType windowType,
+      core::WindowNode::BoundType boundType,
+      const core::TypedExprPtr& value,
+      const RowTypePtr& inputType);
+
+  std::vector<WindowFunctionArg> makeFunctionArgs(
+      const core::CallTypedExprPtr& call,
+      const RowTypePtr& inputType);
+
+  // Returns the number of rows at the start of 'sortedRows_' that
+  // belong to partitions with all their rows in 'sortedRows_'.
+  vector_size_t numCompleteRows() const {
+    return partitionStartRows_.empty() ? 0 : partitionStartRows_.back();
+  }
+
+  bool hasPendingOutput() const {
+    return numProcessedRows_ < numCompleteRows();
+  }
+
+  // Returns true if 'left' and 'right' have the same partition keys.
+  bool samePartition(const char* left, const char* right) const;
+
+  // Returns true if 'left' and 'right' have the same sorting keys.
+  bool arePeers(const char* left, const char* right) const;
+
+  // Sorts the rows of 'data_' and finds the partition boundaries. Used
+  // if the input is not sorted.
+  void sortPartitions();
+
+  // Appends the rows from 'firstNewRow' on to the partition
+  // boundaries. Used if the input is sorted.
+  void findPartitionStarts(vector_size_t firstNewRow);
+
+  // Frees the rows of the partitions that have been output. Used if
+  // the input is sorted.
+  void eraseProcessedPartitions();
+
+  // Sets up the window functions for partition 'currentPartition_'.
+  void startPartition();
+
+  // Fills the peer group and frame buffers for 'numRows' rows starting
+  // at 'partitionOffset_' in the current partition.
+  void computePeerAndFrameBounds(vector_size_t numRows);
+
+  // Fills 'rawBounds' with 'bound' for each of 'numRows' rows starting
+  // at 'partitionOffset_'. The bounds are clamped to one position
+  // before or after the partition.
+  void computeFrameBound(
+      const Frame& frame,
+      const FrameBound& bound,
+      bool isStart,
+      vector_size_t numRows,
+      vector_size_t* rawBounds);
+
+  const vector_size_t numInputColumns_;
+
+  // All input columns in input order. The window functions and the
+  // sorting refer to these by input channel.
+  std::unique_ptr<RowContainer> data_;
+
+  // Input channels and collation of the partition and sorting keys.
+  std::vector<std::pair<column_index_t, CompareFlags>> partitionKeyInfo_;
+  std::vector<std::pair<column_index_t, CompareFlags>> sortKeyInfo_;
+
+  // True if the input is clustered on the partition keys and sorted on
+  // the sorting keys within each partition.
+  const bool inputsSorted_;
+
+  std::vector<std::unique_ptr<WindowFunction>> windowFunctions_;
+  // The frame of each of 'windowFunctions_'.
+  std::vector<Frame> windowFrames_;
+
+  // The rows of 'data_' in partition and sorting key order.
+  std::vector<char*> sortedRows_;
+
+  // The offsets in 'sortedRows_' at which partitions start. The last
+  // element is the end of the last complete partition. If the input is
+  // sorted, the rows after the last element belong to a partition
+  // that may get more rows from the next input.
+  std::vector<vector_size_t> partitionStartRows_;
+
+  // The number of rows at the start of 'sortedRows_' that have been
+  // returned.
+  vector_size_t numProcessedRows_{0};
+
+  // The partition being output and the number of its rows that have
+  // been output.
+  vector_size_t currentPartition_{0};
+  vector_size_t partitionOffset_{0};
+  std::unique_ptr<WindowPartition> windowPartition_;
+
+  // Peer group of the last row for which the peer group was computed.
+  // Offsets in the current partition, 'peerEnd_' is exclusive.
+  vector_size_t peerStart_{0};
+  vector_size_t peerEnd_{0};
+
+  // Peer group bounds for the rows being output.
+  BufferPtr peerGroupStarts_;
+  BufferPtr peerGroupEnds_;
+
+  // Frame bounds for the rows being output for each of
+  // 'windowFunctions_'.
+  std::vector<BufferPtr> frameStarts_;
+  std::vector<BufferPtr> frameEnds_;
+
+  // Reusable vector for frame offsets from an input column.
+  VectorPtr frameOffsets_;
+};
+} // namespace facebook::velox::exec
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/WindowFunction.h"
+#include "velox/exec/Aggregate.h"
+
+namespace facebook::velox::exec {
+
+WindowFunctionMap& windowFunctions() {
+  static WindowFunctionMap functions;
+  return functions;
+}
+
+namespace {
+std::optional<const WindowFunctionEntry*> getWindowFunctionEntry(
+    const std::string& name) {
+  auto& functionsMap = windowFunctions();
+  auto it = functionsMap.find(sanitizeFunctionName(name));
+  if (it != functionsMap.end()) {
+    return &it->second;
+  }
+
+  return std::nullopt;
+}
+
+// Evaluates an aggregate function over the frame of each row with a
+// single accumulator. If the frame of a row starts where the frame of
+// the previous row started and does not end before it, only the rows
+// past the previous frame are added to the accumulator. Running
+// aggregates, e.g. with a frame from UNBOUNDED PRECEDING to CURRENT
+// ROW, are thus computed in one pass over the partition. Other frames
+// recompute the accumulator from the frame start.
+class AggregateWindowFunction : public WindowFunction {
+ public:
+  AggregateWindowFunction(
+      const std::string& name,
+      const std::vector<WindowFunctionArg>& args,
+      const TypePtr& resultType,
+      memory::MemoryPool* pool,
+      HashStringAllocator* stringAllocator)
+      : WindowFunction(resultType, pool), args_(args) {
+    std::vector<TypePtr> argTypes;
+    for (const auto& arg : args_) {
+      argTypes.push_back(arg.type);
+      argVectors_.push_back(
+          arg.constantValue ? nullptr : BaseVector::create(arg.type, 0, pool));
+    }
+    aggregate_ = Aggregate::create(
+        name, core::AggregationNode::Step::kSingle, argTypes, resultType);
+    aggregate_->setAllocator(stringAllocator);
+    // The accumulator is kept in a single group row with the null flag
+    // in the first byte and the row size at 'kRowSizeOffset'.
+    aggregate_->setOffsets(
+        kAccumulatorOffset,
+        RowContainer::nullByte(0),
+        RowContainer::nullMask(0),
+        kRowSizeOffset);
+    groupBuffer_ = AlignedBuffer::allocate<char>(
+        kAccumulatorOffset + aggregate_->accumulatorFixedWidthSize(), pool);
+    group_ = groupBuffer_->asMutable<char>();
+    singleResult_ = BaseVector::create(resultType, 1, pool);
+  }
+
+  ~AggregateWindowFunction() override {
+    if (initialized_) {
+      aggregate_->destroy(folly::Range<char**>(&group_, 1));
+    }
+  }
+
+  void resetPartition(const WindowPartition* partition) override {
+    partition_ = partition;
+    resetAccumulator(0);
+  }
+
+  void apply(
+      const BufferPtr& /*peerGroupStarts*/,
+      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& frameStarts,
+      const BufferPtr& frameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) override {
+    auto numRows = frameStarts->size() / sizeof(vector_size_t);
+    auto rawFrameStarts = frameStarts->as<vector_size_t>();
+    auto rawFrameEnds = frameEnds->as<vector_size_t>();
+    for (auto i = 0; i < numRows; ++i) {
+      auto start = rawFrameStarts[i];
+      auto end = rawFrameEnds[i];
+      if (start != frameStart_ || end < frameEnd_) {
+        resetAccumulator(start);
+      }
+      if (end > frameEnd_) {
+        addRows(frameEnd_ + 1, end);
+        frameEnd_ = end;
+      }
+      aggregate_->finalize(&group_, 1);
+      aggregate_->extractValues(&group_, 1, &singleResult_);
+      result->copy(singleResult_.get(), resultOffset + i, 0, 1);
+    }
+  }
+
+ private:
+  static constexpr int32_t kRowSizeOffset = 4;
+  static constexpr int32_t kAccumulatorOffset = 16;
+
+  // Clears the accumulator. The next frame starts at 'frameStart'.
+  void resetAccumulator(vector_size_t frameStart) {
+    static const vector_size_t kGroupIndex = 0;
+    if (initialized_) {
+      aggregate_->destroy(folly::Range<char**>(&group_, 1));
+    }
+    memset(group_, 0, kAccumulatorOffset);
+    aggregate_->clear();
+    aggregate_->initializeNewGroups(
+        &group_, folly::Range<const vector_size_t*>(&kGroupIndex, 1));
+    initialized_ = true;
+    frameStart_ = frameStart;
+    frameEnd_ = frameStart - 1;
+  }
+
+  // Adds the rows from 'begin' to 'end' inclusive to the accumulator.
+  void addRows(vector_size_t begin, vector_size_t end) {
+    auto numRows = end - begin + 1;
+    std::vector<VectorPtr> args;
+    args.reserve(args_.size());
+    for (auto i = 0; i < args_.size(); ++i) {
+      const auto& arg = args_[i];
+      if (arg.constantValue) {
+        args.push_back(
+            BaseVector::wrapInConstant(numRows, 0, arg.constantValue));
+      } else {
+        partition_->extractColumn(
+            arg.index.value(), begin, numRows, argVectors_[i]);
+        args.push_back(argVectors_[i]);
+      }
+    }
+    rows_.resize(numRows);
+    rows_.setAll();
+    aggregate_->addSingleGroupRawInput(group_, rows_, args, false);
+  }
+
+  const std::vector<WindowFunctionArg> args_;
+  std::unique_ptr<Aggregate> aggregate_;
+  // Reusable vectors for the column arguments.
+  std::vector<VectorPtr> argVectors_;
+  SelectivityVector rows_;
+  BufferPtr groupBuffer_;
+  char* group_;
+  bool initialized_{false};
+  VectorPtr singleResult_;
+  const WindowPartition* partition_{nullptr};
+  // The rows in the accumulator. The accumulator is empty if
+  // 'frameEnd_' < 'frameStart_'.
+  vector_size_t frameStart_{0};
+  vector_size_t frameEnd_{-1};
+};
+} // namespace
+
+bool registerWindowFunction(
+    const std::string& name,
+    std::vector<FunctionSignaturePtr> signatures,
+    WindowFunctionFactory factory) {
+  windowFunctions()[sanitizeFunctionName(name)] = {
+      std::move(signatures), std::move(factory)};
+  return true;
+}
+
+std::optional<std::vector<FunctionSignaturePtr>> getWindowFunctionSignatures(
+    const std::string& name) {
+  if (auto func = getWindowFunctionEntry(name)) {
+    return func.value()->signatures;
+  }
+
+  return std::nullopt;
+}
+
+// static
+std::unique_ptr<WindowFunction> WindowFunction::create(
+    const std::string& name,
+    const std::vector<WindowFunctionArg>& args,
+    const TypePtr& resultType,
+    memory::MemoryPool* pool,
+    HashStringAllocator* stringAllocator) {
+  if (auto func = getWindowFunctionEntry(name)) {
+    return func.value()->factory(args, resultType, pool);
+  }
+
+  // Throws if 'name' is not an aggregate function either.
+  return std::make_unique<AggregateWindowFunction>(
+      name, args, resultType, pool, stringAllocator);
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/memory/HashStringAllocator.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/expression/FunctionSignature.h"
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox::exec {
+
+// The rows of one window partition in the order of the window's
+// sorting keys. The rows are stored in a RowContainer with one column
+// per input column of the Window operator.
+class WindowPartition {
+ public:
+  WindowPartition(RowContainer* data, folly::Range<char**> rows)
+      : data_(data), rows_(rows) {}
+
+  vector_size_t numRows() const {
+    return rows_.size();
+  }
+
+  // Copies the values of input column 'columnIndex' for 'numRows' rows
+  // starting at 'partitionOffset' into 'result'. 'result' is resized
+  // to 'numRows'.
+  void extractColumn(
+      column_index_t columnIndex,
+      vector_size_t partitionOffset,
+      vector_size_t numRows,
+      const VectorPtr& result) const {
+    VELOX_CHECK_LE(partitionOffset + numRows, rows_.size());
+    data_->extractColumn(
+        rows_.data() + partitionOffset, numRows, columnIndex, result);
+  }
+
+ private:
+  RowContainer* const data_;
+  const folly::Range<char**> rows_;
+};
+
+// An argument of a window function. Either 'constantValue' or 'index'
+// is set.
+struct WindowFunctionArg {
+  TypePtr type;
+  // Constant argument, e.g. the offset of lag(x, 2).
+  VectorPtr constantValue;
+  // Input column of the Window operator.
+  std::optional<column_index_t> index;
+};
+
+class WindowFunction {
+ public:
+  explicit WindowFunction(TypePtr resultType, memory::MemoryPool* pool)
+      : resultType_(std::move(resultType)), pool_(pool) {}
+
+  virtual ~WindowFunction() = default;
+
+  const TypePtr& resultType() const {
+    return resultType_;
+  }
+
+  // Starts a new partition. Called before any apply() on the rows of
+  // 'partition'. 'partition' stays valid until the next call.
+  virtual void resetPartition(const WindowPartition* partition) = 0;
+
+  // Computes the function for a run of consecutive rows of the current
+  // partition. The buffers have one vector_size_t per row, all
+  // offsets are positions in the partition:
+  // @param peerGroupStarts First row of the peer group of each row.
+  // Peers are the rows with equal sorting keys.
+  // @param peerGroupEnds Last row of the peer group of each row.
+  // @param frameStarts First row of the frame of each row.
+  // @param frameEnds Last row of the frame of each row. The frame is
+  // empty if this is less than the frame start.
+  // @param resultOffset Position in 'result' of the first row.
+  // @param result Result vector of the function.
+  virtual void apply(
+      const BufferPtr& peerGroupStarts,
+      const BufferPtr& peerGroupEnds,
+      const BufferPtr& frameStarts,
+      const BufferPtr& frameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) = 0;
+
+  // Creates the window function 'name'. If there is no window function
+  // with that name, an aggregate function of that name is evaluated
+  // over the frame of each row.
+  static std::unique_ptr<WindowFunction> create(
+      const std::string& name,
+      const std::vector<WindowFunctionArg>& args,
+      const TypePtr& resultType,
+      memory::MemoryPool* pool,
+      HashStringAllocator* stringAllocator);
+
+ protected:
+  const TypePtr resultType_;
+  memory::MemoryPool* const pool_;
+};
+
+using WindowFunctionFactory = std::function<std::unique_ptr<WindowFunction>(
+    const std::vector<WindowFunctionArg>& args,
+    const TypePtr& resultType,
+    memory::MemoryPool* pool)>;
+
+/// Registers a window function with the specified name and signatures.
+bool registerWindowFunction(
+    const std::string& name,
+    std::vector<FunctionSignaturePtr> signatures,
+    WindowFunctionFactory factory);
+
+/// Returns signatures of the window function with the specified name.
+/// Returns empty std::optional if function with that name is not found.
+std::optional<std::vector<FunctionSignaturePtr>> getWindowFunctionSignatures(
+    const std::string& name);
+
+struct WindowFunctionEntry {
+  std::vector<FunctionSignaturePtr> signatures;
+  WindowFunctionFactory factory;
+};
+
+using WindowFunctionMap = std::unordered_map<std::string, WindowFunctionEntry>;
+
+WindowFunctionMap& windowFunctions();
+} // namespace facebook::velox::exec
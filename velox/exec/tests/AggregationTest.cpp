@@ -783,6 +783,61 @@ TEST_F(AggregationTest, partialAggregationMemoryLimit) {
       0);
 }
 
+TEST_F(AggregationTest, abandonPartialAggregation) {
+  // Nearly unique keys with some nulls. The partial aggregation does not
+  // reduce its input and switches to passing it through after 1000 rows.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             1'000,
+             [&](auto row) { return (i * 1'000 + row) / 2; },
+             nullEvery(17)),
+         makeFlatVector<int32_t>(
+             1'000, [](auto row) { return row % 7; }, nullEvery(11))}));
+  }
+  createDuckDbTable(vectors);
+
+  auto testAbandon = [&](const std::vector<std::string>& aggregates,
+                         const std::string& sql,
+                         bool abandoned) {
+    core::PlanNodeId aggNodeId;
+    auto task =
+        AssertQueryBuilder(duckDbQueryRunner_)
+            .config(
+                core::QueryConfig::kAbandonPartialAggregationMinRows, "1000")
+            .config(core::QueryConfig::kAbandonPartialAggregationMinPct, "40")
+            .plan(PlanBuilder()
+                      .values(vectors)
+                      .partialAggregation({"c0"}, aggregates)
+                      .capturePlanNodeId(aggNodeId)
+                      .finalAggregation()
+                      .planNode())
+            .assertResults(sql);
+    auto stats = toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+    if (abandoned) {
+      EXPECT_EQ(1, stats.at("abandonedPartialAggregation").sum);
+      EXPECT_LT(0, stats.at("abandonedPartialAggregationRows").sum);
+    } else {
+      EXPECT_EQ(0, stats.count("abandonedPartialAggregation"));
+    }
+  };
+
+  testAbandon({}, "SELECT distinct c0 FROM tmp", true);
+  testAbandon(
+      {"count(1)", "sum(c1)", "max(c1)"},
+      "SELECT c0, count(1), sum(c1), max(c1) FROM tmp GROUP BY 1",
+      true);
+
+  // Grouping on c1 reduces the input, so the aggregation is kept.
+  vectors = {makeRowVector({vectors[0]->childAt(1), vectors[0]->childAt(0)})};
+  createDuckDbTable(vectors);
+  testAbandon(
+      {"count(1)", "sum(c1)"},
+      "SELECT c0, count(1), sum(c1) FROM tmp GROUP BY 1",
+      false);
+}
+
 // Validates partial aggregate output types for SUM/MIN/MAX.
 TEST_F(AggregationTest, validatePartialTypes) {
   auto vectors = makeVectors(rowType_, 10, 1);
@@ -906,6 +961,40 @@ TEST_F(AggregationTest, spill) {
   EXPECT_LT(20 << 20, stats[0].operatorStats[1].spilledBytes);
 }
 
+TEST_F(AggregationTest, distributeSpilledPartitions) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 20; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return (i * 1'000 + row) % 7'919; }),
+         makeFlatVector<int32_t>(1'000, [](auto row) { return row % 97; })}));
+  }
+  auto makePlan = [&](core::PlanNodeId& aggNodeId) {
+    return PlanBuilder()
+        .values(vectors, true)
+        .partialAggregation({"c0"}, {"count(1)", "max(c1)"})
+        .localPartition({"c0"})
+        .finalAggregation()
+        .capturePlanNodeId(aggNodeId)
+        .planNode();
+  };
+
+  core::PlanNodeId aggNodeId;
+  auto results = AssertQueryBuilder(makePlan(aggNodeId))
+                     .maxDrivers(4)
+                     .copyResults(pool_.get());
+
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto task = AssertQueryBuilder(makePlan(aggNodeId))
+                  .maxDrivers(4)
+                  .config(core::QueryConfig::kSpillPath, tempDirectory->path)
+                  .config(core::QueryConfig::kTestingSpillPct, "100")
+                  .assertResults(results);
+
+  auto planStats = toPlanStats(task->taskStats()).at(aggNodeId);
+  EXPECT_LT(0, planStats.customStats.at("distributedSpillPartitions").sum);
+}
+
 /// Verify number of memory allocations in the HashAggregation operator.
 TEST_F(AggregationTest, memoryAllocations) {
   vector_size_t size = 1'024;
@@ -20,6 +20,7 @@
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 
 using namespace facebook::velox;
@@ -1005,6 +1006,61 @@ TEST_F(HashJoinTest, dynamicFilters) {
   }
 }
 
+TEST_F(HashJoinTest, bloomFilterPushdown) {
+  const int32_t numSplits = 10;
+  const int32_t numRowsProbe = 10'000;
+  // More distinct build side keys than VectorHasher keeps track of, so the
+  // pushed down filter is a Bloom filter.
+  const int32_t numRowsBuild = 150'000;
+
+  std::vector<RowVectorPtr> leftVectors;
+  auto leftFiles = makeFilePaths(numSplits);
+  for (int i = 0; i < numSplits; i++) {
+    auto rowVector = makeRowVector({
+        makeFlatVector<int64_t>(
+            numRowsProbe,
+            [&](auto row) { return (i * numRowsProbe + row) * 500; }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    });
+    leftVectors.push_back(rowVector);
+    writeToFile(leftFiles[i]->path, rowVector);
+  }
+
+  // Every other probe key has a match.
+  auto rightVectors = {makeRowVector({makeFlatVector<int64_t>(
+      numRowsBuild, [](auto row) { return row * 1'000; })})};
+
+  createDuckDbTable("t", {leftVectors});
+  createDuckDbTable("u", {rightVectors});
+
+  auto probeType = ROW({"c0", "c1"}, {BIGINT(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+  auto buildSide = PlanBuilder(planNodeIdGenerator)
+                       .values(rightVectors)
+                       .project({"c0 AS u_c0"})
+                       .planNode();
+
+  for (auto joinType : {core::JoinType::kInner, core::JoinType::kLeftSemi}) {
+    core::PlanNodeId leftScanId;
+    auto op = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(probeType)
+                  .capturePlanNodeId(leftScanId)
+                  .hashJoin({"c0"}, {"u_c0"}, buildSide, "", {"c1"}, joinType)
+                  .planNode();
+
+    auto task = AssertQueryBuilder(op, duckDbQueryRunner_)
+                    .splits(leftScanId, makeHiveConnectorSplits(leftFiles))
+                    .assertResults(
+                        "SELECT t.c1 FROM t WHERE t.c0 IN (SELECT c0 FROM u)");
+    EXPECT_EQ(1, getFiltersProduced(task, 1).sum);
+    EXPECT_EQ(1, getFiltersAccepted(task, 0).sum);
+    // The Bloom filter is not exact, so the join cannot be replaced by it
+    // even though the build side keys are unique.
+    EXPECT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+    EXPECT_LT(getInputPositions(task, 1), numRowsProbe * numSplits * 3 / 4);
+  }
+}
+
 TEST_F(HashJoinTest, leftJoin) {
   // Left side keys are [0, 1, 2,..10].
   // Use 3-rd column as row number to allow for asserting the order of results.
@@ -1538,3 +1594,215 @@ TEST_F(HashJoinTest, smallOutputBatchSize) {
       .config(core::QueryConfig::kPreferredOutputBatchSize, std::to_string(10))
       .assertResults("SELECT c0, u_c1 FROM t, u WHERE c0 = u_c0 AND c1 < u_c1");
 }
+
+TEST_F(HashJoinTest, spill) {
+  using core::QueryConfig;
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<RowVectorPtr> buildVectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    probeVectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000,
+            [&](auto row) { return (row * 7 + i) % 3'001; },
+            nullEvery(17)),
+        makeFlatVector<StringView>(
+            1'000,
+            [&](auto row) {
+              return StringView(fmt::format("probe {}-{}", i, row));
+            }),
+    }));
+    buildVectors.push_back(makeRowVector(
+        {"u_c0", "u_c1"},
+        {
+            makeFlatVector<int64_t>(
+                500,
+                [&](auto row) { return (row * 11 + i * 3) % 4'001; },
+                nullEvery(13)),
+            makeFlatVector<StringView>(
+                500,
+                [&](auto row) {
+                  return StringView(fmt::format("build {}-{}", i, row));
+                }),
+        }));
+  }
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  struct {
+    core::JoinType joinType;
+    std::vector<std::string> outputLayout;
+    std::string referenceQuery;
+  } testSettings[] = {
+      {core::JoinType::kInner,
+       {"c0", "c1", "u_c1"},
+       "SELECT t.c0, t.c1, u.u_c1 FROM t, u WHERE t.c0 = u.u_c0"},
+      {core::JoinType::kLeft,
+       {"c0", "c1", "u_c1"},
+       "SELECT t.c0, t.c1, u.u_c1 FROM t LEFT JOIN u ON t.c0 = u.u_c0"},
+      {core::JoinType::kRight,
+       {"c0", "c1", "u_c1"},
+       "SELECT t.c0, t.c1, u.u_c1 FROM t RIGHT JOIN u ON t.c0 = u.u_c0"},
+      {core::JoinType::kFull,
+       {"c0", "c1", "u_c1"},
+       "SELECT t.c0, t.c1, u.u_c1 FROM t FULL OUTER JOIN u ON t.c0 = u.u_c0"},
+      {core::JoinType::kLeftSemi,
+       {"c0", "c1"},
+       "SELECT t.c0, t.c1 FROM t WHERE t.c0 IN (SELECT u_c0 FROM u)"},
+  };
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(core::joinTypeName(testData.joinType));
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .values(probeVectors, true)
+                    .hashJoin(
+                        {"c0"},
+                        {"u_c0"},
+                        PlanBuilder(planNodeIdGenerator)
+                            .values(buildVectors, true)
+                            .planNode(),
+                        "",
+                        testData.outputLayout,
+                        testData.joinType)
+                    .planNode();
+
+    // Spill on every build input batch and split every spilled partition once
+    // more before joining it.
+    auto tempDirectory = TempDirectoryPath::create();
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .maxDrivers(4)
+                    .config(QueryConfig::kSpillPath, tempDirectory->path)
+                    .config(QueryConfig::kTestingSpillPct, "100")
+                    .assertResults(testData.referenceQuery);
+
+    uint64_t buildSpilledRows = 0;
+    uint64_t probeSpilledRows = 0;
+    for (const auto& pipeline : task->taskStats().pipelineStats) {
+      for (const auto& op : pipeline.operatorStats) {
+        if (op.operatorType == "HashBuild") {
+          buildSpilledRows += op.spilledRows;
+        } else if (op.operatorType == "HashProbe") {
+          probeSpilledRows += op.spilledRows;
+        }
+      }
+    }
+    EXPECT_LT(0, buildSpilledRows);
+    EXPECT_LT(0, probeSpilledRows);
+  }
+}
+
+TEST_F(HashJoinTest, spillSemiAndAntiJoins) {
+  using core::QueryConfig;
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<RowVectorPtr> buildVectors;
+  std::vector<RowVectorPtr> buildVectorsWithNulls;
+  for (int32_t i = 0; i < 10; ++i) {
+    probeVectors.push_back(makeRowVector(
+        {"t0", "t1"},
+        {
+            makeFlatVector<int64_t>(
+                1'000,
+                [&](auto row) { return (row * 7 + i) % 3'001; },
+                nullEvery(17)),
+            makeFlatVector<int64_t>(
+                1'000, [&](auto row) { return i * 1'000 + row; }),
+        }));
+    // Anti join returns the probe rows with null keys only if the build side
+    // is empty, so the build side has no null keys.
+    buildVectors.push_back(makeRowVector(
+        {"u0", "u1"},
+        {
+            makeFlatVector<int64_t>(
+                500, [&](auto row) { return (row * 11 + i * 3) % 4'001; }),
+            makeFlatVector<int64_t>(500, [](auto row) { return row % 5; }),
+        }));
+    buildVectorsWithNulls.push_back(makeRowVector(
+        {"u0", "u1"},
+        {
+            makeFlatVector<int64_t>(
+                500,
+                [&](auto row) { return (row * 11 + i * 3) % 4'001; },
+                nullEvery(97)),
+            makeFlatVector<int64_t>(500, [](auto row) { return row % 5; }),
+        }));
+  }
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+  createDuckDbTable("v", buildVectorsWithNulls);
+
+  struct {
+    core::JoinType joinType;
+    std::string filter;
+    bool buildNulls;
+    std::string referenceQuery;
+  } testSettings[] = {
+      {core::JoinType::kLeftSemi,
+       "",
+       false,
+       "SELECT t0, t1 FROM t WHERE t0 IN (SELECT u0 FROM u)"},
+      {core::JoinType::kLeftSemi,
+       "t1 % 5 != u1",
+       false,
+       "SELECT t0, t1 FROM t "
+       "WHERE EXISTS (SELECT * FROM u WHERE t0 = u0 AND t1 % 5 <> u1)"},
+      {core::JoinType::kAnti,
+       "",
+       false,
+       "SELECT t0, t1 FROM t WHERE t0 NOT IN (SELECT u0 FROM u)"},
+      // Nulls in the build side keys are found before or after spilling
+      // started. Either way the result is empty.
+      {core::JoinType::kAnti,
+       "",
+       true,
+       "SELECT t0, t1 FROM t WHERE t0 NOT IN (SELECT u0 FROM v)"},
+  };
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(fmt::format(
+        "{} filter: '{}' build nulls: {}",
+        core::joinTypeName(testData.joinType),
+        testData.filter,
+        testData.buildNulls));
+    auto planNodeIdGenerator = std::make_shared<PlanNodeIdGenerator>();
+    auto plan =
+        PlanBuilder(planNodeIdGenerator)
+            .values(probeVectors, true)
+            .hashJoin(
+                {"t0"},
+                {"u0"},
+                PlanBuilder(planNodeIdGenerator)
+                    .values(
+                        testData.buildNulls ? buildVectorsWithNulls
+                                            : buildVectors,
+                        true)
+                    .planNode(),
+                testData.filter,
+                {"t0", "t1"},
+                testData.joinType)
+            .planNode();
+
+    auto tempDirectory = TempDirectoryPath::create();
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .maxDrivers(4)
+                    .config(QueryConfig::kSpillPath, tempDirectory->path)
+                    .config(QueryConfig::kTestingSpillPct, "100")
+                    .assertResults(testData.referenceQuery);
+    if (testData.buildNulls) {
+      continue;
+    }
+
+    uint64_t buildSpilledRows = 0;
+    uint64_t probeSpilledRows = 0;
+    for (const auto& pipeline : task->taskStats().pipelineStats) {
+      for (const auto& op : pipeline.operatorStats) {
+        if (op.operatorType == "HashBuild") {
+          buildSpilledRows += op.spilledRows;
+        } else if (op.operatorType == "HashProbe") {
+          probeSpilledRows += op.spilledRows;
+        }
+      }
+    }
+    EXPECT_LT(0, buildSpilledRows);
+    EXPECT_LT(0, probeSpilledRows);
+  }
+}
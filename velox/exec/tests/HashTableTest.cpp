@@ -19,6 +19,7 @@
 #include "velox/exec/VectorHasher.h"
 #include "velox/vector/tests/VectorMaker.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <memory>
 
@@ -81,7 +82,7 @@ class HashTableTest : public testing::Test {
       batches_.insert(batches_.end(), batches.begin(), batches.end());
       startOffset += size;
     }
-    topTable_->prepareJoinTable(std::move(otherTables));
+    topTable_->prepareJoinTable(std::move(otherTables), executor_.get());
     EXPECT_EQ(topTable_->hashMode(), mode);
     LOG(INFO) << "Made table " << describeTable();
     testProbe();
@@ -442,6 +443,9 @@ class HashTableTest : public testing::Test {
   // Spacing between consecutive generated keys. Affects whether
   // Vectorhashers make ranges or ids of distinct values.
   int32_t keySpacing_ = 1;
+  // Executor for building join tables in parallel. If nullptr, join
+  // tables are built on the calling thread.
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
 };
 
 TEST_F(HashTableTest, int2DenseArray) {
@@ -493,6 +497,21 @@ TEST_F(HashTableTest, mixed6Sparse) {
   testCycle(BaseHashTable::HashMode::kHash, 1000000, 2, type, 6);
 }
 
+TEST_F(HashTableTest, parallelBuildNormalized) {
+  auto type = ROW({"k1", "k2"}, {BIGINT(), BIGINT()});
+  keySpacing_ = 1000;
+  executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  testCycle(BaseHashTable::HashMode::kNormalizedKey, 10000, 4, type, 2);
+}
+
+TEST_F(HashTableTest, parallelBuildHash) {
+  auto type =
+      ROW({"key"}, {ROW({"k1", "k2", "k3"}, {BIGINT(), VARCHAR(), BIGINT()})});
+  keySpacing_ = 1000;
+  executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  testCycle(BaseHashTable::HashMode::kHash, 50000, 4, type, 1);
+}
+
 // It should be safe to call clear() before we insert any data into HashTable
 TEST_F(HashTableTest, clear) {
   std::vector<std::unique_ptr<VectorHasher>> keyHashers;
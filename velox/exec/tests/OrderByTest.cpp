@@ -13,8 +13,12 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/file/FileSystems.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/vector/tests/VectorMaker.h"
 
 using namespace facebook::velox;
@@ -22,6 +26,11 @@ using namespace facebook::velox::exec::test;
 
 class OrderByTest : public OperatorTestBase {
  protected:
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    filesystems::registerLocalFileSystem();
+  }
+
   void testSingleKey(
       const std::vector<RowVectorPtr>& input,
       const std::string& key) {
@@ -264,3 +273,105 @@ TEST_F(OrderByTest, unknown) {
   assertQueryOrdered(
       plan, "SELECT *, null FROM tmp ORDER BY c0 DESC NULLS LAST", {0});
 }
+
+TEST_F(OrderByTest, spill) {
+  using core::QueryConfig;
+  vector_size_t batchSize = 1000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 20; ++i) {
+    auto c0 = makeFlatVector<int64_t>(
+        batchSize,
+        [&](vector_size_t row) { return (row * 17 + i * 31) % 997; },
+        nullEvery(7));
+    auto c1 = makeFlatVector<StringView>(
+        batchSize,
+        [&](vector_size_t row) {
+          return StringView(fmt::format("{}-{}", row % 13, i));
+        },
+        nullEvery(11));
+    auto c2 = makeFlatVector<double>(
+        batchSize, [&](vector_size_t row) { return row * 0.1 + i; });
+    vectors.push_back(makeRowVector({c0, c1, c2}));
+  }
+  createDuckDbTable(vectors);
+
+  // Spill every input batch so that the output is merged from 20 sorted runs.
+  // The sorting keys are not the leading columns and c2 breaks the ties.
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .orderBy(
+                      {"c1 DESC NULLS FIRST",
+                       "c0 ASC NULLS LAST",
+                       "c2 ASC NULLS LAST"},
+                      false)
+                  .planNode();
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(QueryConfig::kSpillPath, tempDirectory->path)
+                  .config(QueryConfig::kTestingSpillPct, "100")
+                  .assertResults(
+                      "SELECT * FROM tmp "
+                      "ORDER BY c1 DESC NULLS FIRST, c0 NULLS LAST, c2",
+                      {{1, 0, 2}});
+
+  auto stats = task->taskStats().pipelineStats;
+  EXPECT_LT(0, stats[0].operatorStats[1].spilledBytes);
+  EXPECT_EQ(19 * batchSize, stats[0].operatorStats[1].spilledRows);
+}
+
+TEST_F(OrderByTest, parallelSort) {
+  using core::QueryConfig;
+  vector_size_t batchSize = 1000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 10; ++i) {
+    auto c0 = makeFlatVector<int32_t>(
+        batchSize,
+        [&](vector_size_t row) { return (row * 7 + i * 13) % 101 - 50; },
+        nullEvery(9));
+    // Strings with a common 8 byte prefix tie on the prefix of the sort.
+    auto c1 = makeFlatVector<StringView>(
+        batchSize,
+        [&](vector_size_t row) {
+          return StringView(fmt::format("common-prefix-{}", row % 17));
+        },
+        nullEvery(13));
+    auto c2 = makeFlatVector<double>(
+        batchSize, [&](vector_size_t row) { return row * -0.5 + i; });
+    vectors.push_back(makeRowVector({c0, c1, c2}));
+  }
+  createDuckDbTable(vectors);
+
+  auto runOrderBy = [&](const std::vector<std::string>& keys,
+                        const std::string& sql,
+                        const std::vector<uint32_t>& sortingKeys) {
+    auto plan = PlanBuilder().values(vectors).orderBy(keys, false).planNode();
+    // Runs of 1000 rows make 10 runs.
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .config(QueryConfig::kParallelSortMinRunSize, "1000")
+                    .assertResults(sql, sortingKeys);
+    auto stats = task->taskStats().pipelineStats[0].operatorStats[1];
+    EXPECT_EQ(10, stats.runtimeStats["parallelSortRuns"].sum);
+  };
+
+  runOrderBy(
+      {"c0 ASC NULLS LAST", "c2 DESC NULLS FIRST"},
+      "SELECT * FROM tmp ORDER BY c0 NULLS LAST, c2 DESC NULLS FIRST",
+      {0, 2});
+  runOrderBy(
+      {"c1 DESC NULLS FIRST", "c0 ASC NULLS FIRST", "c2 ASC NULLS LAST"},
+      "SELECT * FROM tmp "
+      "ORDER BY c1 DESC NULLS FIRST, c0 NULLS FIRST, c2 NULLS LAST",
+      {1, 0, 2});
+  runOrderBy(
+      {"c2 ASC NULLS LAST"}, "SELECT * FROM tmp ORDER BY c2 NULLS LAST", {2});
+
+  // With the default run size, the rows are sorted on the Driver thread.
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .orderBy({"c0 DESC NULLS LAST", "c2 ASC NULLS LAST"}, false)
+                  .planNode();
+  auto task = assertQueryOrdered(
+      plan, "SELECT * FROM tmp ORDER BY c0 DESC NULLS LAST, c2", {0, 2});
+  auto stats = task->taskStats().pipelineStats[0].operatorStats[1];
+  EXPECT_EQ(0, stats.runtimeStats.count("parallelSortRuns"));
+}
@@ -21,6 +21,7 @@
 #include "velox/common/file/FileSystems.h"
 #include "velox/dwio/dwrf/test/utils/BatchMaker.h"
 #include "velox/exec/ContainerRowSerde.h"
+#include "velox/exec/SortPrefix.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/exec/tests/utils/RowContainerTestBase.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
@@ -107,6 +108,34 @@ class RowContainerTest : public exec::test::RowContainerTestBase {
     testExtractColumnForOddRows(rowContainer, rows, 0, input);
   }
 
+  // Checks that the SortPrefixes of 'rows' order them like compareRows()
+  // with 'flags' for all collations of the keys.
+  void checkSortPrefix(RowContainer& data, const std::vector<char*>& rows) {
+    for (auto nullsFirst : {true, false}) {
+      for (auto ascending : {true, false}) {
+        std::vector<CompareFlags> flags(
+            data.keyTypes().size(), {nullsFirst, ascending, false});
+        SortPrefix prefix(data, flags);
+        std::vector<uint64_t> prefixes;
+        for (auto row : rows) {
+          prefixes.push_back(prefix.encode(row));
+        }
+        for (auto i = 0; i < rows.size(); ++i) {
+          for (auto j = 0; j < rows.size(); ++j) {
+            auto result = data.compareRows(rows[i], rows[j], flags);
+            if (prefixes[i] < prefixes[j]) {
+              EXPECT_LT(result, 0) << i << " " << j;
+            } else if (prefixes[i] > prefixes[j]) {
+              EXPECT_GT(result, 0) << i << " " << j;
+            } else if (prefix.isComplete()) {
+              EXPECT_EQ(0, result) << i << " " << j;
+            }
+          }
+        }
+      }
+    }
+  }
+
   template <typename T>
   void testCompareFloats(TypePtr type, bool ascending) {
     auto rowContainer = makeRowContainer({type}, {type});
@@ -494,3 +523,98 @@ TEST_F(RowContainerTest, compareDouble) {
   // Verify descending order
   testCompareFloats<double>(DOUBLE(), false);
 }
+
+TEST_F(RowContainerTest, sortPrefix) {
+  auto rowType = ROW(
+      {"c0", "c1", "c2", "c3"}, {SMALLINT(), DOUBLE(), VARCHAR(), BIGINT()});
+  auto batch = makeDataset(rowType, 200, [](RowVectorPtr rows) {
+    // Repeat values so that the prefixes have ties.
+    auto c0 = rows->childAt(0)->asFlatVector<int16_t>();
+    auto c1 = rows->childAt(1)->asFlatVector<double>();
+    for (auto i = 0; i < rows->size(); ++i) {
+      c0->set(i, i % 7 - 3);
+      if (i % 5 == 0) {
+        c1->set(i, i % 3 == 0 ? 0.0 : -0.0);
+      }
+    }
+  });
+  SelectivityVector allRows(batch->size());
+
+  auto makeRows = [&](RowContainer& data) {
+    std::vector<char*> rows(batch->size());
+    for (auto i = 0; i < rows.size(); ++i) {
+      rows[i] = data.newRow();
+    }
+    for (auto column = 0; column < data.keyTypes().size(); ++column) {
+      DecodedVector decoded(*batch->childAt(column), allRows);
+      for (auto i = 0; i < rows.size(); ++i) {
+        data.store(decoded, i, rows[i], column);
+      }
+    }
+    return rows;
+  };
+
+  // The string key ends the prefix.
+  auto data = makeRowContainer(rowType->children(), {});
+  auto rows = makeRows(*data);
+  EXPECT_FALSE(SortPrefix(*data, {}).isComplete());
+  checkSortPrefix(*data, rows);
+
+  // The smallint and the double keys take 82 bits, so the double is truncated.
+  data = makeRowContainer({SMALLINT(), DOUBLE()}, {});
+  rows = makeRows(*data);
+  EXPECT_FALSE(SortPrefix(*data, {}).isComplete());
+  checkSortPrefix(*data, rows);
+
+  // A single smallint key fits in the prefix. Equal prefixes are equal keys.
+  data = makeRowContainer({SMALLINT()}, {});
+  rows = makeRows(*data);
+  EXPECT_TRUE(SortPrefix(*data, {}).isComplete());
+  checkSortPrefix(*data, rows);
+}
+
+TEST_F(RowContainerTest, storeSortPrefix) {
+  std::vector<TypePtr> keys{BIGINT(), VARCHAR()};
+  std::vector<TypePtr> dependents{DOUBLE()};
+  std::vector<CompareFlags> flags{{false, false, false}, {true, true, false}};
+  RowContainer data(keys, dependents, flags, mappedMemory_);
+  RowContainer noPrefix(keys, dependents, mappedMemory_);
+  EXPECT_TRUE(data.hasSortPrefix());
+  EXPECT_FALSE(noPrefix.hasSortPrefix());
+  EXPECT_EQ(noPrefix.fixedRowSize() + 8, data.fixedRowSize());
+
+  auto batch = makeDataset(
+      ROW({"c0", "c1", "c2"}, {BIGINT(), VARCHAR(), DOUBLE()}),
+      100,
+      [](RowVectorPtr rows) {
+        auto c0 = rows->childAt(0)->asFlatVector<int64_t>();
+        for (auto i = 0; i < rows->size(); ++i) {
+          c0->set(i, i % 10);
+        }
+      });
+  SelectivityVector allRows(batch->size());
+  std::vector<char*> rows(batch->size());
+  for (auto i = 0; i < rows.size(); ++i) {
+    rows[i] = data.newRow();
+  }
+  for (auto column = 0; column < batch->childrenSize(); ++column) {
+    DecodedVector decoded(*batch->childAt(column), allRows);
+    for (auto i = 0; i < rows.size(); ++i) {
+      data.store(decoded, i, rows[i], column);
+    }
+  }
+  SortPrefix prefix(data, flags);
+  for (auto row : rows) {
+    data.storeSortPrefix(row);
+    EXPECT_EQ(prefix.encode(row), data.sortPrefix(row));
+  }
+
+  auto sign = [](int32_t result) { return result < 0 ? -1 : result > 0; };
+  for (auto left : rows) {
+    for (auto right : rows) {
+      EXPECT_EQ(
+          sign(data.compareRows(left, right, flags)),
+          sign(data.compareRowsWithSortPrefix(left, right)));
+    }
+  }
+}
@@ -14,9 +14,13 @@
  * limitations under the License.
  */
 #include "velox/exec/Spill.h"
+#include <folly/executors/IOThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <array>
+#include <filesystem>
+#include <fstream>
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/serializers/PrestoSerializer.h"
@@ -37,63 +41,272 @@ class SpillTest : public testing::Test,
     filesystems::registerLocalFileSystem();
   }
 
+  // Writes two partitions of sorted runs with 'fileOptions' and checks that
+  // merging them back produces the written data. Calls 'checkStats' with the
+  // IO counters of the spill files.
+  void spillState(
+      const SpillFileOptions& fileOptions,
+      std::function<void(const SpillStats&)> checkStats = nullptr) {
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    // We make a state that has 2 partitions, each with its own file
+    // list. We write 10 sorted vectors in each partition. The vectors
+    // have the ith element = i * 20 + sequence, where sequence is the
+    // sequence number of the vector in the partition. When read back,
+    // both partitions produce an ascending sequence of integers without
+    // gaps.
+    SpillState state(
+        tempDirectory->path + "/test",
+        2,
+        1,
+        10000, // small target file size. Makes a new file for each batch.
+        *pool(),
+        *mappedMemory_,
+        {},
+        fileOptions);
+
+    EXPECT_EQ(2, state.maxPartitions());
+    state.setNumPartitions(2);
+    for (auto partition = 0; partition < state.maxPartitions(); ++partition) {
+      for (auto batch = 0; batch < 10; ++batch) {
+        // We add a sorted run in two pieces: 1, 11, 21,,, followed by
+        // 100001 , 100011, 100021   etc. where the last digit is the batch
+        // number. Each sorted run has 20000 rows.
+        state.appendToPartition(
+            partition,
+            makeRowVector({makeFlatVector<int64_t>(
+                10000, [&](auto row) { return row * 10 + batch; })}));
+
+        state.appendToPartition(
+            partition,
+            makeRowVector({makeFlatVector<int64_t>(10000, [&](auto row) {
+              return row * 10 + batch + 100000;
+            })}));
+        // Indicates that the next additions to 'partition' are not sorted
+        // with respect to the values added so far.
+        state.finishWrite(partition);
+      }
+    }
+    if (fileOptions.compression == SpillCompression::kNone) {
+      EXPECT_LT(200'000 * sizeof(int64_t), state.spilledBytes());
+    }
+    for (auto partition = 0; partition < state.maxPartitions(); ++partition) {
+      auto merge = state.startMerge(partition, nullptr);
+      // We expect 10 * 20000 rows in dense increasing order.
+      for (auto i = 0; i < 200000; ++i) {
+        auto stream = merge->next();
+        ASSERT_NE(nullptr, stream);
+        EXPECT_EQ(
+            i,
+            stream->current()
+                .childAt(0)
+                ->asUnchecked<FlatVector<int64_t>>()
+                ->valueAt(stream->currentIndex()));
+        EXPECT_EQ(
+            i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+
+        stream->pop();
+      }
+      ASSERT_EQ(nullptr, merge->next());
+    }
+    if (checkStats) {
+      checkStats(state.stats());
+    }
+  }
+
   memory::MappedMemory* mappedMemory_;
 };
 
 TEST_F(SpillTest, spillState) {
+  spillState({}, [](const SpillStats& stats) {
+    EXPECT_EQ(stats.uncompressedBytes, stats.writtenBytes);
+    EXPECT_EQ(stats.writtenBytes, stats.readBytes);
+  });
+}
+
+TEST_F(SpillTest, compressedSpillState) {
+  for (auto compression : {SpillCompression::kLz4, SpillCompression::kZstd}) {
+    SCOPED_TRACE(static_cast<int>(compression));
+    SpillFileOptions options;
+    options.compression = compression;
+    options.checksum = true;
+    spillState(options, [](const SpillStats& stats) {
+      EXPECT_LT(stats.writtenBytes, stats.uncompressedBytes);
+      EXPECT_EQ(stats.writtenBytes, stats.readBytes);
+      EXPECT_GT(stats.readTimeUs + stats.writeTimeUs, 0);
+    });
+  }
+  SpillFileOptions checksumOnly;
+  checksumOnly.checksum = true;
+  spillState(checksumOnly);
+}
+
+TEST_F(SpillTest, readAhead) {
+  folly::IOThreadPoolExecutor executor(4);
+  for (auto compression : {SpillCompression::kNone, SpillCompression::kLz4}) {
+    SCOPED_TRACE(static_cast<int>(compression));
+    SpillFileOptions options;
+    options.compression = compression;
+    options.readAheadExecutor = &executor;
+    // Small buffers make several reads per file.
+    options.readBufferBudget = 1 << 20;
+    spillState(options, [](const SpillStats& stats) {
+      EXPECT_EQ(stats.writtenBytes, stats.readBytes);
+    });
+  }
+}
+
+TEST_F(SpillTest, readBufferSize) {
+  SpillFileOptions options;
+  options.readBufferBudget = 16 << 20;
+  EXPECT_EQ(options.readBufferSize(1), (4 << 20) - AlignedBuffer::kPaddedSize);
+  EXPECT_EQ(options.readBufferSize(16), 1 << 20);
+  EXPECT_EQ(options.readBufferSize(10'000), 64 << 10);
+  folly::IOThreadPoolExecutor executor(1);
+  options.readAheadExecutor = &executor;
+  EXPECT_EQ(options.readBufferSize(16), 512 << 10);
+}
+
+TEST_F(SpillTest, mergeManyFiles) {
   auto tempDirectory = exec::test::TempDirectoryPath::create();
-  // We make a state that has 2 partitions, each with its own file
-  // list. We write 10 sorted vectors in each partition. The vectors
-  // have the ith element = i * 20 + sequence, where sequence is the
-  // sequence number of the vector in the partition. When read back,
-  // both partitions produce an ascending sequence of integers without
-  // gaps.
+  constexpr int32_t kNumFiles = 32;
+  constexpr int32_t kRowsPerFile = 40'000;
+  SpillFileOptions options;
+  options.readBufferBudget = 4 << 20;
   SpillState state(
       tempDirectory->path + "/test",
-      2,
       1,
-      10000, // small target file size. Makes a new file for each batch.
+      1,
+      std::numeric_limits<uint64_t>::max(),
       *pool(),
-      *mappedMemory_);
-
-  EXPECT_EQ(2, state.maxPartitions());
-  state.setNumPartitions(2);
-  for (auto partition = 0; partition < state.maxPartitions(); ++partition) {
-    for (auto batch = 0; batch < 10; ++batch) {
-      // We add a sorted run in two pieces: 1, 11, 21,,, followed by 100001 ,
-      // 100011, 100021   etc. where the last digit is the batch number. Each
-      // sorted run has 20000 rows.
-      state.appendToPartition(
-          partition,
-          makeRowVector({makeFlatVector<int64_t>(
-              10000, [&](auto row) { return row * 10 + batch; })}));
+      *mappedMemory_,
+      {},
+      options);
+  state.setNumPartitions(1);
+  for (auto i = 0; i < kNumFiles; ++i) {
+    state.appendToPartition(
+        0, makeRowVector({makeFlatVector<int64_t>(kRowsPerFile, [&](auto row) {
+          return row * kNumFiles + i;
+        })}));
+    state.finishWrite(0);
+  }
+  auto files = state.files(0);
+  ASSERT_EQ(files.size(), kNumFiles);
+
+  // Each file gets an equal share of the budget, which is less than the
+  // size of a file.
+  std::vector<std::unique_ptr<SpillStream>> streams;
+  for (auto& file : files) {
+    ASSERT_LT(options.readBufferSize(kNumFiles), file->size());
+    file->startRead(kNumFiles);
+    EXPECT_EQ(file->readBufferSize(), options.readBufferSize(kNumFiles));
+    EXPECT_EQ(file->readBufferSize(), 128 << 10);
+    streams.push_back(std::move(file));
+  }
+  TreeOfLosers<SpillStream> merge(std::move(streams));
+  for (auto i = 0; i < kNumFiles * kRowsPerFile; ++i) {
+    auto stream = merge.next();
+    ASSERT_NE(nullptr, stream);
+    ASSERT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
+    stream->pop();
+  }
+  ASSERT_EQ(nullptr, merge.next());
+}
 
+TEST_F(SpillTest, readsOfFramedFile) {
+  constexpr int32_t kNumBatches = 2'000;
+  constexpr int32_t kBatchSize = 64;
+  folly::IOThreadPoolExecutor executor(1);
+  for (auto readAhead : {false, true}) {
+    SCOPED_TRACE(readAhead);
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    SpillFileOptions options;
+    options.checksum = true;
+    options.readBufferBudget = 512 << 10;
+    options.readAheadExecutor = readAhead ? &executor : nullptr;
+    SpillState state(
+        tempDirectory->path + "/test",
+        1,
+        1,
+        std::numeric_limits<uint64_t>::max(),
+        *pool(),
+        *mappedMemory_,
+        {},
+        options);
+    state.setNumPartitions(1);
+    // Small batches, as from a Spiller, are written in blocks of about 64KB.
+    for (auto i = 0; i < kNumBatches; ++i) {
       state.appendToPartition(
-          partition,
-          makeRowVector({makeFlatVector<int64_t>(
-              10000, [&](auto row) { return row * 10 + batch + 100000; })}));
-      // Indicates that the next additions to 'partition' are not sorted with
-      // respect to the values added so far.
-      state.finishWrite(partition);
+          0, makeRowVector({makeFlatVector<int64_t>(kBatchSize, [&](auto row) {
+            return i * kBatchSize + row;
+          })}));
     }
-  }
-  EXPECT_LT(200'000 * sizeof(int64_t), state.spilledBytes());
-  for (auto partition = 0; partition < state.maxPartitions(); ++partition) {
-    auto merge = state.startMerge(partition, nullptr);
-    // We expect 10 * 20000 rows in dense increasing order.
-    for (auto i = 0; i < 200000; ++i) {
-      auto stream = merge->next();
-      ASSERT_NE(nullptr, stream);
-      EXPECT_EQ(
-          i,
-          stream->current()
-              .childAt(0)
-              ->asUnchecked<FlatVector<int64_t>>()
-              ->valueAt(stream->currentIndex()));
-      EXPECT_EQ(i, stream->decoded(0).valueAt<int64_t>(stream->currentIndex()));
-
-      stream->pop();
+    state.finishWrite(0);
+    auto files = state.files(0);
+    ASSERT_EQ(files.size(), 1);
+    auto& file = files[0];
+    file->startRead();
+    RowVectorPtr batch;
+    int64_t numRows = 0;
+    while (file->readBatch(batch)) {
+      auto values = batch->childAt(0)->asFlatVector<int64_t>();
+      for (auto i = 0; i < batch->size(); ++i) {
+        ASSERT_EQ(numRows++, values->valueAt(i));
+      }
     }
-    ASSERT_EQ(nullptr, merge->next());
+    ASSERT_EQ(numRows, kNumBatches * kBatchSize);
+
+    // Each read fills the buffer. All whole blocks in it are decoded and the
+    // start of the last block, less than 64KB and a batch, is kept for the
+    // next read.
+    const auto& stats = state.stats();
+    EXPECT_EQ(stats.writtenBytes, stats.readBytes);
+    EXPECT_LE(
+        stats.numReads,
+        bits::divRoundUp(file->size(), file->readBufferSize() - (80 << 10)));
+    EXPECT_LT(stats.numReads, file->size() / (64 << 10));
   }
 }
+
+TEST_F(SpillTest, checksumMismatch) {
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  SpillFileOptions options;
+  options.checksum = true;
+  SpillState state(
+      tempDirectory->path + "/test",
+      1,
+      0,
+      std::numeric_limits<uint64_t>::max(),
+      *pool(),
+      *mappedMemory_,
+      {},
+      options);
+  state.setNumPartitions(1);
+  state.appendToPartition(
+      0, makeRowVector({makeFlatVector<int64_t>(1000, [](auto row) {
+        return row;
+      })}));
+  auto files = state.files(0);
+  ASSERT_EQ(files.size(), 1);
+
+  // Flips a byte after the block header.
+  for (const auto& entry :
+       std::filesystem::directory_iterator(tempDirectory->path)) {
+    std::fstream file(
+        entry.path(), std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(100);
+    char byte;
+    file.read(&byte, 1);
+    byte ^= 1;
+    file.seekp(100);
+    file.write(&byte, 1);
+  }
+  VELOX_ASSERT_THROW(files[0]->startRead(), "Spill file checksum mismatch");
+}
+
+TEST_F(SpillTest, compressionFromString) {
+  EXPECT_EQ(spillCompressionFromString("none"), SpillCompression::kNone);
+  EXPECT_EQ(spillCompressionFromString("lz4"), SpillCompression::kLz4);
+  EXPECT_EQ(spillCompressionFromString("zstd"), SpillCompression::kZstd);
+  VELOX_ASSERT_THROW(
+      spillCompressionFromString("gzip"), "Unknown spill compression: gzip");
+}
@@ -13,14 +13,23 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/file/FileSystems.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
 
 using namespace facebook::velox;
 using namespace facebook::velox::exec::test;
 
 class TopNTest : public OperatorTestBase {
  protected:
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    filesystems::registerLocalFileSystem();
+  }
+
   static std::vector<std::string> getSortOrderSqls() {
     return {"NULLS LAST", "NULLS FIRST", "DESC NULLS FIRST", "DESC NULLS LAST"};
   }
@@ -245,3 +254,77 @@ TEST_F(TopNTest, empty) {
 
   testSingleKey(vectors, "c0", "c0 < 0");
 }
+
+TEST_F(TopNTest, spill) {
+  using core::QueryConfig;
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 20; ++i) {
+    auto c0 = makeFlatVector<int64_t>(
+        batchSize,
+        [&](vector_size_t row) { return (row * 17 + i * 31) % 997; },
+        nullEvery(7));
+    auto c1 = makeFlatVector<StringView>(
+        batchSize,
+        [&](vector_size_t row) {
+          return StringView(fmt::format("{}-{}", row % 13, i));
+        },
+        nullEvery(11));
+    auto c2 = makeFlatVector<double>(
+        batchSize, [&](vector_size_t row) { return row * 0.1 + i; });
+    vectors.push_back(makeRowVector({c0, c1, c2}));
+  }
+  createDuckDbTable(vectors);
+
+  // Spill every input batch so that the output is merged from 20 sorted runs.
+  // The limit is larger than one run. c2 breaks the ties.
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .topN(
+                      {"c1 DESC NULLS FIRST",
+                       "c0 ASC NULLS LAST",
+                       "c2 ASC NULLS LAST"},
+                      2'500,
+                      false)
+                  .planNode();
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(QueryConfig::kSpillPath, tempDirectory->path)
+                  .config(QueryConfig::kTestingSpillPct, "100")
+                  .assertResults(
+                      "SELECT * FROM tmp "
+                      "ORDER BY c1 DESC NULLS FIRST, c0 NULLS LAST, c2 "
+                      "LIMIT 2500",
+                      {{1, 0, 2}});
+
+  auto stats = task->taskStats().pipelineStats;
+  EXPECT_LT(0, stats[0].operatorStats[1].spilledBytes);
+  EXPECT_EQ(19 * batchSize, stats[0].operatorStats[1].spilledRows);
+}
+
+TEST_F(TopNTest, spillThreshold) {
+  using core::QueryConfig;
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 20; ++i) {
+    auto c0 = makeFlatVector<int64_t>(
+        batchSize, [&](vector_size_t row) { return i * batchSize + row; });
+    auto c1 = makeFlatVector<int64_t>(
+        batchSize, [&](vector_size_t row) { return row % 7; });
+    vectors.push_back(makeRowVector({c0, c1}));
+  }
+  createDuckDbTable(vectors);
+
+  // The first spill writes the top 100 rows of the first batch. All later
+  // rows come after the last of these, so they are dropped and not spilled.
+  auto plan =
+      PlanBuilder().values(vectors).topN({"c0"}, 100, false).planNode();
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(QueryConfig::kSpillPath, tempDirectory->path)
+                  .config(QueryConfig::kTestingSpillPct, "100")
+                  .assertResults("SELECT * FROM tmp ORDER BY c0 LIMIT 100");
+
+  auto stats = task->taskStats().pipelineStats;
+  EXPECT_EQ(100, stats[0].operatorStats[1].spilledRows);
+}
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+class WindowTest : public OperatorTestBase {
+ protected:
+  // Returns batches with a partition key c0, a unique sorting key c1, a
+  // sorting key with duplicates c2 and a nullable value c3. If 'sorted'
+  // is true, the rows are in c0, c1 order across batches.
+  std::vector<RowVectorPtr>
+  makeVectors(int32_t numBatches, vector_size_t batchSize, bool sorted) {
+    std::vector<RowVectorPtr> vectors;
+    const vector_size_t numRows = numBatches * batchSize;
+    const int32_t numPartitions = 7;
+    for (int32_t i = 0; i < numBatches; ++i) {
+      auto row = [&, i](vector_size_t j) { return i * batchSize + j; };
+      auto c0 = makeFlatVector<int32_t>(batchSize, [&](vector_size_t j) {
+        return sorted ? row(j) * numPartitions / numRows
+                      : row(j) % numPartitions;
+      });
+      auto c1 = makeFlatVector<int64_t>(
+          batchSize, [&](vector_size_t j) { return row(j); });
+      auto c2 = makeFlatVector<int64_t>(
+          batchSize, [&](vector_size_t j) { return row(j) / 11; });
+      auto c3 = makeFlatVector<int64_t>(
+          batchSize,
+          [&](vector_size_t j) { return row(j) % 17; },
+          nullEvery(9));
+      vectors.push_back(makeRowVector({c0, c1, c2, c3}));
+    }
+    return vectors;
+  }
+
+  void testWindowFunction(
+      const std::vector<RowVectorPtr>& input,
+      const std::vector<std::string>& partitionKeys,
+      const std::vector<std::string>& sortingKeys,
+      const std::string& function,
+      const std::string& duckDbFunction,
+      bool inputsSorted = false) {
+    auto plan =
+        PlanBuilder()
+            .values(input)
+            .window(partitionKeys, sortingKeys, {function}, inputsSorted)
+            .planNode();
+
+    std::string overClause;
+    if (!partitionKeys.empty()) {
+      overClause = "PARTITION BY " + folly::join(", ", partitionKeys);
+    }
+    if (!sortingKeys.empty()) {
+      overClause += " ORDER BY " + folly::join(", ", sortingKeys);
+    }
+    assertQuery(
+        plan,
+        fmt::format(
+            "SELECT *, {} OVER ({}) FROM tmp", duckDbFunction, overClause));
+  }
+};
+
+TEST_F(WindowTest, rankingFunctions) {
+  auto vectors = makeVectors(3, 1'000, false);
+  createDuckDbTable(vectors);
+
+  testWindowFunction(vectors, {"c0"}, {"c1"}, "row_number()", "row_number()");
+  testWindowFunction(
+      vectors, {"c0"}, {"c1 DESC"}, "row_number()", "row_number()");
+  testWindowFunction(vectors, {"c0"}, {"c2"}, "rank()", "rank()");
+  testWindowFunction(
+      vectors, {"c0"}, {"c2 DESC"}, "dense_rank()", "dense_rank()");
+  testWindowFunction(vectors, {}, {"c2"}, "rank()", "rank()");
+  testWindowFunction(vectors, {"c0", "c2"}, {"c1"}, "rank()", "rank()");
+}
+
+TEST_F(WindowTest, aggregateFunctions) {
+  auto vectors = makeVectors(3, 1'000, false);
+  createDuckDbTable(vectors);
+
+  // The default frame is RANGE BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW,
+  // which includes the peers of the current row.
+  testWindowFunction(vectors, {"c0"}, {"c2"}, "sum(c3)", "sum(c3)");
+  testWindowFunction(vectors, {"c0"}, {"c1"}, "count(c3)", "count(c3)");
+  testWindowFunction(vectors, {"c0"}, {}, "max(c3)", "max(c3)");
+
+  const std::vector<std::string> frames = {
+      "ROWS BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW",
+      "ROWS BETWEEN 3 PRECEDING AND CURRENT ROW",
+      "ROWS BETWEEN 2 PRECEDING AND 2 FOLLOWING",
+      "ROWS BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING",
+      "ROWS BETWEEN 5 FOLLOWING AND 10 FOLLOWING",
+      "ROWS BETWEEN 10 PRECEDING AND 5 PRECEDING",
+      "ROWS BETWEEN UNBOUNDED PRECEDING AND UNBOUNDED FOLLOWING",
+      "RANGE BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING",
+      "RANGE BETWEEN CURRENT ROW AND CURRENT ROW",
+  };
+  for (const auto& frame : frames) {
+    SCOPED_TRACE(frame);
+    auto function = fmt::format("sum(c3) {}", frame);
+    testWindowFunction(vectors, {"c0"}, {"c1"}, function, function);
+    testWindowFunction(vectors, {"c0"}, {"c2"}, function, function);
+
+    function = fmt::format("min(c3) {}", frame);
+    testWindowFunction(vectors, {"c0"}, {"c1 DESC"}, function, function);
+  }
+}
+
+TEST_F(WindowTest, multipleFunctions) {
+  auto vectors = makeVectors(2, 1'000, false);
+  createDuckDbTable(vectors);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .window(
+                      {"c0"},
+                      {"c1"},
+                      {"row_number() AS rn",
+                       "avg(c3) ROWS BETWEEN 4 PRECEDING AND CURRENT ROW",
+                       "count(c3) ROWS BETWEEN 1 FOLLOWING AND 3 FOLLOWING"})
+                  .planNode();
+  ASSERT_EQ(
+      plan->outputType()->toString(),
+      "ROW<c0:INTEGER,c1:BIGINT,c2:BIGINT,c3:BIGINT,rn:BIGINT,w1:DOUBLE,"
+      "w2:BIGINT>");
+
+  assertQuery(
+      plan,
+      "SELECT *, row_number() OVER w, "
+      "avg(c3) OVER (w ROWS BETWEEN 4 PRECEDING AND CURRENT ROW), "
+      "count(c3) OVER (w ROWS BETWEEN 1 FOLLOWING AND 3 FOLLOWING) "
+      "FROM tmp WINDOW w AS (PARTITION BY c0 ORDER BY c1)");
+}
+
+TEST_F(WindowTest, sortedInput) {
+  auto vectors = makeVectors(10, 333, true);
+  createDuckDbTable(vectors);
+
+  testWindowFunction(
+      vectors, {"c0"}, {"c1"}, "row_number()", "row_number()", true);
+  testWindowFunction(vectors, {"c0"}, {"c2"}, "rank()", "rank()", true);
+  testWindowFunction(vectors, {"c0"}, {"c1"}, "sum(c3)", "sum(c3)", true);
+  testWindowFunction(
+      vectors,
+      {"c0"},
+      {"c1"},
+      "sum(c3) ROWS BETWEEN 2 PRECEDING AND 2 FOLLOWING",
+      "sum(c3) ROWS BETWEEN 2 PRECEDING AND 2 FOLLOWING",
+      true);
+  testWindowFunction(
+      vectors,
+      {"c0"},
+      {"c1"},
+      "sum(c3) ROWS BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING",
+      "sum(c3) ROWS BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING",
+      true);
+}
+
+TEST_F(WindowTest, columnFrameOffsets) {
+  vector_size_t size = 1'000;
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 5; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 4; }),
+  });
+  createDuckDbTable({data});
+
+  auto plan = PlanBuilder()
+                  .values({data})
+                  .window(
+                      {"c0"},
+                      {"c1"},
+                      {"sum(c1) ROWS BETWEEN c2 PRECEDING AND CURRENT ROW"})
+                  .planNode();
+  assertQuery(
+      plan,
+      "SELECT *, sum(c1) OVER (PARTITION BY c0 ORDER BY c1 "
+      "ROWS BETWEEN c2 PRECEDING AND CURRENT ROW) FROM tmp");
+}
+
+TEST_F(WindowTest, maxFrameOffsets) {
+  auto vectors = makeVectors(2, 500, false);
+  createDuckDbTable(vectors);
+
+  // Offsets of INT64_MAX reach past either end of any partition. DuckDB is
+  // given the equivalent frames.
+  const std::vector<std::pair<std::string, std::string>> frames = {
+      {"ROWS BETWEEN 9223372036854775807 PRECEDING AND CURRENT ROW",
+       "ROWS BETWEEN UNBOUNDED PRECEDING AND CURRENT ROW"},
+      {"ROWS BETWEEN CURRENT ROW AND 9223372036854775807 FOLLOWING",
+       "ROWS BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING"},
+      {"ROWS BETWEEN 9223372036854775807 PRECEDING "
+       "AND 9223372036854775807 FOLLOWING",
+       "ROWS BETWEEN UNBOUNDED PRECEDING AND UNBOUNDED FOLLOWING"},
+      {"ROWS BETWEEN 9223372036854775807 FOLLOWING AND UNBOUNDED FOLLOWING",
+       "ROWS BETWEEN 10000 FOLLOWING AND UNBOUNDED FOLLOWING"},
+      {"ROWS BETWEEN UNBOUNDED PRECEDING AND 9223372036854775807 PRECEDING",
+       "ROWS BETWEEN UNBOUNDED PRECEDING AND 10000 PRECEDING"},
+  };
+  for (const auto& [frame, duckDbFrame] : frames) {
+    SCOPED_TRACE(frame);
+    testWindowFunction(
+        vectors,
+        {"c0"},
+        {"c1"},
+        fmt::format("sum(c3) {}", frame),
+        fmt::format("sum(c3) {}", duckDbFrame));
+  }
+
+  // The same with offsets from a column.
+  vector_size_t size = 1'000;
+  const auto kMaxOffset = std::numeric_limits<int64_t>::max();
+  auto data = makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 5; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(size, [&](auto /*row*/) { return kMaxOffset; }),
+  });
+  createDuckDbTable({data});
+  testWindowFunction(
+      {data},
+      {"c0"},
+      {"c1"},
+      "sum(c1) ROWS BETWEEN c2 PRECEDING AND c2 FOLLOWING",
+      "sum(c1) ROWS BETWEEN UNBOUNDED PRECEDING AND UNBOUNDED FOLLOWING");
+}
+
+TEST_F(WindowTest, unsupportedFrame) {
+  auto vectors = makeVectors(1, 100, false);
+
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .window(
+                      {"c0"},
+                      {"c1"},
+                      {"sum(c3) RANGE BETWEEN 1 PRECEDING AND CURRENT ROW"})
+                  .planNode();
+  VELOX_ASSERT_THROW(
+      assertQuery(plan, "SELECT 1"),
+      "RANGE window frames support only UNBOUNDED and CURRENT ROW bounds");
+}
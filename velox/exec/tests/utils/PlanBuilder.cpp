@@ -17,6 +17,7 @@
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include <velox/core/ITypedExpr.h>
 #include <velox/type/Filter.h>
+#include <regex>
 #include "velox/common/memory/Memory.h"
 #include "velox/connectors/hive/HiveConnector.h"
 #include "velox/connectors/tpch/TpchConnector.h"
@@ -24,6 +25,7 @@
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/RoundRobinPartitionFunction.h"
+#include "velox/exec/WindowFunction.h"
 #include "velox/expression/ExprToSubfieldFilter.h"
 #include "velox/expression/SignatureBinder.h"
 #include "velox/parse/Expressions.h"
@@ -679,6 +681,188 @@ PlanBuilder& PlanBuilder::topN(
   return *this;
 }
 
+namespace {
+// Resolves the result types of window functions. Aggregate functions used
+// as window functions return the type of their single step.
+class WindowTypeResolver {
+ public:
+  WindowTypeResolver() : previousHook_(core::Expressions::getResolverHook()) {
+    core::Expressions::setTypeResolverHook(
+        [&](const auto& inputs, const auto& expr, bool nullOnFailure) {
+          return resolveType(inputs, expr, nullOnFailure);
+        });
+  }
+
+  ~WindowTypeResolver() {
+    core::Expressions::setTypeResolverHook(previousHook_);
+  }
+
+ private:
+  TypePtr resolveType(
+      const std::vector<core::TypedExprPtr>& inputs,
+      const std::shared_ptr<const core::CallExpr>& expr,
+      bool nullOnFailure) const {
+    std::vector<TypePtr> types;
+    for (auto& input : inputs) {
+      types.push_back(input->type());
+    }
+
+    auto functionName = expr->getFunctionName();
+    if (auto signatures = exec::getWindowFunctionSignatures(functionName)) {
+      for (const auto& signature : signatures.value()) {
+        exec::SignatureBinder binder(*signature, types);
+        if (binder.tryBind()) {
+          return binder.tryResolveType(signature->returnType());
+        }
+      }
+
+      if (nullOnFailure) {
+        return nullptr;
+      }
+      VELOX_USER_FAIL(
+          "Window function signature is not supported: {}",
+          toString(functionName, types));
+    }
+
+    return resolveAggregateType(
+        functionName,
+        core::AggregationNode::Step::kSingle,
+        types,
+        nullOnFailure);
+  }
+
+  const core::Expressions::TypeResolverHook previousHook_;
+};
+
+std::string trim(const std::string& text) {
+  auto begin = text.find_first_not_of(' ');
+  if (begin == std::string::npos) {
+    return "";
+  }
+  auto end = text.find_last_not_of(' ');
+  return text.substr(begin, end - begin + 1);
+}
+
+std::pair<core::WindowNode::BoundType, core::TypedExprPtr> parseFrameBound(
+    const std::string& text,
+    const RowTypePtr& inputType,
+    memory::MemoryPool* pool) {
+  static const std::string kPreceding = " preceding";
+  static const std::string kFollowing = " following";
+
+  auto bound = trim(text);
+  std::string lowerBound = bound;
+  std::transform(
+      lowerBound.begin(), lowerBound.end(), lowerBound.begin(), ::tolower);
+  if (lowerBound == "unbounded preceding") {
+    return {core::WindowNode::BoundType::kUnboundedPreceding, nullptr};
+  }
+  if (lowerBound == "unbounded following") {
+    return {core::WindowNode::BoundType::kUnboundedFollowing, nullptr};
+  }
+  if (lowerBound == "current row") {
+    return {core::WindowNode::BoundType::kCurrentRow, nullptr};
+  }
+
+  auto endsWith = [&](const std::string& suffix) {
+    return lowerBound.size() > suffix.size() &&
+        lowerBound.compare(
+            lowerBound.size() - suffix.size(), suffix.size(), suffix) == 0;
+  };
+  auto parseOffset = [&](const std::string& suffix) {
+    return parseExpr(
+        bound.substr(0, bound.size() - suffix.size()), inputType, pool);
+  };
+  if (endsWith(kPreceding)) {
+    return {core::WindowNode::BoundType::kPreceding, parseOffset(kPreceding)};
+  }
+  if (endsWith(kFollowing)) {
+    return {core::WindowNode::BoundType::kFollowing, parseOffset(kFollowing)};
+  }
+  VELOX_USER_FAIL("Invalid window frame bound: {}", text);
+}
+
+// Parses "<call> [ROWS|RANGE BETWEEN <bound> AND <bound>] [AS <alias>]".
+// Returns the call with the alias and the frame.
+std::pair<std::string, core::WindowNode::Frame> parseWindowFunction(
+    const std::string& text,
+    const RowTypePtr& inputType,
+    memory::MemoryPool* pool) {
+  static const std::regex kFramePattern(
+      "(.+?)\\s+(rows|range)\\s+between\\s+(.+?)\\s+and\\s+(.+?)"
+      "(\\s+as\\s+\\w+)?\\s*",
+      std::regex::icase);
+
+  core::WindowNode::Frame frame{
+      core::WindowNode::WindowType::kRange,
+      core::WindowNode::BoundType::kUnboundedPreceding,
+      nullptr,
+      core::WindowNode::BoundType::kCurrentRow,
+      nullptr};
+
+  std::smatch match;
+  if (!std::regex_match(text, match, kFramePattern)) {
+    return {text, frame};
+  }
+
+  std::string windowType = match[2];
+  std::transform(
+      windowType.begin(), windowType.end(), windowType.begin(), ::tolower);
+  frame.type = windowType == "rows" ? core::WindowNode::WindowType::kRows
+                                    : core::WindowNode::WindowType::kRange;
+  std::tie(frame.startType, frame.startValue) =
+      parseFrameBound(match[3], inputType, pool);
+  std::tie(frame.endType, frame.endValue) =
+      parseFrameBound(match[4], inputType, pool);
+  return {std::string(match[1]) + std::string(match[5]), frame};
+}
+} // namespace
+
+PlanBuilder& PlanBuilder::window(
+    const std::vector<std::string>& partitionKeys,
+    const std::vector<std::string>& sortingKeys,
+    const std::vector<std::string>& windowFunctions,
+    bool inputsSorted) {
+  const auto& inputType = planNode_->outputType();
+  auto [sortingKeyExprs, sortingOrders] =
+      parseOrderByClauses(sortingKeys, inputType, pool_);
+
+  WindowTypeResolver resolver;
+  std::vector<core::WindowNode::Function> functions;
+  std::vector<std::string> names;
+  functions.reserve(windowFunctions.size());
+  names.reserve(windowFunctions.size());
+  for (auto i = 0; i < windowFunctions.size(); ++i) {
+    auto [call, frame] =
+        parseWindowFunction(windowFunctions[i], inputType, pool_);
+    auto untypedExpr = duckdb::parseExpr(call);
+    auto callExpr = std::dynamic_pointer_cast<const core::CallTypedExpr>(
+        inferTypes(untypedExpr));
+    VELOX_CHECK_NOT_NULL(
+        callExpr,
+        "Window function must be a function call: {}",
+        windowFunctions[i]);
+    functions.push_back({callExpr, frame, false});
+
+    if (untypedExpr->alias().has_value()) {
+      names.push_back(untypedExpr->alias().value());
+    } else {
+      names.push_back(fmt::format("w{}", i));
+    }
+  }
+
+  planNode_ = std::make_shared<core::WindowNode>(
+      nextPlanNodeId(),
+      fields(partitionKeys),
+      sortingKeyExprs,
+      sortingOrders,
+      std::move(names),
+      std::move(functions),
+      planNode_,
+      inputsSorted);
+  return *this;
+}
+
 PlanBuilder& PlanBuilder::limit(int32_t offset, int32_t count, bool isPartial) {
   planNode_ = std::make_shared<core::LimitNode>(
       nextPlanNodeId(), offset, count, isPartial, planNode_);
@@ -478,6 +478,34 @@ class PlanBuilder {
   PlanBuilder&
   topN(const std::vector<std::string>& keys, int32_t count, bool isPartial);
 
+  /// Add a WindowNode using specified PARTITION BY keys, ORDER BY clauses and
+  /// window functions. The output has the input columns followed by one
+  /// column per window function.
+  ///
+  /// For example,
+  ///
+  ///     .window(
+  ///         {"a"},
+  ///         {"b DESC"},
+  ///         {"row_number() AS rn",
+  ///          "sum(c) ROWS BETWEEN 2 PRECEDING AND CURRENT ROW AS s"})
+  ///
+  /// A window function is a call to a window or aggregate function followed
+  /// by an optional frame and an optional alias. The frame is either
+  /// ROWS or RANGE BETWEEN <bound> AND <bound>, where a bound is UNBOUNDED
+  /// PRECEDING, <expr> PRECEDING, CURRENT ROW, <expr> FOLLOWING or UNBOUNDED
+  /// FOLLOWING. The default frame is RANGE BETWEEN UNBOUNDED PRECEDING AND
+  /// CURRENT ROW. If an alias is not specified, the output column name is
+  /// generated as "w0", "w1", etc.
+  ///
+  /// @param inputsSorted Indicates that the input is clustered on
+  /// 'partitionKeys' and sorted on 'sortingKeys' within each partition.
+  PlanBuilder& window(
+      const std::vector<std::string>& partitionKeys,
+      const std::vector<std::string>& sortingKeys,
+      const std::vector<std::string>& windowFunctions,
+      bool inputsSorted = false);
+
   /// Add a LimitNode.
   ///
   /// @param offset Offset, i.e. number of rows of input to skip.
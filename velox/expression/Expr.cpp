@@ -19,6 +19,7 @@
 
 #include "velox/common/base/SuccinctPrinter.h"
 #include "velox/core/Expressions.h"
+#include "velox/expression/ConstantExpr.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/ExprCompiler.h"
 #include "velox/expression/FieldReference.h"
@@ -953,7 +954,10 @@ void Expr::evalAll(
     }
   }
 
-  if (!tryPeelArgs ||
+  if (resultCache_ && inputValues_[resultCacheArg_]->isFlatEncoding()) {
+    applyFunctionWithResultCache(*remainingRows, context, result);
+  } else if (
+      !tryPeelArgs ||
       !applyFunctionWithPeeling(rows, *remainingRows, context, result)) {
     applyFunction(*remainingRows, context, result);
   }
@@ -1120,6 +1124,89 @@ void Expr::applyFunction(
   }
 }
 
+void Expr::enableResultCache(
+    uint32_t maxEntries,
+    memory::MemoryPool* pool) {
+  if (maxEntries == 0 || !vectorFunction_ || specialForm_ ||
+      !deterministic_ || !ExprResultCache::isSupportedType(type_)) {
+    return;
+  }
+  int32_t keyArg = -1;
+  for (auto i = 0; i < inputs_.size(); ++i) {
+    if (dynamic_cast<const ConstantExpr*>(inputs_[i].get())) {
+      continue;
+    }
+    if (keyArg >= 0) {
+      return;
+    }
+    keyArg = i;
+  }
+  if (keyArg < 0) {
+    return;
+  }
+  const auto keyKind = inputs_[keyArg]->type()->kind();
+  if (keyKind != TypeKind::VARCHAR && keyKind != TypeKind::VARBINARY) {
+    return;
+  }
+  resultCacheArg_ = keyArg;
+  resultCache_ = std::make_unique<ExprResultCache>(type_, maxEntries, pool);
+}
+
+void Expr::applyFunctionWithResultCache(
+    const SelectivityVector& rows,
+    EvalCtx& context,
+    VectorPtr& result) {
+  // The extra reference keeps the function from writing its result over
+  // the keys.
+  const VectorPtr keysHolder = inputValues_[resultCacheArg_];
+  const auto& keys = *keysHolder->asUnchecked<FlatVector<StringView>>();
+  LocalSelectivityVector hitsHolder(context, rows.end());
+  LocalSelectivityVector missesHolder(context, rows.end());
+  LocalSelectivityVector repeatsHolder(context, rows.end());
+  auto& hits = *hitsHolder.get();
+  auto& misses = *missesHolder.get();
+  auto& repeats = *repeatsHolder.get();
+  resultCache_->lookup(rows, keys, hits, misses, repeats);
+
+  if (misses.hasSelections()) {
+    applyFunction(misses, context, result);
+    if (auto* errors = context.errors()) {
+      // A repeat fails like the row it repeats. Failed rows are not cached.
+      repeats.applyToSelected([&](auto row) {
+        const auto repeated = resultCache_->repeatedRow(row);
+        if (repeated < errors->size() && !errors->isNullAt(repeated)) {
+          context.setError(
+              row,
+              *std::static_pointer_cast<std::exception_ptr>(
+                  errors->valueAt(repeated)));
+        }
+      });
+      deselectErrors(context, repeats);
+      deselectErrors(context, misses);
+    }
+    if (result) {
+      resultCache_->add(misses, keys, *result);
+    }
+  }
+  if (hits.hasSelections()) {
+    BaseVector::ensureWritable(hits, type(), context.pool(), &result);
+    resultCache_->copyHits(hits, *result);
+  }
+  if (repeats.hasSelections()) {
+    BaseVector::ensureWritable(repeats, type(), context.pool(), &result);
+    resultCache_->copyRepeats(repeats, *result);
+  }
+
+  const auto numSaved = hits.countSelected() + repeats.countSelected();
+  if (numSaved > 0) {
+    stats_.runtimeStats["resultCacheHits"].addValue(numSaved);
+  }
+  resultCache_->endBatch();
+  if (!resultCache_->enabled()) {
+    resultCache_.reset();
+  }
+}
+
 void Expr::applyVectorFunction(
     const SelectivityVector& rows,
     EvalCtx& context,
@@ -1200,7 +1287,11 @@ void printExprTree(
   if (withStats) {
     out << " [cpu time: " << succinctNanos(stats.timing.cpuNanos)
         << ", rows: " << stats.numProcessedRows
-        << ", batches: " << stats.numProcessedVectors << "]";
+        << ", batches: " << stats.numProcessedVectors;
+    for (const auto& [name, metric] : stats.runtimeStats) {
+      out << ", " << name << ": " << metric.sum;
+    }
+    out << "]";
   }
   out << " -> " << expr.type()->toString() << " [#" << id << "]" << std::endl;
 
@@ -1211,6 +1302,15 @@ void printExprTree(
 }
 } // namespace
 
+ExprStats Expr::stats() const {
+  if (!vectorFunction_) {
+    return stats_;
+  }
+  auto stats = stats_;
+  vectorFunction_->addRuntimeStats(stats.runtimeStats);
+  return stats;
+}
+
 std::string Expr::toString(bool recursive) const {
   if (recursive) {
     std::stringstream out;
@@ -1263,8 +1363,9 @@ void addStats(
   uniqueExprs.insert(&expr);
 
   // Do not aggregate empty stats.
-  if (expr.stats().numProcessedRows) {
-    stats[expr.name()].add(expr.stats());
+  const auto exprStats = expr.stats();
+  if (exprStats.numProcessedRows || !exprStats.runtimeStats.empty()) {
+    stats[expr.name()].add(exprStats);
   }
 
   for (const auto& input : expr.inputs()) {
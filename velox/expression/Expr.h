@@ -20,10 +20,12 @@
 
 #include <folly/container/F14Map.h>
 
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/core/Expressions.h"
 #include "velox/expression/DecodedArgs.h"
 #include "velox/expression/EvalCtx.h"
+#include "velox/expression/ExprResultCache.h"
 #include "velox/vector/SimpleVector.h"
 
 namespace facebook::velox::exec {
@@ -43,10 +45,17 @@ struct ExprStats {
   /// size.
   uint64_t numProcessedVectors{0};
 
+  /// Statistics specific to the function, e.g. cache hits. See
+  /// VectorFunction::addRuntimeStats().
+  std::unordered_map<std::string, RuntimeMetric> runtimeStats;
+
   void add(const ExprStats& other) {
     timing.add(other.timing);
     numProcessedRows += other.numProcessedRows;
     numProcessedVectors += other.numProcessedVectors;
+    for (const auto& [name, metric] : other.runtimeStats) {
+      runtimeStats.try_emplace(name, metric.unit).first->second.merge(metric);
+    }
   }
 };
 
@@ -185,8 +194,18 @@ class Expr {
   /// their inputs recursively.
   virtual std::string toString(bool recursive = true) const;
 
-  const ExprStats& stats() const {
-    return stats_;
+  /// Returns the stats of this expression, including the runtime stats of
+  /// its function.
+  ExprStats stats() const;
+
+  /// Keeps up to 'maxEntries' results of the function across batches, keyed
+  /// on the value of its argument, if the function is deterministic, all
+  /// but one argument are constant and that argument is a string. See
+  /// ExprResultCache. No-op otherwise.
+  void enableResultCache(uint32_t maxEntries, memory::MemoryPool* pool);
+
+  bool hasResultCache() const {
+    return resultCache_ != nullptr;
   }
 
  private:
@@ -260,6 +279,13 @@ class Expr {
       EvalCtx& context,
       VectorPtr& result);
 
+  // Calls the function for the rows of 'rows' whose argument value is not
+  // in 'resultCache_' and copies the results of the others.
+  void applyFunctionWithResultCache(
+      const SelectivityVector& rows,
+      EvalCtx& context,
+      VectorPtr& result);
+
   // Calls 'vectorFunction_' on values in 'inputValues_'.
   void applyVectorFunction(
       const SelectivityVector& rows,
@@ -362,6 +388,13 @@ class Expr {
   // Count of times the cacheable vector is seen for a non-first time.
   int32_t numCacheableRepeats_{0};
 
+  // Results by argument value kept across batches. Set by
+  // enableResultCache().
+  std::unique_ptr<ExprResultCache> resultCache_;
+
+  // The argument 'resultCache_' is keyed on.
+  int32_t resultCacheArg_{-1};
+
   /// Runtime statistics. CPU time, wall time and number of processed rows.
   ExprStats stats_;
 };
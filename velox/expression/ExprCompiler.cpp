@@ -440,6 +440,9 @@ ExprPtr compileExpression(
 
   auto folded =
       enableConstantFolding ? tryFoldIfConstant(result, scope) : result;
+  if (folded == result) {
+    result->enableResultCache(config.exprResultCacheMaxEntries(), pool);
+  }
   scope->visited[expr.get()] = folded;
   return folded;
 }
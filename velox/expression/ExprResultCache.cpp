@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/expression/ExprResultCache.h"
+
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::exec {
+
+namespace {
+// Sets 'values[index]' to 'decoded[row]'. Strings are copied into the
+// buffers of 'values' so that the cache does not hold on to the buffers of
+// the batches it has seen.
+template <TypeKind kind>
+void setValue(
+    BaseVector& values,
+    vector_size_t index,
+    const DecodedVector& decoded,
+    vector_size_t row) {
+  using T = typename TypeTraits<kind>::NativeType;
+  auto* flat = values.asUnchecked<FlatVector<T>>();
+  if (decoded.isNullAt(row)) {
+    flat->setNull(index, true);
+  } else {
+    flat->set(index, decoded.valueAt<T>(row));
+  }
+}
+} // namespace
+
+// static
+bool ExprResultCache::isSupportedType(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::REAL:
+    case TypeKind::DOUBLE:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+    case TypeKind::TIMESTAMP:
+    case TypeKind::DATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+ExprResultCache::ExprResultCache(
+    TypePtr type,
+    uint32_t maxEntries,
+    memory::MemoryPool* pool)
+    : maxEntries_(maxEntries), values_(BaseVector::create(type, 0, pool)) {
+  VELOX_CHECK(isSupportedType(values_->type()));
+}
+
+void ExprResultCache::lookup(
+    const SelectivityVector& rows,
+    const FlatVector<StringView>& keys,
+    SelectivityVector& hits,
+    SelectivityVector& misses,
+    SelectivityVector& repeats) {
+  VELOX_DCHECK(enabled_);
+  hits.clearAll();
+  misses.clearAll();
+  repeats.clearAll();
+  batchIndex_.clear();
+  if (sourceRows_.size() < rows.end()) {
+    sourceRows_.resize(rows.end());
+  }
+  batchSaved_ = 0;
+  batchRows_ = 0;
+  rows.applyToSelected([&](vector_size_t row) {
+    ++batchRows_;
+    // The value under a null is undefined and may equal a cached key.
+    if (keys.isNullAt(row)) {
+      misses.setValid(row, true);
+      return;
+    }
+    const auto value = keys.valueAtFast(row);
+    const std::string_view key(value.data(), value.size());
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      hits.setValid(row, true);
+      sourceRows_[row] = it->second;
+      ++batchSaved_;
+      return;
+    }
+    auto [first, inserted] = batchIndex_.try_emplace(key, row);
+    if (inserted) {
+      misses.setValid(row, true);
+    } else {
+      repeats.setValid(row, true);
+      sourceRows_[row] = first->second;
+      ++batchSaved_;
+    }
+  });
+  hits.updateBounds();
+  misses.updateBounds();
+  repeats.updateBounds();
+}
+
+void ExprResultCache::copyHits(
+    const SelectivityVector& hits,
+    BaseVector& result) const {
+  result.copy(values_.get(), hits, sourceRows_.data());
+}
+
+void ExprResultCache::copyRepeats(
+    const SelectivityVector& repeats,
+    BaseVector& result) const {
+  // 'repeats' and the rows they copy from are disjoint.
+  result.copy(&result, repeats, sourceRows_.data());
+}
+
+void ExprResultCache::add(
+    const SelectivityVector& misses,
+    const FlatVector<StringView>& keys,
+    const BaseVector& result) {
+  if (index_.size() >= maxEntries_ || !misses.hasSelections()) {
+    return;
+  }
+  DecodedVector decoded(result, misses);
+  misses.testSelected([&](vector_size_t row) {
+    if (keys.isNullAt(row)) {
+      return true;
+    }
+    const auto index = index_.size();
+    index_.emplace(std::string(keys.valueAtFast(row)), index);
+    if (values_->size() <= index) {
+      values_->resize(std::max<vector_size_t>(16, 2 * index));
+    }
+    VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+        setValue, values_->typeKind(), *values_, index, decoded, row);
+    return index_.size() < maxEntries_;
+  });
+}
+
+void ExprResultCache::endBatch() {
+  windowSaved_ += batchSaved_;
+  windowRows_ += batchRows_;
+  batchSaved_ = 0;
+  batchRows_ = 0;
+  if (windowRows_ < kHitRatioWindow) {
+    return;
+  }
+  if (windowSaved_ < kMinHitRatio * windowRows_) {
+    enabled_ = false;
+    index_.clear();
+    batchIndex_.clear();
+    values_->resize(0);
+  }
+  windowSaved_ = 0;
+  windowRows_ = 0;
+}
+
+} // namespace facebook::velox::exec
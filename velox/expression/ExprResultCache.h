@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/container/F14Map.h>
+
+#include "velox/vector/FlatVector.h"
+#include "velox/vector/SelectivityVector.h"
+
+namespace facebook::velox::exec {
+
+/// Results of a deterministic function keyed on the value of its only
+/// non-constant argument, which is a string. Unlike the memo of results
+/// over a dictionary base, the cache is kept across batches, so that it
+/// helps also when a low cardinality column arrives flat. Within a batch,
+/// the function is evaluated once per distinct uncached value.
+///
+/// Holds at most 'maxEntries' results. Values first seen when the cache is
+/// full are not added. The cache turns itself off when fewer than
+/// kMinHitRatio of the rows in a window of kHitRatioWindow rows are
+/// served from the cache or from an earlier row of the same batch.
+class ExprResultCache {
+ public:
+  static constexpr int64_t kHitRatioWindow = 10'000;
+  static constexpr double kMinHitRatio = 0.5;
+
+  /// Returns true if results of 'type' can be cached.
+  static bool isSupportedType(const TypePtr& type);
+
+  ExprResultCache(
+      TypePtr type,
+      uint32_t maxEntries,
+      memory::MemoryPool* FOLLY_NONNULL pool);
+
+  /// Looks up 'keys' for 'rows' and splits 'rows' three ways. 'hits' gets
+  /// the rows with a cached result, 'misses' the first row of each
+  /// uncached value and 'repeats' the later rows of the same values. Rows
+  /// with a null key are always in 'misses'. The function must be
+  /// evaluated for 'misses'. 'hits', 'misses' and 'repeats' must be sized
+  /// at least rows.end().
+  void lookup(
+      const SelectivityVector& rows,
+      const FlatVector<StringView>& keys,
+      SelectivityVector& hits,
+      SelectivityVector& misses,
+      SelectivityVector& repeats);
+
+  /// Returns the row of 'misses' whose value 'row' of 'repeats' repeats.
+  vector_size_t repeatedRow(vector_size_t row) const {
+    return sourceRows_[row];
+  }
+
+  /// Copies the cached results of 'hits' to 'result', which must be
+  /// writable for 'hits'.
+  void copyHits(const SelectivityVector& hits, BaseVector& result) const;
+
+  /// Copies the results of the repeated rows of 'misses' to 'repeats' of
+  /// 'result', which must be writable for 'repeats'.
+  void copyRepeats(const SelectivityVector& repeats, BaseVector& result)
+      const;
+
+  /// Adds the values of 'result' for 'misses' keyed on 'keys' while there
+  /// is room. Rows with a null key are not added.
+  void add(
+      const SelectivityVector& misses,
+      const FlatVector<StringView>& keys,
+      const BaseVector& result);
+
+  /// Accounts the last lookup() to the hit ratio and turns the cache off if
+  /// too few rows were spared an evaluation. Call after the results of the
+  /// batch have been taken.
+  void endBatch();
+
+  /// False after the hit ratio has dropped below kMinHitRatio. The cache
+  /// then holds no results and must not be used.
+  bool enabled() const {
+    return enabled_;
+  }
+
+  int32_t size() const {
+    return index_.size();
+  }
+
+ private:
+  const uint32_t maxEntries_;
+
+  // The cached results. A key maps to a position here.
+  VectorPtr values_;
+
+  folly::F14FastMap<std::string, vector_size_t> index_;
+
+  // The first row of each uncached value in the last lookup(). The keys
+  // point into the batch.
+  folly::F14FastMap<std::string_view, vector_size_t> batchIndex_;
+
+  // For each row of the last lookup(), the position in 'values_' for a hit
+  // or the first row with the same value for a repeat.
+  std::vector<vector_size_t> sourceRows_;
+
+  int64_t batchSaved_{0};
+  int64_t batchRows_{0};
+  int64_t windowSaved_{0};
+  int64_t windowRows_{0};
+  bool enabled_{true};
+};
+
+} // namespace facebook::velox::exec
@@ -49,6 +49,18 @@ struct IsMapWriter<MapWriter<K, V>> {
   static constexpr bool value = true;
 };
 
+// True for readers of fixed-width values in flat or constant vectors, which
+// can be read directly from a values buffer.
+template <typename T>
+struct IsFixedWidthFlatConstantReader {
+  static constexpr bool value = false;
+};
+
+template <typename T>
+struct IsFixedWidthFlatConstantReader<ConstantFlatVectorReader<T>> {
+  static constexpr bool value = CppToType<T>::isFixedWidth;
+};
+
 template <typename FUNC>
 class SimpleFunctionAdapter : public VectorFunction {
   using T = typename FUNC::exec_return_type;
@@ -67,6 +79,11 @@ class SimpleFunctionAdapter : public VectorFunction {
   static constexpr bool fastPathIteration =
       return_type_traits::isPrimitiveType && return_type_traits::isFixedWidth;
 
+  // The dense loop is specialized for flat and constant vectors for this many
+  // leading arguments. This bounds the number of specializations to
+  // 2 ^ kMaxDenseSpecializedArgs. Later arguments use the reader as is.
+  static constexpr int32_t kMaxDenseSpecializedArgs = 3;
+
   template <int32_t POSITION>
   static constexpr bool isArgFlatConstantFastPathEligible =
       CppToType<arg_at<POSITION>>::typeKind !=
@@ -561,6 +578,20 @@ class SimpleFunctionAdapter : public VectorFunction {
 
     // Iterate the rows.
     if constexpr (fastPathIteration) {
+      // If all arguments are fixed-width values in flat or constant vectors
+      // without nulls, run a tight loop over the values buffers or the
+      // function's callBatch().
+      if constexpr ((IsFixedWidthFlatConstantReader<TReader>::value && ...)) {
+        if (allNotNull && applyContext.rows->isAllSelected()) {
+          if constexpr (FUNC::udf_has_callBatch) {
+            applyBatch(applyContext, readers...);
+          } else {
+            applyDense<0>(applyContext, std::forward_as_tuple(readers...));
+          }
+          return;
+        }
+      }
+
       uint64_t* nullBuffer = nullptr;
       auto* data = applyContext.result->mutableRawValues();
       auto writeResult = [&applyContext, &nullBuffer, &data](
@@ -662,6 +693,156 @@ class SimpleFunctionAdapter : public VectorFunction {
     }
   }
 
+  // Replaces the readers in 'readers' with DenseVectorReaders one at a time
+  // and runs the dense loop with the result.
+  template <int32_t POSITION, typename TReaders, typename... TDenseReader>
+  void applyDense(
+      ApplyContext& applyContext,
+      const TReaders& readers,
+      const TDenseReader&... denseReaders) const {
+    if constexpr (POSITION == FUNC::num_args) {
+      if constexpr (return_type_traits::typeKind == TypeKind::BOOLEAN) {
+        iterateDenseBool(applyContext, denseReaders...);
+      } else {
+        iterateDense(applyContext, denseReaders...);
+      }
+    } else if constexpr (POSITION < kMaxDenseSpecializedArgs) {
+      const auto& reader = std::get<POSITION>(readers);
+      if (reader.isConstant()) {
+        applyDense<POSITION + 1>(
+            applyContext,
+            readers,
+            denseReaders...,
+            DenseVectorReader<arg_at<POSITION>, true>(reader));
+      } else {
+        applyDense<POSITION + 1>(
+            applyContext,
+            readers,
+            denseReaders...,
+            DenseVectorReader<arg_at<POSITION>, false>(reader));
+      }
+    } else {
+      applyDense<POSITION + 1>(
+          applyContext, readers, denseReaders..., std::get<POSITION>(readers));
+    }
+  }
+
+  template <typename... TReader>
+  FOLLY_ALWAYS_INLINE bool
+  doApplyDense(vector_size_t row, T& out, const TReader&... readers) const {
+    if constexpr (FUNC::udf_has_callNullFree) {
+      return doApplyNullFree<0>(row, out, readers...);
+    } else {
+      return doApplyNotNull<0>(row, out, readers...);
+    }
+  }
+
+  // Computes all rows, which are 0 to rows->end(), without going through
+  // the selectivity vector. After an error, the loop resumes at the next row,
+  // so that each row is computed once. This matters because the result may
+  // be one of the arguments.
+  template <typename... TReader>
+  void iterateDense(ApplyContext& applyContext, const TReader&... readers)
+      const {
+    auto* data = applyContext.result->mutableRawValues();
+    const auto end = applyContext.rows->end();
+    vector_size_t row = 0;
+    while (row < end) {
+      try {
+        for (; row < end; ++row) {
+          typename return_type_traits::NativeType out{};
+          if (doApplyDense(row, out, readers...)) {
+            data[row] = out;
+          } else {
+            bits::setNull(applyContext.result->mutableRawNulls(), row);
+          }
+        }
+      } catch (const std::exception& e) {
+        applyContext.context->setError(row, std::current_exception());
+        ++row;
+      }
+    }
+  }
+
+  // Like iterateDense() for a boolean result. Results are collected in a
+  // word at a time instead of setting one bit per row. After an error, the
+  // rows of the word are computed again one at a time. A boolean result never
+  // shares a buffer with the arguments.
+  template <typename... TReader>
+  void iterateDenseBool(ApplyContext& applyContext, const TReader&... readers)
+      const {
+    auto* data = applyContext.result->template mutableRawValues<uint64_t>();
+    auto applyRow = [&](vector_size_t row) {
+      try {
+        bool out{};
+        if (doApplyDense(row, out, readers...)) {
+          bits::setBit(data, row, out);
+        } else {
+          bits::setNull(applyContext.result->mutableRawNulls(), row);
+        }
+      } catch (const std::exception& e) {
+        applyContext.context->setError(row, std::current_exception());
+      }
+    };
+    const auto end = applyContext.rows->end();
+    bits::forEachWord(
+        0,
+        end,
+        [&](int32_t index, uint64_t /*mask*/) {
+          // The rows start at 0, so only the last word can be partial.
+          for (auto row = index * 64; row < end; ++row) {
+            applyRow(row);
+          }
+        },
+        [&](int32_t index) {
+          const auto begin = index * 64;
+          try {
+            uint64_t word = 0;
+            uint64_t nullWord = 0;
+            for (auto i = 0; i < 64; ++i) {
+              bool out{};
+              const bool notNull = doApplyDense(begin + i, out, readers...);
+              word |= static_cast<uint64_t>(out) << i;
+              nullWord |= static_cast<uint64_t>(!notNull) << i;
+            }
+            data[index] = word;
+            if (nullWord) {
+              applyContext.result->mutableRawNulls()[index] &= ~nullWord;
+            }
+          } catch (const std::exception& e) {
+            for (auto row = begin; row < begin + 64; ++row) {
+              applyRow(row);
+            }
+          }
+        });
+  }
+
+  // Passes all rows, which are 0 to rows->end(), to the function's
+  // callBatch(). Constant arguments are expanded into buffers. If
+  // callBatch() throws, all rows get the error.
+  template <typename... TReader>
+  void applyBatch(ApplyContext& applyContext, const TReader&... readers) const {
+    const auto size = applyContext.rows->end();
+    std::vector<BufferPtr> expandedConstants;
+    auto batchArg = [&](const auto& reader) {
+      using value_t = std::remove_const_t<
+          std::remove_pointer_t<decltype(reader.rawValues())>>;
+      if (!reader.isConstant()) {
+        return reader.rawValues();
+      }
+      expandedConstants.push_back(AlignedBuffer::allocate<value_t>(
+          size, applyContext.context->pool(), *reader.rawValues()));
+      return expandedConstants.back()->template as<value_t>();
+    };
+    try {
+      (*fn_).callBatch(
+          applyContext.result->mutableRawValues(), batchArg(readers)..., size);
+    } catch (const std::exception& e) {
+      applyContext.context->setErrors(
+          *applyContext.rows, std::current_exception());
+    }
+  }
+
   template <typename Func>
   void applyUdf(ApplyContext& applyContext, Func func) const {
     if constexpr (IsArrayWriter<T>::value || IsMapWriter<T>::value) {
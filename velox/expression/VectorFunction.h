@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <unordered_map>
 #include <vector>
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/FunctionSignature.h"
 #include "velox/vector/SelectivityVector.h"
@@ -85,6 +87,12 @@ class VectorFunction {
     return true;
   }
 
+  /// Adds statistics specific to the function, e.g. cache hits, to 'stats'.
+  /// Called when the stats of an expression are collected. The values cover
+  /// all calls to apply() since the function was created.
+  virtual void addRuntimeStats(
+      std::unordered_map<std::string, RuntimeMetric>& /*stats*/) const {}
+
   // Returns true if null in any argument always produces null result.
   // In this case, "rows" in "apply" will point only to positions for
   // which all arguments are not null.
@@ -155,6 +155,14 @@ struct ConstantFlatVectorReader {
   // Scalars don't have children, so this is a no-op.
   void setChildrenMayHaveNulls() {}
 
+  const exec_in_t* rawValues() const {
+    return rawValues_;
+  }
+
+  bool isConstant() const {
+    return indexMultiple_ == 0;
+  }
+
   const exec_in_t* rawValues_;
   const uint64_t* rawNulls_;
   // Flat Vectors use an identity mapping for indices, Constant Vectors map all
@@ -163,6 +171,35 @@ struct ConstantFlatVectorReader {
   const vector_size_t indexMultiple_;
 };
 
+// Reads the values of a flat vector or the value of a constant vector
+// without nulls. Unlike ConstantFlatVectorReader, whether the vector is
+// constant is known at compile time, so that a loop over the rows has no
+// index arithmetic and constant values are kept in registers. This lets the
+// compiler vectorize the loop.
+template <typename T, bool isConstant>
+struct DenseVectorReader {
+  using exec_in_t = typename VectorExec::template resolver<T>::in_type;
+
+  explicit DenseVectorReader(const ConstantFlatVectorReader<T>& reader)
+      : rawValues_(reader.rawValues()),
+        value_(isConstant ? reader.rawValues()[0] : exec_in_t{}) {}
+
+  exec_in_t operator[](vector_size_t offset) const {
+    if constexpr (isConstant) {
+      return value_;
+    } else {
+      return rawValues_[offset];
+    }
+  }
+
+  exec_in_t readNullFree(vector_size_t offset) const {
+    return operator[](offset);
+  }
+
+  const exec_in_t* rawValues_;
+  const exec_in_t value_;
+};
+
 namespace detail {
 
 template <typename TOut>
@@ -2828,3 +2828,142 @@ TEST_F(ExprTest, lambdaWithRowField) {
 
   assertEqualVectors(array, evalResult);
 }
+
+TEST_F(ExprTest, resultCache) {
+  queryCtx_->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kExprResultCacheMaxEntries, "3"}});
+  auto rowType = ROW({"c0", "c1"}, {VARCHAR(), VARCHAR()});
+
+  // Values longer than inline strings, so that the cached results own
+  // string buffers.
+  std::vector<std::string> words = {
+      "apples and pears",
+      "bananas and dates",
+      "cherries and figs",
+      "durians and limes"};
+  std::vector<std::string> upperWords = {
+      "APPLES AND PEARS",
+      "BANANAS AND DATES",
+      "CHERRIES AND FIGS",
+      "DURIANS AND LIMES"};
+  auto makeInput = [&](int32_t batch) {
+    return makeRowVector({
+        makeFlatVector<StringView>(
+            100,
+            [&](auto row) { return StringView(words[(row + batch) % 4]); }),
+        makeFlatVector<StringView>(
+            100, [&](auto /*row*/) { return StringView("x"); }),
+    });
+  };
+
+  auto exprSet = compileExpression("upper(c0)", rowType);
+  ASSERT_TRUE(exprSet->expr(0)->hasResultCache());
+  for (auto batch = 0; batch < 3; ++batch) {
+    auto result = evaluate(exprSet.get(), makeInput(batch));
+    assertEqualVectors(
+        makeFlatVector<StringView>(
+            100,
+            [&](auto row) {
+              return StringView(upperWords[(row + batch) % 4]);
+            }),
+        result);
+  }
+  // The first batch evaluates the first row of each value and caches 3 of
+  // the 4 values. The next batches evaluate the first row of the fourth.
+  auto stats = exprSet->expr(0)->stats();
+  EXPECT_EQ(stats.runtimeStats.at("resultCacheHits").sum, 96 + 99 + 99);
+  EXPECT_EQ(stats.numProcessedRows, 4 + 1 + 1);
+
+  // Not cached with more than one non-constant argument.
+  exprSet = compileExpression("concat(c0, c1)", rowType);
+  ASSERT_FALSE(exprSet->expr(0)->hasResultCache());
+  exprSet = compileExpression("concat(c0, 'x')", rowType);
+  ASSERT_TRUE(exprSet->expr(0)->hasResultCache());
+
+  // A value seen only once in a window turns the cache off.
+  exprSet = compileExpression("upper(c0)", rowType);
+  std::vector<std::string> values;
+  for (auto i = 0; i < exec::ExprResultCache::kHitRatioWindow; ++i) {
+    values.push_back(fmt::format("value {}", i));
+  }
+  auto distinct = makeRowVector({
+      makeFlatVector<StringView>(
+          values.size(), [&](auto row) { return StringView(values[row]); }),
+      makeFlatVector<StringView>(
+          values.size(), [&](auto /*row*/) { return StringView("x"); }),
+  });
+  auto result = evaluate(exprSet.get(), distinct);
+  EXPECT_EQ(
+      result->as<SimpleVector<StringView>>()->valueAt(7).str(), "VALUE 7");
+  EXPECT_FALSE(exprSet->expr(0)->hasResultCache());
+}
+
+TEST_F(ExprTest, resultCacheErrors) {
+  queryCtx_->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kExprResultCacheMaxEntries, "100"}});
+  auto exprSet =
+      compileExpression("try(from_hex(c0))", ROW({"c0"}, {VARCHAR()}));
+  ASSERT_TRUE(exprSet->expr(0)->inputs()[0]->hasResultCache());
+
+  // Repeats of a failing value fail as well. Failures are not cached.
+  for (auto batch = 0; batch < 2; ++batch) {
+    auto result = evaluate(
+        exprSet.get(),
+        makeRowVector({makeFlatVector<std::string>(
+            {"616263", "zz", "616263", "zz", "61"})}));
+    auto values = result->as<SimpleVector<StringView>>();
+    EXPECT_EQ(values->valueAt(0).str(), "abc");
+    EXPECT_TRUE(values->isNullAt(1));
+    EXPECT_EQ(values->valueAt(2).str(), "abc");
+    EXPECT_TRUE(values->isNullAt(3));
+    EXPECT_EQ(values->valueAt(4).str(), "a");
+  }
+}
+
+namespace {
+// Does not propagate nulls, so that null keys reach the result cache.
+template <typename T>
+struct DescribeNullableFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE bool callNullable(
+      out_type<Varchar>& out,
+      const arg_type<Varchar>* input) {
+    if (input) {
+      out += "[";
+      out += *input;
+      out += "]";
+    } else {
+      out += "null";
+    }
+    return true;
+  }
+};
+} // namespace
+
+TEST_F(ExprTest, resultCacheNulls) {
+  registerFunction<DescribeNullableFunction, Varchar, Varchar>(
+      {"describe_nullable"});
+  queryCtx_->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kExprResultCacheMaxEntries, "100"}});
+  auto exprSet =
+      compileExpression("describe_nullable(c0)", ROW({"c0"}, {VARCHAR()}));
+  ASSERT_TRUE(exprSet->expr(0)->hasResultCache());
+
+  // The value under a null is "". Nulls must neither hit nor be cached as
+  // "".
+  for (auto batch = 0; batch < 3; ++batch) {
+    auto result = evaluate(
+        exprSet.get(),
+        makeRowVector({makeNullableFlatVector<std::string>(
+            {"", std::nullopt, "", std::nullopt, "a"})}));
+    assertEqualVectors(
+        makeFlatVector<std::string>({"[]", "null", "[]", "null", "[a]"}),
+        result);
+  }
+  // Null rows are evaluated in every batch. The first batch evaluates ""
+  // and "a" once.
+  auto stats = exprSet->expr(0)->stats();
+  EXPECT_EQ(stats.runtimeStats.at("resultCacheHits").sum, 1 + 3 + 3);
+  EXPECT_EQ(stats.numProcessedRows, 4 + 2 + 2);
+}
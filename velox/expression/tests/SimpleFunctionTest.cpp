@@ -20,6 +20,7 @@
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/expression/Expr.h"
 #include "velox/functions/Udf.h"
 #include "velox/functions/prestosql/tests/FunctionBaseTest.h"
@@ -1036,4 +1037,131 @@ TEST_F(SimpleFunctionTest, variadicReuseNoArgsDifferentType) {
   ASSERT_NE(resultPtr.get(), capturedArg1);
 }
 
+// Functions for the loop over flat and constant inputs without nulls. They
+// throw for a zero divisor and return null for a negative dividend.
+template <typename T>
+struct DenseDivideFunction {
+  FOLLY_ALWAYS_INLINE bool
+  call(int64_t& out, const int64_t& a, const int64_t& b) {
+    VELOX_USER_CHECK_NE(b, 0, "division by zero");
+    if (a < 0) {
+      return false;
+    }
+    out = a / b;
+    return true;
+  }
+};
+
+template <typename T>
+struct DenseLessThanFunction {
+  FOLLY_ALWAYS_INLINE bool
+  call(bool& out, const int64_t& a, const int64_t& b) {
+    VELOX_USER_CHECK_NE(b, 0, "division by zero");
+    if (a < 0) {
+      return false;
+    }
+    out = a < b;
+    return true;
+  }
+};
+
+TEST_F(SimpleFunctionTest, denseLoop) {
+  registerFunction<DenseDivideFunction, int64_t, int64_t, int64_t>(
+      {"dense_divide"});
+  registerFunction<DenseLessThanFunction, bool, int64_t, int64_t>(
+      {"dense_less_than"});
+
+  // More than two words of rows, so that boolean results have full and
+  // partial words.
+  const vector_size_t size = 150;
+  auto a = [](auto row) { return row % 7 - 1; };
+  auto b = [](auto row) { return row % 5; };
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(size, a),
+      makeFlatVector<int64_t>(size, b),
+  });
+  auto isNull = [&](auto row) { return b(row) == 0 || a(row) < 0; };
+
+  auto result =
+      evaluate<FlatVector<int64_t>>("try(dense_divide(c0, c1))", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size, [&](auto row) { return a(row) / std::max(1, b(row)); }, isNull),
+      result);
+
+  result = evaluate<FlatVector<int64_t>>("try(dense_divide(c1, 2))", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(size, [&](auto row) { return b(row) / 2; }),
+      result);
+
+  auto boolResult =
+      evaluate<FlatVector<bool>>("try(dense_less_than(c0, c1))", data);
+  assertEqualVectors(
+      makeFlatVector<bool>(
+          size, [&](auto row) { return a(row) < b(row); }, isNull),
+      boolResult);
+
+  boolResult = evaluate<FlatVector<bool>>("dense_less_than(c1, 3)", data);
+  assertEqualVectors(
+      makeFlatVector<bool>(size, [&](auto row) { return b(row) < 3; }),
+      boolResult);
+
+  VELOX_ASSERT_THROW(
+      evaluate<FlatVector<int64_t>>("dense_divide(c0, c1)", data),
+      "division by zero");
+}
+
+int32_t numBatchPlusCalls = 0;
+
+template <typename T>
+struct BatchPlusFunction {
+  FOLLY_ALWAYS_INLINE void
+  call(int64_t& out, const int64_t& a, const int64_t& b) {
+    out = a + b;
+  }
+
+  void callBatch(
+      int64_t* out,
+      const int64_t* a,
+      const int64_t* b,
+      int32_t size) {
+    ++numBatchPlusCalls;
+    for (auto i = 0; i < size; ++i) {
+      out[i] = a[i] + b[i];
+    }
+  }
+};
+
+TEST_F(SimpleFunctionTest, callBatch) {
+  registerFunction<BatchPlusFunction, int64_t, int64_t, int64_t>(
+      {"batch_plus"});
+
+  const vector_size_t size = 100;
+  auto data = makeRowVector({
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row * 2; }, nullEvery(7)),
+  });
+
+  auto result = evaluate<FlatVector<int64_t>>("batch_plus(c0, c0)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(size, [](auto row) { return row * 2; }), result);
+  EXPECT_EQ(numBatchPlusCalls, 1);
+
+  // Constant arguments are expanded.
+  result = evaluate<FlatVector<int64_t>>("batch_plus(10, c0)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(size, [](auto row) { return row + 10; }),
+      result);
+  EXPECT_EQ(numBatchPlusCalls, 2);
+
+  // Inputs with nulls go through call().
+  result = evaluate<FlatVector<int64_t>>("batch_plus(c0, c1)", data);
+  assertEqualVectors(
+      makeFlatVector<int64_t>(
+          size, [](auto row) { return row * 3; }, nullEvery(7)),
+      result);
+  EXPECT_EQ(numBatchPlusCalls, 2);
+}
+
 } // namespace
@@ -15,13 +15,17 @@
  */
 #include "velox/functions/lib/Re2Functions.h"
 
+#include <folly/container/F14Map.h>
 #include <re2/re2.h>
+#include <list>
 #include <optional>
 #include <string>
 
+#include "velox/common/base/SimdUtil.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/Expr.h"
 #include "velox/functions/lib/ArrayBuilder.h"
+#include "velox/functions/lib/string/StringCore.h"
 #include "velox/type/StringView.h"
 #include "velox/vector/FlatVector.h"
 
@@ -67,6 +71,73 @@ void checkForBadPattern(const RE2& re) {
   }
 }
 
+std::unique_ptr<RE2> compileRe2(StringView pattern) {
+  auto re = std::make_unique<RE2>(toStringPiece(pattern), RE2::Quiet);
+  checkForBadPattern(*re);
+  return re;
+}
+
+uint32_t maxCompiledRegexes(EvalCtx* context) {
+  return context->execCtx()->queryCtx()->config().exprMaxCompiledRegexes();
+}
+
+// Compiled forms of non-constant patterns. Keeps at most
+// 'expression.max_compiled_regexes' and evicts the least recently used. A
+// function instance is used by one thread at a time, so there is no
+// locking.
+template <typename T>
+class CompiledPatternCache {
+ public:
+  // Returns the compiled 'pattern'. Calls 'compile' to make a
+  // std::unique_ptr<T> on a miss. Consecutive rows with the same pattern
+  // only compare the pattern with the last one used.
+  template <typename TCompile>
+  const T&
+  findOrCompile(StringView pattern, uint32_t maxSize, TCompile compile) {
+    const std::string_view key(pattern.data(), pattern.size());
+    if (!entries_.empty() && entries_.front().first == key) {
+      ++numHits_;
+      return *entries_.front().second;
+    }
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      ++numHits_;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return *entries_.front().second;
+    }
+    ++numMisses_;
+    // Compiles first so that an invalid pattern leaves the cache unchanged.
+    auto compiled = compile(pattern);
+    while (!entries_.empty() && entries_.size() >= std::max(maxSize, 1U)) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    entries_.emplace_front(std::string(key), std::move(compiled));
+    index_.emplace(entries_.front().first, entries_.begin());
+    return *entries_.front().second;
+  }
+
+  void addRuntimeStats(
+      std::unordered_map<std::string, RuntimeMetric>& stats) const {
+    if (numHits_ + numMisses_ == 0) {
+      return;
+    }
+    stats["compiledRegexCacheHits"].addValue(numHits_);
+    stats["compiledRegexCacheMisses"].addValue(numMisses_);
+  }
+
+ private:
+  // Most recently used first. The keys of 'index_' point to the patterns
+  // here.
+  std::list<std::pair<std::string, std::unique_ptr<T>>> entries_;
+  folly::F14FastMap<
+      std::string_view,
+      typename std::list<std::pair<std::string, std::unique_ptr<T>>>::iterator>
+      index_;
+  uint64_t numHits_{0};
+  uint64_t numMisses_{0};
+};
+
 FlatVector<bool>& ensureWritableBool(
     const SelectivityVector& rows,
     velox::memory::MemoryPool* pool,
@@ -227,12 +298,21 @@ class Re2Match final : public VectorFunction {
         ensureWritableBool(rows, context->pool(), resultRef);
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
+    const auto maxSize = maxCompiledRegexes(context);
     rows.applyToSelected([&](vector_size_t row) {
-      RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
-      checkForBadPattern(re);
+      const auto& re = cache_.findOrCompile(
+          pattern->valueAt<StringView>(row), maxSize, compileRe2);
       result.set(row, Fn(toSearch->valueAt<StringView>(row), re));
     });
   }
+
+  void addRuntimeStats(
+      std::unordered_map<std::string, RuntimeMetric>& stats) const final {
+    cache_.addRuntimeStats(stats);
+  }
+
+ private:
+  mutable CompiledPatternCache<RE2> cache_;
 };
 
 void checkForBadGroupId(int groupId, const RE2& re) {
@@ -339,19 +419,19 @@ class Re2SearchAndExtract final : public VectorFunction {
       return;
     }
 
-    // The general case. Further optimizations are possible to avoid regex
-    // recompilation, but a constant pattern is by far the most common case.
+    // The general case. Each distinct pattern is compiled once and cached.
     FlatVector<StringView>& result =
         ensureWritableStringView(rows, context->pool(), resultRef);
     exec::LocalDecodedVector toSearch(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
+    const auto maxSize = maxCompiledRegexes(context);
     bool mustRefSourceStrings = false;
     FOLLY_DECLARE_REUSED(groups, std::vector<re2::StringPiece>);
     if (args.size() == 2) {
       groups.resize(1);
       rows.applyToSelected([&](vector_size_t i) {
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(i)), RE2::Quiet);
-        checkForBadPattern(re);
+        const auto& re = cache_.findOrCompile(
+            pattern->valueAt<StringView>(i), maxSize, compileRe2);
         mustRefSourceStrings |=
             re2Extract(result, i, re, toSearch, groups, 0, emptyNoMatch_);
       });
@@ -359,8 +439,8 @@ class Re2SearchAndExtract final : public VectorFunction {
       exec::LocalDecodedVector groupIds(context, *args[2], rows);
       rows.applyToSelected([&](vector_size_t i) {
         const auto groupId = groupIds->valueAt<T>(i);
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(i)), RE2::Quiet);
-        checkForBadPattern(re);
+        const auto& re = cache_.findOrCompile(
+            pattern->valueAt<StringView>(i), maxSize, compileRe2);
         checkForBadGroupId(groupId, re);
         groups.resize(groupId + 1);
         mustRefSourceStrings |=
@@ -372,15 +452,60 @@ class Re2SearchAndExtract final : public VectorFunction {
     }
   }
 
+  void addRuntimeStats(
+      std::unordered_map<std::string, RuntimeMetric>& stats) const final {
+    cache_.addRuntimeStats(stats);
+  }
+
  private:
   const bool emptyNoMatch_;
+  mutable CompiledPatternCache<RE2> cache_;
 };
 
+// Applies 'match' to the strings of the first argument of LIKE.
+template <typename TMatch>
+void applyLike(
+    const SelectivityVector& rows,
+    std::vector<VectorPtr>& args,
+    EvalCtx* context,
+    VectorPtr* resultRef,
+    TMatch match) {
+  FlatVector<bool>& result =
+      ensureWritableBool(rows, context->pool(), resultRef);
+
+  exec::DecodedArgs decodedArgs(rows, args, context);
+  auto toSearch = decodedArgs.at(0);
+  if (toSearch->isIdentityMapping()) {
+    auto rawStrings = toSearch->data<StringView>();
+    rows.applyToSelected(
+        [&](vector_size_t i) { result.set(i, match(rawStrings[i])); });
+    return;
+  }
+
+  if (toSearch->isConstantMapping()) {
+    bool matched = match(toSearch->valueAt<StringView>(0));
+    rows.applyToSelected([&](vector_size_t i) { result.set(i, matched); });
+    return;
+  }
+
+  // Since the likePattern and escapeChar (2nd and 3rd args) are both
+  // constants, so the first arg is expected to be either of flat or constant
+  // vector only. This code path is unreachable.
+  VELOX_UNREACHABLE();
+}
+
+// '%' and '_' match any character including a newline.
+RE2::Options likeRe2Options() {
+  RE2::Options options(RE2::Quiet);
+  options.set_dot_nl(true);
+  return options;
+}
+
 class LikeConstantPattern final : public VectorFunction {
  public:
   LikeConstantPattern(StringView pattern, std::optional<char> escapeChar)
       : re_(toStringPiece(likePatternToRe2(pattern, escapeChar, validPattern_)),
-            RE2::Quiet) {}
+            likeRe2Options()) {}
 
   void apply(
       const SelectivityVector& rows,
@@ -399,34 +524,155 @@ class LikeConstantPattern final : public VectorFunction {
 
     // apply() will not be invoked if the selection is empty.
     checkForBadPattern(re_);
+    applyLike(rows, args, context, resultRef, [&](StringView input) {
+      return re2FullMatch(input, re_);
+    });
+  }
+
+ private:
+  RE2 re_;
+  bool validPattern_;
+};
+
+// Matches the patterns of 'kind' without RE2.
+template <PatternKind kind>
+class OptimizedLike final : public VectorFunction {
+ public:
+  explicit OptimizedLike(PatternMetadata metadata)
+      : metadata_(std::move(metadata)) {}
+
+  static bool match(StringView input, const PatternMetadata& metadata) {
+    const auto& fixed = metadata.fixedPattern;
+    const size_t length = metadata.length;
+    if constexpr (kind == PatternKind::kExactlyN) {
+      // A character takes 1 to 4 bytes.
+      if (input.size() < length || input.size() > 4 * length) {
+        return false;
+      }
+      return stringCore::lengthUnicode(input.data(), input.size()) == length;
+    } else if constexpr (kind == PatternKind::kAtLeastN) {
+      if (input.size() < length) {
+        return false;
+      }
+      if (input.size() >= 4 * length) {
+        return true;
+      }
+      return stringCore::lengthUnicode(input.data(), input.size()) >= length;
+    } else if constexpr (kind == PatternKind::kFixed) {
+      return input.size() == fixed.size() &&
+          memcmp(input.data(), fixed.data(), fixed.size()) == 0;
+    } else if constexpr (kind == PatternKind::kPrefix) {
+      return input.size() >= fixed.size() &&
+          memcmp(input.data(), fixed.data(), fixed.size()) == 0;
+    } else if constexpr (kind == PatternKind::kSuffix) {
+      return input.size() >= fixed.size() &&
+          memcmp(input.data() + input.size() - fixed.size(),
+                 fixed.data(),
+                 fixed.size()) == 0;
+    } else {
+      static_assert(kind == PatternKind::kSubstring);
+      return simd::simdStrstr(
+                 input.data(), input.size(), fixed.data(), fixed.size()) !=
+          std::string::npos;
+    }
+  }
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      EvalCtx* context,
+      VectorPtr* resultRef) const final {
+    VELOX_CHECK(args.size() == 2 || args.size() == 3);
+    applyLike(rows, args, context, resultRef, [&](StringView input) {
+      return match(input, metadata_);
+    });
+  }
+
+ private:
+  const PatternMetadata metadata_;
+};
+
+// LIKE with a pattern that is not constant. Each distinct pattern is
+// classified, and compiled if RE2 is needed, once per function instance.
+class LikeVariablePattern final : public VectorFunction {
+ public:
+  explicit LikeVariablePattern(std::optional<char> escapeChar)
+      : escapeChar_(escapeChar) {}
+
+  void apply(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& args,
+      const TypePtr& /* outputType */,
+      EvalCtx* context,
+      VectorPtr* resultRef) const final {
+    VELOX_CHECK(args.size() == 2 || args.size() == 3);
     FlatVector<bool>& result =
         ensureWritableBool(rows, context->pool(), resultRef);
+    exec::LocalDecodedVector toSearch(context, *args[0], rows);
+    exec::LocalDecodedVector pattern(context, *args[1], rows);
+    const auto maxSize = maxCompiledRegexes(context);
+    context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
+      const auto& like = cache_.findOrCompile(
+          pattern->valueAt<StringView>(row), maxSize, [&](StringView p) {
+            return compile(p);
+          });
+      result.set(row, match(toSearch->valueAt<StringView>(row), like));
+    });
+  }
 
-    exec::DecodedArgs decodedArgs(rows, args, context);
-    auto toSearch = decodedArgs.at(0);
-    if (toSearch->isIdentityMapping()) {
-      auto rawStrings = toSearch->data<StringView>();
-      rows.applyToSelected([&](vector_size_t i) {
-        result.set(i, re2FullMatch(rawStrings[i], re_));
-      });
-      return;
-    }
+  void addRuntimeStats(
+      std::unordered_map<std::string, RuntimeMetric>& stats) const final {
+    cache_.addRuntimeStats(stats);
+  }
 
-    if (toSearch->isConstantMapping()) {
-      bool match = re2FullMatch(toSearch->valueAt<StringView>(0), re_);
-      rows.applyToSelected([&](vector_size_t i) { result.set(i, match); });
-      return;
+ private:
+  struct CompiledLike {
+    PatternMetadata metadata;
+    // Set if 'metadata' is of kind kGeneric.
+    std::unique_ptr<RE2> re;
+  };
+
+  std::unique_ptr<CompiledLike> compile(StringView pattern) const {
+    auto like = std::make_unique<CompiledLike>();
+    like->metadata = determinePatternKind(pattern, escapeChar_);
+    if (like->metadata.patternKind == PatternKind::kGeneric) {
+      bool validPattern;
+      const auto re2Pattern =
+          likePatternToRe2(pattern, escapeChar_, validPattern);
+      VELOX_USER_CHECK(
+          validPattern,
+          "Escape character must be followed by '%', '_' or the escape "
+          "character itself");
+      like->re =
+          std::make_unique<RE2>(toStringPiece(re2Pattern), likeRe2Options());
+      checkForBadPattern(*like->re);
     }
+    return like;
+  }
 
-    // Since the likePattern and escapeChar (2nd and 3rd args) are both
-    // constants, so the first arg is expected to be either of flat or constant
-    // vector only. This code path is unreachable.
-    VELOX_UNREACHABLE();
+  static bool match(StringView input, const CompiledLike& like) {
+    const auto& metadata = like.metadata;
+    switch (metadata.patternKind) {
+      case PatternKind::kExactlyN:
+        return OptimizedLike<PatternKind::kExactlyN>::match(input, metadata);
+      case PatternKind::kAtLeastN:
+        return OptimizedLike<PatternKind::kAtLeastN>::match(input, metadata);
+      case PatternKind::kFixed:
+        return OptimizedLike<PatternKind::kFixed>::match(input, metadata);
+      case PatternKind::kPrefix:
+        return OptimizedLike<PatternKind::kPrefix>::match(input, metadata);
+      case PatternKind::kSuffix:
+        return OptimizedLike<PatternKind::kSuffix>::match(input, metadata);
+      case PatternKind::kSubstring:
+        return OptimizedLike<PatternKind::kSubstring>::match(input, metadata);
+      default:
+        return re2FullMatch(input, *like.re);
+    }
   }
 
- private:
-  RE2 re_;
-  bool validPattern_;
+  const std::optional<char> escapeChar_;
+  mutable CompiledPatternCache<CompiledLike> cache_;
 };
 
 void re2ExtractAll(
@@ -545,6 +791,7 @@ class Re2ExtractAll final : public VectorFunction {
         rows.size(), rows.countSelected() * 3, context->pool());
     exec::LocalDecodedVector inputStrs(context, *args[0], rows);
     exec::LocalDecodedVector pattern(context, *args[1], rows);
+    const auto maxSize = maxCompiledRegexes(context);
     FOLLY_DECLARE_REUSED(groups, std::vector<re2::StringPiece>);
 
     if (args.size() == 2) {
@@ -552,8 +799,8 @@ class Re2ExtractAll final : public VectorFunction {
       //
       groups.resize(1);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
-        checkForBadPattern(re);
+        const auto& re = cache_.findOrCompile(
+            pattern->valueAt<StringView>(row), maxSize, compileRe2);
         re2ExtractAll(builder, re, inputStrs, row, groups, 0);
       });
     } else {
@@ -562,8 +809,8 @@ class Re2ExtractAll final : public VectorFunction {
       exec::LocalDecodedVector groupIds(context, *args[2], rows);
       context->applyToSelectedNoThrow(rows, [&](vector_size_t row) {
         const T groupId = groupIds->valueAt<T>(row);
-        RE2 re(toStringPiece(pattern->valueAt<StringView>(row)), RE2::Quiet);
-        checkForBadPattern(re);
+        const auto& re = cache_.findOrCompile(
+            pattern->valueAt<StringView>(row), maxSize, compileRe2);
         checkForBadGroupId(groupId, re);
         groups.resize(groupId + 1);
         re2ExtractAll(builder, re, inputStrs, row, groups, groupId);
@@ -577,6 +824,14 @@ class Re2ExtractAll final : public VectorFunction {
         std::move(builder).finish(context->pool());
     context->moveOrCopyResult(arrayVector, rows, resultRef);
   }
+
+  void addRuntimeStats(
+      std::unordered_map<std::string, RuntimeMetric>& stats) const final {
+    cache_.addRuntimeStats(stats);
+  }
+
+ private:
+  mutable CompiledPatternCache<RE2> cache_;
 };
 
 template <bool (*Fn)(StringView, const RE2&)>
@@ -597,9 +852,8 @@ std::shared_ptr<VectorFunction> makeRe2MatchImpl(
     return std::make_shared<Re2MatchConstantPattern<Fn>>(
         constantPattern->as<ConstantVector<StringView>>()->valueAt(0));
   }
-  static std::shared_ptr<Re2Match<Fn>> kMatchExpr =
-      std::make_shared<Re2Match<Fn>>();
-  return kMatchExpr;
+  // Each instance has its own cache of compiled patterns.
+  return std::make_shared<Re2Match<Fn>>();
 }
 
 } // namespace
@@ -719,6 +973,75 @@ std::vector<std::shared_ptr<exec::FunctionSignature>> re2ExtractSignatures() {
   };
 }
 
+PatternMetadata determinePatternKind(
+    StringView pattern,
+    std::optional<char> escapeChar) {
+  // The pattern as a sequence of '%', '_' and literal characters with
+  // escapes removed.
+  enum class Token { kAny, kOne, kLiteral };
+  std::vector<Token> tokens;
+  std::string literal;
+  bool escaped = false;
+  for (const char c : pattern) {
+    if (escaped) {
+      if (!(c == '%' || c == '_' || c == escapeChar)) {
+        return {PatternKind::kGeneric};
+      }
+      tokens.push_back(Token::kLiteral);
+      literal.push_back(c);
+      escaped = false;
+    } else if (c == escapeChar) {
+      escaped = true;
+    } else if (c == '%') {
+      tokens.push_back(Token::kAny);
+    } else if (c == '_') {
+      tokens.push_back(Token::kOne);
+    } else {
+      tokens.push_back(Token::kLiteral);
+      literal.push_back(c);
+    }
+  }
+  if (escaped) {
+    return {PatternKind::kGeneric};
+  }
+
+  const auto numOne = std::count(tokens.begin(), tokens.end(), Token::kOne);
+  if (literal.empty()) {
+    const bool hasAny =
+        std::find(tokens.begin(), tokens.end(), Token::kAny) != tokens.end();
+    return {
+        hasAny ? PatternKind::kAtLeastN : PatternKind::kExactlyN,
+        static_cast<vector_size_t>(numOne)};
+  }
+  if (numOne > 0) {
+    return {PatternKind::kGeneric};
+  }
+
+  // The literal characters must be contiguous with only '%' around them.
+  const size_t first =
+      std::find(tokens.begin(), tokens.end(), Token::kLiteral) -
+      tokens.begin();
+  const size_t last = first + literal.size() - 1;
+  for (auto i = first; i <= last; ++i) {
+    if (tokens[i] != Token::kLiteral) {
+      return {PatternKind::kGeneric};
+    }
+  }
+  const bool leadingAny = first > 0;
+  const bool trailingAny = last < tokens.size() - 1;
+  PatternKind kind;
+  if (leadingAny && trailingAny) {
+    kind = PatternKind::kSubstring;
+  } else if (leadingAny) {
+    kind = PatternKind::kSuffix;
+  } else if (trailingAny) {
+    kind = PatternKind::kPrefix;
+  } else {
+    kind = PatternKind::kFixed;
+  }
+  return {kind, 0, std::move(literal)};
+}
+
 std::shared_ptr<exec::VectorFunction> makeLike(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs) {
@@ -764,13 +1087,33 @@ std::shared_ptr<exec::VectorFunction> makeLike(
   }
 
   BaseVector* constantPattern = inputArgs[1].constantValue.get();
-  VELOX_USER_CHECK(
-      constantPattern != nullptr,
-      "{} requires second argument to be a constant of type VARCHAR",
-      name,
-      inputArgs[1].type->toString());
+  if (constantPattern == nullptr) {
+    return std::make_shared<LikeVariablePattern>(escapeChar);
+  }
   auto pattern = constantPattern->as<ConstantVector<StringView>>()->valueAt(0);
-  return std::make_shared<LikeConstantPattern>(pattern, escapeChar);
+  auto metadata = determinePatternKind(pattern, escapeChar);
+  switch (metadata.patternKind) {
+    case PatternKind::kExactlyN:
+      return std::make_shared<OptimizedLike<PatternKind::kExactlyN>>(
+          std::move(metadata));
+    case PatternKind::kAtLeastN:
+      return std::make_shared<OptimizedLike<PatternKind::kAtLeastN>>(
+          std::move(metadata));
+    case PatternKind::kFixed:
+      return std::make_shared<OptimizedLike<PatternKind::kFixed>>(
+          std::move(metadata));
+    case PatternKind::kPrefix:
+      return std::make_shared<OptimizedLike<PatternKind::kPrefix>>(
+          std::move(metadata));
+    case PatternKind::kSuffix:
+      return std::make_shared<OptimizedLike<PatternKind::kSuffix>>(
+          std::move(metadata));
+    case PatternKind::kSubstring:
+      return std::make_shared<OptimizedLike<PatternKind::kSubstring>>(
+          std::move(metadata));
+    default:
+      return std::make_shared<LikeConstantPattern>(pattern, escapeChar);
+  }
 }
 
 std::vector<std::shared_ptr<exec::FunctionSignature>> likeSignatures() {
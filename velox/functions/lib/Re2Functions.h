@@ -16,6 +16,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include <re2/re2.h>
@@ -77,6 +79,46 @@ std::shared_ptr<exec::VectorFunction> makeRe2Extract(
 
 std::vector<std::shared_ptr<exec::FunctionSignature>> re2ExtractSignatures();
 
+/// The kinds of LIKE patterns that are matched without RE2.
+enum class PatternKind {
+  /// Matches strings of exactly 'length' characters, e.g. '___'.
+  kExactlyN,
+  /// Matches strings of at least 'length' characters, e.g. '_%_'.
+  kAtLeastN,
+  /// Matches 'fixedPattern', e.g. 'abc'.
+  kFixed,
+  /// Matches strings starting with 'fixedPattern', e.g. 'abc%'.
+  kPrefix,
+  /// Matches strings ending with 'fixedPattern', e.g. '%abc'.
+  kSuffix,
+  /// Matches strings containing 'fixedPattern', e.g. '%abc%'.
+  kSubstring,
+  /// Any other pattern. Matched with RE2.
+  kGeneric,
+};
+
+struct PatternMetadata {
+  PatternKind patternKind;
+  /// Number of characters for kExactlyN and kAtLeastN.
+  vector_size_t length{0};
+  /// The pattern without wildcards and with escapes removed for kFixed,
+  /// kPrefix, kSuffix and kSubstring.
+  std::string fixedPattern;
+};
+
+/// Returns the kind of the LIKE 'pattern'. Returns kGeneric for a pattern
+/// with an invalid escape.
+PatternMetadata determinePatternKind(
+    StringView pattern,
+    std::optional<char> escapeChar);
+
+/// like(string, pattern) → bool
+/// like(string, pattern, escape) → bool
+///
+/// Returns whether string matches the constant LIKE pattern, where '%'
+/// matches any sequence of characters and '_' any one character. Patterns
+/// of the kinds in PatternKind are matched directly on the string and the
+/// rest are translated to RE2.
 std::shared_ptr<exec::VectorFunction> makeLike(
     const std::string& name,
     const std::vector<exec::VectorFunctionArg>& inputArgs);
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <fmt/format.h>
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <string>
+
+#include "velox/functions/lib/Re2Functions.h"
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+
+// Compares LIKE patterns that are matched without RE2 with the regular
+// expressions RE2 would otherwise match for them.
+
+namespace facebook::velox::functions::test {
+namespace {
+
+constexpr int32_t kBlockSize = 10 << 10;
+
+int run(int n, const std::string& expression) {
+  folly::BenchmarkSuspender kSuspender;
+  FunctionBenchmarkBase benchmarkBase;
+
+  // Strings of 20 to 80 characters. Every 10th has 'abc' at the start, the
+  // end or in the middle.
+  std::vector<std::string> strings(kBlockSize);
+  for (auto row = 0; row < kBlockSize; ++row) {
+    auto& str = strings[row];
+    str.assign(20 + row % 61, static_cast<char>('a' + row % 3));
+    if (row % 10 == 0) {
+      auto position = (row / 10) % 3 * (str.size() - 3) / 2;
+      str.replace(position, 3, "abc");
+    }
+  }
+  auto vector = benchmarkBase.maker().flatVector<StringView>(
+      kBlockSize, [&](auto row) { return StringView(strings[row]); });
+  const auto data = benchmarkBase.maker().rowVector({vector});
+
+  exec::ExprSet expr =
+      benchmarkBase.compileExpression(expression, data->type());
+  kSuspender.dismiss();
+  for (int i = 0; i != n; ++i) {
+    benchmarkBase.evaluate(expr, data);
+  }
+  return n * kBlockSize;
+}
+
+int like(int n, const char* pattern) {
+  return run(n, fmt::format("like(c0, '{}')", pattern));
+}
+
+int re2(int n, const char* regex) {
+  return run(n, fmt::format("re2_match(c0, '(?s)^{}$')", regex));
+}
+
+BENCHMARK_NAMED_PARAM_MULTI(re2, prefix, "abc.*");
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(like, prefix, "abc%");
+BENCHMARK_NAMED_PARAM_MULTI(re2, suffix, ".*abc");
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(like, suffix, "%abc");
+BENCHMARK_NAMED_PARAM_MULTI(re2, substring, ".*abc.*");
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(like, substring, "%abc%");
+BENCHMARK_NAMED_PARAM_MULTI(re2, fixed, "abcabcabcabcabcabcabc");
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(like, fixed, "abcabcabcabcabcabcabc");
+BENCHMARK_NAMED_PARAM_MULTI(re2, exactlyN, "....................");
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(like, exactlyN, "____________________");
+BENCHMARK_NAMED_PARAM_MULTI(re2, atLeastN, "...........*");
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(like, atLeastN, "__________%");
+
+} // namespace
+
+void registerLikeFunctions() {
+  exec::registerStatefulVectorFunction("like", likeSignatures(), makeLike);
+  exec::registerStatefulVectorFunction(
+      "re2_match", re2MatchSignatures(), makeRe2Match);
+}
+
+} // namespace facebook::velox::functions::test
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  facebook::velox::functions::test::registerLikeFunctions();
+  folly::runBenchmarks();
+  return 0;
+}
@@ -401,6 +401,148 @@ TEST_F(Re2FunctionsTest, likePatternAndEscape) {
   EXPECT_EQ(like("cde", "%#%%", '#'), false);
 
   EXPECT_THROW(like("abcd", "a#}#+", '#'), std::exception);
+
+  // Escaped wildcards in patterns matched without RE2.
+  EXPECT_EQ(like("a%", "a#%", '#'), true);
+  EXPECT_EQ(like("ab", "a#%", '#'), false);
+  EXPECT_EQ(like("x_y", "%#_y", '#'), true);
+  EXPECT_EQ(like("xay", "%#_y", '#'), false);
+  EXPECT_EQ(like("a#b", "a###b%", '#'), true);
+}
+
+TEST_F(Re2FunctionsTest, determinePatternKind) {
+  auto kindOf = [](const std::string& pattern,
+                   std::optional<char> escape = std::nullopt) {
+    return determinePatternKind(StringView(pattern), escape);
+  };
+
+  auto metadata = kindOf("___");
+  EXPECT_EQ(metadata.patternKind, PatternKind::kExactlyN);
+  EXPECT_EQ(metadata.length, 3);
+  EXPECT_EQ(kindOf("").patternKind, PatternKind::kExactlyN);
+  metadata = kindOf("_%_");
+  EXPECT_EQ(metadata.patternKind, PatternKind::kAtLeastN);
+  EXPECT_EQ(metadata.length, 2);
+  EXPECT_EQ(kindOf("%").patternKind, PatternKind::kAtLeastN);
+
+  metadata = kindOf("abc");
+  EXPECT_EQ(metadata.patternKind, PatternKind::kFixed);
+  EXPECT_EQ(metadata.fixedPattern, "abc");
+  metadata = kindOf("abc%%");
+  EXPECT_EQ(metadata.patternKind, PatternKind::kPrefix);
+  EXPECT_EQ(metadata.fixedPattern, "abc");
+  metadata = kindOf("%abc");
+  EXPECT_EQ(metadata.patternKind, PatternKind::kSuffix);
+  EXPECT_EQ(metadata.fixedPattern, "abc");
+  metadata = kindOf("%%abc%");
+  EXPECT_EQ(metadata.patternKind, PatternKind::kSubstring);
+  EXPECT_EQ(metadata.fixedPattern, "abc");
+  metadata = kindOf("%a#%c%", '#');
+  EXPECT_EQ(metadata.patternKind, PatternKind::kSubstring);
+  EXPECT_EQ(metadata.fixedPattern, "a%c");
+
+  EXPECT_EQ(kindOf("a%c").patternKind, PatternKind::kGeneric);
+  EXPECT_EQ(kindOf("_abc").patternKind, PatternKind::kGeneric);
+  EXPECT_EQ(kindOf("%a%c%").patternKind, PatternKind::kGeneric);
+  EXPECT_EQ(kindOf("a#b", '#').patternKind, PatternKind::kGeneric);
+  EXPECT_EQ(kindOf("ab#", '#').patternKind, PatternKind::kGeneric);
+}
+
+TEST_F(Re2FunctionsTest, likeSpecialized) {
+  auto like = [&](std::optional<std::string> str, const std::string& pattern) {
+    return evaluateOnce<bool>("like(c0, '" + pattern + "')", str);
+  };
+
+  // kExactlyN and kAtLeastN count characters, not bytes.
+  EXPECT_EQ(like("abc", "___"), true);
+  EXPECT_EQ(like("ab", "___"), false);
+  EXPECT_EQ(like("abcd", "___"), false);
+  EXPECT_EQ(like("\u4FE1\u5FF5\u7231", "___"), true);
+  EXPECT_EQ(like("\u4FE1\u5FF5", "___"), false);
+  EXPECT_EQ(like("", ""), true);
+  EXPECT_EQ(like("a", ""), false);
+  EXPECT_EQ(like("abc", "_%_"), true);
+  EXPECT_EQ(like("a", "_%_"), false);
+  EXPECT_EQ(like("\u4FE1\u5FF5", "_%_"), true);
+  EXPECT_EQ(like("", "%"), true);
+
+  EXPECT_EQ(like("abc", "abc"), true);
+  EXPECT_EQ(like("abcd", "abc"), false);
+  EXPECT_EQ(like("xyzabc", "%abc"), true);
+  EXPECT_EQ(like("abcx", "%abc"), false);
+  EXPECT_EQ(like("ab", "%abc"), false);
+  EXPECT_EQ(like("abc", "abc%"), true);
+  EXPECT_EQ(like("ab", "abc%"), false);
+
+  // Substrings at all positions of strings longer than a SIMD register.
+  for (auto i = 0; i < 70; ++i) {
+    std::string str(i, 'x');
+    EXPECT_EQ(like(str + "needle" + str, "%needle%"), true) << i;
+    EXPECT_EQ(like(str + "needlf" + str, "%needle%"), false) << i;
+  }
+
+  // '%' and '_' match newlines, also when matched with RE2.
+  EXPECT_EQ(like("a\nb", "a%"), true);
+  EXPECT_EQ(like("a\nb", "a_b"), true);
+  EXPECT_EQ(like("a\nb", "a%b"), true);
+  EXPECT_EQ(like("\n", "_"), true);
+}
+
+TEST_F(Re2FunctionsTest, likeVariablePattern) {
+  auto data = makeRowVector({
+      makeFlatVector<std::string>(
+          {"abc", "abcd", "xyzabc", "abc", "a\nb", "ab", "a%", "ab", "abc"}),
+      makeFlatVector<std::string>(
+          {"___", "abc", "%abc", "abc%", "a%b", "%b%", "a#%", "a#%", "_b%"}),
+  });
+  assertEqualVectors(
+      makeFlatVector<bool>(
+          {true, false, true, true, true, true, false, false, true}),
+      evaluate<SimpleVector<bool>>("like(c0, c1)", data));
+  assertEqualVectors(
+      makeFlatVector<bool>(
+          {true, false, true, true, true, true, true, false, true}),
+      evaluate<SimpleVector<bool>>("like(c0, c1, '#')", data));
+
+  auto like = [&](std::optional<std::string> str,
+                  std::optional<std::string> pattern) {
+    return evaluateOnce<bool>("like(c0, c1, '#')", str, pattern);
+  };
+  EXPECT_EQ(like("abc", std::nullopt), std::nullopt);
+  EXPECT_THROW(like("abcd", "a#}#+"), VeloxUserError);
+}
+
+TEST_F(Re2FunctionsTest, compiledRegexCache) {
+  auto data = makeRowVector({
+      makeFlatVector<std::string>({"abc", "xbz", "abd", "abc", "aXc", "abc"}),
+      makeFlatVector<std::string>({"a%c", "_b_", "a%c", "_b_", "a_c", "a%c"}),
+  });
+  auto expected = makeFlatVector<bool>({true, true, false, true, true, true});
+
+  auto runtimeStats = [&](const std::string& expression) {
+    auto exprSet = compileExpressions({expression}, asRowType(data->type()));
+    evaluate(*exprSet, data);
+    return exprSet->exprs()[0]->stats().runtimeStats;
+  };
+
+  auto stats = runtimeStats("like(c0, c1)");
+  EXPECT_EQ(stats.at("compiledRegexCacheHits").sum, 3);
+  EXPECT_EQ(stats.at("compiledRegexCacheMisses").sum, 3);
+  stats = runtimeStats("re2_match(c0, c1)");
+  EXPECT_EQ(stats.at("compiledRegexCacheHits").sum, 3);
+  EXPECT_EQ(stats.at("compiledRegexCacheMisses").sum, 3);
+
+  // With room for 2 patterns, 'a_c' evicts 'a%c', which then evicts '_b_'.
+  queryCtx_->setConfigOverridesUnsafe(
+      {{core::QueryConfig::kExprMaxCompiledRegexes, "2"}});
+  auto exprSet = compileExpressions({"like(c0, c1)"}, asRowType(data->type()));
+  assertEqualVectors(expected, evaluate(*exprSet, data));
+  stats = exprSet->exprs()[0]->stats().runtimeStats;
+  EXPECT_EQ(stats.at("compiledRegexCacheHits").sum, 2);
+  EXPECT_EQ(stats.at("compiledRegexCacheMisses").sum, 4);
+
+  // Constant patterns are compiled once without the cache.
+  EXPECT_TRUE(runtimeStats("like(c0, 'a%c')").empty());
 }
 
 template <typename T>
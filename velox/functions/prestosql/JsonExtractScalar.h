@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/core/QueryConfig.h"
 #include "velox/functions/Macros.h"
 #include "velox/functions/UDFOutputString.h"
 #include "velox/functions/prestosql/json/JsonExtractor.h"
@@ -28,14 +29,28 @@ template <typename T>
 struct JsonExtractScalarFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // The compiled path if the path is a constant.
+  std::optional<JsonPath> path_;
+
+  FOLLY_ALWAYS_INLINE void initialize(
+      const core::QueryConfig& /*config*/,
+      const arg_type<Varchar>* /*json*/,
+      const arg_type<Varchar>* jsonPath) {
+    if (jsonPath != nullptr) {
+      path_.emplace(folly::StringPiece(*jsonPath));
+    }
+  }
+
   FOLLY_ALWAYS_INLINE bool call(
       out_type<Varchar>& result,
       const arg_type<Varchar>& json,
       const arg_type<Varchar>& jsonPath) {
     const folly::StringPiece& jsonStringPiece = json;
     const folly::StringPiece& jsonPathStringPiece = jsonPath;
-    auto extractResult =
-        jsonExtractScalar(jsonStringPiece, jsonPathStringPiece);
+    auto extractResult = jsonExtractScalar(
+        jsonStringPiece,
+        path_.has_value() ? path_.value()
+                          : cachedJsonPath(jsonPathStringPiece));
     if (extractResult.hasValue()) {
       UDFOutputString::assign(result, *extractResult);
       return true;
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/core/QueryConfig.h"
+#include "velox/functions/Macros.h"
+#include "velox/functions/UDFOutputString.h"
+#include "velox/functions/prestosql/json/JsonExtractor.h"
+#include "velox/functions/prestosql/json/JsonScanner.h"
+
+namespace facebook::velox::functions {
+
+// json_extract(json, json_path) -> json
+// Returns the value at json_path as JSON text. Returns null if there is no
+// value at json_path.
+template <typename T>
+struct JsonExtractFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  // The compiled path if the path is a constant.
+  std::optional<JsonPath> path_;
+  std::string value_;
+
+  FOLLY_ALWAYS_INLINE void initialize(
+      const core::QueryConfig& /*config*/,
+      const arg_type<Varchar>* /*json*/,
+      const arg_type<Varchar>* jsonPath) {
+    if (jsonPath != nullptr) {
+      path_.emplace(folly::StringPiece(*jsonPath));
+    }
+  }
+
+  FOLLY_ALWAYS_INLINE bool call(
+      out_type<Varchar>& result,
+      const arg_type<Varchar>& json,
+      const arg_type<Varchar>& jsonPath) {
+    const auto& path = path_.has_value()
+        ? path_.value()
+        : cachedJsonPath(folly::StringPiece(jsonPath));
+    if (!jsonExtract(folly::StringPiece(json), path, value_)) {
+      return false;
+    }
+    UDFOutputString::assign(result, value_);
+    return true;
+  }
+};
+
+// json_array_length(json) -> bigint
+// Returns the number of elements of a JSON array or null if json is not an
+// array.
+template <typename T>
+struct JsonArrayLengthFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE bool call(
+      int64_t& result,
+      const arg_type<Varchar>& json) {
+    auto length = jsonArrayLength(folly::StringPiece(json));
+    if (!length.hasValue()) {
+      return false;
+    }
+    result = length.value();
+    return true;
+  }
+};
+
+// json_size(json, json_path) -> bigint
+// Returns the number of members of the array or object at json_path, 0 for
+// a scalar or null if there is no value at json_path.
+template <typename T>
+struct JsonSizeFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  // The compiled path if the path is a constant.
+  std::optional<JsonPath> path_;
+
+  FOLLY_ALWAYS_INLINE void initialize(
+      const core::QueryConfig& /*config*/,
+      const arg_type<Varchar>* /*json*/,
+      const arg_type<Varchar>* jsonPath) {
+    if (jsonPath != nullptr) {
+      path_.emplace(folly::StringPiece(*jsonPath));
+    }
+  }
+
+  FOLLY_ALWAYS_INLINE bool call(
+      int64_t& result,
+      const arg_type<Varchar>& json,
+      const arg_type<Varchar>& jsonPath) {
+    const auto& path = path_.has_value()
+        ? path_.value()
+        : cachedJsonPath(folly::StringPiece(jsonPath));
+    auto size = jsonSize(folly::StringPiece(json), path);
+    if (!size.hasValue()) {
+      return false;
+    }
+    result = size.value();
+    return true;
+  }
+};
+
+// json_array_contains(json, value) -> boolean
+// Returns true if the JSON array json has an element equal to value, which
+// is a boolean, bigint, double or varchar. Returns null if json is not an
+// array. Elements of other JSON types than value never match.
+template <typename T>
+struct JsonArrayContainsFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  template <typename TValue>
+  FOLLY_ALWAYS_INLINE bool
+  call(bool& result, const arg_type<Varchar>& json, const TValue& value) {
+    JsonScanner scanner(std::string_view(json.data(), json.size()));
+    if (!scanner.enterArray()) {
+      return false;
+    }
+    while (scanner.nextElement()) {
+      if (elementEquals(scanner, value)) {
+        result = true;
+        return true;
+      }
+    }
+    if (scanner.failed()) {
+      return false;
+    }
+    result = false;
+    return true;
+  }
+
+ private:
+  // Consumes the next element of 'scanner' and returns true if it equals
+  // 'value'.
+  template <typename TValue>
+  bool elementEquals(JsonScanner& scanner, const TValue& value) {
+    const auto kind = scanner.peek();
+    if constexpr (std::is_same_v<TValue, bool>) {
+      if (kind == JsonScanner::Kind::kTrue ||
+          kind == JsonScanner::Kind::kFalse) {
+        const bool element = kind == JsonScanner::Kind::kTrue;
+        return scanner.skipValue() && element == value;
+      }
+    } else if constexpr (
+        std::is_same_v<TValue, int64_t> || std::is_same_v<TValue, double>) {
+      std::string_view number;
+      if (kind == JsonScanner::Kind::kNumber && scanner.readNumber(number)) {
+        // A bigint only matches a number without fraction or exponent.
+        if (std::is_same_v<TValue, int64_t> &&
+            !JsonScanner::isInteger(number)) {
+          return false;
+        }
+        auto element = folly::tryTo<TValue>(
+            folly::StringPiece(number.data(), number.size()));
+        return element.hasValue() && element.value() == value;
+      }
+    } else {
+      if (kind == JsonScanner::Kind::kString) {
+        element_.clear();
+        return scanner.readString(element_) &&
+            StringView(element_) == StringView(value);
+      }
+    }
+    scanner.skipValue();
+    return false;
+  }
+
+  std::string element_;
+};
+
+} // namespace facebook::velox::functions
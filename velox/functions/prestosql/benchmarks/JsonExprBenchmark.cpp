@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include "folly/json.h"
+#include "velox/functions/Macros.h"
+#include "velox/functions/Registerer.h"
+#include "velox/functions/lib/benchmarks/FunctionBenchmarkBase.h"
+#include "velox/functions/prestosql/json/JsonExtractor.h"
+#include "velox/functions/prestosql/registration/RegistrationFunctions.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::functions;
+
+namespace {
+
+// The functions below parse the whole document into a folly::dynamic, which
+// is what the JSON functions did before they scanned the text in place.
+
+template <typename T>
+struct FollyJsonExtractScalarFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE bool call(
+      out_type<Varchar>& result,
+      const arg_type<Varchar>& json,
+      const arg_type<Varchar>& jsonPath) {
+    auto extracted =
+        jsonExtract(folly::StringPiece(json), folly::StringPiece(jsonPath));
+    if (!extracted.hasValue() || extracted->isArray() ||
+        extracted->isObject() || extracted->isNull()) {
+      return false;
+    }
+    UDFOutputString::assign(result, extracted->asString());
+    return true;
+  }
+};
+
+template <typename T>
+struct FollyJsonExtractFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE bool call(
+      out_type<Varchar>& result,
+      const arg_type<Varchar>& json,
+      const arg_type<Varchar>& jsonPath) {
+    auto extracted =
+        jsonExtract(folly::StringPiece(json), folly::StringPiece(jsonPath));
+    if (!extracted.hasValue()) {
+      return false;
+    }
+    UDFOutputString::assign(result, folly::toJson(extracted.value()));
+    return true;
+  }
+};
+
+template <typename T>
+struct FollyJsonArrayLengthFunction {
+  VELOX_DEFINE_FUNCTION_TYPES(T);
+
+  FOLLY_ALWAYS_INLINE bool call(
+      int64_t& result,
+      const arg_type<Varchar>& json) {
+    try {
+      auto parsed = folly::parseJson(folly::StringPiece(json));
+      if (!parsed.isArray()) {
+        return false;
+      }
+      result = parsed.size();
+      return true;
+    } catch (const std::exception&) {
+      return false;
+    }
+  }
+};
+
+class JsonBenchmark : public functions::test::FunctionBenchmarkBase {
+ public:
+  JsonBenchmark() : FunctionBenchmarkBase() {
+    functions::prestosql::registerJsonFunctions();
+
+    // Register folly based implementations.
+    registerFunction<FollyJsonExtractScalarFunction, Varchar, Varchar, Varchar>(
+        {"folly_json_extract_scalar"});
+    registerFunction<FollyJsonExtractFunction, Varchar, Varchar, Varchar>(
+        {"folly_json_extract"});
+    registerFunction<FollyJsonArrayLengthFunction, int64_t, Varchar>(
+        {"folly_json_array_length"});
+  }
+
+  // Runs 'fnName' on objects of about 'numFields' fields each. If 'path'
+  // is given, it is passed as a constant second argument, else the objects
+  // are wrapped in an array.
+  void runJson(
+      const std::string& fnName,
+      int32_t numFields,
+      const std::string& path = "") {
+    folly::BenchmarkSuspender suspender;
+
+    size_t size = 1000;
+    std::vector<std::string> documents(size);
+    for (auto row = 0; row < size; ++row) {
+      auto& json = documents[row];
+      json = R"({"id":)" + std::to_string(row) +
+          R"(,"tags":["a","b","c"],"user":{"name":"user)" +
+          std::to_string(row) + R"(","score":)" +
+          std::to_string(row * 0.25) + "}";
+      for (auto i = 0; i < numFields; ++i) {
+        json += fmt::format(
+            R"(,"field{}":"some longer text to skip over {}")", i, row);
+      }
+      json += R"(,"last":[)" + std::to_string(row) + "]}";
+      if (path.empty()) {
+        json = "[" + json + "]";
+      }
+    }
+    auto jsonVector = vectorMaker_.flatVector<StringView>(
+        size, [&](auto row) { return StringView(documents[row]); });
+    auto rowVector = vectorMaker_.rowVector({jsonVector});
+
+    auto expression = path.empty()
+        ? fmt::format("{}(c0)", fnName)
+        : fmt::format("{}(c0, '{}')", fnName, path);
+    auto exprSet = compileExpression(expression, rowVector->type());
+
+    suspender.dismiss();
+
+    doRun(exprSet, rowVector);
+  }
+
+  void doRun(ExprSet& exprSet, const RowVectorPtr& rowVector) {
+    uint32_t cnt = 0;
+    for (auto i = 0; i < 100; i++) {
+      cnt += evaluate(exprSet, rowVector)->size();
+    }
+    folly::doNotOptimizeAway(cnt);
+  }
+};
+
+BENCHMARK(folly_extract_scalar_first) {
+  JsonBenchmark benchmark;
+  benchmark.runJson("folly_json_extract_scalar", 20, "$.user.name");
+}
+
+BENCHMARK_RELATIVE(velox_extract_scalar_first) {
+  JsonBenchmark benchmark;
+  benchmark.runJson("json_extract_scalar", 20, "$.user.name");
+}
+
+BENCHMARK(folly_extract_scalar_last) {
+  JsonBenchmark benchmark;
+  benchmark.runJson("folly_json_extract_scalar", 20, "$.last[0]");
+}
+
+BENCHMARK_RELATIVE(velox_extract_scalar_last) {
+  JsonBenchmark benchmark;
+  benchmark.runJson("json_extract_scalar", 20, "$.last[0]");
+}
+
+BENCHMARK(folly_extract) {
+  JsonBenchmark benchmark;
+  benchmark.runJson("folly_json_extract", 20, "$.user");
+}
+
+BENCHMARK_RELATIVE(velox_extract) {
+  JsonBenchmark benchmark;
+  benchmark.runJson("json_extract", 20, "$.user");
+}
+
+BENCHMARK(folly_array_length) {
+  JsonBenchmark benchmark;
+  benchmark.runJson("folly_json_array_length", 20);
+}
+
+BENCHMARK_RELATIVE(velox_array_length) {
+  JsonBenchmark benchmark;
+  benchmark.runJson("json_array_length", 20);
+}
+
+} // namespace
+
+int main(int /*argc*/, char** /*argv*/) {
+  folly::runBenchmarks();
+  return 0;
+}
@@ -25,6 +25,7 @@
 #include "folly/json.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/functions/prestosql/json/JsonPathTokenizer.h"
+#include "velox/functions/prestosql/json/JsonScanner.h"
 
 namespace facebook::velox::functions {
 
@@ -55,49 +56,28 @@ class JsonExtractor {
 
   folly::Optional<folly::dynamic> extract(const folly::dynamic& json);
 
-  // Shouldn't instantiate directly - use getInstance().
-  explicit JsonExtractor(const std::string& path) {
-    if (!tokenize(path)) {
-      VELOX_USER_FAIL("Invalid JSON path: {}", path);
-    }
+  const JsonPath& path() const {
+    return path_;
   }
 
- private:
-  bool tokenize(const std::string& path) {
-    if (path.empty()) {
-      return false;
-    }
-    if (!kTokenizer.reset(path)) {
-      return false;
-    }
-
-    while (kTokenizer.hasNext()) {
-      if (auto token = kTokenizer.getNext()) {
-        tokens_.push_back(token.value());
-      } else {
-        tokens_.clear();
-        return false;
-      }
-    }
-    return true;
-  }
+  // Shouldn't instantiate directly - use getInstance().
+  explicit JsonExtractor(const std::string& path) : path_(path) {}
 
+ private:
   // Cache tokenize operations in JsonExtractor across invocations in the same
   // thread for the same JsonPath.
   thread_local static std::
       unordered_map<std::string, std::shared_ptr<JsonExtractor>>
           kExtractorCache;
-  thread_local static JsonPathTokenizer kTokenizer;
 
   // Max extractor number in extractor cache
   static const uint32_t kMaxCacheNum{32};
 
-  std::vector<std::string> tokens_;
+  const JsonPath path_;
 };
 
 thread_local std::unordered_map<std::string, std::shared_ptr<JsonExtractor>>
     JsonExtractor::kExtractorCache;
-thread_local JsonPathTokenizer JsonExtractor::kTokenizer;
 
 void extractObject(
     const folly::dynamic* jsonObj,
@@ -137,7 +117,7 @@ folly::Optional<folly::dynamic> JsonExtractor::extract(
   JsonVector result;
   input.push_back(&json);
 
-  for (auto& token : tokens_) {
+  for (auto& token : path_.tokens()) {
     for (auto& jsonObj : input) {
       if (jsonObj->isObject()) {
         extractObject(jsonObj, token, result);
@@ -166,13 +146,110 @@ folly::Optional<folly::dynamic> JsonExtractor::extract(
   }
 }
 
-bool isScalarType(const folly::Optional<folly::dynamic>& json) {
-  return json.has_value() && !json->isObject() && !json->isArray() &&
-      !json->isNull();
+enum class WalkResult { kContinue, kStop, kError };
+
+// Calls 'onMatch' with 'scanner' positioned at each value at the tokens of
+// 'path' from 'depth' on in the next value of 'scanner'. 'onMatch' consumes
+// the value and returns false if it is malformed. Returns kStop after the
+// match if 'path' cannot match more than one value.
+template <typename OnMatch>
+WalkResult walk(
+    JsonScanner& scanner,
+    const JsonPath& path,
+    int32_t depth,
+    OnMatch& onMatch) {
+  const auto& tokens = path.tokens();
+  if (depth == tokens.size()) {
+    if (!onMatch(scanner)) {
+      return WalkResult::kError;
+    }
+    return path.hasWildcard() ? WalkResult::kContinue : WalkResult::kStop;
+  }
+  const auto& token = tokens[depth];
+  const auto kind = scanner.peek();
+  if (kind == JsonScanner::Kind::kObject) {
+    scanner.enterObject();
+    std::string_view key;
+    while (scanner.nextField(key)) {
+      if (JsonScanner::keyEquals(key, token)) {
+        auto result = walk(scanner, path, depth + 1, onMatch);
+        if (result != WalkResult::kContinue) {
+          return result;
+        }
+      } else if (!scanner.skipValue()) {
+        return WalkResult::kError;
+      }
+    }
+  } else if (kind == JsonScanner::Kind::kArray) {
+    scanner.enterArray();
+    const bool all = token == "*";
+    int64_t index = -1;
+    if (!all) {
+      auto rv = folly::tryTo<int32_t>(token);
+      if (rv.hasValue()) {
+        index = rv.value();
+      }
+    }
+    for (int64_t i = 0; scanner.nextElement(); ++i) {
+      if (all || i == index) {
+        auto result = walk(scanner, path, depth + 1, onMatch);
+        if (result != WalkResult::kContinue) {
+          return result;
+        }
+      } else if (!scanner.skipValue()) {
+        return WalkResult::kError;
+      }
+    }
+  } else {
+    scanner.skipValue();
+  }
+  return scanner.failed() ? WalkResult::kError : WalkResult::kContinue;
+}
+
+// Returns the number of members of the next value of 'scanner' if it is an
+// array or object and 0 if it is a scalar.
+folly::Optional<int64_t> scanSize(JsonScanner& scanner) {
+  int64_t size = 0;
+  const auto kind = scanner.peek();
+  if (kind == JsonScanner::Kind::kObject) {
+    scanner.enterObject();
+    std::string_view key;
+    while (scanner.nextField(key) && scanner.skipValue()) {
+      ++size;
+    }
+  } else if (kind == JsonScanner::Kind::kArray) {
+    scanner.enterArray();
+    while (scanner.nextElement() && scanner.skipValue()) {
+      ++size;
+    }
+  } else {
+    scanner.skipValue();
+  }
+  if (scanner.failed()) {
+    return folly::none;
+  }
+  return size;
 }
 
 } // namespace
 
+JsonPath::JsonPath(folly::StringPiece path) {
+  auto trimmedPath = folly::trimWhitespace(path);
+  JsonPathTokenizer tokenizer;
+  bool valid = !trimmedPath.empty() && tokenizer.reset(trimmedPath);
+  while (valid && tokenizer.hasNext()) {
+    if (auto token = tokenizer.getNext()) {
+      hasWildcard_ |= token.value() == "*";
+      tokens_.push_back(std::move(token.value()));
+    } else {
+      valid = false;
+    }
+  }
+  if (!valid) {
+    VELOX_USER_FAIL("Invalid JSON path: {}", trimmedPath);
+  }
+}
+
 folly::Optional<folly::dynamic> jsonExtract(
     folly::StringPiece json,
     folly::StringPiece path) {
@@ -207,19 +284,108 @@ folly::Optional<folly::dynamic> jsonExtract(
   return folly::none;
 }
 
+const JsonPath& cachedJsonPath(folly::StringPiece path) {
+  return JsonExtractor::getInstance(path).path();
+}
+
 folly::Optional<std::string> jsonExtractScalar(
     folly::StringPiece json,
     folly::StringPiece path) {
-  auto res = jsonExtract(json, path);
-  // Not a scalar value
-  if (isScalarType(res)) {
-    if (res->isBool()) {
-      return res->asBool() ? std::string{"true"} : std::string{"false"};
-    } else {
-      return res->asString();
+  // An invalid path throws a VeloxUserError.
+  return jsonExtractScalar(json, cachedJsonPath(path));
+}
+
+folly::Optional<std::string> jsonExtractScalar(
+    folly::StringPiece json,
+    const JsonPath& path) {
+  JsonScanner scanner(std::string_view(json.data(), json.size()));
+  int32_t numMatches = 0;
+  folly::Optional<std::string> value;
+  auto onMatch = [&](JsonScanner& scanner) {
+    // Several values make an array, which is not a scalar.
+    if (++numMatches > 1) {
+      value = folly::none;
+      return scanner.skipValue();
+    }
+    switch (scanner.peek().value_or(JsonScanner::Kind::kNull)) {
+      case JsonScanner::Kind::kString:
+        value.emplace();
+        return scanner.readString(value.value());
+      case JsonScanner::Kind::kNumber: {
+        std::string_view number;
+        if (!scanner.readNumber(number)) {
+          return false;
+        }
+        value = std::string(number);
+        return true;
+      }
+      case JsonScanner::Kind::kTrue:
+        value = std::string("true");
+        return scanner.skipValue();
+      case JsonScanner::Kind::kFalse:
+        value = std::string("false");
+        return scanner.skipValue();
+      default:
+        return scanner.skipValue();
     }
+  };
+  if (walk(scanner, path, 0, onMatch) == WalkResult::kError) {
+    return folly::none;
   }
-  return folly::none;
+  return value;
+}
+
+bool jsonExtract(
+    folly::StringPiece json,
+    const JsonPath& path,
+    std::string& result) {
+  result.clear();
+  JsonScanner scanner(std::string_view(json.data(), json.size()));
+  int32_t numMatches = 0;
+  auto onMatch = [&](JsonScanner& scanner) {
+    if (numMatches++ > 0) {
+      result.push_back(',');
+    }
+    return scanner.copyValue(result);
+  };
+  if (walk(scanner, path, 0, onMatch) == WalkResult::kError ||
+      numMatches == 0) {
+    return false;
+  }
+  if (numMatches > 1) {
+    result.insert(result.begin(), '[');
+    result.push_back(']');
+  }
+  return true;
+}
+
+folly::Optional<int64_t> jsonArrayLength(folly::StringPiece json) {
+  JsonScanner scanner(std::string_view(json.data(), json.size()));
+  if (scanner.peek() != JsonScanner::Kind::kArray) {
+    return folly::none;
+  }
+  return scanSize(scanner);
+}
+
+folly::Optional<int64_t> jsonSize(
+    folly::StringPiece json,
+    const JsonPath& path) {
+  JsonScanner scanner(std::string_view(json.data(), json.size()));
+  int32_t numMatches = 0;
+  folly::Optional<int64_t> size;
+  auto onMatch = [&](JsonScanner& scanner) {
+    // The values matched by a wildcard count as an array.
+    if (++numMatches > 1) {
+      size = numMatches;
+      return scanner.skipValue();
+    }
+    size = scanSize(scanner);
+    return size.has_value();
+  };
+  if (walk(scanner, path, 0, onMatch) == WalkResult::kError) {
+    return folly::none;
+  }
+  return size;
 }
 
 folly::Optional<std::string> jsonExtractScalar(
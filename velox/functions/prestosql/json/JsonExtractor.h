@@ -17,12 +17,34 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "folly/Range.h"
 #include "folly/dynamic.h"
 
 namespace facebook::velox::functions {
 
+/// A JSON path split into its keys and subscripts. Compiling a path once
+/// saves tokenizing it for every row when the path is a constant.
+class JsonPath {
+ public:
+  /// Throws a VeloxUserError if 'path' is not a valid JSON path.
+  explicit JsonPath(folly::StringPiece path);
+
+  const std::vector<std::string>& tokens() const {
+    return tokens_;
+  }
+
+  /// True if the path has a '*' that may match several values.
+  bool hasWildcard() const {
+    return hasWildcard_;
+  }
+
+ private:
+  std::vector<std::string> tokens_;
+  bool hasWildcard_{false};
+};
+
 /**
  * Extract a json object from path
  * @param json: A json object
@@ -67,6 +89,40 @@ folly::Optional<folly::dynamic> jsonExtract(
     const std::string& json,
     const std::string& path);
 
+/// Returns 'path' compiled. Compiled paths are cached per thread. The
+/// result is valid until the next call on the same thread.
+const JsonPath& cachedJsonPath(folly::StringPiece path);
+
+/// The functions below scan 'json' in place with a JsonScanner instead of
+/// parsing it into a folly::dynamic. They stop at the value 'path' refers
+/// to, so text after that value is not validated.
+
+/// Returns the scalar value at 'path' in 'json' as a string. Numbers are
+/// returned as written. Returns folly::none if there is no value at 'path',
+/// the value is null, an array or an object, or 'json' is malformed.
+folly::Optional<std::string> jsonExtractScalar(
+    folly::StringPiece json,
+    const JsonPath& path);
+
+/// Sets 'result' to the JSON text of the value at 'path' in 'json' with no
+/// whitespace between tokens. If a wildcard in 'path' matches several
+/// values, 'result' is an array of them. Returns false if no value matches
+/// or 'json' is malformed.
+bool jsonExtract(
+    folly::StringPiece json,
+    const JsonPath& path,
+    std::string& result);
+
+/// Returns the number of elements of the array 'json' or folly::none if
+/// 'json' is not an array.
+folly::Optional<int64_t> jsonArrayLength(folly::StringPiece json);
+
+/// Returns the number of members of the array or object at 'path' in
+/// 'json', 0 for a scalar or folly::none if there is no value at 'path'.
+folly::Optional<int64_t> jsonSize(
+    folly::StringPiece json,
+    const JsonPath& path);
+
 folly::Optional<std::string> jsonExtractScalar(
     const std::string& json,
     const std::string& path);
@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/functions/prestosql/json/JsonScanner.h"
+
+#include "velox/common/base/SimdUtil.h"
+
+namespace facebook::velox::functions {
+
+namespace {
+
+inline bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+inline bool isHexDigit(char c) {
+  return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// True for the characters that end a run of plain string content.
+inline bool isStringSpecial(char c) {
+  return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+// Returns the number of leading bytes of 'data' that are plain string
+// content, checking a SIMD register of bytes at a time. Stops before the
+// last 'size' % register width bytes, which the caller checks one by one.
+int64_t skipStringContent(const char* data, int64_t size) {
+  constexpr int32_t kWidth = xsimd::batch<int8_t>::size;
+  const auto quote = xsimd::broadcast<int8_t>('"');
+  const auto backslash = xsimd::broadcast<int8_t>('\\');
+  const auto zero = xsimd::broadcast<int8_t>(0);
+  const auto space = xsimd::broadcast<int8_t>(0x20);
+  int64_t offset = 0;
+  for (; offset + kWidth <= size; offset += kWidth) {
+    auto bytes =
+        xsimd::load_unaligned(reinterpret_cast<const int8_t*>(data + offset));
+    // Control characters are 0..0x1f. Bytes of multibyte UTF-8 characters
+    // are negative as int8_t.
+    auto special = (bytes == quote) | (bytes == backslash) |
+        ((bytes >= zero) & (bytes < space));
+    uint32_t mask = simd::toBitMask(special);
+    if (mask) {
+      return offset + __builtin_ctz(mask);
+    }
+  }
+  return offset;
+}
+
+bool parseHex4(std::string_view text, size_t offset, uint32_t& value) {
+  if (offset + 4 > text.size()) {
+    return false;
+  }
+  value = 0;
+  for (auto i = offset; i < offset + 4; ++i) {
+    const char c = text[i];
+    uint32_t digit;
+    if (isDigit(c)) {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    value = value * 16 + digit;
+  }
+  return true;
+}
+
+void appendUtf8(uint32_t codePoint, std::string& out) {
+  if (codePoint < 0x80) {
+    out.push_back(codePoint);
+  } else if (codePoint < 0x800) {
+    out.push_back(0xc0 | (codePoint >> 6));
+    out.push_back(0x80 | (codePoint & 0x3f));
+  } else if (codePoint < 0x10000) {
+    out.push_back(0xe0 | (codePoint >> 12));
+    out.push_back(0x80 | ((codePoint >> 6) & 0x3f));
+    out.push_back(0x80 | (codePoint & 0x3f));
+  } else {
+    out.push_back(0xf0 | (codePoint >> 18));
+    out.push_back(0x80 | ((codePoint >> 12) & 0x3f));
+    out.push_back(0x80 | ((codePoint >> 6) & 0x3f));
+    out.push_back(0x80 | (codePoint & 0x3f));
+  }
+}
+} // namespace
+
+void JsonScanner::skipWhitespace() {
+  while (pos_ < end_ &&
+         (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t')) {
+    ++pos_;
+  }
+}
+
+std::optional<JsonScanner::Kind> JsonScanner::peek() {
+  if (failed_) {
+    return std::nullopt;
+  }
+  skipWhitespace();
+  if (pos_ >= end_) {
+    return std::nullopt;
+  }
+  switch (*pos_) {
+    case '{':
+      return Kind::kObject;
+    case '[':
+      return Kind::kArray;
+    case '"':
+      return Kind::kString;
+    case 't':
+      return Kind::kTrue;
+    case 'f':
+      return Kind::kFalse;
+    case 'n':
+      return Kind::kNull;
+    default:
+      if (*pos_ == '-' || isDigit(*pos_)) {
+        return Kind::kNumber;
+      }
+      return std::nullopt;
+  }
+}
+
+bool JsonScanner::skipValue() {
+  auto kind = peek();
+  if (!kind) {
+    return fail();
+  }
+  switch (*kind) {
+    case Kind::kObject: {
+      enterObject();
+      std::string_view key;
+      while (nextField(key)) {
+        if (!skipValue()) {
+          return false;
+        }
+      }
+      return !failed_;
+    }
+    case Kind::kArray:
+      enterArray();
+      while (nextElement()) {
+        if (!skipValue()) {
+          return false;
+        }
+      }
+      return !failed_;
+    case Kind::kString: {
+      std::string_view raw;
+      return scanString(raw);
+    }
+    case Kind::kNumber: {
+      std::string_view text;
+      return scanNumber(text);
+    }
+    case Kind::kTrue:
+      return scanLiteral("true");
+    case Kind::kFalse:
+      return scanLiteral("false");
+    case Kind::kNull:
+      return scanLiteral("null");
+  }
+  return fail();
+}
+
+bool JsonScanner::enter(char open) {
+  if (failed_) {
+    return false;
+  }
+  skipWhitespace();
+  if (pos_ >= end_ || *pos_ != open || ++depth_ > kMaxDepth) {
+    return fail();
+  }
+  ++pos_;
+  first_ = true;
+  return true;
+}
+
+bool JsonScanner::enterArray() {
+  return enter('[');
+}
+
+bool JsonScanner::enterObject() {
+  return enter('{');
+}
+
+bool JsonScanner::nextMember(char close) {
+  if (failed_) {
+    return false;
+  }
+  const bool first = first_;
+  first_ = false;
+  skipWhitespace();
+  if (pos_ >= end_) {
+    return fail();
+  }
+  if (*pos_ == close) {
+    ++pos_;
+    --depth_;
+    return false;
+  }
+  if (!first) {
+    if (*pos_ != ',') {
+      return fail();
+    }
+    ++pos_;
+  }
+  return true;
+}
+
+bool JsonScanner::nextElement() {
+  return nextMember(']');
+}
+
+bool JsonScanner::nextField(std::string_view& rawKey) {
+  if (!nextMember('}')) {
+    return false;
+  }
+  skipWhitespace();
+  if (pos_ >= end_ || *pos_ != '"' || !scanString(rawKey)) {
+    return fail();
+  }
+  skipWhitespace();
+  if (pos_ >= end_ || *pos_ != ':') {
+    return fail();
+  }
+  ++pos_;
+  return true;
+}
+
+bool JsonScanner::scanString(std::string_view& raw) {
+  // 'pos_' is at the opening quote.
+  const char* start = ++pos_;
+  for (;;) {
+    pos_ += skipStringContent(pos_, end_ - pos_);
+    while (pos_ < end_ && !isStringSpecial(*pos_)) {
+      ++pos_;
+    }
+    if (pos_ >= end_) {
+      return fail();
+    }
+    if (*pos_ == '"') {
+      raw = std::string_view(start, pos_ - start);
+      ++pos_;
+      return true;
+    }
+    if (*pos_ != '\\' || pos_ + 1 >= end_) {
+      // An unescaped control character or a backslash at the end.
+      return fail();
+    }
+    switch (pos_[1]) {
+      case '"':
+      case '\\':
+      case '/':
+      case 'b':
+      case 'f':
+      case 'n':
+      case 'r':
+      case 't':
+        pos_ += 2;
+        break;
+      case 'u':
+        if (end_ - pos_ < 6 || !isHexDigit(pos_[2]) || !isHexDigit(pos_[3]) ||
+            !isHexDigit(pos_[4]) || !isHexDigit(pos_[5])) {
+          return fail();
+        }
+        pos_ += 6;
+        break;
+      default:
+        return fail();
+    }
+  }
+}
+
+bool JsonScanner::scanNumber(std::string_view& text) {
+  const char* start = pos_;
+  if (pos_ < end_ && *pos_ == '-') {
+    ++pos_;
+  }
+  if (pos_ >= end_ || !isDigit(*pos_)) {
+    return fail();
+  }
+  if (*pos_ == '0') {
+    ++pos_;
+  } else {
+    while (pos_ < end_ && isDigit(*pos_)) {
+      ++pos_;
+    }
+  }
+  if (pos_ < end_ && *pos_ == '.') {
+    ++pos_;
+    if (pos_ >= end_ || !isDigit(*pos_)) {
+      return fail();
+    }
+    while (pos_ < end_ && isDigit(*pos_)) {
+      ++pos_;
+    }
+  }
+  if (pos_ < end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+    ++pos_;
+    if (pos_ < end_ && (*pos_ == '+' || *pos_ == '-')) {
+      ++pos_;
+    }
+    if (pos_ >= end_ || !isDigit(*pos_)) {
+      return fail();
+    }
+    while (pos_ < end_ && isDigit(*pos_)) {
+      ++pos_;
+    }
+  }
+  text = std::string_view(start, pos_ - start);
+  return true;
+}
+
+bool JsonScanner::scanLiteral(std::string_view literal) {
+  if (end_ - pos_ < literal.size() ||
+      std::string_view(pos_, literal.size()) != literal) {
+    return fail();
+  }
+  pos_ += literal.size();
+  return true;
+}
+
+bool JsonScanner::readString(std::string& out) {
+  std::string_view raw;
+  if (peek() != Kind::kString || !scanString(raw)) {
+    return fail();
+  }
+  return unescape(raw, out) || fail();
+}
+
+bool JsonScanner::readNumber(std::string_view& text) {
+  if (peek() != Kind::kNumber) {
+    return fail();
+  }
+  return scanNumber(text);
+}
+
+bool JsonScanner::copyValue(std::string& out) {
+  auto kind = peek();
+  if (!kind) {
+    return fail();
+  }
+  switch (*kind) {
+    case Kind::kObject: {
+      enterObject();
+      out.push_back('{');
+      std::string_view key;
+      bool first = true;
+      while (nextField(key)) {
+        if (!first) {
+          out.push_back(',');
+        }
+        first = false;
+        out.push_back('"');
+        out.append(key);
+        out.append("\":");
+        if (!copyValue(out)) {
+          return false;
+        }
+      }
+      out.push_back('}');
+      return !failed_;
+    }
+    case Kind::kArray: {
+      enterArray();
+      out.push_back('[');
+      bool first = true;
+      while (nextElement()) {
+        if (!first) {
+          out.push_back(',');
+        }
+        first = false;
+        if (!copyValue(out)) {
+          return false;
+        }
+      }
+      out.push_back(']');
+      return !failed_;
+    }
+    case Kind::kString: {
+      std::string_view raw;
+      if (!scanString(raw)) {
+        return false;
+      }
+      out.push_back('"');
+      out.append(raw);
+      out.push_back('"');
+      return true;
+    }
+    case Kind::kNumber: {
+      std::string_view text;
+      if (!scanNumber(text)) {
+        return false;
+      }
+      out.append(text);
+      return true;
+    }
+    case Kind::kTrue:
+    case Kind::kFalse:
+    case Kind::kNull: {
+      const char* start = pos_;
+      if (!skipValue()) {
+        return false;
+      }
+      out.append(start, pos_ - start);
+      return true;
+    }
+  }
+  return fail();
+}
+
+bool JsonScanner::atEnd() {
+  if (failed_) {
+    return false;
+  }
+  skipWhitespace();
+  return pos_ == end_;
+}
+
+// static
+bool JsonScanner::unescape(std::string_view raw, std::string& out) {
+  size_t i = 0;
+  for (;;) {
+    const auto backslash = raw.find('\\', i);
+    if (backslash == std::string_view::npos) {
+      out.append(raw.substr(i));
+      return true;
+    }
+    out.append(raw.substr(i, backslash - i));
+    i = backslash + 1;
+    if (i >= raw.size()) {
+      return false;
+    }
+    switch (raw[i++]) {
+      case '"':
+        out.push_back('"');
+        break;
+      case '\\':
+        out.push_back('\\');
+        break;
+      case '/':
+        out.push_back('/');
+        break;
+      case 'b':
+        out.push_back('\b');
+        break;
+      case 'f':
+        out.push_back('\f');
+        break;
+      case 'n':
+        out.push_back('\n');
+        break;
+      case 'r':
+        out.push_back('\r');
+        break;
+      case 't':
+        out.push_back('\t');
+        break;
+      case 'u': {
+        uint32_t codePoint;
+        if (!parseHex4(raw, i, codePoint)) {
+          return false;
+        }
+        i += 4;
+        // A high surrogate followed by an escaped low surrogate is one
+        // code point outside of the basic multilingual plane.
+        uint32_t low;
+        if (codePoint >= 0xd800 && codePoint <= 0xdbff &&
+            i + 6 <= raw.size() && raw[i] == '\\' && raw[i + 1] == 'u' &&
+            parseHex4(raw, i + 2, low) && low >= 0xdc00 && low <= 0xdfff) {
+          codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+          i += 6;
+        }
+        appendUtf8(codePoint, out);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+}
+
+// static
+bool JsonScanner::keyEquals(std::string_view raw, std::string_view key) {
+  if (raw.find('\\') == std::string_view::npos) {
+    return raw == key;
+  }
+  std::string decoded;
+  return unescape(raw, decoded) && decoded == key;
+}
+
+// static
+bool JsonScanner::isInteger(std::string_view number) {
+  return number.find_first_of(".eE") == std::string_view::npos;
+}
+
+} // namespace facebook::velox::functions
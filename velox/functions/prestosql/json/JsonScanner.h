@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace facebook::velox::functions {
+
+/// Parses a JSON document in place without building a tree of values. The
+/// caller walks the document and decodes only the values it needs. Values
+/// it passes over are validated and skipped, with the contents of strings
+/// skipped a SIMD register at a time.
+///
+/// The first syntax error makes the current and all later calls return
+/// false. Text after the last value a caller reads is not looked at, so a
+/// document that is malformed only after that point reads as valid. Use
+/// atEnd() to check that a document has nothing after its value.
+class JsonScanner {
+ public:
+  enum class Kind { kObject, kArray, kString, kNumber, kTrue, kFalse, kNull };
+
+  /// Maximum nesting of arrays and objects.
+  static constexpr int32_t kMaxDepth = 1'000;
+
+  explicit JsonScanner(std::string_view json)
+      : pos_(json.data()), end_(json.data() + json.size()) {}
+
+  /// Returns the kind of the next value or std::nullopt if the next
+  /// character cannot start a value.
+  std::optional<Kind> peek();
+
+  /// Skips the next value.
+  bool skipValue();
+
+  /// Consumes the opening bracket of the next value, which must be an
+  /// array. The elements are then visited with nextElement().
+  bool enterArray();
+
+  /// Positions at the next element of the innermost entered array. Returns
+  /// false after consuming the closing bracket or on error, which are told
+  /// apart by failed(). The caller must consume each element before the
+  /// next call.
+  bool nextElement();
+
+  /// Consumes the opening brace of the next value, which must be an
+  /// object. The fields are then visited with nextField().
+  bool enterObject();
+
+  /// Like nextElement() for the innermost entered object. Sets 'rawKey' to
+  /// the key of the field with escapes not decoded and positions at the
+  /// value.
+  bool nextField(std::string_view& rawKey);
+
+  /// Reads a string and appends its value with escapes decoded to 'out'.
+  bool readString(std::string& out);
+
+  /// Reads a number and sets 'text' to it as written.
+  bool readNumber(std::string_view& text);
+
+  /// Reads the next value and appends its JSON text without whitespace
+  /// between tokens to 'out'.
+  bool copyValue(std::string& out);
+
+  /// Returns true if only whitespace is left.
+  bool atEnd();
+
+  bool failed() const {
+    return failed_;
+  }
+
+  /// Appends 'raw', the characters between the quotes of a JSON string, to
+  /// 'out' with escapes decoded. Returns false on an invalid escape.
+  static bool unescape(std::string_view raw, std::string& out);
+
+  /// Returns true if 'raw' is the undecoded form of 'key'.
+  static bool keyEquals(std::string_view raw, std::string_view key);
+
+  /// Returns true if 'number' as returned by readNumber() has no fraction
+  /// or exponent.
+  static bool isInteger(std::string_view number);
+
+ private:
+  void skipWhitespace();
+
+  // Scans the string starting at 'pos_' and sets 'raw' to the characters
+  // between the quotes.
+  bool scanString(std::string_view& raw);
+
+  bool scanNumber(std::string_view& text);
+
+  bool scanLiteral(std::string_view literal);
+
+  bool enter(char open);
+
+  // Common part of nextElement() and nextField().
+  bool nextMember(char close);
+
+  bool fail() {
+    failed_ = true;
+    return false;
+  }
+
+  const char* pos_;
+  const char* const end_;
+  int32_t depth_{0};
+  // True from entering an array or object until its first member.
+  bool first_{false};
+  bool failed_{false};
+};
+
+} // namespace facebook::velox::functions
@@ -21,8 +21,11 @@
 #include "velox/common/base/VeloxException.h"
 
 using facebook::velox::VeloxUserError;
+using facebook::velox::functions::JsonPath;
+using facebook::velox::functions::jsonArrayLength;
 using facebook::velox::functions::jsonExtract;
 using facebook::velox::functions::jsonExtractScalar;
+using facebook::velox::functions::jsonSize;
 using folly::json::parse_error;
 using namespace std::string_literals;
 
@@ -501,3 +504,46 @@ TEST(JsonExtractorTest, jsonMultipleExtractsTest) {
   ASSERT_TRUE(extract2.hasValue());
   EXPECT_EQ(jsonExtract(json, "$.store.fruit").value(), extract2.value());
 }
+
+TEST(JsonExtractorTest, compiledPath) {
+  EXPECT_THROW(JsonPath("$.fuu..bar"), VeloxUserError);
+  EXPECT_THROW(JsonPath(""), VeloxUserError);
+  EXPECT_FALSE(JsonPath("$.a[0].b").hasWildcard());
+  EXPECT_TRUE(JsonPath("$.a[*].b").hasWildcard());
+
+  const std::string json =
+      R"({"a": [{"b": 1.50, "c": "x\"y"}, {"b": true}], "d": null})";
+  EXPECT_EQ(jsonExtractScalar(json, JsonPath("$.a[0].b")).value(), "1.50");
+  EXPECT_EQ(jsonExtractScalar(json, JsonPath("$.a[0].c")).value(), "x\"y");
+  EXPECT_EQ(jsonExtractScalar(json, JsonPath("$.a[1].b")).value(), "true");
+  EXPECT_FALSE(jsonExtractScalar(json, JsonPath("$.a[0]")).hasValue());
+  EXPECT_FALSE(jsonExtractScalar(json, JsonPath("$.d")).hasValue());
+  EXPECT_FALSE(jsonExtractScalar(json, JsonPath("$.e")).hasValue());
+  EXPECT_FALSE(jsonExtractScalar("{\"a\": ", JsonPath("$.a")).hasValue());
+
+  std::string result;
+  ASSERT_TRUE(jsonExtract(json, JsonPath("$.a[0]"), result));
+  EXPECT_EQ(result, R"({"b":1.50,"c":"x\"y"})");
+  result.clear();
+  ASSERT_TRUE(jsonExtract(json, JsonPath("$.a[*].b"), result));
+  EXPECT_EQ(result, "[1.50,true]");
+  result.clear();
+  ASSERT_TRUE(jsonExtract(json, JsonPath("$.d"), result));
+  EXPECT_EQ(result, "null");
+  result.clear();
+  EXPECT_FALSE(jsonExtract(json, JsonPath("$.a[2]"), result));
+}
+
+TEST(JsonExtractorTest, arrayLengthAndSize) {
+  EXPECT_EQ(jsonArrayLength("[]").value(), 0);
+  EXPECT_EQ(jsonArrayLength(R"([1, [2, 3], {"a": 4}])").value(), 3);
+  EXPECT_FALSE(jsonArrayLength(R"({"a": 1})").hasValue());
+  EXPECT_FALSE(jsonArrayLength("[1, 2").hasValue());
+
+  const std::string json = R"({"a": [1, 2, 3], "b": {"c": 1}, "d": "e"})";
+  EXPECT_EQ(jsonSize(json, JsonPath("$")).value(), 3);
+  EXPECT_EQ(jsonSize(json, JsonPath("$.a")).value(), 3);
+  EXPECT_EQ(jsonSize(json, JsonPath("$.b")).value(), 1);
+  EXPECT_EQ(jsonSize(json, JsonPath("$.d")).value(), 0);
+  EXPECT_FALSE(jsonSize(json, JsonPath("$.x")).hasValue());
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/functions/prestosql/json/JsonScanner.h"
+
+#include "gtest/gtest.h"
+
+using facebook::velox::functions::JsonScanner;
+
+namespace {
+bool isValid(std::string_view json) {
+  JsonScanner scanner(json);
+  return scanner.skipValue() && scanner.atEnd();
+}
+
+std::string copy(std::string_view json) {
+  JsonScanner scanner(json);
+  std::string out;
+  EXPECT_TRUE(scanner.copyValue(out));
+  EXPECT_TRUE(scanner.atEnd());
+  return out;
+}
+} // namespace
+
+TEST(JsonScannerTest, validate) {
+  EXPECT_TRUE(isValid("1"));
+  EXPECT_TRUE(isValid(" -0.5e+10 "));
+  EXPECT_TRUE(isValid("true"));
+  EXPECT_TRUE(isValid("null"));
+  EXPECT_TRUE(isValid(R"("a\"b\\c\u00e9")"));
+  EXPECT_TRUE(isValid(R"({"a":[1,{"b":null}],"c":"d"})"));
+  EXPECT_TRUE(isValid("[]"));
+  EXPECT_TRUE(isValid("{ }"));
+
+  // Strings longer than a SIMD register with the quote at each position.
+  for (auto i = 0; i < 70; ++i) {
+    std::string json = "\"" + std::string(i, 'x') + "\"";
+    EXPECT_TRUE(isValid(json)) << json;
+    json = "\"" + std::string(i, 'x') + "\\\"x\"";
+    EXPECT_TRUE(isValid(json)) << json;
+  }
+
+  EXPECT_FALSE(isValid(""));
+  EXPECT_FALSE(isValid("01"));
+  EXPECT_FALSE(isValid("1."));
+  EXPECT_FALSE(isValid("-"));
+  EXPECT_FALSE(isValid("tru"));
+  EXPECT_FALSE(isValid("NaN"));
+  EXPECT_FALSE(isValid("[1,]"));
+  EXPECT_FALSE(isValid("[1 2]"));
+  EXPECT_FALSE(isValid(R"({"a" 1})"));
+  EXPECT_FALSE(isValid(R"({a:1})"));
+  EXPECT_FALSE(isValid(R"("abc)"));
+  EXPECT_FALSE(isValid(R"("\x")"));
+  EXPECT_FALSE(isValid(R"("\u12")"));
+  EXPECT_FALSE(isValid("\"a\nb\""));
+  EXPECT_FALSE(isValid("[1] 2"));
+}
+
+TEST(JsonScannerTest, depth) {
+  std::string nested(JsonScanner::kMaxDepth, '[');
+  nested.append(JsonScanner::kMaxDepth, ']');
+  EXPECT_TRUE(isValid(nested));
+  EXPECT_FALSE(isValid("[" + nested + "]"));
+}
+
+TEST(JsonScannerTest, walk) {
+  JsonScanner scanner(R"( {"k1": [1, "two", true], "k\"2": null} )");
+  EXPECT_EQ(scanner.peek(), JsonScanner::Kind::kObject);
+  ASSERT_TRUE(scanner.enterObject());
+
+  std::string_view key;
+  ASSERT_TRUE(scanner.nextField(key));
+  EXPECT_EQ(key, "k1");
+  ASSERT_TRUE(scanner.enterArray());
+  ASSERT_TRUE(scanner.nextElement());
+  std::string_view number;
+  ASSERT_TRUE(scanner.readNumber(number));
+  EXPECT_EQ(number, "1");
+  ASSERT_TRUE(scanner.nextElement());
+  std::string value;
+  ASSERT_TRUE(scanner.readString(value));
+  EXPECT_EQ(value, "two");
+  ASSERT_TRUE(scanner.nextElement());
+  EXPECT_EQ(scanner.peek(), JsonScanner::Kind::kTrue);
+  ASSERT_TRUE(scanner.skipValue());
+  EXPECT_FALSE(scanner.nextElement());
+  EXPECT_FALSE(scanner.failed());
+
+  ASSERT_TRUE(scanner.nextField(key));
+  EXPECT_EQ(key, R"(k\"2)");
+  EXPECT_TRUE(JsonScanner::keyEquals(key, "k\"2"));
+  EXPECT_EQ(scanner.peek(), JsonScanner::Kind::kNull);
+  ASSERT_TRUE(scanner.skipValue());
+  EXPECT_FALSE(scanner.nextField(key));
+  EXPECT_FALSE(scanner.failed());
+  EXPECT_TRUE(scanner.atEnd());
+}
+
+TEST(JsonScannerTest, errorIsSticky) {
+  JsonScanner scanner("[1, x, 2]");
+  ASSERT_TRUE(scanner.enterArray());
+  ASSERT_TRUE(scanner.nextElement());
+  ASSERT_TRUE(scanner.skipValue());
+  ASSERT_TRUE(scanner.nextElement());
+  EXPECT_FALSE(scanner.skipValue());
+  EXPECT_TRUE(scanner.failed());
+  EXPECT_FALSE(scanner.nextElement());
+  EXPECT_FALSE(scanner.peek().has_value());
+  EXPECT_FALSE(scanner.atEnd());
+}
+
+TEST(JsonScannerTest, unescape) {
+  auto unescape = [](std::string_view raw) {
+    std::string out;
+    EXPECT_TRUE(JsonScanner::unescape(raw, out)) << raw;
+    return out;
+  };
+  EXPECT_EQ(unescape("abc"), "abc");
+  EXPECT_EQ(unescape(R"(a\"b\\c\/d)"), "a\"b\\c/d");
+  EXPECT_EQ(unescape(R"(\b\f\n\r\t)"), "\b\f\n\r\t");
+  EXPECT_EQ(unescape(R"(\u0041\u00e9\u20ac)"), "A\u00e9\u20ac");
+  // A surrogate pair.
+  EXPECT_EQ(unescape(R"(\ud83d\ude00)"), "\U0001F600");
+
+  std::string out;
+  EXPECT_FALSE(JsonScanner::unescape(R"(\q)", out));
+  EXPECT_FALSE(JsonScanner::unescape(R"(\u00)", out));
+}
+
+TEST(JsonScannerTest, copyValue) {
+  EXPECT_EQ(
+      copy(R"( { "a" : [ 1 , 2.5 ] , "b" : { } } )"),
+      R"({"a":[1,2.5],"b":{}})");
+  EXPECT_EQ(copy(R"([ "x\ny" , null , false ])"), R"(["x\ny",null,false])");
+  EXPECT_EQ(copy("-1e3"), "-1e3");
+}
+
+TEST(JsonScannerTest, isInteger) {
+  EXPECT_TRUE(JsonScanner::isInteger("123"));
+  EXPECT_TRUE(JsonScanner::isInteger("-0"));
+  EXPECT_FALSE(JsonScanner::isInteger("1.0"));
+  EXPECT_FALSE(JsonScanner::isInteger("1e5"));
+  EXPECT_FALSE(JsonScanner::isInteger("1E-5"));
+}
@@ -148,16 +148,31 @@ TEST_F(JsonExtractScalarTest, invalidPath) {
   EXPECT_THROW(json_extract_scalar(R"({"k1":"v1)", "$.k1]"), VeloxUserError);
 }
 
-// TODO: Folly tries to convert scalar integers, and in case they are large
-// enough it overflows and throws conversion error. In this case, we do out best
-// and return NULL, but in Presto java the large integer is returned as-is as a
-// string.
+// Numbers are returned as written, like in Presto java, also if they do not
+// fit a bigint or double.
 TEST_F(JsonExtractScalarTest, overflow) {
   EXPECT_EQ(
       json_extract_scalar(
           R"(184467440737095516151844674407370955161518446744073709551615)",
           "$"),
-      std::nullopt);
+      "184467440737095516151844674407370955161518446744073709551615");
+  EXPECT_EQ(json_extract_scalar(R"({"k1":1.50e+00})", "$.k1"), "1.50e+00");
+}
+
+TEST_F(JsonExtractScalarTest, constantPath) {
+  auto data = makeRowVector({makeFlatVector<StringView>(
+      {R"({"k1":"v1"})"_sv, R"({"k1":[1]})"_sv, R"({"k2":2})"_sv, "[1"_sv})});
+  auto expected = makeNullableFlatVector<StringView>(
+      {"v1"_sv, std::nullopt, std::nullopt, std::nullopt});
+  ::facebook::velox::test::assertEqualVectors(
+      expected,
+      evaluate<SimpleVector<StringView>>(
+          "json_extract_scalar(c0, '$.k1')", data));
+
+  EXPECT_THROW(
+      evaluate<SimpleVector<StringView>>(
+          "json_extract_scalar(c0, '$.k1.')", data),
+      VeloxUserError);
 }
 
 } // namespace
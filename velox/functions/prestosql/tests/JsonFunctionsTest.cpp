@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/functions/prestosql/tests/FunctionBaseTest.h"
+
+namespace facebook::velox::functions::prestosql {
+
+namespace {
+
+class JsonFunctionsTest : public functions::test::FunctionBaseTest {
+ public:
+  std::optional<std::string> json_extract(
+      std::optional<std::string> json,
+      std::optional<std::string> path) {
+    return evaluateOnce<std::string>("json_extract(c0, c1)", json, path);
+  }
+
+  std::optional<int64_t> json_array_length(std::optional<std::string> json) {
+    return evaluateOnce<int64_t>("json_array_length(c0)", json);
+  }
+
+  std::optional<int64_t> json_size(
+      std::optional<std::string> json,
+      std::optional<std::string> path) {
+    return evaluateOnce<int64_t>("json_size(c0, c1)", json, path);
+  }
+
+  template <typename T>
+  std::optional<bool> json_array_contains(
+      std::optional<std::string> json,
+      std::optional<T> value) {
+    return evaluateOnce<bool>("json_array_contains(c0, c1)", json, value);
+  }
+};
+
+TEST_F(JsonFunctionsTest, jsonExtract) {
+  const std::string json = R"({"k1": [1, {"k2": "v"}]})";
+  EXPECT_EQ(json_extract(json, "$.k1"), R"([1,{"k2":"v"}])");
+  EXPECT_EQ(json_extract(json, "$.k1[1].k2"), R"("v")");
+  EXPECT_EQ(json_extract(R"({"k1": null})", "$.k1"), "null");
+  EXPECT_EQ(json_extract(R"([{"a": 1}, {"a": 2}])", "$[*].a"), "[1,2]");
+  EXPECT_EQ(json_extract(R"({"k1": 1})", "$.k2"), std::nullopt);
+  EXPECT_EQ(json_extract(std::nullopt, "$"), std::nullopt);
+  EXPECT_THROW(json_extract(R"({"k1": 1})", "$.k1."), VeloxUserError);
+}
+
+TEST_F(JsonFunctionsTest, jsonArrayLength) {
+  EXPECT_EQ(json_array_length("[]"), 0);
+  EXPECT_EQ(json_array_length(R"([1, "2", [3, 4], {"5": 6}])"), 4);
+  EXPECT_EQ(json_array_length(R"({"k1": [1, 2]})"), std::nullopt);
+  EXPECT_EQ(json_array_length("1"), std::nullopt);
+  EXPECT_EQ(json_array_length("[1, 2"), std::nullopt);
+  EXPECT_EQ(json_array_length(std::nullopt), std::nullopt);
+}
+
+TEST_F(JsonFunctionsTest, jsonSize) {
+  EXPECT_EQ(json_size(R"({"k1": {"a": 1, "b": 2}})", "$.k1"), 2);
+  EXPECT_EQ(json_size(R"({"k1": [1, 2, 3]})", "$.k1"), 3);
+  EXPECT_EQ(json_size(R"({"k1": "abc"})", "$.k1"), 0);
+  EXPECT_EQ(json_size(R"({"k1": 1})", "$.k2"), std::nullopt);
+  EXPECT_EQ(json_size("[]", "$"), 0);
+}
+
+TEST_F(JsonFunctionsTest, jsonArrayContains) {
+  EXPECT_EQ(json_array_contains<bool>("[1, true, false]", true), true);
+  EXPECT_EQ(json_array_contains<bool>("[1, false]", true), false);
+  EXPECT_EQ(json_array_contains<int64_t>(R"(["1", 2.0, 3])", 3), true);
+  EXPECT_EQ(json_array_contains<int64_t>(R"(["1", 2.0])", 2), false);
+  EXPECT_EQ(json_array_contains<double>("[1, 2.5e0]", 2.5), true);
+  EXPECT_EQ(json_array_contains<double>("[1, 2.5e0]", 3.5), false);
+  EXPECT_EQ(
+      json_array_contains<std::string>(R"([{"a": "b"}, "a\"b"])", "a\"b"),
+      true);
+  EXPECT_EQ(json_array_contains<std::string>(R"(["ab"])", "a"), false);
+
+  // Not an array.
+  EXPECT_EQ(json_array_contains<int64_t>(R"({"k1": 1})", 1), std::nullopt);
+  EXPECT_EQ(json_array_contains<int64_t>("[1, 2", 2), true);
+  EXPECT_EQ(json_array_contains<int64_t>("[1, 2", 3), std::nullopt);
+}
+
+} // namespace
+
+} // namespace facebook::velox::functions::prestosql
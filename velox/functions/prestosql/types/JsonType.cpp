@@ -28,11 +28,14 @@
 #include "velox/expression/StringWriter.h"
 #include "velox/expression/VectorWriters.h"
 #include "velox/functions/lib/LambdaFunctionUtil.h"
+#include "velox/functions/prestosql/json/JsonScanner.h"
 #include "velox/type/Type.h"
 
 namespace facebook::velox {
 namespace {
 
+using functions::JsonScanner;
+
 template <typename T, bool isMapKey = false>
 void generateJsonTyped(
     const SimpleVector<T>& input,
@@ -466,24 +469,28 @@ FOLLY_ALWAYS_INLINE void castFromJsonTyped<TypeKind::BOOLEAN>(
   writer.castTo<bool>() = object.asBool();
 }
 
+template <typename T>
+T castDoubleToInt(double value) {
+  constexpr double kIntMaxAsDouble =
+      static_cast<double>(std::numeric_limits<T>::max());
+  constexpr double kIntMinAsDouble =
+      static_cast<double>(std::numeric_limits<T>::min());
+
+  if (value <= kIntMaxAsDouble && value >= kIntMinAsDouble) {
+    return static_cast<T>(value);
+  } else {
+    throw std::invalid_argument(fmt::format(
+        "value is outside the range of {}: [{}, {}].",
+        CppToType<T>::create()->toString(),
+        kIntMinAsDouble,
+        kIntMaxAsDouble));
+  }
+}
+
 template <typename T>
 FOLLY_ALWAYS_INLINE T castJsonToInt(const folly::dynamic& object) {
   if (object.isDouble()) {
-    constexpr double kIntMaxAsDouble =
-        static_cast<double>(std::numeric_limits<T>::max());
-    constexpr double kIntMinAsDouble =
-        static_cast<double>(std::numeric_limits<T>::min());
-
-    double value = object.asDouble();
-    if (value <= kIntMaxAsDouble && value >= kIntMinAsDouble) {
-      return static_cast<T>(value);
-    } else {
-      throw std::invalid_argument(fmt::format(
-          "value is outside the range of {}: [{}, {}].",
-          CppToType<T>::create()->toString(),
-          kIntMinAsDouble,
-          kIntMaxAsDouble));
-    }
+    return castDoubleToInt<T>(object.asDouble());
   } else {
     return folly::to<T>(object.asInt());
   }
@@ -586,6 +593,171 @@ FOLLY_ALWAYS_INLINE void castFromJsonTyped<TypeKind::MAP>(
   }
 }
 
+// A scalar value read by a JsonScanner. Strings are unescaped and numbers
+// are as written.
+struct JsonScalar {
+  JsonScanner::Kind kind;
+  std::string text;
+};
+
+// Reads the next value of 'scanner', which must be a scalar other than
+// null.
+JsonScalar readJsonScalar(JsonScanner& scanner) {
+  auto kind = scanner.peek();
+  VELOX_USER_CHECK(kind.has_value(), "Not a JSON input");
+  JsonScalar scalar{kind.value(), {}};
+  switch (scalar.kind) {
+    case JsonScanner::Kind::kString:
+      VELOX_USER_CHECK(scanner.readString(scalar.text), "Not a JSON input");
+      break;
+    case JsonScanner::Kind::kNumber: {
+      std::string_view number;
+      VELOX_USER_CHECK(scanner.readNumber(number), "Not a JSON input");
+      scalar.text.assign(number);
+      break;
+    }
+    case JsonScanner::Kind::kTrue:
+    case JsonScanner::Kind::kFalse:
+      VELOX_USER_CHECK(scanner.skipValue(), "Not a JSON input");
+      break;
+    default:
+      VELOX_USER_FAIL("Expected a JSON scalar value");
+  }
+  return scalar;
+}
+
+// The conversions below give the same results as the ones of folly::dynamic
+// used by castFromJsonTyped.
+
+bool jsonScalarToBool(const JsonScalar& scalar) {
+  switch (scalar.kind) {
+    case JsonScanner::Kind::kTrue:
+      return true;
+    case JsonScanner::Kind::kFalse:
+      return false;
+    case JsonScanner::Kind::kNumber:
+      return JsonScanner::isInteger(scalar.text)
+          ? folly::to<int64_t>(scalar.text) != 0
+          : folly::to<double>(scalar.text) != 0;
+    default:
+      return folly::to<bool>(scalar.text);
+  }
+}
+
+template <typename T>
+T jsonScalarToInt(const JsonScalar& scalar) {
+  switch (scalar.kind) {
+    case JsonScanner::Kind::kTrue:
+      return 1;
+    case JsonScanner::Kind::kFalse:
+      return 0;
+    case JsonScanner::Kind::kNumber:
+      if (!JsonScanner::isInteger(scalar.text)) {
+        return castDoubleToInt<T>(folly::to<double>(scalar.text));
+      }
+      [[fallthrough]];
+    default:
+      return folly::to<T>(folly::to<int64_t>(scalar.text));
+  }
+}
+
+double jsonScalarToDouble(const JsonScalar& scalar) {
+  switch (scalar.kind) {
+    case JsonScanner::Kind::kTrue:
+      return 1;
+    case JsonScanner::Kind::kFalse:
+      return 0;
+    default:
+      return folly::to<double>(scalar.text);
+  }
+}
+
+std::string jsonScalarToString(JsonScalar&& scalar) {
+  switch (scalar.kind) {
+    case JsonScanner::Kind::kTrue:
+      return "true";
+    case JsonScanner::Kind::kFalse:
+      return "false";
+    case JsonScanner::Kind::kNumber:
+      return JsonScanner::isInteger(scalar.text)
+          ? folly::to<std::string>(folly::to<int64_t>(scalar.text))
+          : folly::to<std::string>(folly::to<double>(scalar.text));
+    default:
+      return std::move(scalar.text);
+  }
+}
+
+// Writes the next value of 'scanner' to 'writer'. Like castFromJsonTyped
+// but reads the JSON text in place instead of from a folly::dynamic.
+template <TypeKind kind>
+void castFromScannedJson(JsonScanner& scanner, exec::GenericWriter& writer) {
+  if constexpr (kind == TypeKind::VARCHAR) {
+    if (isJsonType(writer.type())) {
+      std::string json;
+      VELOX_USER_CHECK(scanner.copyValue(json), "Not a JSON input");
+      writer.castTo<Varchar>().append(json);
+    } else {
+      writer.castTo<Varchar>().append(
+          jsonScalarToString(readJsonScalar(scanner)));
+    }
+  } else if constexpr (kind == TypeKind::BOOLEAN) {
+    writer.castTo<bool>() = jsonScalarToBool(readJsonScalar(scanner));
+  } else if constexpr (kind == TypeKind::TINYINT) {
+    writer.castTo<int8_t>() = jsonScalarToInt<int8_t>(readJsonScalar(scanner));
+  } else if constexpr (kind == TypeKind::SMALLINT) {
+    writer.castTo<int16_t>() =
+        jsonScalarToInt<int16_t>(readJsonScalar(scanner));
+  } else if constexpr (kind == TypeKind::INTEGER) {
+    writer.castTo<int32_t>() =
+        jsonScalarToInt<int32_t>(readJsonScalar(scanner));
+  } else if constexpr (kind == TypeKind::BIGINT) {
+    writer.castTo<int64_t>() =
+        jsonScalarToInt<int64_t>(readJsonScalar(scanner));
+  } else if constexpr (kind == TypeKind::REAL) {
+    writer.castTo<float>() =
+        folly::to<float>(jsonScalarToDouble(readJsonScalar(scanner)));
+  } else if constexpr (kind == TypeKind::DOUBLE) {
+    writer.castTo<double>() = jsonScalarToDouble(readJsonScalar(scanner));
+  } else if constexpr (kind == TypeKind::ARRAY) {
+    auto& writerTyped = writer.castTo<Array<Any>>();
+    const auto& elementType = writer.type()->childAt(0);
+    VELOX_USER_CHECK(scanner.enterArray(), "Expected a JSON array");
+    while (scanner.nextElement()) {
+      // If casting to array of JSON, nulls in array elements should become
+      // the JSON text "null".
+      if (!isJsonType(elementType) &&
+          scanner.peek() == JsonScanner::Kind::kNull) {
+        scanner.skipValue();
+        writerTyped.add_null();
+      } else {
+        VELOX_DYNAMIC_TYPE_DISPATCH(
+            castFromScannedJson,
+            elementType->kind(),
+            scanner,
+            writerTyped.add_item());
+      }
+    }
+    VELOX_USER_CHECK(!scanner.failed(), "Not a JSON input");
+  } else {
+    VELOX_NYI(
+        "Casting from JSON to {} is not supported.", TypeTraits<kind>::name);
+  }
+}
+
+// True if 'type' is or contains a map. Casts to these go through
+// folly::dynamic, which keeps the last of duplicate keys.
+bool hasMap(const TypePtr& type) {
+  if (type->kind() == TypeKind::MAP) {
+    return true;
+  }
+  for (auto i = 0; i < type->size(); ++i) {
+    if (hasMap(type->childAt(i))) {
+      return true;
+    }
+  }
+  return false;
+}
+
 template <TypeKind kind>
 void castFromJson(
     const BaseVector& input,
@@ -600,12 +772,42 @@ void castFromJson(
   // input is guaranteed to be in flat or constant encodings when passed in.
   auto* inputVector = input.as<SimpleVector<StringView>>();
 
+  const bool scan = !hasMap(result.type());
   folly::dynamic object;
   context.applyToSelectedNoThrow(rows, [&](auto row) {
     writer.setOffset(row);
 
     if (inputVector->isNullAt(row)) {
       writer.commitNull();
+    } else if (scan) {
+      const auto json = inputVector->valueAt(row);
+      JsonScanner scanner(std::string_view(json.data(), json.size()));
+      if (scanner.peek() == JsonScanner::Kind::kNull) {
+        VELOX_USER_CHECK(
+            scanner.skipValue() && scanner.atEnd(),
+            "Not a JSON input: {}",
+            json);
+        writer.commitNull();
+        return;
+      }
+      try {
+        castFromScannedJson<kind>(scanner, writer.current());
+        // Like folly::parseJson, rejects anything after the value.
+        VELOX_USER_CHECK(scanner.atEnd(), "Not a JSON input");
+      } catch (const VeloxException& ve) {
+        VELOX_USER_FAIL(
+            "Cannot cast from Json value {} to {}: {}",
+            json,
+            result.type()->toString(),
+            ve.message());
+      } catch (const std::exception& e) {
+        VELOX_USER_FAIL(
+            "Cannot cast from Json value {} to {}: {}",
+            json,
+            result.type()->toString(),
+            e.what());
+      }
+      writer.commit(true);
     } else {
       try {
         object = folly::parseJson(inputVector->valueAt(row));
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/WindowFunction.h"
+#include "velox/functions/prestosql/window/WindowFunctionNames.h"
+#include "velox/vector/FlatVector.h"
+
+namespace facebook::velox::window {
+
+namespace {
+
+// rank() is the position in the partition of the first peer of the row,
+// counting from 1. dense_rank() is the number of distinct peer groups
+// up to and including the row. Both ignore the frame.
+template <bool isDense>
+class RankFunction : public exec::WindowFunction {
+ public:
+  explicit RankFunction(memory::MemoryPool* pool)
+      : WindowFunction(BIGINT(), pool) {}
+
+  void resetPartition(const exec::WindowPartition* /*partition*/) override {
+    lastPeerStart_ = -1;
+    denseRank_ = 0;
+  }
+
+  void apply(
+      const BufferPtr& peerGroupStarts,
+      const BufferPtr& /*peerGroupEnds*/,
+      const BufferPtr& /*frameStarts*/,
+      const BufferPtr& /*frameEnds*/,
+      vector_size_t resultOffset,
+      const VectorPtr& result) override {
+    auto numRows = peerGroupStarts->size() / sizeof(vector_size_t);
+    auto rawPeerStarts = peerGroupStarts->as<vector_size_t>();
+    auto rawValues = result->asFlatVector<int64_t>()->mutableRawValues();
+    for (auto i = 0; i < numRows; ++i) {
+      auto peerStart = rawPeerStarts[i];
+      if constexpr (isDense) {
+        if (peerStart != lastPeerStart_) {
+          ++denseRank_;
+          lastPeerStart_ = peerStart;
+        }
+        rawValues[resultOffset + i] = denseRank_;
+      } else {
+        rawValues[resultOffset + i] = peerStart + 1;
+      }
+    }
+  }
+
+ private:
+  // Used by dense_rank(). The peer group of the last row and its rank.
+  vector_size_t lastPeerStart_{-1};
+  int64_t denseRank_{0};
+};
+
+template <bool isDense>
+bool registerRank(const std::string& name) {
+  std::vector<exec::FunctionSignaturePtr> signatures{
+      exec::FunctionSignatureBuilder().returnType("bigint").build(),
+  };
+
+  return exec::registerWindowFunction(
+      name,
+      std::move(signatures),
+      [name](
+          const std::vector<exec::WindowFunctionArg>& args,
+          const TypePtr& /*resultType*/,
+          memory::MemoryPool* pool) -> std::unique_ptr<exec::WindowFunction> {
+        VELOX_CHECK(args.empty(), "{} takes no arguments", name);
+        return std::make_unique<RankFunction<isDense>>(pool);
+      });
+}
+
+} // namespace
+
+static bool FB_ANONYMOUS_VARIABLE(g_RankFunction) = registerRank<false>(kRank);
+static bool FB_ANONYMOUS_VARIABLE(g_DenseRankFunction) =
+    registerRank<true>(kDenseRank);
+
+} // namespace facebook::velox::window
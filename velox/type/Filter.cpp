@@ -53,6 +53,9 @@ std::string Filter::toString() const {
     case FilterKind::kBigintValuesUsingBitmask:
       strKind = "BigintValuesUsingBitmask";
       break;
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      strKind = "BigintValuesUsingBloomFilter";
+      break;
     case FilterKind::kNegatedBigintValuesUsingHashTable:
       strKind = "NegatedBigintValuesUsingHashTable";
       break;
@@ -1138,6 +1141,7 @@ std::unique_ptr<Filter> BigintRange::mergeWith(const Filter* other) const {
     }
     case FilterKind::kBigintValuesUsingBitmask:
     case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kBigintMultiRange: {
       auto otherMultiRange = dynamic_cast<const BigintMultiRange*>(other);
@@ -1204,6 +1208,7 @@ std::unique_ptr<Filter> BigintValuesUsingHashTable::mergeWith(
       return mergeWith(min, max, other);
     }
     case FilterKind::kBigintValuesUsingBitmask:
+    case FilterKind::kBigintValuesUsingBloomFilter:
       return other->mergeWith(this);
     case FilterKind::kBigintMultiRange: {
       auto otherMultiRange = dynamic_cast<const BigintMultiRange*>(other);
@@ -1303,6 +1308,8 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
 
       return mergeWith(min, max, other);
     }
+    case FilterKind::kBigintValuesUsingBloomFilter:
+      return other->mergeWith(this);
     case FilterKind::kBigintMultiRange: {
       auto otherMultiRange = dynamic_cast<const BigintMultiRange*>(other);
 
@@ -1344,6 +1351,67 @@ std::unique_ptr<Filter> BigintValuesUsingBitmask::mergeWith(
   return createBigintValues(valuesToKeep, bothNullAllowed);
 }
 
+std::unique_ptr<Filter> BigintValuesUsingBloomFilter::mergeWith(
+    const Filter* other) const {
+  switch (other->kind()) {
+    case FilterKind::kAlwaysTrue:
+    case FilterKind::kAlwaysFalse:
+    case FilterKind::kIsNull:
+      return other->mergeWith(this);
+    case FilterKind::kIsNotNull:
+      return std::make_unique<BigintValuesUsingBloomFilter>(*this, false);
+    case FilterKind::kBigintRange: {
+      auto otherRange = dynamic_cast<const BigintRange*>(other);
+      bool bothNullAllowed = nullAllowed_ && other->testNull();
+
+      auto min = std::max(min_, otherRange->lower());
+      auto max = std::min(max_, otherRange->upper());
+      if (min > max) {
+        return nullOrFalse(bothNullAllowed);
+      }
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          min, max, bloomFilter_, bothNullAllowed);
+    }
+    case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBitmask: {
+      bool bothNullAllowed = nullAllowed_ && other->testNull();
+      auto values = other->kind() == FilterKind::kBigintValuesUsingHashTable
+          ? dynamic_cast<const BigintValuesUsingHashTable*>(other)->values()
+          : dynamic_cast<const BigintValuesUsingBitmask*>(other)->values();
+
+      std::vector<int64_t> valuesToKeep;
+      for (auto value : values) {
+        if (testInt64(value)) {
+          valuesToKeep.push_back(value);
+        }
+      }
+      return createBigintValues(valuesToKeep, bothNullAllowed);
+    }
+    case FilterKind::kBigintValuesUsingBloomFilter: {
+      // Keeps the Bloom filter of 'this' with the common range.
+      auto otherBloom =
+          dynamic_cast<const BigintValuesUsingBloomFilter*>(other);
+      bool bothNullAllowed = nullAllowed_ && other->testNull();
+
+      auto min = std::max(min_, otherBloom->min_);
+      auto max = std::min(max_, otherBloom->max_);
+      if (min > max) {
+        return nullOrFalse(bothNullAllowed);
+      }
+      return std::make_unique<BigintValuesUsingBloomFilter>(
+          min, max, bloomFilter_, bothNullAllowed);
+    }
+    case FilterKind::kNegatedBigintValuesUsingHashTable:
+    case FilterKind::kNegatedBigintValuesUsingBitmask:
+    case FilterKind::kBigintMultiRange:
+      // Not expressible as a single filter. Drops the Bloom filter, which
+      // may only pass more values than the exact AND.
+      return other->clone(nullAllowed_ && other->testNull());
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
 std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
     const Filter* other) const {
   // Rules of NegatedBigintValuesUsingHashTable with IsNull/IsNotNull
@@ -1363,6 +1431,7 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingHashTable::mergeWith(
       return std::make_unique<NegatedBigintValuesUsingHashTable>(*this, false);
     case FilterKind::kBigintValuesUsingHashTable:
     case FilterKind::kBigintValuesUsingBitmask:
+    case FilterKind::kBigintValuesUsingBloomFilter:
     case FilterKind::kBigintRange:
     case FilterKind::kBigintMultiRange: {
       return other->mergeWith(this);
@@ -1404,6 +1473,7 @@ std::unique_ptr<Filter> NegatedBigintValuesUsingBitmask::mergeWith(
       return std::make_unique<NegatedBigintValuesUsingBitmask>(*this, false);
     case FilterKind::kBigintValuesUsingHashTable:
     case FilterKind::kBigintValuesUsingBitmask:
+    case FilterKind::kBigintValuesUsingBloomFilter:
     case FilterKind::kBigintRange:
     case FilterKind::kBigintMultiRange: {
       return other->mergeWith(this);
@@ -1444,7 +1514,8 @@ std::unique_ptr<Filter> BigintMultiRange::mergeWith(const Filter* other) const {
     }
     case FilterKind::kBigintRange:
     case FilterKind::kBigintValuesUsingBitmask:
-    case FilterKind::kBigintValuesUsingHashTable: {
+    case FilterKind::kBigintValuesUsingHashTable:
+    case FilterKind::kBigintValuesUsingBloomFilter: {
       return other->mergeWith(this);
     }
     case FilterKind::kBigintMultiRange: {
@@ -380,6 +380,62 @@ TEST(FilterTest, bigintValuesUsingBitmask) {
   EXPECT_FALSE(filter->testInt64Range(1234, 2000, false));
 }
 
+TEST(FilterTest, bigintValuesUsingBloomFilter) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(1'000);
+  for (auto i = 0; i < 1'000; ++i) {
+    bloomFilter->insert(i * 7);
+  }
+  auto filter = std::make_unique<BigintValuesUsingBloomFilter>(
+      0, 999 * 7, bloomFilter, false);
+
+  for (auto i = 0; i < 1'000; ++i) {
+    EXPECT_TRUE(filter->testInt64(i * 7));
+  }
+  EXPECT_FALSE(filter->testNull());
+  EXPECT_FALSE(filter->testInt64(-7));
+  EXPECT_FALSE(filter->testInt64(1'000 * 7));
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < 1'000; ++i) {
+    numFalsePositives += filter->testInt64(i * 7 + 1);
+  }
+  EXPECT_LT(numFalsePositives, 100);
+
+  EXPECT_TRUE(filter->testInt64Range(-10, 0, false));
+  EXPECT_TRUE(filter->testInt64Range(100, 200, false));
+  EXPECT_FALSE(filter->testInt64Range(-10, -1, false));
+  EXPECT_FALSE(filter->testInt64Range(7'000, 8'000, false));
+  EXPECT_FALSE(filter->testInt64Range(-10, -1, true));
+  EXPECT_TRUE(filter->clone(true)->testInt64Range(-10, -1, true));
+
+  // AND with a range narrows the range of the Bloom filter.
+  auto range = std::make_unique<BigintRange>(70, 140, false);
+  auto merged = filter->mergeWith(range.get());
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+  EXPECT_TRUE(merged->testInt64(70));
+  EXPECT_TRUE(merged->testInt64(140));
+  EXPECT_FALSE(merged->testInt64(63));
+  EXPECT_FALSE(merged->testInt64(147));
+  merged = range->mergeWith(filter.get());
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+
+  // AND with an IN list keeps the values that pass the Bloom filter.
+  auto values = createBigintValues({7, 14, 100'000, 200'000}, false);
+  merged = values->mergeWith(filter.get());
+  EXPECT_TRUE(merged->testInt64(7));
+  EXPECT_TRUE(merged->testInt64(14));
+  EXPECT_FALSE(merged->testInt64(100'000));
+  EXPECT_FALSE(merged->testInt64(200'000));
+
+  merged = filter->mergeWith(std::make_unique<AlwaysFalse>().get());
+  ASSERT_EQ(merged->kind(), FilterKind::kAlwaysFalse);
+  merged = filter->mergeWith(std::make_unique<IsNotNull>().get());
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+  range = std::make_unique<BigintRange>(-10, -1, true);
+  merged = filter->mergeWith(range.get());
+  ASSERT_EQ(merged->kind(), FilterKind::kAlwaysFalse);
+}
+
 TEST(FilterTest, negatedBigintValuesUsingBitmask) {
   auto filter = createNegatedBigintValues({1, 6, 1000, 8, 9, 100, 10}, false);
   auto castedFilter =